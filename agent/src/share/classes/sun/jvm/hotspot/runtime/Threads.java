@@ -125,6 +125,7 @@ public class Threads {
         virtualConstructor.addMapping("SurrogateLockerThread", JavaThread.class);
         virtualConstructor.addMapping("JvmtiAgentThread", JvmtiAgentThread.class);
         virtualConstructor.addMapping("ServiceThread", ServiceThread.class);
+        virtualConstructor.addMapping("CodeCacheSweeperThread", CodeCacheSweeperThread.class);
     }
 
     public Threads() {
@@ -164,7 +165,7 @@ public class Threads {
             return thread;
         } catch (Exception e) {
             throw new RuntimeException("Unable to deduce type of thread from address " + threadAddr +
-            " (expected type JavaThread, CompilerThread, ServiceThread, JvmtiAgentThread, or SurrogateLockerThread)", e);
+            " (expected type JavaThread, CompilerThread, ServiceThread, CodeCacheSweeperThread, JvmtiAgentThread, or SurrogateLockerThread)", e);
         }
     }
 
@@ -206,6 +206,11 @@ void VM_Version::initialize() {
   }
 #endif
 
+  if (UseCharsetIntrinsics) {
+    warning("charset intrinsics are not available on this CPU");
+    FLAG_SET_DEFAULT(UseCharsetIntrinsics, false);
+  }
+
   if (UseSHA) {
     warning("SHA instructions are not available on this CPU");
     FLAG_SET_DEFAULT(UseSHA, false);
@@ -319,6 +319,11 @@ void VM_Version::initialize() {
     }
   }
 
+  if (UseCharsetIntrinsics) {
+    warning("charset intrinsics are not available on this CPU");
+    FLAG_SET_DEFAULT(UseCharsetIntrinsics, false);
+  }
+
   // SHA1, SHA256, and SHA512 instructions were added to SPARC T-series at different times
   if (has_sha1() || has_sha256() || has_sha512()) {
     if (UseVIS > 0) { // SHA intrinsics use VIS1 instructions
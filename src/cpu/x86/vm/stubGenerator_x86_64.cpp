@@ -3680,6 +3680,164 @@ class StubGenerator: public StubCodeGenerator {
   }
 
 
+  /**
+   *  Arguments:
+   *
+   * Inputs:
+   *   c_rarg0   - byte* src
+   *   c_rarg1   - jchar* dst
+   *   c_rarg2   - int length
+   */
+  address generate_inflateBytes() {
+    assert(UseCharsetIntrinsics, "need charset intrinsics");
+
+    __ align(CodeEntryAlignment);
+    StubCodeMark mark(this, "StubRoutines", "inflateBytes");
+
+    address start = __ pc();
+    const Register src = c_rarg0;  // source java byte array address
+    const Register dst = c_rarg1;  // destination java char array address
+    const Register len = c_rarg2;  // length
+    const Register tmp = r10;
+    const XMMRegister vec0  = xmm0;
+    const XMMRegister vec1  = xmm1;
+    const XMMRegister vzero = xmm2;
+    assert_different_registers(src, dst, len, tmp);
+
+    Label L_loop16, L_tail8, L_tail, L_done;
+
+    BLOCK_COMMENT("Entry:");
+    __ enter(); // required for proper stackwalking of RuntimeStub frame
+
+    __ movl(len, len);
+    __ pxor(vzero, vzero);
+
+    // Zero-extend 16 bytes to 16 chars per iteration.
+    __ bind(L_loop16);
+    __ cmpl(len, 16);
+    __ jccb(Assembler::less, L_tail8);
+    __ movq(vec0, Address(src, 0));
+    __ movq(vec1, Address(src, 8));
+    __ punpcklbw(vec0, vzero);
+    __ punpcklbw(vec1, vzero);
+    __ movdqu(Address(dst, 0), vec0);
+    __ movdqu(Address(dst, 16), vec1);
+    __ addptr(src, 16);
+    __ addptr(dst, 32);
+    __ subl(len, 16);
+    __ jmpb(L_loop16);
+
+    __ bind(L_tail8);
+    __ cmpl(len, 8);
+    __ jccb(Assembler::less, L_tail);
+    __ movq(vec0, Address(src, 0));
+    __ punpcklbw(vec0, vzero);
+    __ movdqu(Address(dst, 0), vec0);
+    __ addptr(src, 8);
+    __ addptr(dst, 16);
+    __ subl(len, 8);
+
+    __ bind(L_tail);
+    __ testl(len, len);
+    __ jccb(Assembler::zero, L_done);
+    __ movzbl(tmp, Address(src, 0));
+    __ movw(Address(dst, 0), tmp);
+    __ incrementq(src);
+    __ addptr(dst, 2);
+    __ decrementl(len);
+    __ jmpb(L_tail);
+
+    __ bind(L_done);
+    __ leave(); // required for proper stackwalking of RuntimeStub frame
+    __ ret(0);
+
+    return start;
+  }
+
+
+  /**
+   *  Arguments:
+   *
+   * Inputs:
+   *   c_rarg0   - byte* src
+   *   c_rarg1   - jchar* dst
+   *   c_rarg2   - int length
+   *
+   * Output:
+   *   rax       - number of bytes inflated, up to the first negative byte
+   */
+  address generate_inflateASCIIBytes() {
+    assert(UseCharsetIntrinsics, "need charset intrinsics");
+
+    __ align(CodeEntryAlignment);
+    StubCodeMark mark(this, "StubRoutines", "inflateASCIIBytes");
+
+    address start = __ pc();
+    const Register src    = c_rarg0;  // source java byte array address
+    const Register dst    = c_rarg1;  // destination java char array address
+    const Register len    = c_rarg2;  // length
+    const Register result = rax;      // bytes inflated
+    const Register mask   = r10;
+    const Register tmp    = r11;
+    const XMMRegister vec0  = xmm0;
+    const XMMRegister vec1  = xmm1;
+    const XMMRegister vzero = xmm2;
+    assert_different_registers(src, dst, len, result, mask, tmp);
+
+    Label L_loop16, L_tail, L_done;
+
+    BLOCK_COMMENT("Entry:");
+    __ enter(); // required for proper stackwalking of RuntimeStub frame
+
+    __ movl(len, len);
+    __ xorl(result, result);
+    __ mov64(mask, CONST64(0x8080808080808080));
+    __ pxor(vzero, vzero);
+
+    // Zero-extend 16 bytes to 16 chars per iteration while none of them
+    // has the sign bit set.
+    __ bind(L_loop16);
+    __ cmpl(len, 16);
+    __ jccb(Assembler::less, L_tail);
+    __ movq(tmp, Address(src, 0));
+    __ orq(tmp, Address(src, 8));
+    __ testq(tmp, mask);
+    __ jccb(Assembler::notZero, L_tail);
+    __ movq(vec0, Address(src, 0));
+    __ movq(vec1, Address(src, 8));
+    __ punpcklbw(vec0, vzero);
+    __ punpcklbw(vec1, vzero);
+    __ movdqu(Address(dst, 0), vec0);
+    __ movdqu(Address(dst, 16), vec1);
+    __ addptr(src, 16);
+    __ addptr(dst, 32);
+    __ addl(result, 16);
+    __ subl(len, 16);
+    __ jmpb(L_loop16);
+
+    // The remaining bytes, or the block with a negative byte, one at a
+    // time up to the first negative byte.
+    __ bind(L_tail);
+    __ testl(len, len);
+    __ jccb(Assembler::zero, L_done);
+    __ movsbl(tmp, Address(src, 0));
+    __ testl(tmp, tmp);
+    __ jccb(Assembler::negative, L_done);
+    __ movw(Address(dst, 0), tmp);
+    __ incrementq(src);
+    __ addptr(dst, 2);
+    __ incrementl(result);
+    __ decrementl(len);
+    __ jmpb(L_tail);
+
+    __ bind(L_done);
+    __ leave(); // required for proper stackwalking of RuntimeStub frame
+    __ ret(0);
+
+    return start;
+  }
+
+
   /**
    *  Arguments:
    *
@@ -4077,6 +4235,11 @@ class StubGenerator: public StubCodeGenerator {
       StubRoutines::_cipherBlockChaining_decryptAESCrypt = generate_cipherBlockChaining_decryptAESCrypt_Parallel();
     }
 
+    if (UseCharsetIntrinsics) {
+      StubRoutines::_inflateBytes = generate_inflateBytes();
+      StubRoutines::_inflateASCIIBytes = generate_inflateASCIIBytes();
+    }
+
     // Safefetch stubs.
     generate_safefetch("SafeFetch32", sizeof(int),     &StubRoutines::_safefetch32_entry,
                                                        &StubRoutines::_safefetch32_fault_pc,
@@ -582,6 +582,20 @@ void VM_Version::get_processor_features() {
     FLAG_SET_DEFAULT(UseCRC32Intrinsics, false);
   }
 
+  // The charset stubs are only generated for 64-bit VMs.
+#ifdef _LP64
+  if (FLAG_IS_DEFAULT(UseCharsetIntrinsics)) {
+    UseCharsetIntrinsics = true;
+  }
+#else
+  if (UseCharsetIntrinsics) {
+    if (!FLAG_IS_DEFAULT(UseCharsetIntrinsics)) {
+      warning("charset intrinsics are not available in 32-bit VM");
+    }
+    FLAG_SET_DEFAULT(UseCharsetIntrinsics, false);
+  }
+#endif
+
   // The AES intrinsic stubs require AES instruction support (of course)
   // but also require sse3 mode for instructions it use.
   if (UseAES && (UseSSE > 2)) {
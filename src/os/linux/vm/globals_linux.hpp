@@ -43,6 +43,10 @@
   product(bool, UseTransparentHugePages, false,                         \
           "Use MADV_HUGEPAGE for large pages")                          \
                                                                         \
+  product(bool, UseTransparentHugePagesForCodeCache, false,             \
+          "Use MADV_HUGEPAGE for the code cache, independently of "     \
+          "UseLargePages")                                              \
+                                                                        \
   product(bool, LoadExecStackDllInVMThread, true,                       \
           "Load DLLs with executable-stack attribute in the VM Thread") \
                                                                         \
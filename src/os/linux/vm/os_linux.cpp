@@ -3593,7 +3593,59 @@ bool os::Linux::setup_large_page_type(size_t page_size) {
   return UseSHM;
 }
 
+// Transparent huge pages for the code cache only
+
+static size_t _code_huge_page_size = 0;
+
+// With UseTransparentHugePagesForCodeCache the code cache is reserved at
+// huge page alignment and advised with MADV_HUGEPAGE on every commit, so
+// that compiled code gets few iTLB entries even when large pages are not
+// used for the Java heap.
+void os::Linux::setup_code_huge_pages() {
+  if (!UseTransparentHugePagesForCodeCache) {
+    return;
+  }
+  size_t page_size = find_large_page_size();
+  if (!transparent_huge_pages_sanity_check(!FLAG_IS_DEFAULT(UseTransparentHugePagesForCodeCache), page_size)) {
+    UseTransparentHugePagesForCodeCache = false;
+    return;
+  }
+  _code_huge_page_size = page_size;
+}
+
+// Huge page size for the code cache, 0 if the code cache uses the default
+// page size or the regular large page setup.
+size_t linux_code_huge_page_size() {
+  return _code_huge_page_size;
+}
+
+// Bytes of the code cache advised with MADV_HUGEPAGE and the number of
+// madvise calls that failed, reported by PrintCodeCache.
+static volatile intptr_t _code_huge_page_advised = 0;
+static volatile jint     _code_huge_page_advise_failures = 0;
+
+void linux_advise_code_huge_pages(char* base, size_t size) {
+  if (_code_huge_page_size != 0 && size > 0) {
+    // A failure is not fatal, the code cache just stays on small pages.
+    if (::madvise(base, size, MADV_HUGEPAGE) == 0) {
+      Atomic::add_ptr((intptr_t)size, &_code_huge_page_advised);
+    } else {
+      Atomic::inc(&_code_huge_page_advise_failures);
+    }
+  }
+}
+
+void linux_print_code_huge_pages(outputStream* st) {
+  if (_code_huge_page_size != 0) {
+    st->print_cr("CodeCache huge pages: page_size=" SIZE_FORMAT "K advised=" SIZE_FORMAT
+                 "Kb failed=%d", _code_huge_page_size/K, (size_t)_code_huge_page_advised/K,
+                 _code_huge_page_advise_failures);
+  }
+}
+
 void os::large_page_init() {
+  Linux::setup_code_huge_pages();
+
   if (!UseLargePages &&
       !UseTransparentHugePages &&
       !UseHugeTLBFS &&
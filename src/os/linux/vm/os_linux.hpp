@@ -109,6 +109,7 @@ class Linux {
 
   static bool setup_large_page_type(size_t page_size);
   static bool transparent_huge_pages_sanity_check(bool warn, size_t pages_size);
+  static void setup_code_huge_pages();
   static bool hugetlbfs_sanity_check(bool warn, size_t page_size);
 
   static char* reserve_memory_special_shm(size_t bytes, size_t alignment, char* req_addr, bool exec);
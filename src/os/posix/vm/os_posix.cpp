@@ -30,7 +30,9 @@
 
 #include <signal.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/resource.h>
+#include <sys/wait.h>
 #include <sys/utsname.h>
 #include <pthread.h>
 #include <signal.h>
@@ -106,6 +108,47 @@ int os::get_native_stack(address* stack, int frames, int toSkip) {
 }
 
 
+#ifdef __APPLE__
+// Darwin has no "environ" in a dynamic library.
+#include <crt_externs.h>
+#define environ (*_NSGetEnviron())
+#else
+extern char** environ;
+#endif
+
+// The process is started by a short-lived intermediate child, so that it
+// is reparented to init and nobody has to wait for it. Only async-signal-
+// safe functions are called between fork() and execve().
+int os::spawn_detached(const char* path, char* const argv[], bool inherit_output) {
+  pid_t pid = fork();
+  if (pid < 0) {
+    return -1;
+  } else if (pid == 0) {
+    pid_t grandchild = fork();
+    if (grandchild == 0) {
+      if (!inherit_output) {
+        int fd = ::open("/dev/null", O_RDWR);
+        if (fd >= 0) {
+          dup2(fd, 0);
+          dup2(fd, 1);
+          dup2(fd, 2);
+        }
+      }
+      execve(path, argv, environ);
+      _exit(127);
+    }
+    _exit(grandchild < 0 ? 1 : 0);
+  }
+
+  int status;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      return -1;
+    }
+  }
+  return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
 bool os::unsetenv(const char* name) {
   assert(name != NULL, "Null pointer");
   return (::unsetenv(name) == 0);
@@ -5096,6 +5096,47 @@ int os::fork_and_exec(char* cmd, bool use_vfork_if_available) {
   }
 }
 
+int os::spawn_detached(const char* path, char* const argv[], bool inherit_output) {
+  // CreateProcess takes a single command line. Every argument is quoted,
+  // so it must neither contain a quote nor end with a backslash. The
+  // executable is taken from argv[0], which lets CreateProcess append the
+  // .exe extension to path.
+  stringStream cmd;
+  for (int i = 0; argv[i] != NULL; i++) {
+    size_t len = strlen(argv[i]);
+    if (strchr(argv[i], '"') != NULL || (len > 0 && argv[i][len - 1] == '\\')) {
+      return -1;
+    }
+    cmd.print_raw(i == 0 ? "\"" : " \"");
+    cmd.print_raw(argv[i]);
+    cmd.print_raw("\"");
+  }
+
+  STARTUPINFO si;
+  PROCESS_INFORMATION pi;
+
+  memset(&si, 0, sizeof(si));
+  si.cb = sizeof(si);
+  memset(&pi, 0, sizeof(pi));
+  BOOL rslt = CreateProcess(NULL,                  // executable name - use command line
+                            cmd.as_string(),       // command line
+                            NULL,                  // process security attribute
+                            NULL,                  // thread security attribute
+                            inherit_output,        // inherits system handles
+                            inherit_output ? 0 : DETACHED_PROCESS,
+                            NULL,                  // use parent's environment block
+                            NULL,                  // use parent's starting directory
+                            &si,                   // (in) startup information
+                            &pi);                  // (out) process information
+  if (!rslt) {
+    return -1;
+  }
+  // Don't wait for the process
+  CloseHandle(pi.hProcess);
+  CloseHandle(pi.hThread);
+  return 0;
+}
+
 //--------------------------------------------------------------------------------------------------
 // Non-product code
 
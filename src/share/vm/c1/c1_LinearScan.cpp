@@ -49,17 +49,19 @@
 #endif
 
 
+  // per-phase timers are also available in product builds so that
+  // -XX:+CITime can break down where linear scan spends its time
+  static LinearScanTimers _total_timer;
+
+  // helper macro for short definition of timer
+  #define TIME_LINEAR_SCAN(timer_name)  TraceTime _block_timer("", _total_timer.timer(LinearScanTimers::timer_name), TimeLinearScan || CITime || TimeEachLinearScan, Verbose);
+
 #ifndef PRODUCT
 
   static LinearScanStatistic _stat_before_alloc;
   static LinearScanStatistic _stat_after_asign;
   static LinearScanStatistic _stat_final;
 
-  static LinearScanTimers _total_timer;
-
-  // helper macro for short definition of timer
-  #define TIME_LINEAR_SCAN(timer_name)  TraceTime _block_timer("", _total_timer.timer(LinearScanTimers::timer_name), TimeLinearScan || TimeEachLinearScan, Verbose);
-
   // helper macro for short definition of trace-output inside code
   #define TRACE_LINEAR_SCAN(level, code)       \
     if (TraceLinearScanLevel >= level) {       \
@@ -68,7 +70,6 @@
 
 #else
 
-  #define TIME_LINEAR_SCAN(timer_name)
   #define TRACE_LINEAR_SCAN(level, code)
 
 #endif
@@ -757,6 +758,14 @@ void LinearScan::compute_global_live_sets() {
   int  iteration_count = 0;
   BitMap live_out(live_set_size()); live_out.clear(); // scratch set for calculations
 
+  // Change stamps (indexed by linear scan number): live_out of a block only has to be
+  // recomputed if the live_in set of a successor or exception handler changed since
+  // the last computation.  This avoids the full set unions for all blocks in every
+  // iteration, which dominate this phase for huge methods with many loops.
+  int      stamp = 0;
+  intArray live_in_changed(num_blocks, 0);
+  intArray live_out_computed(num_blocks, -1);
+
   // Perform a backward dataflow analysis to compute live_out and live_in for each block.
   // The loop is executed until a fixpoint is reached (no changes in an iteration)
   // Exception handlers must be processed because not all live values are
@@ -767,14 +776,25 @@ void LinearScan::compute_global_live_sets() {
     // iterate all blocks in reverse order
     for (int i = num_blocks - 1; i >= 0; i--) {
       BlockBegin* block = block_at(i);
+      assert(block->linear_scan_number() == i, "wrong block order");
 
       change_occurred_in_block = false;
 
       // live_out(block) is the union of live_in(sux), for successors sux of block
       int n = block->number_of_sux();
       int e = block->number_of_exception_handlers();
-      if (n + e > 0) {
+      bool sux_changed = false;
+      int  computed = live_out_computed.at(i);
+      for (int j = 0; j < n && !sux_changed; j++) {
+        sux_changed = live_in_changed.at(block->sux_at(j)->linear_scan_number()) > computed;
+      }
+      for (int j = 0; j < e && !sux_changed; j++) {
+        sux_changed = live_in_changed.at(block->exception_handler_at(j)->linear_scan_number()) > computed;
+      }
+
+      if (sux_changed) {
         // block has successors
+        live_out_computed.at_put(i, ++stamp);
         if (n > 0) {
           live_out.set_from(block->sux_at(0)->live_in());
           for (int j = 1; j < n; j++) {
@@ -805,6 +825,7 @@ void LinearScan::compute_global_live_sets() {
         live_in.set_from(block->live_out());
         live_in.set_difference(block->live_kill());
         live_in.set_union(block->live_gen());
+        live_in_changed.at_put(i, ++stamp);
       }
 
 #ifndef PRODUCT
@@ -1755,7 +1776,10 @@ void LinearScan::resolve_data_flow() {
   int num_blocks = block_count();
   MoveResolver move_resolver(this);
   BitMap block_completed(num_blocks);  block_completed.clear();
-  BitMap already_resolved(num_blocks); already_resolved.clear();
+  // index of the last from_block that resolved an edge to each block; this
+  // replaces copying block_completed for every block, which is quadratic in
+  // the number of blocks for huge methods
+  intArray already_resolved(num_blocks, -1);
 
   int i;
   for (i = 0; i < num_blocks; i++) {
@@ -1793,16 +1817,16 @@ void LinearScan::resolve_data_flow() {
   for (i = 0; i < num_blocks; i++) {
     if (!block_completed.at(i)) {
       BlockBegin* from_block = block_at(i);
-      already_resolved.set_from(block_completed);
 
       int num_sux = from_block->number_of_sux();
       for (int s = 0; s < num_sux; s++) {
         BlockBegin* to_block = from_block->sux_at(s);
 
         // check for duplicate edges between the same blocks (can happen with switch blocks)
-        if (!already_resolved.at(to_block->linear_scan_number())) {
+        int to_nr = to_block->linear_scan_number();
+        if (!block_completed.at(to_nr) && already_resolved.at(to_nr) != i) {
           TRACE_LINEAR_SCAN(3, tty->print_cr("**** processing edge between B%d and B%d", from_block->block_id(), to_block->block_id()));
-          already_resolved.set_bit(to_block->linear_scan_number());
+          already_resolved.at_put(to_nr, i);
 
           // collect all intervals that have been split between from_block and to_block
           resolve_collect_mappings(from_block, to_block, move_resolver);
@@ -3029,7 +3053,7 @@ void LinearScan::assign_reg_num() {
 
 
 void LinearScan::do_linear_scan() {
-  NOT_PRODUCT(_total_timer.begin_method());
+  _total_timer.begin_method();
 
   number_instructions();
 
@@ -3089,18 +3113,18 @@ void LinearScan::do_linear_scan() {
 
   NOT_PRODUCT(print_lir(1, "Before Code Generation", false));
   NOT_PRODUCT(LinearScanStatistic::compute(this, _stat_final));
-  NOT_PRODUCT(_total_timer.end_method(this));
+  _total_timer.end_method(this);
 }
 
 
 // ********** Printing functions
 
-#ifndef PRODUCT
-
 void LinearScan::print_timers(double total) {
   _total_timer.print(total);
 }
 
+#ifndef PRODUCT
+
 void LinearScan::print_statistics() {
   _stat_before_alloc.print("before allocation");
   _stat_after_asign.print("after assignment of register");
@@ -5013,8 +5037,10 @@ int LinearScanWalker::find_optimal_split_pos(BlockBegin* min_block, BlockBegin*
     optimal_split_pos = max_block->first_lir_instruction_id();
   }
 
+  // no block can have a lower loop depth than 0, so the search can stop
+  // early; this matters for long intervals spanning many blocks
   int min_loop_depth = max_block->loop_depth();
-  for (int i = to_block_nr - 1; i >= from_block_nr; i--) {
+  for (int i = to_block_nr - 1; i >= from_block_nr && min_loop_depth > 0; i--) {
     BlockBegin* cur = block_at(i);
 
     if (cur->loop_depth() < min_loop_depth) {
@@ -6642,6 +6668,9 @@ void LinearScanStatistic::compute(LinearScan* allocator, LinearScanStatistic &gl
 }
 
 
+#endif // #ifndef PRODUCT
+
+
 // Implementation of LinearTimers
 
 LinearScanTimers::LinearScanTimers() {
@@ -6709,7 +6738,7 @@ void LinearScanTimers::end_method(LinearScan* allocator) {
 }
 
 void LinearScanTimers::print(double total_time) {
-  if (TimeLinearScan) {
+  if (TimeLinearScan || CITime) {
     // correction value: sum of dummy-timer that only measures the time that
     // is necesary to start and stop itself
     double c = timer(timer_do_nothing)->seconds();
@@ -6720,5 +6749,3 @@ void LinearScanTimers::print(double total_time) {
     }
   }
 }
-
-#endif // #ifndef PRODUCT
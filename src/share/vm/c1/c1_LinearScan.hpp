@@ -405,9 +405,9 @@ class LinearScan : public CompilationResourceObj {
   int         num_calls() const   { assert(_num_calls >= 0, "not set"); return _num_calls; }
 
   // entry functions for printing
+  static void print_timers(double total);
 #ifndef PRODUCT
   static void print_statistics();
-  static void print_timers(double total);
 #endif
 };
 
@@ -932,6 +932,8 @@ class LinearScanStatistic : public StackObj {
   static void compute(LinearScan* allocator, LinearScanStatistic &global_statistic);
 };
 
+#endif // ifndef PRODUCT
+
 
 // Helper class for collecting compilation time of LinearScan
 class LinearScanTimers : public StackObj {
@@ -969,9 +971,6 @@ class LinearScanTimers : public StackObj {
 };
 
 
-#endif // ifndef PRODUCT
-
-
 // Pick up platform-dependent implementation details
 #ifdef TARGET_ARCH_x86
 # include "c1_LinearScan_x86.hpp"
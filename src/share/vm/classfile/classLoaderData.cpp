@@ -58,6 +58,7 @@
 #include "memory/metaspaceShared.hpp"
 #include "memory/oopFactory.hpp"
 #include "runtime/jniHandles.hpp"
+#include "runtime/monitorContentionStatistics.hpp"
 #include "runtime/mutex.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/synchronizer.hpp"
@@ -773,6 +774,8 @@ bool ClassLoaderDataGraph::do_unloading(BoolObjectClosure* is_alive_closure, boo
     chain->do_unloading(is_alive_closure);
   }
 
+  MonitorContentionStatistics::do_unloading(is_alive_closure);
+
   // Save previous _unloading pointer for CMS which may add to unloading list before
   // purging and we don't want to rewalk the previously unloaded class loader data.
   _saved_unloading = _unloading;
@@ -820,6 +820,24 @@ oop StringTable::intern(const char* utf8_string, TRAPS) {
   return result;
 }
 
+bool StringTable::add_archived_string(oop string) {
+  // The archived value array never moves, so its characters can be used
+  // directly.
+  typeArrayOop value = java_lang_String::value(string);
+  int length = java_lang_String::length(string);
+  jchar* chars = length == 0 ? NULL : value->char_at_addr(java_lang_String::offset(string));
+  unsigned int hashValue = hash_string(chars, length);
+
+  MutexLocker ml(StringTable_lock);
+  int index = the_table()->hash_to_index(hashValue);
+  if (the_table()->lookup(index, chars, length, hashValue) != NULL) {
+    return false;
+  }
+  HashtableEntry<oop, mtSymbol>* entry = the_table()->new_entry(hashValue, string);
+  the_table()->add_entry(index, entry);
+  return true;
+}
+
 void StringTable::unlink_or_oops_do(BoolObjectClosure* is_alive, OopClosure* f, int* processed, int* removed) {
   BucketUnlinkContext context;
   buckets_unlink_or_oops_do(is_alive, f, 0, the_table()->table_size(), &context);
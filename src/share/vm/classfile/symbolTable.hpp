@@ -346,6 +346,10 @@ public:
   static oop intern(oop string, TRAPS);
   static oop intern(const char *utf8_string, TRAPS);
 
+  // Add a string loaded from the shared archive, unless an equal string
+  // is already interned. Returns true if the string was added.
+  static bool add_archived_string(oop string);
+
   // Debugging
   static void verify();
   static void dump(outputStream* st);
@@ -40,6 +40,7 @@
 #include "interpreter/interpreter.hpp"
 #include "memory/filemap.hpp"
 #include "memory/gcLocker.hpp"
+#include "memory/heapShared.hpp"
 #include "memory/oopFactory.hpp"
 #include "oops/instanceKlass.hpp"
 #include "oops/instanceRefKlass.hpp"
@@ -1978,6 +1979,13 @@ void SystemDictionary::initialize_preloaded_classes(TRAPS) {
   java_lang_String::compute_offsets();
   java_lang_Class::compute_offsets();
 
+#if INCLUDE_CDS
+  if (UseSharedSpaces) {
+    // The archived interned strings can be used from now on.
+    HeapShared::add_archived_strings_to_table();
+  }
+#endif
+
   // Fixup mirrors for classes loaded before java.lang.Class.
   // These calls iterate over the objects currently in the perm gen
   // so calling them at this point is matters (not before when there
@@ -524,9 +524,11 @@
   template(String_StringBuilder_signature,            "(Ljava/lang/String;)Ljava/lang/StringBuilder;")            \
   template(int_StringBuilder_signature,               "(I)Ljava/lang/StringBuilder;")                             \
   template(char_StringBuilder_signature,              "(C)Ljava/lang/StringBuilder;")                             \
+  template(bool_StringBuilder_signature,              "(Z)Ljava/lang/StringBuilder;")                             \
   template(String_StringBuffer_signature,             "(Ljava/lang/String;)Ljava/lang/StringBuffer;")             \
   template(int_StringBuffer_signature,                "(I)Ljava/lang/StringBuffer;")                              \
   template(char_StringBuffer_signature,               "(C)Ljava/lang/StringBuffer;")                              \
+  template(bool_StringBuffer_signature,               "(Z)Ljava/lang/StringBuffer;")                              \
   template(int_String_signature,                      "(I)Ljava/lang/String;")                                    \
   template(codesource_permissioncollection_signature, "(Ljava/security/CodeSource;Ljava/security/PermissionCollection;)V") \
   /* signature symbols needed by intrinsics */                                                                    \
@@ -809,6 +811,14 @@
    do_name(     encodeISOArray_name,                             "encodeISOArray")                                      \
    do_signature(encodeISOArray_signature,                        "([CI[BII)I")                                          \
                                                                                                                         \
+  do_class(sun_nio_cs_iso8859_1_Decoder,  "sun/nio/cs/ISO_8859_1$Decoder")                                              \
+  do_intrinsic(_decodeISO8859_1,   sun_nio_cs_iso8859_1_Decoder, decode_name, decodeISO8859_1_signature,   F_R)         \
+   do_name(     decode_name,                                     "decode")                                              \
+   do_signature(decodeISO8859_1_signature,                       "([BII[C)I")                                           \
+                                                                                                                        \
+  do_class(sun_nio_cs_utf_8_Decoder,      "sun/nio/cs/UTF_8$Decoder")                                                   \
+  do_intrinsic(_decodeUTF_8,       sun_nio_cs_utf_8_Decoder,     decode_name, decodeISO8859_1_signature,   F_R)         \
+                                                                                                                        \
   do_class(java_math_BigInteger,                      "java/math/BigInteger")                                           \
   do_intrinsic(_multiplyToLen,      java_math_BigInteger, multiplyToLen_name, multiplyToLen_signature, F_S)             \
    do_name(     multiplyToLen_name,                             "multiplyToLen")                                        \
@@ -1083,6 +1093,7 @@
   do_intrinsic(_StringBuilder_append_char,   java_lang_StringBuilder, append_name, char_StringBuilder_signature,   F_R)   \
   do_intrinsic(_StringBuilder_append_int,    java_lang_StringBuilder, append_name, int_StringBuilder_signature,    F_R)   \
   do_intrinsic(_StringBuilder_append_String, java_lang_StringBuilder, append_name, String_StringBuilder_signature, F_R)   \
+  do_intrinsic(_StringBuilder_append_bool,   java_lang_StringBuilder, append_name, bool_StringBuilder_signature,   F_R)   \
                                                                                                                           \
   do_intrinsic(_StringBuilder_toString, java_lang_StringBuilder, toString_name, void_string_signature,             F_R)   \
                                                                                                                           \
@@ -1093,6 +1104,7 @@
   do_intrinsic(_StringBuffer_append_char,   java_lang_StringBuffer, append_name, char_StringBuffer_signature,      F_Y)   \
   do_intrinsic(_StringBuffer_append_int,    java_lang_StringBuffer, append_name, int_StringBuffer_signature,       F_Y)   \
   do_intrinsic(_StringBuffer_append_String, java_lang_StringBuffer, append_name, String_StringBuffer_signature,    F_Y)   \
+  do_intrinsic(_StringBuffer_append_bool,   java_lang_StringBuffer, append_name, bool_StringBuffer_signature,      F_Y)   \
                                                                                                                           \
   do_intrinsic(_StringBuffer_toString,  java_lang_StringBuffer, toString_name, void_string_signature,              F_Y)   \
                                                                                                                           \
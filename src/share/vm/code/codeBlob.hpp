@@ -35,7 +35,10 @@
 struct CodeBlobType {
   enum {
     All                 = 0,    // All types (No code cache segmentation)
-    NumTypes            = 1     // Number of CodeBlobTypes
+    MethodNonProfiled   = 1,    // Execution level 1 and 4 (non-profiled) nmethods (including native nmethods)
+    MethodProfiled      = 2,    // Execution level 2 and 3 (profiled) nmethods
+    NonNMethod          = 3,    // Non-nmethods like Buffers, Adapters and Runtime Stubs
+    NumTypes            = 4     // Number of CodeBlobTypes
   };
 };
 
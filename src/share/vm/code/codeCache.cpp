@@ -118,7 +118,11 @@ class CodeBlob_sizes {
 
 // CodeCache implementation
 
-CodeHeap * CodeCache::_heap = new CodeHeap();
+CodeHeap * CodeCache::_heap = NULL;
+CodeHeap* CodeCache::_heaps[CodeBlobType::NumTypes] = { NULL };
+int CodeCache::_number_of_heaps = 0;
+address CodeCache::_low_bound = NULL;
+address CodeCache::_high_bound = NULL;
 int CodeCache::_number_of_blobs = 0;
 int CodeCache::_number_of_adapters = 0;
 int CodeCache::_number_of_nmethods = 0;
@@ -128,15 +132,79 @@ nmethod* CodeCache::_scavenge_root_nmethods = NULL;
 
 int CodeCache::_codemem_full_count = 0;
 
+int CodeCache::heap_index_of(const void* p) {
+  for (int i = 0; i < _number_of_heaps; i++) {
+    if (_heaps[i]->contains(p)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+CodeHeap* CodeCache::heap_for(int code_blob_type) {
+  for (int i = 0; i < _number_of_heaps; i++) {
+    if (_heaps[i]->code_blob_type() == code_blob_type) {
+      return _heaps[i];
+    }
+  }
+  // Without segmentation, or without a profiled heap when tiered
+  // compilation is off, the request is served by the method heap.
+  assert(code_blob_type != CodeBlobType::NonNMethod || !SegmentedCodeCache, "non-nmethod heap must exist");
+  return _heap;
+}
+
+int CodeCache::code_blob_type_for(int comp_level) {
+  if (!SegmentedCodeCache) {
+    return CodeBlobType::All;
+  }
+  if (comp_level == CompLevel_limited_profile || comp_level == CompLevel_full_profile) {
+    return CodeBlobType::MethodProfiled;
+  }
+  return CodeBlobType::MethodNonProfiled;
+}
+
+const char* CodeCache::heap_name(int code_blob_type) {
+  switch (code_blob_type) {
+    case CodeBlobType::MethodNonProfiled: return "CodeHeap 'non-profiled nmethods'";
+    case CodeBlobType::MethodProfiled:    return "CodeHeap 'profiled nmethods'";
+    case CodeBlobType::NonNMethod:        return "CodeHeap 'non-nmethods'";
+    default:                              return "Code Cache";
+  }
+}
+
+CodeBlob* CodeCache::first_blob_from(int index, bool methods_only) {
+  for (; index < _number_of_heaps; index++) {
+    CodeHeap* heap = _heaps[index];
+    if (methods_only && !heap_may_contain_nmethods(heap)) {
+      continue;
+    }
+    CodeBlob* cb = first_blob(heap);
+    if (cb != NULL) {
+      return cb;
+    }
+  }
+  return NULL;
+}
+
+CodeBlob* CodeCache::next_blob(CodeBlob* cb, bool methods_only) {
+  int index = heap_index_of(cb);
+  assert(index >= 0, "CodeBlob must be in a code heap");
+  CodeBlob* next = next_blob(_heaps[index], cb);
+  if (next != NULL) {
+    return next;
+  }
+  return first_blob_from(index + 1, methods_only);
+}
+
 CodeBlob* CodeCache::first() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->first();
+  return first_blob_from(0, false);
 }
 
 
 CodeBlob* CodeCache::next(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->next(cb);
+  return next_blob(cb, false);
 }
 
 
@@ -147,33 +215,35 @@ CodeBlob* CodeCache::alive(CodeBlob *cb) {
 }
 
 
+// The nmethod iterators skip the non-nmethod heap, so the sweeper and
+// the GC do not walk the interpreter, adapters and stubs.
 nmethod* CodeCache::alive_nmethod(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  while (cb != NULL && (!cb->is_alive() || !cb->is_nmethod())) cb = next(cb);
+  while (cb != NULL && (!cb->is_alive() || !cb->is_nmethod())) cb = next_blob(cb, true);
   return (nmethod*)cb;
 }
 
 nmethod* CodeCache::first_nmethod() {
   assert_locked_or_safepoint(CodeCache_lock);
-  CodeBlob* cb = first();
+  CodeBlob* cb = first_blob_from(0, true);
   while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
+    cb = next_blob(cb, true);
   }
   return (nmethod*)cb;
 }
 
 nmethod* CodeCache::next_nmethod (CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  cb = next(cb);
+  cb = next_blob(cb, true);
   while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
+    cb = next_blob(cb, true);
   }
   return (nmethod*)cb;
 }
 
 static size_t maxCodeCacheUsed = 0;
 
-CodeBlob* CodeCache::allocate(int size, bool is_critical) {
+CodeBlob* CodeCache::allocate(int size, int code_blob_type, bool is_critical) {
   // Do not seize the CodeCache lock here--if the caller has not
   // already done so, we are going to lose bigtime, since the code
   // cache will contain a garbage CodeBlob until the caller can
@@ -181,32 +251,48 @@ CodeBlob* CodeCache::allocate(int size, bool is_critical) {
   // instantiating.
   guarantee(size >= 0, "allocation request must be reasonable");
   assert_locked_or_safepoint(CodeCache_lock);
+  CodeHeap* heap = heap_for(code_blob_type);
   CodeBlob* cb = NULL;
-  _number_of_blobs++;
+  bool tried_fallback = false;
   while (true) {
-    cb = (CodeBlob*)_heap->allocate(size, is_critical);
+    cb = (CodeBlob*)heap->allocate(size, is_critical);
     if (cb != NULL) break;
-    if (!_heap->expand_by(CodeCacheExpansionSize)) {
-      // Expansion failed
+    if (!heap->expand_by(CodeCacheExpansionSize)) {
+      // Expansion failed. With a segmented code cache, nmethods may still
+      // fit into the other method heap and non-nmethods into the
+      // non-profiled heap before we give up.
+      if (SegmentedCodeCache && !tried_fallback) {
+        tried_fallback = true;
+        CodeHeap* fallback = heap_for(code_blob_type == CodeBlobType::MethodNonProfiled ?
+                                      CodeBlobType::MethodProfiled : CodeBlobType::MethodNonProfiled);
+        if (fallback != heap) {
+          if (PrintCodeCacheExtension) {
+            tty->print_cr("%s is full, allocating in %s", heap->name(), fallback->name());
+          }
+          heap = fallback;
+          continue;
+        }
+      }
       if (EnableJFR) {
         if (CodeCache_lock->owned_by_self()) {
           MutexUnlockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-          report_codemem_full();
+          report_codemem_full(heap->code_blob_type());
         } else {
-          report_codemem_full();
+          report_codemem_full(heap->code_blob_type());
         }
       }
       return NULL;
     }
     if (PrintCodeCacheExtension) {
       ResourceMark rm;
-      tty->print_cr("code cache extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (" SSIZE_FORMAT " bytes)",
-                    (intptr_t)_heap->low_boundary(), (intptr_t)_heap->high(),
-                    (address)_heap->high() - (address)_heap->low_boundary());
+      tty->print_cr("%s extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (" SSIZE_FORMAT " bytes)",
+                    heap->name(), (intptr_t)heap->low_boundary(), (intptr_t)heap->high(),
+                    (address)heap->high() - (address)heap->low_boundary());
     }
   }
-  maxCodeCacheUsed = MAX2(maxCodeCacheUsed, ((address)_heap->high_boundary() -
-                          (address)_heap->low_boundary()) - unallocated_capacity());
+  _number_of_blobs++;
+  heap->adjust_blob_count(1);
+  maxCodeCacheUsed = MAX2(maxCodeCacheUsed, max_capacity() - unallocated_capacity());
   verify_if_often();
   print_trace("allocation", cb, size);
   return cb;
@@ -223,12 +309,19 @@ void CodeCache::free(CodeBlob* cb) {
       _number_of_nmethods_with_dependencies--;
     }
   }
+  CodeHeap* heap = heap_of(cb);
+  assert(heap != NULL, "CodeBlob must be in a code heap");
+  if (cb->is_nmethod()) {
+    heap->adjust_nmethod_count(-1);
+  }
   if (cb->is_adapter_blob()) {
     _number_of_adapters--;
+    heap->adjust_adapter_count(-1);
   }
   _number_of_blobs--;
+  heap->adjust_blob_count(-1);
 
-  _heap->deallocate(cb);
+  heap->deallocate(cb);
 
   verify_if_often();
   assert(_number_of_blobs >= 0, "sanity check");
@@ -247,6 +340,14 @@ void CodeCache::commit(CodeBlob* cb) {
   if (cb->is_adapter_blob()) {
     _number_of_adapters++;
   }
+  CodeHeap* heap = heap_of(cb);
+  assert(heap != NULL, "CodeBlob must be in a code heap");
+  if (cb->is_nmethod()) {
+    heap->adjust_nmethod_count(1);
+  }
+  if (cb->is_adapter_blob()) {
+    heap->adjust_adapter_count(1);
+  }
 
   // flush the hardware I-cache
   ICache::invalidate_range(cb->content_begin(), cb->content_size());
@@ -268,7 +369,7 @@ void CodeCache::flush() {
 
 bool CodeCache::contains(void *p) {
   // It should be ok to call contains without holding a lock
-  return _heap->contains(p);
+  return heap_index_of(p) >= 0;
 }
 
 
@@ -312,6 +413,7 @@ void CodeCache::alive_nmethods_do(void f(nmethod* nm)) {
   }
 }
 
+// All code heaps share the same segment size, so any of them can answer.
 int CodeCache::alignment_unit() {
   return (int)_heap->alignment_unit();
 }
@@ -586,13 +688,37 @@ void CodeCache::verify_oops() {
 
 address CodeCache::first_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->low_boundary();
+  return _low_bound;
 }
 
 
 address CodeCache::last_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->high();
+  return (address)_heaps[_number_of_heaps - 1]->high();
+}
+
+size_t CodeCache::capacity() {
+  size_t cap = 0;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    cap += _heaps[i]->capacity();
+  }
+  return cap;
+}
+
+size_t CodeCache::max_capacity() {
+  size_t max_cap = 0;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    max_cap += _heaps[i]->max_capacity();
+  }
+  return max_cap;
+}
+
+size_t CodeCache::unallocated_capacity() {
+  size_t unallocated_cap = 0;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    unallocated_cap += _heaps[i]->unallocated_capacity();
+  }
+  return unallocated_cap;
 }
 
 /**
@@ -619,11 +745,25 @@ void CodeCache::initialize() {
   CodeCacheExpansionSize = round_to(CodeCacheExpansionSize, os::vm_page_size());
   InitialCodeCacheSize = round_to(InitialCodeCacheSize, os::vm_page_size());
   ReservedCodeCacheSize = round_to(ReservedCodeCacheSize, os::vm_page_size());
-  if (!_heap->reserve(ReservedCodeCacheSize, InitialCodeCacheSize, CodeCacheSegmentSize)) {
-    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  size_t page_size = CodeHeap::preferred_page_size(ReservedCodeCacheSize);
+  if (page_size > (size_t)os::vm_page_size() && !CodeHeap::reserve_as_large_pages(page_size)) {
+    // Huge pages are committed on demand: expand by whole pages, so that
+    // new code can be backed by a huge page right away.
+    CodeCacheExpansionSize = round_to(CodeCacheExpansionSize, page_size);
+  }
+  if (SegmentedCodeCache) {
+    initialize_heaps();
+  } else {
+    _heap = new CodeHeap(heap_name(CodeBlobType::All), CodeBlobType::All);
+    if (!_heap->reserve(ReservedCodeCacheSize, InitialCodeCacheSize, CodeCacheSegmentSize)) {
+      vm_exit_during_initialization("Could not reserve enough space for code cache");
+    }
+    _heaps[_number_of_heaps++] = _heap;
+    MemoryService::add_code_heap_memory_pool(_heap, _heap->name());
   }
 
-  MemoryService::add_code_heap_memory_pool(_heap);
+  _low_bound = (address)_heaps[0]->low_boundary();
+  _high_bound = (address)_heaps[_number_of_heaps - 1]->high_boundary();
 
   // Initialize ICache flush mechanism
   // This service is needed for os::register_code_area
@@ -632,7 +772,110 @@ void CodeCache::initialize() {
   // Give OS a chance to register generated code area.
   // This is used on Windows 64 bit platforms to register
   // Structured Exception Handlers for our generated code.
-  os::register_code_area(_heap->low_boundary(), _heap->high_boundary());
+  os::register_code_area((char*)_low_bound, (char*)_high_bound);
+}
+
+void CodeCache::add_heap(CodeHeap* heap, ReservedSpace rs, size_t committed_size) {
+  assert(_number_of_heaps < CodeBlobType::NumTypes, "too many code heaps");
+  committed_size = MIN2((size_t)round_to(committed_size, os::vm_page_size()), rs.size());
+  if (!heap->reserve(rs, committed_size, CodeCacheSegmentSize)) {
+    vm_exit_during_initialization("Could not reserve enough space for code heap", heap->name());
+  }
+  _heaps[_number_of_heaps++] = heap;
+  MemoryService::add_code_heap_memory_pool(heap, heap->name());
+}
+
+// Reserve the code cache as one contiguous range, so that the full limits
+// of the code cache stay valid for branch reachability checks, and split
+// it into the non-nmethod, profiled and non-profiled heaps in that order.
+void CodeCache::initialize_heaps() {
+  const size_t page_size = CodeHeap::preferred_page_size(ReservedCodeCacheSize);
+  const size_t alignment = MAX2(page_size, (size_t)os::vm_allocation_granularity());
+  const size_t min_size = round_to(CodeCacheMinimumUseSpace DEBUG_ONLY(* 3), alignment);
+
+  size_t non_nmethod_size = NonNMethodCodeHeapSize;
+  size_t profiled_size = ProfiledCodeHeapSize;
+  size_t non_profiled_size = NonProfiledCodeHeapSize;
+  if (!TieredCompilation) {
+    // Only tiers 2 and 3 produce profiled code
+    if (profiled_size != 0 && !FLAG_IS_DEFAULT(ProfiledCodeHeapSize)) {
+      warning("ProfiledCodeHeapSize is ignored without TieredCompilation");
+    }
+    profiled_size = 0;
+  }
+
+  if (FLAG_IS_DEFAULT(NonNMethodCodeHeapSize)) {
+    // The interpreter and the runtime stubs need about CodeCacheMinimumUseSpace,
+    // the remainder is for adapters, method handle intrinsics and compiler buffers.
+    non_nmethod_size = MAX2(min_size, (size_t)ReservedCodeCacheSize / 20);
+  }
+  if (!FLAG_IS_DEFAULT(NonNMethodCodeHeapSize) && !FLAG_IS_DEFAULT(NonProfiledCodeHeapSize) &&
+      (!TieredCompilation || !FLAG_IS_DEFAULT(ProfiledCodeHeapSize))) {
+    // All sizes given, they define the code cache size
+    FLAG_SET_ERGO(uintx, ReservedCodeCacheSize, non_nmethod_size + profiled_size + non_profiled_size);
+  }
+  if (non_nmethod_size >= (size_t)ReservedCodeCacheSize) {
+    vm_exit_during_initialization("NonNMethodCodeHeapSize must be smaller than ReservedCodeCacheSize");
+  }
+
+  size_t method_size = ReservedCodeCacheSize - non_nmethod_size;
+  if (TieredCompilation) {
+    if (FLAG_IS_DEFAULT(ProfiledCodeHeapSize) && FLAG_IS_DEFAULT(NonProfiledCodeHeapSize)) {
+      profiled_size = method_size / 2;
+      non_profiled_size = method_size - profiled_size;
+    } else if (FLAG_IS_DEFAULT(ProfiledCodeHeapSize)) {
+      profiled_size = method_size > non_profiled_size ? method_size - non_profiled_size : 0;
+    } else if (FLAG_IS_DEFAULT(NonProfiledCodeHeapSize)) {
+      non_profiled_size = method_size > profiled_size ? method_size - profiled_size : 0;
+    }
+  } else {
+    non_profiled_size = method_size;
+  }
+  if (non_nmethod_size + profiled_size + non_profiled_size > (size_t)ReservedCodeCacheSize) {
+    vm_exit_during_initialization(err_msg("Code heap sizes (" SIZE_FORMAT "K + " SIZE_FORMAT "K + " SIZE_FORMAT
+                                          "K) exceed ReservedCodeCacheSize (" UINTX_FORMAT "K)",
+                                          non_nmethod_size/K, profiled_size/K, non_profiled_size/K,
+                                          ReservedCodeCacheSize/K));
+  }
+
+  non_nmethod_size = align_size_up(non_nmethod_size, alignment);
+  profiled_size = align_size_down(profiled_size, alignment);
+  non_profiled_size = align_size_down(non_profiled_size, alignment);
+  if (non_nmethod_size < min_size) {
+    vm_exit_during_initialization(err_msg("Invalid NonNMethodCodeHeapSize=" SIZE_FORMAT "K. Must be at least "
+                                          SIZE_FORMAT "K.", non_nmethod_size/K, min_size/K));
+  }
+  if (non_profiled_size < min_size) {
+    vm_exit_during_initialization("Not enough space in the code cache for non-profiled code",
+                                  "increase ReservedCodeCacheSize or NonProfiledCodeHeapSize");
+  }
+  FLAG_SET_ERGO(uintx, NonNMethodCodeHeapSize, non_nmethod_size);
+  FLAG_SET_ERGO(uintx, ProfiledCodeHeapSize, profiled_size);
+  FLAG_SET_ERGO(uintx, NonProfiledCodeHeapSize, non_profiled_size);
+
+  const size_t total_size = non_nmethod_size + profiled_size + non_profiled_size;
+  const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 : alignment;
+  ReservedCodeSpace rs(total_size, rs_align, CodeHeap::reserve_as_large_pages(page_size));
+  if (!rs.is_reserved()) {
+    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  }
+  os::trace_page_sizes("code cache", total_size, total_size, page_size, rs.base(), rs.size());
+
+  // The interpreter and the early stubs are generated into the non-nmethod
+  // heap, so it gets the initial commit; the method heaps start small and
+  // grow by CodeCacheExpansionSize.
+  ReservedSpace non_nmethod_space = rs.first_part(non_nmethod_size);
+  ReservedSpace rest = rs.last_part(non_nmethod_size);
+  add_heap(new CodeHeap(heap_name(CodeBlobType::NonNMethod), CodeBlobType::NonNMethod),
+           non_nmethod_space, MIN2((size_t)InitialCodeCacheSize, non_nmethod_size));
+  if (profiled_size > 0) {
+    ReservedSpace profiled_space = rest.first_part(profiled_size);
+    rest = rest.last_part(profiled_size);
+    add_heap(new CodeHeap(heap_name(CodeBlobType::MethodProfiled), CodeBlobType::MethodProfiled),
+             profiled_space, CodeCacheExpansionSize);
+  }
+  _heap = new CodeHeap(heap_name(CodeBlobType::MethodNonProfiled), CodeBlobType::MethodNonProfiled);
+  add_heap(_heap, rest, CodeCacheExpansionSize);
 }
 
 
@@ -777,24 +1020,27 @@ void CodeCache::make_marked_nmethods_not_entrant() {
 }
 
 void CodeCache::verify() {
-  _heap->verify();
+  for (int i = 0; i < _number_of_heaps; i++) {
+    _heaps[i]->verify();
+  }
   FOR_ALL_ALIVE_BLOBS(p) {
     p->verify();
   }
 }
 
-void CodeCache::report_codemem_full() {
+void CodeCache::report_codemem_full(int code_blob_type) {
   _codemem_full_count++;
   EventCodeCacheFull event;
   if (event.should_commit()) {
-    event.set_codeBlobType((u1)CodeBlobType::All);
-    event.set_startAddress((u8)low_bound());
-    event.set_commitedTopAddress((u8)high());
-    event.set_reservedTopAddress((u8)high_bound());
-    event.set_entryCount(nof_blobs());
-    event.set_methodCount(nof_nmethods());
-    event.set_adaptorCount(nof_adapters());
-    event.set_unallocatedCapacity(unallocated_capacity()/K);
+    CodeHeap* heap = heap_for(code_blob_type);
+    event.set_codeBlobType((u1)heap->code_blob_type());
+    event.set_startAddress((u8)heap->low_boundary());
+    event.set_commitedTopAddress((u8)heap->high());
+    event.set_reservedTopAddress((u8)heap->high_boundary());
+    event.set_entryCount(heap->blob_count());
+    event.set_methodCount(heap->nmethod_count());
+    event.set_adaptorCount(heap->adapter_count());
+    event.set_unallocatedCapacity(heap->unallocated_capacity()/K);
     event.set_fullCount(_codemem_full_count);
     event.commit();
   }
@@ -807,7 +1053,9 @@ void CodeCache::report_codemem_full() {
 
 void CodeCache::verify_if_often() {
   if (VerifyCodeCacheOften) {
-    _heap->verify();
+    for (int i = 0; i < _number_of_heaps; i++) {
+      _heaps[i]->verify();
+    }
   }
 }
 
@@ -979,17 +1227,31 @@ void CodeCache::print() {
 }
 
 void CodeCache::print_summary(outputStream* st, bool detailed) {
-  size_t total = (_heap->high_boundary() - _heap->low_boundary());
+  size_t total = max_capacity();
   st->print_cr("CodeCache: size=" SIZE_FORMAT "Kb used=" SIZE_FORMAT
                "Kb max_used=" SIZE_FORMAT "Kb free=" SIZE_FORMAT "Kb",
                total/K, (total - unallocated_capacity())/K,
                maxCodeCacheUsed/K, unallocated_capacity()/K);
+#ifdef LINUX
+  extern void linux_print_code_huge_pages(outputStream* st);
+  linux_print_code_huge_pages(st);
+#endif
 
   if (detailed) {
-    st->print_cr(" bounds [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT "]",
-                 p2i(_heap->low_boundary()),
-                 p2i(_heap->high()),
-                 p2i(_heap->high_boundary()));
+    for (int i = 0; i < _number_of_heaps; i++) {
+      CodeHeap* heap = _heaps[i];
+      if (SegmentedCodeCache) {
+        size_t heap_total = heap->max_capacity();
+        st->print_cr(" %s: size=" SIZE_FORMAT "Kb used=" SIZE_FORMAT "Kb free=" SIZE_FORMAT "Kb"
+                     " blobs=%d nmethods=%d", heap->name(), heap_total/K,
+                     (heap_total - heap->unallocated_capacity())/K, heap->unallocated_capacity()/K,
+                     heap->blob_count(), heap->nmethod_count());
+      }
+      st->print_cr(" bounds [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT "]",
+                   p2i(heap->low_boundary()),
+                   p2i(heap->high()),
+                   p2i(heap->high_boundary()));
+    }
     st->print_cr(" total_blobs=" UINT32_FORMAT " nmethods=" UINT32_FORMAT
                  " adapters=" UINT32_FORMAT,
                  nof_blobs(), nof_nmethods(), nof_adapters());
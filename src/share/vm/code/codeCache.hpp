@@ -39,6 +39,16 @@
 //   - Each CodeBlob occupies one chunk of memory.
 //   - Like the offset table in oldspace the zone has at table for
 //     locating a method given a addess of an instruction.
+//
+// With -XX:+SegmentedCodeCache the reserved space is split into separate
+// CodeHeaps, one per CodeBlobType, so that profiled (tier 2 and 3) code,
+// non-profiled (tier 1 and 4 and native) code and non-method code such as
+// the interpreter, adapters and runtime stubs do not interleave:
+//   - NonNMethod          non-nmethods, sized by NonNMethodCodeHeapSize
+//   - MethodProfiled      profiled nmethods, sized by ProfiledCodeHeapSize
+//   - MethodNonProfiled   non-profiled nmethods, sized by NonProfiledCodeHeapSize
+// Without segmentation a single CodeHeap of type CodeBlobType::All holds
+// all CodeBlobs.
 
 class OopClosure;
 class DepChange;
@@ -51,6 +61,11 @@ class CodeCache : AllStatic {
   // This may cause memory leak, but is necessary, for now. See 4423824,
   // 4422213 or 4436291 for details.
   static CodeHeap * _heap;
+  // All code heaps in address order; _heap is one of them
+  static CodeHeap* _heaps[CodeBlobType::NumTypes];
+  static int _number_of_heaps;
+  static address _low_bound;                 // Lower bound of all code heaps
+  static address _high_bound;                // Upper bound of all code heaps
   static int _number_of_blobs;
   static int _number_of_adapters;
   static int _number_of_nmethods;
@@ -69,15 +84,29 @@ class CodeCache : AllStatic {
   static void prune_scavenge_root_nmethods();
   static void unlink_scavenge_root_nmethod(nmethod* nm, nmethod* prev);
 
+  // CodeHeap management
+  static void initialize_heaps();                            // reserves and splits the code heaps
+  static void add_heap(CodeHeap* heap, ReservedSpace rs, size_t committed_size);
+  static int  heap_index_of(const void* p);                  // index of the heap containing p or -1
+  static CodeHeap* heap_for(int code_blob_type);             // heap holding CodeBlobs of the given type
+  static bool heap_may_contain_nmethods(CodeHeap* heap) {
+    return heap->code_blob_type() != CodeBlobType::NonNMethod;
+  }
+
+  // Iteration over the heaps, optionally restricted to heaps that may contain nmethods
+  static CodeBlob* first_blob_from(int index, bool methods_only);
+  static CodeBlob* next_blob(CodeBlob* cb, bool methods_only);
+
  public:
 
   // Initialization
   static void initialize();
 
-  static void report_codemem_full();
+  static void report_codemem_full(int code_blob_type = CodeBlobType::All);
 
   // Allocation/administration
-  static CodeBlob* allocate(int size, bool is_critical = false); // allocates a new CodeBlob
+  static CodeBlob* allocate(int size, int code_blob_type = CodeBlobType::All,
+                            bool is_critical = false); // allocates a new CodeBlob
   static void commit(CodeBlob* cb);                 // called when the allocated CodeBlob has been filled
   static int alignment_unit();                      // guaranteed alignment of all CodeBlobs
   static int alignment_offset();                    // guaranteed offset of first CodeBlob byte within alignment unit (i.e., allocation header)
@@ -97,9 +126,12 @@ class CodeCache : AllStatic {
   // what you are doing)
   static CodeBlob* find_blob_unsafe(void* start) {
     // NMT can walk the stack before code cache is created
-    if (_heap == NULL) return NULL;
+    if (_number_of_heaps == 0) return NULL;
+
+    int index = heap_index_of(start);
+    if (index < 0) return NULL;
 
-    CodeBlob* result = (CodeBlob*)_heap->find_start(start);
+    CodeBlob* result = (CodeBlob*)_heaps[index]->find_start(start);
     // this assert is too strong because the heap code will return the
     // heapblock containing start. That block can often be larger than
     // the codeBlob itself. If you look up an address that is within
@@ -130,6 +162,21 @@ class CodeCache : AllStatic {
   static int       nof_adapters()              { return _number_of_adapters; }
   static int       nof_nmethods()              { return _number_of_nmethods; }
 
+  // Code heaps
+  static int       nof_heaps()                 { return _number_of_heaps; }
+  static CodeHeap* heap_at(int index) {
+    assert(0 <= index && index < _number_of_heaps, "heap index out of bounds");
+    return _heaps[index];
+  }
+  static CodeHeap* heap_of(const void* p) {
+    int index = heap_index_of(p);
+    return index < 0 ? NULL : _heaps[index];
+  }
+  static int       code_blob_type_for(int comp_level); // heap type used for nmethods of this tier
+  static const char* heap_name(int code_blob_type);
+  static CodeBlob* first_blob(CodeHeap* heap)  { return (CodeBlob*)heap->first(); }
+  static CodeBlob* next_blob(CodeHeap* heap, CodeBlob* cb) { return (CodeBlob*)heap->next(cb); }
+
   // GC support
   static void gc_epilogue();
   static void gc_prologue();
@@ -160,16 +207,15 @@ class CodeCache : AllStatic {
   static void log_state(outputStream* st);
 
   // The full limits of the codeCache
-  static address  low_bound()                    { return (address) _heap->low_boundary(); }
-  static address  high_bound()                   { return (address) _heap->high_boundary(); }
-  static address  high()                         { return (address) _heap->high(); }
+  static address  low_bound()                    { return _low_bound; }
+  static address  high_bound()                   { return _high_bound; }
 
   // Profiling
   static address first_address();                // first address used for CodeBlobs
   static address last_address();                 // last  address used for CodeBlobs
-  static size_t  capacity()                      { return _heap->capacity(); }
-  static size_t  max_capacity()                  { return _heap->max_capacity(); }
-  static size_t  unallocated_capacity()          { return _heap->unallocated_capacity(); }
+  static size_t  capacity();
+  static size_t  max_capacity();
+  static size_t  unallocated_capacity();
   static double  reverse_free_ratio();
 
   static bool needs_cache_clean()                { return _needs_cache_clean; }
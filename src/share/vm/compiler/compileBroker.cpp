@@ -36,6 +36,7 @@
 #include "oops/oop.inline.hpp"
 #include "prims/nativeLookup.hpp"
 #include "runtime/arguments.hpp"
+#include "runtime/codeCacheSweeperThread.hpp"
 #include "runtime/compilationPolicy.hpp"
 #include "runtime/init.hpp"
 #include "runtime/interfaceSupport.hpp"
@@ -46,6 +47,7 @@
 #include "trace/tracing.hpp"
 #include "utilities/dtrace.hpp"
 #include "utilities/events.hpp"
+#include "utilities/ticks.inline.hpp"
 #ifdef COMPILER1
 #include "c1/c1_Compiler.hpp"
 #endif
@@ -332,6 +334,9 @@ void CompileTask::initialize(int compile_id,
   _failure_reason = NULL;
 
   _is_jwarmup_compilation = false;
+  _queue_wait = Tickspan();
+  _priority_level = 0;
+  _priority_weight = 0;
 
   if (LogCompilation) {
     _time_queued = os::elapsed_counter();
@@ -629,6 +634,26 @@ void CompileTask::log_task_done(CompileLog* log) {
 
 
 
+CompileQueue::CompileQueue(const char* name, Monitor* lock) {
+  _name = name;
+  _lock = lock;
+  _first = NULL;
+  _last = NULL;
+  _size = 0;
+  _first_stale = NULL;
+
+  _heap = NULL;
+  _unprioritized = NULL;
+  _last_priority_refresh = 0;
+  if (UseCompileQueuePriorityHeap) {
+    _heap = new (ResourceObj::C_HEAP, mtCompiler) GrowableArray<CompileTask*>(64, true, mtCompiler);
+    _unprioritized = new (ResourceObj::C_HEAP, mtCompiler) GrowableArray<CompileTask*>(16, true, mtCompiler);
+  }
+
+  _dequeued_count = 0;
+  _stale_count = 0;
+}
+
 /**
  * Add a CompileTask to a CompileQueue
  */
@@ -638,6 +663,14 @@ void CompileQueue::add(CompileTask* task) {
 
   task->set_next(NULL);
   task->set_prev(NULL);
+  task->set_time_enqueued(Ticks::now());
+  if (uses_priority_heap()) {
+    // The compilation policy assigns a priority when it selects the next task
+    task->set_heap_index(unprioritized);
+    _unprioritized->append(task);
+  } else {
+    task->set_heap_index(not_in_heap);
+  }
 
   if (_last == NULL) {
     // The compile queue is empty.
@@ -689,6 +722,10 @@ void CompileQueue::free_all() {
     CompileTask::free(current);
   }
   _first = NULL;
+  if (uses_priority_heap()) {
+    _heap->clear();
+    _unprioritized->clear();
+  }
 
   // Wake up all threads that block on the queue.
   lock()->notify_all();
@@ -755,11 +792,22 @@ CompileTask* CompileQueue::get() {
   }
   if (task != NULL) {
     remove(task);
+    record_wait_time(task);
   }
   purge_stale_tasks(); // may temporarily release MCQ lock
   return task;
 }
 
+void CompileQueue::record_wait_time(CompileTask* task) {
+  const Tickspan wait = Ticks::now() - task->time_enqueued();
+  task->set_queue_wait(wait);
+  _dequeued_count++;
+  _total_wait += wait;
+  if (wait.value() > _max_wait.value()) {
+    _max_wait = wait;
+  }
+}
+
 // Clean & deallocate stale compile tasks.
 // Temporarily releases MethodCompileQueue lock.
 void CompileQueue::purge_stale_tasks() {
@@ -785,6 +833,13 @@ void CompileQueue::purge_stale_tasks() {
 
 void CompileQueue::remove(CompileTask* task) {
    assert(lock()->owned_by_self(), "must own lock");
+  if (task->heap_index() >= 0) {
+    heap_remove(task);
+  } else if (task->heap_index() == unprioritized) {
+    _unprioritized->remove(task);
+  }
+  task->set_heap_index(not_in_heap);
+
   if (task->prev() != NULL) {
     task->prev()->set_next(task->next());
   } else {
@@ -806,6 +861,7 @@ void CompileQueue::remove(CompileTask* task) {
 void CompileQueue::remove_and_mark_stale(CompileTask* task) {
   assert(lock()->owned_by_self(), "must own lock");
   remove(task);
+  _stale_count++;
 
   // Enqueue the task for reclamation (should be done outside MCQ lock)
   task->set_next(_first_stale);
@@ -813,6 +869,126 @@ void CompileQueue::remove_and_mark_stale(CompileTask* task) {
   _first_stale = task;
 }
 
+// Returns true if x should be compiled before y
+bool CompileQueue::higher_priority(CompileTask* x, CompileTask* y) {
+  if (x->priority_level() != y->priority_level()) {
+    return x->priority_level() > y->priority_level();
+  }
+  return x->priority_weight() > y->priority_weight();
+}
+
+void CompileQueue::heap_set(int index, CompileTask* task) {
+  _heap->at_put(index, task);
+  task->set_heap_index(index);
+}
+
+void CompileQueue::heap_sift_up(int index) {
+  CompileTask* task = _heap->at(index);
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+    CompileTask* p = _heap->at(parent);
+    if (!higher_priority(task, p)) {
+      break;
+    }
+    heap_set(index, p);
+    index = parent;
+  }
+  heap_set(index, task);
+}
+
+void CompileQueue::heap_sift_down(int index) {
+  CompileTask* task = _heap->at(index);
+  int len = _heap->length();
+  while (true) {
+    int child = 2 * index + 1;
+    if (child >= len) {
+      break;
+    }
+    if (child + 1 < len && higher_priority(_heap->at(child + 1), _heap->at(child))) {
+      child++;
+    }
+    CompileTask* c = _heap->at(child);
+    if (!higher_priority(c, task)) {
+      break;
+    }
+    heap_set(index, c);
+    index = child;
+  }
+  heap_set(index, task);
+}
+
+void CompileQueue::heap_remove(CompileTask* task) {
+  int index = task->heap_index();
+  assert(_heap->at(index) == task, "heap index out of sync");
+  CompileTask* last = _heap->pop();
+  if (last != task) {
+    heap_set(index, last);
+    heap_sift_down(index);
+    heap_sift_up(last->heap_index());
+  }
+}
+
+/**
+ * Drops all tasks from the heap before the compilation policy recomputes
+ * their priorities. Tasks the policy removes in between are not in the
+ * heap any more, so their removal is O(1).
+ */
+void CompileQueue::begin_priority_refresh() {
+  assert(lock()->owned_by_self(), "must own lock");
+  for (CompileTask* task = _first; task != NULL; task = task->next()) {
+    task->set_heap_index(not_in_heap);
+  }
+  _heap->clear();
+  _unprioritized->clear();
+}
+
+/**
+ * Rebuilds the heap from all remaining tasks in O(n).
+ */
+void CompileQueue::end_priority_refresh(jlong t) {
+  assert(lock()->owned_by_self(), "must own lock");
+  for (CompileTask* task = _first; task != NULL; task = task->next()) {
+    task->set_heap_index(_heap->length());
+    _heap->append(task);
+  }
+  for (int i = _heap->length() / 2 - 1; i >= 0; i--) {
+    heap_sift_down(i);
+  }
+  _last_priority_refresh = t;
+}
+
+CompileTask* CompileQueue::next_unprioritized() {
+  assert(lock()->owned_by_self(), "must own lock");
+  if (_unprioritized->is_empty()) {
+    return NULL;
+  }
+  CompileTask* task = _unprioritized->pop();
+  task->set_heap_index(not_in_heap);
+  return task;
+}
+
+void CompileQueue::add_to_heap(CompileTask* task) {
+  assert(lock()->owned_by_self(), "must own lock");
+  assert(task->heap_index() == not_in_heap, "already in heap");
+  _heap->append(task);
+  task->set_heap_index(_heap->length() - 1);
+  heap_sift_up(_heap->length() - 1);
+}
+
+CompileTask* CompileQueue::highest_priority_task() const {
+  assert(_unprioritized->is_empty(), "all tasks must have a priority");
+  return _heap->is_empty() ? NULL : _heap->at(0);
+}
+
+void CompileQueue::print_statistics(outputStream* st) {
+  double total = (double)_total_wait.value() / os::elapsed_frequency();
+  double max = (double)_max_wait.value() / os::elapsed_frequency();
+  st->print_cr("  %-25s: %6d queued, " JLONG_FORMAT " dequeued, " JLONG_FORMAT " stale, "
+               "wait time average %2.3f s, max %2.3f s",
+               name(), size(), _dequeued_count, _stale_count,
+               _dequeued_count > 0 ? total / _dequeued_count : 0.0, max);
+}
+
 // methods in the compile queue need to be marked as used on the stack
 // so that they don't get reclaimed by Redefine Classes
 void CompileQueue::mark_on_stack() {
@@ -840,6 +1016,51 @@ void CompileQueue::print() {
     tty->print_cr("----------------------");
   }
 }
+
+void CompileQueue::test_priority_heap() {
+  FlagSetting fs(UseCompileQueuePriorityHeap, true);
+  Monitor lock(Mutex::leaf, "CompileQueueTest_lock", true);
+  MutexLockerEx ml(&lock, Mutex::_no_safepoint_check_flag);
+  CompileQueue queue("Test CompileQueue", &lock);
+
+  const int count = 100;
+  CompileTask* tasks[count];
+  for (int i = 0; i < count; i++) {
+    tasks[i] = new CompileTask();
+    tasks[i]->set_heap_index(not_in_heap);
+    // Few distinct levels and many equal weights
+    tasks[i]->set_priority((i * 7) % 5, (double)((i * 37) % 11));
+    queue.add_to_heap(tasks[i]);
+  }
+  // Tasks removed from the middle of the heap, like stale tasks
+  for (int i = 0; i < count; i += 3) {
+    queue.heap_remove(tasks[i]);
+    tasks[i]->set_heap_index(not_in_heap);
+  }
+
+  int remaining = 0;
+  CompileTask* prev = NULL;
+  CompileTask* task;
+  while ((task = queue.highest_priority_task()) != NULL) {
+    assert(prev == NULL || !higher_priority(task, prev), "tasks must come out in priority order");
+    for (int i = 0; i < count; i++) {
+      assert(tasks[i]->heap_index() == not_in_heap || !higher_priority(tasks[i], task),
+             "highest priority task must be at the top of the heap");
+    }
+    queue.heap_remove(task);
+    task->set_heap_index(not_in_heap);
+    prev = task;
+    remaining++;
+  }
+  assert(remaining == count - (count + 2) / 3, "all remaining tasks must be selected");
+
+  delete queue._heap;
+  delete queue._unprioritized;
+  for (int i = 0; i < count; i++) {
+    delete tasks[i]->lock();
+    delete tasks[i];
+  }
+}
 #endif // PRODUCT
 
 CompilerCounters::CompilerCounters(const char* thread_name, int instance, TRAPS) {
@@ -915,6 +1136,9 @@ void CompileBroker::compilation_init() {
 
   // Start the CompilerThreads
   init_compiler_threads(c1_count, c2_count);
+  if (UseCodeCacheSweeperThread && MethodFlushing) {
+    CodeCacheSweeperThread::initialize();
+  }
   // totalTime performance counter is always created as it is required
   // by the implementation of java.lang.management.CompilationMBean.
   {
@@ -2044,6 +2268,7 @@ void CompileBroker::invoke_compiler_on_method(CompileTask* task) {
       event.set_compileLevel(task->comp_level());
       event.set_succeded(task->is_success());
       event.set_isOsr(is_osr);
+      event.set_queueTime(task->queue_wait());
       event.set_codeSize((task->code() == NULL) ? 0 : task->code()->total_size());
       event.set_inlinedBytes(task->num_inlined_bytecodes());
       event.commit();
@@ -2141,10 +2366,14 @@ void CompileBroker::handle_full_code_cache() {
       if (CompileBroker::set_should_compile_new_jobs(CompileBroker::stop_compilation)) {
         NMethodSweeper::log_sweep("disable_compiler");
       }
-      // Switch to 'vm_state'. This ensures that possibly_sweep() can be called
-      // without having to consider the state in which the current thread is.
-      ThreadInVMfromUnknown in_vm;
-      NMethodSweeper::possibly_sweep();
+      if (UseCodeCacheSweeperThread) {
+        NMethodSweeper::notify();
+      } else {
+        // Switch to 'vm_state'. This ensures that possibly_sweep() can be called
+        // without having to consider the state in which the current thread is.
+        ThreadInVMfromUnknown in_vm;
+        NMethodSweeper::possibly_sweep();
+      }
     } else {
       disable_compilation_forever();
     }
@@ -2397,6 +2626,13 @@ void CompileBroker::print_times() {
   tty->cr();
   tty->print_cr("  nmethod code size        : %6d bytes", CompileBroker::_sum_nmethod_code_size);
   tty->print_cr("  nmethod total size       : %6d bytes", CompileBroker::_sum_nmethod_size);
+  tty->cr();
+  if (_c1_compile_queue != NULL) {
+    _c1_compile_queue->print_statistics(tty);
+  }
+  if (_c2_compile_queue != NULL) {
+    _c2_compile_queue->print_statistics(tty);
+  }
 }
 
 // Debugging output for failure
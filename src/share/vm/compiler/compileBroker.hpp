@@ -28,6 +28,8 @@
 #include "ci/compilerInterface.hpp"
 #include "compiler/abstractCompiler.hpp"
 #include "runtime/perfData.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ticks.hpp"
 
 class nmethod;
 class nmethodLocker;
@@ -66,6 +68,12 @@ class CompileTask : public CHeapObj<mtCompiler> {
   const char*  _comment;      // more info about the task
   const char*  _failure_reason;
   bool         _is_jwarmup_compilation;
+  // Fields used for selecting tasks and queue statistics:
+  Ticks        _time_enqueued;
+  Tickspan     _queue_wait;   // time spent in the compile queue
+  int          _heap_index;   // position in the compile queue priority heap
+  int          _priority_level;
+  double       _priority_weight;
 
  public:
   CompileTask() {
@@ -111,6 +119,20 @@ class CompileTask : public CHeapObj<mtCompiler> {
   bool         is_free() const                   { return _is_free; }
   void         set_is_free(bool val)             { _is_free = val; }
 
+  const Ticks& time_enqueued() const             { return _time_enqueued; }
+  void         set_time_enqueued(const Ticks& t) { _time_enqueued = t; }
+  Tickspan     queue_wait() const                { return _queue_wait; }
+  void         set_queue_wait(const Tickspan& w) { _queue_wait = w; }
+
+  int          heap_index() const                { return _heap_index; }
+  void         set_heap_index(int index)         { _heap_index = index; }
+  int          priority_level() const            { return _priority_level; }
+  double       priority_weight() const           { return _priority_weight; }
+  void         set_priority(int level, double weight) {
+    _priority_level = level;
+    _priority_weight = weight;
+  }
+
 private:
   static void  print_compilation_impl(outputStream* st, Method* method, int compile_id, int comp_level,
                                       bool is_osr_method = false, int osr_bci = -1, bool is_blocking = false,
@@ -195,7 +217,11 @@ class CompilerCounters : public CHeapObj<mtCompiler> {
 
 // CompileQueue
 //
-// A list of CompileTasks.
+// A list of CompileTasks. With UseCompileQueuePriorityHeap the tasks are
+// also kept in a binary max-heap ordered by the priority the compilation
+// policy assigned to them, so that the highest priority task is found in
+// O(log n). Tasks added since the policy last assigned priorities wait in
+// _unprioritized.
 class CompileQueue : public CHeapObj<mtCompiler> {
  private:
   const char* _name;
@@ -208,16 +234,31 @@ class CompileQueue : public CHeapObj<mtCompiler> {
 
   int _size;
 
+  GrowableArray<CompileTask*>* _heap;
+  GrowableArray<CompileTask*>* _unprioritized;
+  jlong        _last_priority_refresh;   // in milliseconds
+
+  // Statistics
+  jlong        _dequeued_count;
+  jlong        _stale_count;
+  Tickspan     _total_wait;
+  Tickspan     _max_wait;
+
+  enum {
+    not_in_heap   = -2,
+    unprioritized = -1
+  };
+
+  static bool  higher_priority(CompileTask* x, CompileTask* y);
+  void         heap_set(int index, CompileTask* task);
+  void         heap_sift_up(int index);
+  void         heap_sift_down(int index);
+  void         heap_remove(CompileTask* task);
+
   void purge_stale_tasks();
+  void record_wait_time(CompileTask* task);
  public:
-  CompileQueue(const char* name, Monitor* lock) {
-    _name = name;
-    _lock = lock;
-    _first = NULL;
-    _last = NULL;
-    _size = 0;
-    _first_stale = NULL;
-  }
+  CompileQueue(const char* name, Monitor* lock);
 
   const char*  name() const                      { return _name; }
   Monitor*     lock() const                      { return _lock; }
@@ -233,11 +274,24 @@ class CompileQueue : public CHeapObj<mtCompiler> {
   bool         is_empty() const                  { return _first == NULL; }
   int          size()     const                  { return _size;          }
 
+  // Priority heap support (see AdvancedThresholdPolicy::select_task())
+  bool         uses_priority_heap() const        { return _heap != NULL; }
+  bool         needs_priority_refresh(jlong t) const {
+    return t - _last_priority_refresh >= CompileQueuePriorityRefreshInterval;
+  }
+  void         begin_priority_refresh();
+  void         end_priority_refresh(jlong t);
+  CompileTask* next_unprioritized();
+  void         add_to_heap(CompileTask* task);
+  CompileTask* highest_priority_task() const;
+
+  void         print_statistics(outputStream* st);
 
   // Redefine Classes support
   void mark_on_stack();
   void free_all();
   NOT_PRODUCT (void print();)
+  NOT_PRODUCT (static void test_priority_heap();)
 
   ~CompileQueue() {
     assert (is_empty(), " Compile Queue must be empty");
@@ -825,6 +825,74 @@ HeapWord* G1CollectedHeap::humongous_obj_allocate(size_t word_size, AllocationCo
   return result;
 }
 
+HeapWord* G1CollectedHeap::alloc_archive_regions(size_t word_size) {
+  assert(!is_init_completed(), "expect to be called at JVM init time");
+  MutexLockerEx x(Heap_lock);
+
+  if (G1ElasticHeap) {
+    // The elastic heap owns the commit state of the regions.
+    return NULL;
+  }
+
+  size_t num = align_size_up(word_size, HeapRegion::GrainWords) / HeapRegion::GrainWords;
+  if (num == 0 || num >= max_regions()) {
+    return NULL;
+  }
+  uint archive_regions = (uint)num;
+  uint first = max_regions() - archive_regions;
+
+  if (_hrm.expand_at(first, archive_regions) > 0) {
+    g1_policy()->record_new_heap_size(num_regions());
+  }
+  for (uint i = first; i < first + archive_regions; ++i) {
+    HeapRegion* hr = region_at(i);
+    if (!hr->is_free() || !hr->is_empty()) {
+      return NULL;
+    }
+  }
+  _hrm.allocate_free_regions_starting_at(first, archive_regions);
+  return region_at(first)->bottom();
+}
+
+void G1CollectedHeap::fill_archive_regions(MemRegion range) {
+  MutexLockerEx x(Heap_lock);
+
+  size_t used = 0;
+  HeapWord* cur = range.start();
+  while (cur < range.end()) {
+    HeapRegion* hr = heap_region_containing(cur);
+    assert(hr->bottom() == cur && hr->is_free() && hr->is_empty(),
+           err_msg("region %u is not an unused archive region", hr->hrm_index()));
+    hr->set_archive();
+
+    // Allocate the objects one by one so that the BOT covers each of them.
+    HeapWord* limit = MIN2(hr->end(), range.end());
+    while (cur < limit) {
+      size_t word_size = oop(cur)->size();
+      HeapWord* result = hr->allocate(word_size);
+      guarantee(result == cur, "archived object crosses a region boundary");
+      cur += word_size;
+    }
+    _old_set.add(hr);
+    _hr_printer.alloc(hr, G1HRPrinter::Old);
+    used += hr->used();
+  }
+  _allocator->increase_used(used);
+
+  // Full GCs must neither mark nor move the archived objects.
+  MarkSweep::set_archive_range(range);
+}
+
+void G1CollectedHeap::free_archive_regions(MemRegion range) {
+  MutexLockerEx x(Heap_lock);
+
+  for (HeapWord* cur = range.start(); cur < range.end(); cur += HeapRegion::GrainWords) {
+    HeapRegion* hr = heap_region_containing(cur);
+    assert(hr->is_free() && hr->is_empty(), "archive region should be unused");
+    _hrm.insert_into_free_list(hr);
+  }
+}
+
 HeapWord* G1CollectedHeap::allocate_new_tlab(size_t word_size) {
   assert_heap_not_locked_and_not_at_safepoint();
   assert(!isHumongous(word_size), "we do not allow humongous TLABs");
@@ -1236,7 +1304,7 @@ public:
       }
     } else if (hr->continuesHumongous()) {
       _hr_printer->post_compaction(hr, G1HRPrinter::ContinuesHumongous);
-    } else if (hr->is_old()) {
+    } else if (hr->is_old_or_archive()) {
       _hr_printer->post_compaction(hr, G1HRPrinter::Old);
     } else {
       ShouldNotReachHere();
@@ -2904,7 +2972,7 @@ void G1CollectedHeap::collection_set_iterate_from(HeapRegion* r,
 
 HeapRegion* G1CollectedHeap::next_compaction_region(const HeapRegion* from) const {
   HeapRegion* result = _hrm.next_region_in_heap(from);
-  while (result != NULL && result->isHumongous()) {
+  while (result != NULL && (result->isHumongous() || result->is_archive())) {
     result = _hrm.next_region_in_heap(result);
   }
   return result;
@@ -3473,7 +3541,7 @@ bool G1CollectedHeap::is_obj_dead_cond(const oop obj,
   switch (vo) {
   case VerifyOption_G1UsePrevMarking: return is_obj_dead(obj, hr);
   case VerifyOption_G1UseNextMarking: return is_obj_ill(obj, hr);
-  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked();
+  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked() && !hr->is_archive();
   default:                            ShouldNotReachHere();
   }
   return false; // keep some compilers happy
@@ -3484,7 +3552,8 @@ bool G1CollectedHeap::is_obj_dead_cond(const oop obj,
   switch (vo) {
   case VerifyOption_G1UsePrevMarking: return is_obj_dead(obj);
   case VerifyOption_G1UseNextMarking: return is_obj_ill(obj);
-  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked();
+  case VerifyOption_G1UseMarkWord:    return !obj->is_gc_marked() &&
+                                             !MarkSweep::is_archive_object(obj);
   default:                            ShouldNotReachHere();
   }
   return false; // keep some compilers happy
@@ -6644,7 +6713,7 @@ public:
   TearDownRegionSetsClosure(HeapRegionSet* old_set) : _old_set(old_set) { }
 
   bool doHeapRegion(HeapRegion* r) {
-    if (r->is_old()) {
+    if (r->is_old_or_archive()) {
       _old_set->remove(r);
     } else {
       // We ignore free regions, we'll empty the free list afterwards.
@@ -6713,9 +6782,12 @@ public:
       } else {
         // Objects that were compacted would have ended up on regions
         // that were previously old or free.
-        assert(r->is_free() || r->is_old(), "invariant");
-        // We now consider them old, so register as such.
-        r->set_old();
+        assert(r->is_free() || r->is_old_or_archive(), "invariant");
+        // We now consider them old, so register as such. Archive regions
+        // keep their type.
+        if (!r->is_archive()) {
+          r->set_old();
+        }
         _old_set->add(r);
       }
       _total_used += r->used();
@@ -6889,7 +6961,7 @@ public:
     } else if (hr->is_empty()) {
       assert(_hrm->is_free(hr), err_msg("Heap region %u is empty but not on the free list.", hr->hrm_index()));
       _free_count.increment(1u, hr->capacity());
-    } else if (hr->is_old()) {
+    } else if (hr->is_old_or_archive()) {
       assert(hr->containing_set() == _old_set, err_msg("Heap region %u is old but not in the old set.", hr->hrm_index()));
       _old_count.increment(1u, hr->capacity());
     } else {
@@ -727,6 +727,20 @@ public:
 
   G1HRPrinter* hr_printer() { return &_hr_printer; }
 
+  // Archive region support, used at VM initialization to load archived
+  // heap objects from the shared archive.
+  //
+  // Commit the regions at the top of the reserved heap that cover
+  // word_size words and take them off the free list. Returns the bottom
+  // of the first region, or NULL if the regions are not available.
+  HeapWord* alloc_archive_regions(size_t word_size);
+  // The regions covering range now hold parsable objects; turn them into
+  // archive regions and account for their objects.
+  void fill_archive_regions(MemRegion range);
+  // Give regions returned by alloc_archive_regions() for range back to
+  // the free list.
+  void free_archive_regions(MemRegion range);
+
   // Frees a non-humongous region by initializing its contents and
   // adding it to the free list that's passed as a parameter (this is
   // usually a local list which will be appended to the master free
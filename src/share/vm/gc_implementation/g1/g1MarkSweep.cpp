@@ -222,6 +222,10 @@ void G1MarkSweep::mark_sweep_phase2() {
 class G1AdjustPointersClosure: public HeapRegionClosure {
  public:
   bool doHeapRegion(HeapRegion* r) {
+    if (r->is_archive()) {
+      // Archive objects only refer to other archive objects, which never move.
+      return false;
+    }
     if (r->isHumongous()) {
       if (r->startsHumongous()) {
         // We must adjust the pointers on the single H object.
@@ -277,6 +281,9 @@ public:
   G1SpaceCompactClosure() {}
 
   bool doHeapRegion(HeapRegion* hr) {
+    if (hr->is_archive()) {
+      return false;
+    }
     if (hr->isHumongous()) {
       if (hr->startsHumongous()) {
         oop obj = oop(hr->bottom());
@@ -359,6 +366,10 @@ void G1PrepareCompactClosure::update_sets() {
 }
 
 bool G1PrepareCompactClosure::doHeapRegion(HeapRegion* hr) {
+  if (hr->is_archive()) {
+    // Archive objects are never marked and never move; keep the region as is.
+    return false;
+  }
   if (hr->isHumongous()) {
     if (hr->startsHumongous()) {
       oop obj = oop(hr->bottom());
@@ -422,6 +422,12 @@ class HeapRegion: public G1OffsetTableContigSpace {
 
   bool is_old() const { return _type.is_old(); }
 
+  // An archive region holds objects loaded from the shared archive. They
+  // are implicitly live and are never moved or collected.
+  bool is_archive() const { return _type.is_archive(); }
+
+  bool is_old_or_archive() const { return _type.is_old_or_archive(); }
+
   // For a humongous region, region in which it starts.
   HeapRegion* humongous_start_region() const {
     return _humongous_start_region;
@@ -692,6 +698,13 @@ class HeapRegion: public G1OffsetTableContigSpace {
     _type.set_old();
   }
 
+  void set_archive() {
+    if (EnableJFR) {
+      report_region_type_change(G1HeapRegionTraceType::ClosedArchive);
+    }
+    _type.set_archive();
+  }
+
   void set_eden_pre_gc() {
     if (EnableJFR) {
       report_region_type_change(G1HeapRegionTraceType::Eden);
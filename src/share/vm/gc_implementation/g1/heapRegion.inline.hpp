@@ -139,7 +139,9 @@ inline HeapWord* HeapRegion::allocate_no_bot_updates(size_t word_size) {
 
 inline void HeapRegion::note_start_of_marking() {
   _next_marked_bytes = 0;
-  _next_top_at_mark_start = top();
+  // Keep NTAMS at bottom for archive regions so that all their objects are
+  // implicitly live and marking never needs to visit them.
+  _next_top_at_mark_start = is_archive() ? bottom() : top();
 }
 
 inline void HeapRegion::note_end_of_marking() {
@@ -34,6 +34,7 @@ bool HeapRegionType::is_valid(Tag tag) {
     case HumStartsTag:
     case HumContTag:
     case OldTag:
+    case ArchiveTag:
       return true;
   }
   return false;
@@ -48,6 +49,7 @@ const char* HeapRegionType::get_str() const {
     case HumStartsTag: return "HUMS";
     case HumContTag:   return "HUMC";
     case OldTag:       return "OLD";
+    case ArchiveTag:   return "ARC";
   }
   ShouldNotReachHere();
   // keep some compilers happy
@@ -63,6 +65,7 @@ const char* HeapRegionType::get_short_str() const {
     case HumStartsTag: return "HS";
     case HumContTag:   return "HC";
     case OldTag:       return "O";
+    case ArchiveTag:   return "A";
   }
   ShouldNotReachHere();
   // keep some compilers happy
@@ -78,6 +81,7 @@ G1HeapRegionTraceType::Type HeapRegionType::get_trace_type() {
     case HumStartsTag:          return G1HeapRegionTraceType::StartsHumongous;
     case HumContTag:            return G1HeapRegionTraceType::ContinuesHumongous;
     case OldTag:                return G1HeapRegionTraceType::Old;
+    case ArchiveTag:            return G1HeapRegionTraceType::ClosedArchive;
     default:
       ShouldNotReachHere();
       return G1HeapRegionTraceType::Free; // keep some compilers happy
@@ -53,7 +53,9 @@ private:
   // 0010 0 [ 4] Humongous Starts
   // 0010 1 [ 5] Humongous Continues
   //
-  // 01000 [ 8] Old
+  // 0100 0      Old Mask
+  // 0100 0 [ 8] Old
+  // 0100 1 [ 9] Archive
   typedef enum {
     FreeTag       = 0,
 
@@ -65,7 +67,9 @@ private:
     HumStartsTag  = HumMask,
     HumContTag    = HumMask + 1,
 
-    OldTag        = 8
+    OldMask       = 8,
+    OldTag        = OldMask,
+    ArchiveTag    = OldMask + 1
   } Tag;
 
   volatile Tag _tag;
@@ -109,7 +113,12 @@ public:
   bool is_starts_humongous()    const { return get() == HumStartsTag;  }
   bool is_continues_humongous() const { return get() == HumContTag;    }
 
-  bool is_old() const { return get() == OldTag; }
+  bool is_old()     const { return get() == OldTag;     }
+  bool is_archive() const { return get() == ArchiveTag; }
+
+  // Archive regions are old regions whose objects are never moved or
+  // reclaimed. They are kept in the old region set.
+  bool is_old_or_archive() const { return (get() & OldMask) != 0; }
 
   // Setters
 
@@ -124,6 +133,8 @@ public:
 
   void set_old() { set(OldTag); }
 
+  void set_archive() { set_from(ArchiveTag, FreeTag); }
+
   // Misc
 
   const char* get_str() const;
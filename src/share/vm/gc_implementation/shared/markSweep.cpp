@@ -47,6 +47,8 @@ PreservedMark*          MarkSweep::_preserved_marks = NULL;
 ReferenceProcessor*     MarkSweep::_ref_processor   = NULL;
 STWGCTimer*             MarkSweep::_gc_timer        = NULL;
 SerialOldTracer*        MarkSweep::_gc_tracer       = NULL;
+HeapWord*               MarkSweep::_archive_bottom  = NULL;
+HeapWord*               MarkSweep::_archive_end     = NULL;
 
 MarkSweep::FollowRootClosure  MarkSweep::follow_root_closure;
 
@@ -145,7 +147,9 @@ void MarkSweep::restore_marks() {
 
 MarkSweep::IsAliveClosure   MarkSweep::is_alive;
 
-bool MarkSweep::IsAliveClosure::do_object_b(oop p) { return p->is_gc_marked(); }
+bool MarkSweep::IsAliveClosure::do_object_b(oop p) {
+  return p->is_gc_marked() || is_archive_object(p);
+}
 
 MarkSweep::KeepAliveClosure MarkSweep::keep_alive;
 
@@ -122,6 +122,10 @@ class MarkSweep : AllStatic {
   static STWGCTimer*                     _gc_timer;
   static SerialOldTracer*                _gc_tracer;
 
+  // Archived heap objects (G1 archive regions) are neither marked nor moved
+  static HeapWord*                       _archive_bottom;
+  static HeapWord*                       _archive_end;
+
   // Non public closures
   static KeepAliveClosure keep_alive;
 
@@ -147,6 +151,15 @@ class MarkSweep : AllStatic {
   static STWGCTimer* gc_timer() { return _gc_timer; }
   static SerialOldTracer* gc_tracer() { return _gc_tracer; }
 
+  // Archived heap objects are always live and never move
+  static void set_archive_range(MemRegion range) {
+    _archive_bottom = range.start();
+    _archive_end = range.end();
+  }
+  static bool is_archive_object(oop obj) {
+    return (HeapWord*)obj < _archive_end && (HeapWord*)obj >= _archive_bottom;
+  }
+
   // Call backs for marking
   static void mark_object(oop obj);
   // Mark pointer and follow contents.  Empty marking stack afterwards.
@@ -43,6 +43,7 @@
 #include "oops/oop.inline.hpp"
 #include "runtime/arguments.hpp"
 #include "runtime/globals.hpp"
+#include "runtime/monitorContentionStatistics.hpp"
 #include "runtime/os.hpp"
 #include "runtime/os_perf.hpp"
 #include "runtime/thread.inline.hpp"
@@ -475,6 +476,22 @@ TRACE_REQUEST_FUNC(ClassLoaderStatistics) {
   VMThread::execute(&op);
 }
 
+class JfrMonitorContentionStatsVMOperation : public VM_Operation {
+ public:
+  VMOp_Type type() const { return VMOp_MonitorContentionStatistics; }
+
+  // Emitting at a safepoint keeps the sampled classes from being unloaded
+  // while their events are written.
+  void doit() {
+    MonitorContentionStatistics::emit_events();
+  }
+};
+
+TRACE_REQUEST_FUNC(JavaMonitorContentionStatistics) {
+  JfrMonitorContentionStatsVMOperation op;
+  VMThread::execute(&op);
+}
+
 TRACE_REQUEST_FUNC(CompilerStatistics) {
   EventCompilerStatistics event;
   event.set_compileCount(CompileBroker::get_total_compile_count());
@@ -500,16 +517,19 @@ TRACE_REQUEST_FUNC(CompilerConfiguration) {
 
 TRACE_REQUEST_FUNC(CodeCacheStatistics) {
   // Emit stats for all available code heaps
-  EventCodeCacheStatistics event;
-  event.set_codeBlobType((u1)CodeBlobType::All);
-  event.set_startAddress((u8)CodeCache::low_bound());
-  event.set_reservedTopAddress((u8)CodeCache::high_bound());
-  event.set_entryCount(CodeCache::nof_blobs());
-  event.set_methodCount(CodeCache::nof_nmethods());
-  event.set_adaptorCount(CodeCache::nof_adapters());
-  event.set_unallocatedCapacity(CodeCache::unallocated_capacity());
-  event.set_fullCount(CodeCache::get_codemem_full_count());
-  event.commit();
+  for (int i = 0; i < CodeCache::nof_heaps(); i++) {
+    CodeHeap* heap = CodeCache::heap_at(i);
+    EventCodeCacheStatistics event;
+    event.set_codeBlobType((u1)heap->code_blob_type());
+    event.set_startAddress((u8)heap->low_boundary());
+    event.set_reservedTopAddress((u8)heap->high_boundary());
+    event.set_entryCount(heap->blob_count());
+    event.set_methodCount(heap->nmethod_count());
+    event.set_adaptorCount(heap->adapter_count());
+    event.set_unallocatedCapacity(heap->unallocated_capacity());
+    event.set_fullCount(CodeCache::get_codemem_full_count());
+    event.commit();
+  }
 }
 
 TRACE_REQUEST_FUNC(CodeCacheConfiguration) {
@@ -527,5 +547,19 @@ TRACE_REQUEST_FUNC(CodeSweeperConfiguration) {
   EventCodeSweeperConfiguration event;
   event.set_sweeperEnabled(MethodFlushing);
   event.set_flushingEnabled(UseCodeCacheFlushing);
+  event.set_sweeperThread(UseCodeCacheSweeperThread);
+  event.set_sizeAwareEviction(UseSizeAwareCodeCacheEviction);
+  event.commit();
+}
+
+TRACE_REQUEST_FUNC(CodeSweeperStatistics) {
+  EventCodeSweeperStatistics event;
+  event.set_sweepCount(NMethodSweeper::total_nof_code_cache_sweeps());
+  event.set_methodReclaimedCount(NMethodSweeper::total_nof_methods_reclaimed());
+  event.set_methodEvictedCount(NMethodSweeper::total_nof_methods_evicted());
+  event.set_evictedSize(NMethodSweeper::total_evicted_size());
+  event.set_totalSweepTime(NMethodSweeper::total_time_sweeping());
+  event.set_peakFractionTime(NMethodSweeper::peak_sweep_fraction_time());
+  event.set_peakSweepTime(NMethodSweeper::peak_sweep_time());
   event.commit();
 }
@@ -263,11 +263,12 @@ void CompilerPhaseTypeConstant::write_constants(JfrCheckpointWriter& writer) {
 }
 
 void CodeBlobTypeConstant::write_constants(JfrCheckpointWriter& writer) {
-  // only one code blob now in ajdk8
   static const u4 nof_entries = CodeBlobType::NumTypes;
   writer.write_number_of_constants(nof_entries);
-  writer.write_key((u4)CodeBlobType::All);
-  writer.write("CodeCache");
+  for (u4 i = 0; i < nof_entries; ++i) {
+    writer.write_key(i);
+    writer.write(CodeCache::heap_name(i));
+  }
 };
 
 void VMOperationTypeConstant::write_constants(JfrCheckpointWriter& writer) {
@@ -25,10 +25,13 @@
 #include "classfile/classLoaderData.inline.hpp"
 #include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionary.hpp"
+#include "code/dependencies.hpp"
+#include "code/nmethod.hpp"
 #include "compiler/compileBroker.hpp"
 #include "jwarmup/jitWarmUp.hpp"
 #include "jwarmup/jitWarmUpThread.hpp"
 #include "oops/method.hpp"
+#include "oops/methodData.hpp"
 #include "oops/typeArrayKlass.hpp"
 #include "runtime/arguments.hpp"
 #include "runtime/compilationPolicy.hpp"
@@ -37,14 +40,22 @@
 #include "runtime/javaCalls.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/os.hpp"
+#include "runtime/os_perf.hpp"
 #include "runtime/thread.hpp"
 #include "utilities/hashtable.inline.hpp"
 #include "utilities/stack.hpp"
 #include "utilities/stack.inline.hpp"
+#include "trace/tracing.hpp"
 #include "runtime/atomic.hpp"
 #include "jwarmup/jitWarmUpLog.hpp"  // must be last one to use customized jwarmup log
 
-#define JITWARMUP_VERSION  0x2
+# include <sys/stat.h>
+
+#ifndef O_BINARY       // if defined (Win32) use binary files.
+#define O_BINARY 0     // otherwise do nothing.
+#endif
+
+#define JITWARMUP_VERSION  0x4
 
 JitWarmUp*                JitWarmUp::_instance         = NULL;
 
@@ -255,7 +266,7 @@ int ProfileRecorder::assign_class_init_order(InstanceKlass* klass) {
   return _class_init_order_count;
 }
 
-void ProfileRecorder::add_method(Method* m, int bci) {
+void ProfileRecorder::add_method(Method* m, int bci, nmethod* nm) {
   MutexLockerEx mu(ProfileRecorder_lock, Mutex::_no_safepoint_check_flag);
   // if is flushed, stop adding method
   if (flushed()) {
@@ -267,7 +278,28 @@ void ProfileRecorder::add_method(Method* m, int bci) {
   }
   assert(is_valid(), "JitWarmUp state must be OK");
   unsigned int hash = compute_hash(m);
-  dict()->add_method(hash, m, bci);
+  ProfileRecorderEntry* entry = dict()->add_method(hash, m, bci);
+  record_dependencies(entry, nm);
+}
+
+// keep context classes of the latest nmethod's dependencies,
+// they are validated by fingerprint before the method is compiled by JitWarmUp
+void ProfileRecorder::record_dependencies(ProfileRecorderEntry* entry, nmethod* nm) {
+  GrowableArray<InstanceKlass*>* deps = entry->dependencies();
+  if (deps == NULL) {
+    deps = new (ResourceObj::C_HEAP, mtInternal)
+           GrowableArray<InstanceKlass*>(4, true, mtInternal);
+    entry->set_dependencies(deps);
+  } else {
+    deps->clear();
+  }
+  for (Dependencies::DepStream ds(nm); ds.next(); ) {
+    Klass* k = ds.context_type();
+    if (k == NULL || !k->oop_is_instance()) {
+      continue;
+    }
+    deps->append_if_missing(InstanceKlass::cast(k));
+  }
 }
 
 // NYI
@@ -325,6 +357,7 @@ ProfileRecorderEntry* ProfileRecordDictionary::find_entry(unsigned int hash, Met
 }
 
 void ProfileRecordDictionary::free_entry(ProfileRecorderEntry* entry) {
+  delete entry->dependencies();
   Hashtable<Method*, mtInternal>::free_entry(entry);
 }
 
@@ -508,7 +541,8 @@ void ProfileRecorder::write_inited_class() {
 }
 
 // write profile information
-void ProfileRecorder::write_record(Method* method, int bci, int order) {
+void ProfileRecorder::write_record(Method* method, int bci, int order,
+                                   GrowableArray<InstanceKlass*>* deps) {
   ResourceMark rm;
   unsigned int begin_pos = _pos;
   unsigned int total_size = 0;
@@ -576,11 +610,164 @@ void ProfileRecorder::write_record(Method* method, int bci, int order) {
     write_u4((u4)0);
   }
 
+  write_method_data(method);
+  write_dependencies(deps);
+
   unsigned int end_pos = _pos;
   unsigned int section_size = end_pos - begin_pos;
   overwrite_u4(section_size, size_anchor);
 }
 
+// Counter cells of a ProfileData persisted in log file. The cells are
+// written and restored in the same order, see profile_count_at().
+static int profile_count_cells(ProfileData* data) {
+  if (data->is_MultiBranchData()) {
+    return 1 + data->as_MultiBranchData()->number_of_cases();
+  } else if (data->is_BranchData()) {
+    return 2;
+  } else if (data->is_JumpData() || data->is_CounterData()) {
+    return 1;
+  }
+  return 0;
+}
+
+static uint profile_count_at(ProfileData* data, int index) {
+  if (data->is_MultiBranchData()) {
+    MultiBranchData* mbd = data->as_MultiBranchData();
+    return index == 0 ? mbd->default_count() : mbd->count_at(index - 1);
+  } else if (data->is_BranchData()) {
+    BranchData* bd = data->as_BranchData();
+    return index == 0 ? bd->taken() : bd->not_taken();
+  } else if (data->is_JumpData()) {
+    return data->as_JumpData()->taken();
+  }
+  assert(data->is_CounterData(), "no counter cell");
+  return data->as_CounterData()->count();
+}
+
+static void set_profile_count_at(ProfileData* data, int index, uint value) {
+  if (data->is_MultiBranchData()) {
+    MultiBranchData* mbd = data->as_MultiBranchData();
+    if (index == 0) {
+      mbd->set_default_count(value);
+    } else {
+      mbd->set_count_at(index - 1, value);
+    }
+  } else if (data->is_BranchData()) {
+    BranchData* bd = data->as_BranchData();
+    if (index == 0) {
+      bd->set_taken(value);
+    } else {
+      bd->set_not_taken(value);
+    }
+  } else if (data->is_JumpData()) {
+    data->as_JumpData()->set_taken(value);
+  } else {
+    assert(data->is_CounterData(), "no counter cell");
+    data->as_CounterData()->set_count(value);
+  }
+}
+
+static uint saturated_add(uint a, uint b) {
+  uint sum = a + b;
+  return sum < a ? max_juint : sum;
+}
+
+void ProfileRecorder::write_class_symbols(Klass* klass) {
+  char* class_name = klass->name()->as_C_string();
+  const char* path = JVM_DEFINE_CLASS_PATH;
+  if (klass->oop_is_instance()) {
+    Symbol* path_sym = InstanceKlass::cast(klass)->source_file_path();
+    if (path_sym != NULL) {
+      path = path_sym->as_C_string();
+    }
+  }
+  oop class_loader = klass->class_loader();
+  const char* loader_name = NULL;
+  if (class_loader != NULL) {
+    loader_name = class_loader->klass()->name()->as_C_string();
+  } else {
+    loader_name = "NULL";
+  }
+  write_string(class_name, strlen(class_name));
+  write_string(loader_name, strlen(loader_name));
+  write_string(path, strlen(path));
+}
+
+// write the MethodData of a method:
+//   u4 invocation count, u4 backedge count, u4 record count
+//   per ProfileData: u4 bci, u1 tag, u1 flags, u4 count cells, u4 * cells,
+//                    u4 receivers, (class, loader, path, u4 count) * receivers
+void ProfileRecorder::write_method_data(Method* method) {
+  MethodData* md = method->method_data();
+  if (md == NULL) {
+    write_u4((u4)0);
+    write_u4((u4)0);
+    write_u4((u4)0);
+    return;
+  }
+  write_u4((u4)md->invocation_count());
+  write_u4((u4)md->backedge_count());
+  unsigned int count_anchor = _pos;
+  // record count place holder
+  write_u4((u4)0);
+
+  u4 record_count = 0;
+  for (ProfileData* data = md->first_data();
+       md->is_valid(data);
+       data = md->next_data(data)) {
+    write_u4((u4)data->bci());
+    write_u1(data->data()->tag());
+    write_u1(data->data()->flags());
+    int cells = profile_count_cells(data);
+    write_u4((u4)cells);
+    for (int i = 0; i < cells; i++) {
+      write_u4((u4)profile_count_at(data, i));
+    }
+    if (data->is_ReceiverTypeData()) {
+      ReceiverTypeData* rtd = data->as_ReceiverTypeData();
+      // the number of used rows is written before the rows, collect them first
+      uint row_limit = ReceiverTypeData::row_limit();
+      Klass** receivers = NEW_RESOURCE_ARRAY(Klass*, row_limit);
+      uint* counts = NEW_RESOURCE_ARRAY(uint, row_limit);
+      u4 receiver_count = 0;
+      for (uint row = 0; row < row_limit; row++) {
+        Klass* k = rtd->receiver(row);
+        if (k != NULL) {
+          receivers[receiver_count] = k;
+          counts[receiver_count] = rtd->receiver_count(row);
+          receiver_count++;
+        }
+      }
+      write_u4(receiver_count);
+      for (u4 i = 0; i < receiver_count; i++) {
+        write_class_symbols(receivers[i]);
+        write_u4((u4)counts[i]);
+      }
+    } else {
+      write_u4((u4)0);
+    }
+    record_count++;
+  }
+  overwrite_u4(record_count, count_anchor);
+}
+
+// write dependencies of the recorded nmethod:
+//   u4 count, (class, loader, path, u4 class size, u4 class crc32) * count
+void ProfileRecorder::write_dependencies(GrowableArray<InstanceKlass*>* deps) {
+  if (deps == NULL) {
+    write_u4((u4)0);
+    return;
+  }
+  write_u4((u4)deps->length());
+  for (int i = 0; i < deps->length(); i++) {
+    InstanceKlass* k = deps->at(i);
+    write_class_symbols(k);
+    write_u4((u4)k->bytes_size());
+    write_u4((u4)k->crc32());
+  }
+}
+
 void ProfileRecorder::write_footer() {
 }
 
@@ -608,7 +795,7 @@ void ProfileRecorder::flush() {
     for (ProfileRecorderEntry* entry = dict()->bucket(index);
                                entry != NULL;
                                entry = entry->next()) {
-      write_record(entry->literal(), entry->bci(), entry->order());
+      write_record(entry->literal(), entry->bci(), entry->order(), entry->dependencies());
     }
   }
   // foot section
@@ -749,13 +936,17 @@ PreloadMethodHolder::PreloadMethodHolder(Symbol* name, Symbol* signature)
     _intp_throwout_count(0),
     _invocation_count(0),
     _backage_count(0),
+    _md_invocation_count(0),
+    _md_backedge_count(0),
     _mounted_offset(-1),
     _owns_md_list(true),
     _is_deopted(false),
     _next(NULL),
     _resolved_method(NULL),
     _md_list(new (ResourceObj::C_HEAP, mtClass)
-             GrowableArray<MDRecordInfo*>(16, true, mtClass)) {
+             GrowableArray<MDRecordInfo*>(16, true, mtClass)),
+    _dep_list(new (ResourceObj::C_HEAP, mtClass)
+              GrowableArray<DependencyRecordInfo*>(4, true, mtClass)) {
   // do nothing
 }
 
@@ -768,17 +959,27 @@ PreloadMethodHolder::PreloadMethodHolder(PreloadMethodHolder& rhs)
     _intp_throwout_count(rhs._intp_throwout_count),
     _invocation_count(rhs._invocation_count),
     _backage_count(rhs._backage_count),
+    _md_invocation_count(rhs._md_invocation_count),
+    _md_backedge_count(rhs._md_backedge_count),
     _mounted_offset(rhs._mounted_offset),
     _owns_md_list(false),
     _is_deopted(false),
     _next(NULL),
     _resolved_method(NULL),
-    _md_list(rhs._md_list) {
+    _md_list(rhs._md_list),
+    _dep_list(rhs._dep_list) {
 }
 
 PreloadMethodHolder::~PreloadMethodHolder() {
   if (_owns_md_list) {
+    for (int i = 0; i < _md_list->length(); i++) {
+      delete _md_list->at(i);
+    }
     delete _md_list;
+    for (int i = 0; i < _dep_list->length(); i++) {
+      delete _dep_list->at(i);
+    }
+    delete _dep_list;
   }
 }
 
@@ -900,7 +1101,12 @@ PreloadClassChain::PreloadClassChain(unsigned int size)
     _last_timestamp(),
     _deopt_index(-1),
     _deopt_cur_holder(NULL),
-    _has_unmarked_compiling_flag(false) {
+    _has_unmarked_compiling_flag(false),
+    _scheduled_count(0),
+    _submitted_count(0),
+    _skipped_count(0),
+    _throttled_millis(0),
+    _cpu_perf(NULL) {
   _init_timestamp.update();
   _last_timestamp.update();
   state_trans_to(INITED);
@@ -1041,18 +1247,115 @@ void PreloadClassChain::update_loaded_index(int index) {
 
 void PreloadClassChain::compile_methodholders_queue(Stack<PreloadMethodHolder*, mtInternal>& compile_queue) {
   while (!compile_queue.is_empty()) {
-    PreloadMethodHolder* pmh = compile_queue.pop();
-    compile_methodholder(pmh);
-    Thread* THREAD = Thread::current();
-    if (HAS_PENDING_EXCEPTION) {
-      ResourceMark rm;
-      log_warning(warmup)("[JitWarmUp] WARNING: Exceptions happened in compiling %s",
-                          pmh->name()->as_C_string());
-      // ignore exception occurs during compilation
-      CLEAR_PENDING_EXCEPTION;
-      continue;
+    submit_methodholder(compile_queue.pop());
+  }
+}
+
+// hotter methods first, methods of earlier initialized classes first
+static int compare_by_hotness(PreloadMethodHolder** a, PreloadMethodHolder** b) {
+  julong hot_a = ((julong)(*a)->invocation_count() >> InvocationCounter::count_shift) +
+                 ((julong)(*a)->backage_count() >> InvocationCounter::count_shift);
+  julong hot_b = ((julong)(*b)->invocation_count() >> InvocationCounter::count_shift) +
+                 ((julong)(*b)->backage_count() >> InvocationCounter::count_shift);
+  if (hot_a != hot_b) {
+    return hot_a > hot_b ? -1 : 1;
+  }
+  return (*a)->mounted_offset() - (*b)->mounted_offset();
+}
+
+void PreloadClassChain::compile_scheduled_methodholders(GrowableArray<PreloadMethodHolder*>* methods) {
+  methods->sort(compare_by_hotness);
+  for (int i = 0; i < methods->length(); i++) {
+    submit_methodholder(methods->at(i));
+  }
+}
+
+void PreloadClassChain::submit_methodholder(PreloadMethodHolder* mh) {
+  throttle_submission();
+  bool submitted = compile_methodholder(mh);
+  Thread* THREAD = Thread::current();
+  if (HAS_PENDING_EXCEPTION) {
+    ResourceMark rm;
+    log_warning(warmup)("[JitWarmUp] WARNING: Exceptions happened in compiling %s",
+                        mh->name()->as_C_string());
+    // ignore exception occurs during compilation
+    CLEAR_PENDING_EXCEPTION;
+    submitted = false;
+  }
+  if (submitted) {
+    Atomic::inc(&_submitted_count);
+  } else {
+    Atomic::inc(&_skipped_count);
+  }
+}
+
+bool PreloadClassChain::should_throttle() {
+  if (CompilationWarmUpMaxQueuedTasks > 0 &&
+      CompileBroker::queue_size(CompLevel_full_optimization) >= CompilationWarmUpMaxQueuedTasks) {
+    return true;
+  }
+#ifdef LINUX
+  if (CompilationWarmUpMaxCPULoad > 0) {
+    if (_cpu_perf == NULL) {
+      _cpu_perf = new CPUPerformanceInterface();
+      if (!_cpu_perf->initialize()) {
+        log_warning(warmup)("[JitWarmUp] WARNING: cpu load is not available, "
+                            "CompilationWarmUpMaxCPULoad is ignored");
+        FLAG_SET_ERGO(uintx, CompilationWarmUpMaxCPULoad, 0);
+        return false;
+      }
     }
+    double jvm_user = 0.0;
+    double jvm_kernel = 0.0;
+    double system_total = 0.0;
+    if (_cpu_perf->cpu_loads_process(&jvm_user, &jvm_kernel, &system_total) == OS_OK &&
+        system_total * 100 > (double)CompilationWarmUpMaxCPULoad) {
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
+#define THROTTLE_SLEEP_MILLIS 10
+
+void PreloadClassChain::throttle_submission() {
+  jlong waited = 0;
+  while (waited < (jlong)CompilationWarmUpMaxThrottleTime && should_throttle()) {
+    // interruptible sleep blocks the thread, safepoints are not delayed
+    os::sleep(Thread::current(), THROTTLE_SLEEP_MILLIS, true);
+    waited += THROTTLE_SLEEP_MILLIS;
   }
+  if (waited > 0) {
+    Atomic::add(waited, &_throttled_millis);
+  }
+}
+
+#undef THROTTLE_SLEEP_MILLIS
+
+const char* PreloadClassChain::state_name(ClassChainState state) {
+  switch (state) {
+    case NOT_INITED:            return "not inited";
+    case INITED:                return "inited";
+    case PRE_WARMUP:            return "pre warmup";
+    case WARMUP_COMPILING:      return "warmup compiling";
+    case WARMUP_DONE:           return "warmup done";
+    case WARMUP_PRE_DEOPTIMIZE: return "pre deoptimize";
+    case WARMUP_DEOPTIMIZING:   return "deoptimizing";
+    case WARMUP_DEOPTIMIZED:    return "deoptimized";
+    case ERROR_STATE:           return "error";
+    default:                    return "unknown";
+  }
+}
+
+void PreloadClassChain::print_progress_on(outputStream* st) {
+  st->print_cr("state: %s", state_name(current_state()));
+  st->print_cr("class chain: %d classes, %d loaded, %d initialized",
+               length(), loaded_index() + 1, inited_index() + 1);
+  st->print_cr("methods: %d scheduled, %d submitted, %d skipped",
+               scheduled_count(), submitted_count(), skipped_count());
+  st->print_cr("throttled: " JLONG_FORMAT " ms, C2 queue size: %d",
+               throttled_millis(), CompileBroker::queue_size(CompLevel_full_optimization));
 }
 
 void PreloadClassChain::warmup_impl() {
@@ -1062,6 +1365,10 @@ void PreloadClassChain::warmup_impl() {
     return;
   }
 
+  // methods of the whole chain, submitted after all classes are
+  // initialized when CompilationWarmUpSortByHotness is on
+  GrowableArray<PreloadMethodHolder*> scheduled(256, true, mtInternal);
+
   /* iterate all PreloadClassChainEntry to submit warmup compilation*/
   bool cancel_warmup = false;
   for ( int index = 0; index < length(); index++ ) {
@@ -1097,7 +1404,12 @@ void PreloadClassChain::warmup_impl() {
           if (!entry->has_redefined_class()){
             PreloadMethodHolder* mh = entry->method_holder();
             while (mh != NULL) {
-              compile_queue.push(mh);
+              if (CompilationWarmUpSortByHotness) {
+                scheduled.append(mh);
+              } else {
+                compile_queue.push(mh);
+              }
+              Atomic::inc(&_scheduled_count);
               mh = mh->next();
             }
           }
@@ -1137,6 +1449,7 @@ void PreloadClassChain::warmup_impl() {
     // compile methods in compile_queue
     compile_methodholders_queue(compile_queue);
   }
+  compile_scheduled_methodholders(&scheduled);
 }
 
 bool PreloadClassChain::compile_methodholder(PreloadMethodHolder* mh) {
@@ -1150,8 +1463,15 @@ bool PreloadClassChain::compile_methodholder(PreloadMethodHolder* mh) {
   if (!klass->is_initialized()) {
     return false;
   }
+  if (CompilationWarmUpValidateDependencies &&
+      !holder()->validate_dependencies(mh, m())) {
+    return false;
+  }
 
   m->set_compiled_by_jwarmup(true);
+  if (CompilationWarmUpRestoreProfile) {
+    holder()->restore_method_data(mh, m, t);
+  }
   // not deal with osr compilation
   int bci = InvocationEntryBci;
   bool ret = JitWarmUp::commit_compilation(m, bci, t);
@@ -1405,9 +1725,11 @@ PreloadMethodHolder* PreloadClassChain::resolve_method_info(Method* method, Prel
 }
 
 // JitWarmUp log parser
+// The log file is parsed in place from its mapped (or read) image, strings
+// are made into symbols without being copied
 class JitWarmUpLogParser : CHeapObj<mtInternal> {
 public:
-  JitWarmUpLogParser(randomAccessFileStream* fs, PreloadJitInfo* holder);
+  JitWarmUpLogParser(const char* image, long size, PreloadJitInfo* holder);
   virtual ~JitWarmUpLogParser();
 
   bool valid();
@@ -1424,13 +1746,17 @@ public:
   // or error occurred in parsing process
   PreloadMethodHolder* next();
 
+  // parse the MethodData part of a method record
+  bool parse_method_data(PreloadMethodHolder* mh, int end_pos);
+  // parse the nmethod dependencies part of a method record
+  bool parse_dependencies(PreloadMethodHolder* mh, int end_pos);
+
   void inc_parsed_number() { _parsed_methods++; }
 
   int parsed_methods() { return _parsed_methods; }
   int total_methods()  { return _total_methods; }
 
   long file_size()              { return _file_size; }
-  void set_file_size(long size) { _file_size = size; }
 
   int max_symbol_length() { return _max_symbol_length; }
 
@@ -1450,78 +1776,93 @@ private:
   // method count recorded in log file
   int                     _total_methods;
   long                    _file_size;
-  randomAccessFileStream* _fs;
+  // image of the whole log file, not owned
+  const char*             _image;
 
   int                     _max_symbol_length;
-  char*                   _parse_str_buf;
 
   PreloadJitInfo*         _holder;
-  Arena*                  _arena;
 
+  // loader names repeat from record to record: the last one is kept
+  // with its suffix removed
+  Symbol*                 _last_loader;
+  Symbol*                 _last_loader_no_suffix;
+
+  void                    read_bytes(void* dest, int size);
   u1                      read_u1();
   u4                      read_u4();
   u8                      read_u8();
-  char*                   read_string();
+  const char*             read_string();
+  Symbol*                 create_loader_symbol(const char* loader_char);
 };
 
-JitWarmUpLogParser::JitWarmUpLogParser(randomAccessFileStream* fs, PreloadJitInfo* holder)
+JitWarmUpLogParser::JitWarmUpLogParser(const char* image, long size, PreloadJitInfo* holder)
   : _is_valid(false),
     _has_parsed_header(false),
     _position(0),
     _parsed_methods(0),
     _total_methods(0),
-    _file_size(0),
-    _fs(fs),
+    _file_size(size),
+    _image(image),
     _max_symbol_length(0),
-    _parse_str_buf(NULL),
     _holder(holder),
-    _arena(new (mtInternal) Arena(mtInternal, 128)) {
+    _last_loader(NULL),
+    _last_loader_no_suffix(NULL) {
 }
 
 JitWarmUpLogParser::~JitWarmUpLogParser() {
-  // fileStream lifecycle is not managed by this class
-  delete _arena;
+  // the image lifecycle is not managed by this class
+}
+
+// Reads out of the image return zero; the position still advances so
+// that the section bound checks catch them
+void JitWarmUpLogParser::read_bytes(void* dest, int size) {
+  if (_position >= 0 && _position <= _file_size - size) {
+    ::memcpy(dest, _image + _position, size);
+  } else {
+    ::memset(dest, 0, size);
+  }
+  _position += size;
 }
 
-char parse_int_buf[8];
 u1 JitWarmUpLogParser::read_u1() {
-  _fs->read(parse_int_buf, 1, 1);
-  _position += 1;
-  return *(u1*)parse_int_buf;
+  u1 value;
+  read_bytes(&value, sizeof(value));
+  return value;
 }
 
 u4 JitWarmUpLogParser::read_u4() {
-  _fs->read(parse_int_buf, 4, 1);
-  _position += 4;
-  return *(u4*)parse_int_buf;
+  u4 value;
+  read_bytes(&value, sizeof(value));
+  return value;
 }
 
 u8 JitWarmUpLogParser::read_u8() {
-  _fs->read(parse_int_buf, 8, 1);
-  _position += 8;
-  return *(u8*)parse_int_buf;
+  u8 value;
+  read_bytes(&value, sizeof(value));
+  return value;
 }
 
-char* JitWarmUpLogParser::read_string() {
-  int index = 0;
-  do {
-    _fs->read(_parse_str_buf + index, 1, 1);
-    index++;
-  } while (*(_parse_str_buf + index - 1) != '\0'
-          && index <= _max_symbol_length + 1);
-
-  _position += index;
-  int len = index - 1;
-  if (len == 0) {
+// Returns the string in place in the image
+const char* JitWarmUpLogParser::read_string() {
+  if (_position < 0 || _position >= _file_size) {
+    _position++;
     return NULL;
-  } else if (len > max_symbol_length()) {
+  }
+  const char* str = _image + _position;
+  long limit = MIN2((long)_max_symbol_length + 1, _file_size - _position);
+  int len = 0;
+  while (len < limit && str[len] != '\0') {
+    len++;
+  }
+  if (len == limit) {
+    // no terminator in range
+    _position += len;
     log_error(warmup)("[JitWarmUp] ERROR : Parsed symbol length is longer than %d\n", max_symbol_length());
     return NULL;
-  } else {
-    char* str = NEW_RESOURCE_ARRAY(char, len + 1);
-    ::memcpy(str, _parse_str_buf, len + 1);
-    return str;
   }
+  _position += len + 1;
+  return len == 0 ? NULL : str;
 }
 
 #define MAX_COUNT_VALUE (1024 * 1024 * 128)
@@ -1572,6 +1913,11 @@ bool JitWarmUpLogParser::should_ignore_this_class(Symbol* s) {
 bool JitWarmUpLogParser::parse_header() {
   int begin_pos = _position;
   int end_pos = begin_pos + HEADER_SIZE;
+  if (_file_size <= HEADER_SIZE) {
+    _is_valid = false;
+    log_error(warmup)("[JitWarmUp] ERROR : illegal header");
+    return false;
+  }
   u4 version_number = read_u4();
   u4 magic_number = read_u4();
   u4 file_size = read_u4();
@@ -1597,7 +1943,7 @@ bool JitWarmUpLogParser::parse_header() {
     return false;
   }
   // valid crc32
-  int crc32_actual = ProfileRecorder::compute_crc32(_fs);
+  int crc32_actual = ClassLoader::crc32(0, _image + HEADER_SIZE, (int)(_file_size - HEADER_SIZE));
   if (crc32_recorded != crc32_actual) {
     _is_valid = false;
     log_error(warmup)("[JitWarmUp] ERROR : log file crc32 check failure");
@@ -1606,7 +1952,6 @@ bool JitWarmUpLogParser::parse_header() {
 
   u4 max_symbol_length = read_u4();
   LOGPARSER_ILLEGAL_COUNT_CHECK(max_symbol_length, false);
-  _parse_str_buf = (char*)_arena->Amalloc(max_symbol_length + 2);
   _max_symbol_length = (int)max_symbol_length;
 
   u4 record_count = read_u4();
@@ -1620,6 +1965,15 @@ bool JitWarmUpLogParser::parse_header() {
 #define CREATE_SYMBOL(char_name)      \
   SymbolTable::new_symbol(char_name, (int)strlen(char_name), Thread::current())
 
+Symbol* JitWarmUpLogParser::create_loader_symbol(const char* loader_char) {
+  Symbol* loader_name = CREATE_SYMBOL(loader_char);
+  if (loader_name != _last_loader) {
+    _last_loader = loader_name;
+    _last_loader_no_suffix = PreloadJitInfo::remove_meaningless_suffix(loader_name);
+  }
+  return _last_loader_no_suffix;
+}
+
 bool JitWarmUpLogParser::parse_class_init_section() {
   ResourceMark rm;
   int begin_pos = _position;
@@ -1633,16 +1987,15 @@ bool JitWarmUpLogParser::parse_class_init_section() {
   chain->set_holder(this->info_holder());
 
   for (int i = 0; i < (int)cnt; i++) {
-    char* name_char = read_string();
+    const char* name_char = read_string();
     LOGPARSER_ILLEGAL_STRING_CHECK(name_char, false);
-    char* loader_char = read_string();
+    const char* loader_char = read_string();
     LOGPARSER_ILLEGAL_STRING_CHECK(loader_char, false);
-    char* path_char = read_string();
+    const char* path_char = read_string();
     LOGPARSER_ILLEGAL_STRING_CHECK(path_char, false);
     Symbol* name = CREATE_SYMBOL(name_char);
-    Symbol* loader_name = CREATE_SYMBOL(loader_char);
+    Symbol* loader_name = create_loader_symbol(loader_char);
     Symbol* path = CREATE_SYMBOL(path_char);
-    loader_name = PreloadJitInfo::remove_meaningless_suffix(loader_name);
     chain->at(i)->set_class_name(name);
     chain->at(i)->set_loader_name(loader_name);
     chain->at(i)->set_path(path);
@@ -1691,7 +2044,6 @@ bool JitWarmUpLogParser::has_next() {
 
 PreloadMethodHolder* JitWarmUpLogParser::next() {
   ResourceMark rm;
-  _fs->fseek(_position, SEEK_SET);
   int begin_pos = _position;
   u4 section_size = read_u4();
   int end_pos = begin_pos + section_size;
@@ -1706,10 +2058,10 @@ PreloadMethodHolder* JitWarmUpLogParser::next() {
     return NULL;
   }
   // method info
-  char* method_name_char = read_string();
+  const char* method_name_char = read_string();
   LOGPARSER_ILLEGAL_STRING_CHECK(method_name_char, NULL);
   Symbol* method_name = CREATE_SYMBOL(method_name_char);
-  char* method_sig_char = read_string();
+  const char* method_sig_char = read_string();
   LOGPARSER_ILLEGAL_STRING_CHECK(method_sig_char, NULL);
   Symbol* method_sig = CREATE_SYMBOL(method_sig_char);
   u4 first_invoke_init_order = read_u4();
@@ -1726,7 +2078,7 @@ PreloadMethodHolder* JitWarmUpLogParser::next() {
   }
 
   // class info
-  char* class_name_char = read_string();
+  const char* class_name_char = read_string();
   LOGPARSER_ILLEGAL_STRING_CHECK(class_name_char, NULL);
   Symbol* class_name = CREATE_SYMBOL(class_name_char);
   // ignore
@@ -1734,11 +2086,10 @@ PreloadMethodHolder* JitWarmUpLogParser::next() {
     _position = end_pos;
     return NULL;
   }
-  char* class_loader_char = read_string();
+  const char* class_loader_char = read_string();
   LOGPARSER_ILLEGAL_STRING_CHECK(class_loader_char, NULL);
-  Symbol* class_loader = CREATE_SYMBOL(class_loader_char);
-  class_loader = PreloadJitInfo::remove_meaningless_suffix(class_loader);
-  char* path_char = read_string();
+  Symbol* class_loader = create_loader_symbol(class_loader_char);
+  const char* path_char = read_string();
   LOGPARSER_ILLEGAL_STRING_CHECK(path_char, NULL);
   Symbol* path = CREATE_SYMBOL(path_char);
 
@@ -1776,6 +2127,12 @@ PreloadMethodHolder* JitWarmUpLogParser::next() {
   mh->set_hash(method_hash);
   mh->set_size(method_size);
 
+  if (!parse_method_data(mh, end_pos) || !parse_dependencies(mh, end_pos)) {
+    delete mh;
+    _position = end_pos;
+    return NULL;
+  }
+
   // add class init chain relation
   /*
   int method_chain_offset = static_cast<int>(first_invoke_init_order) >= class_chain_offset ? first_invoke_init_order
@@ -1788,6 +2145,80 @@ PreloadMethodHolder* JitWarmUpLogParser::next() {
   return mh;
 }
 
+bool JitWarmUpLogParser::parse_method_data(PreloadMethodHolder* mh, int end_pos) {
+  u4 md_invocation_count = read_u4();
+  u4 md_backedge_count = read_u4();
+  u4 record_count = read_u4();
+  LOGPARSER_ILLEGAL_COUNT_CHECK(record_count, false);
+  mh->set_md_invocation_count(md_invocation_count);
+  mh->set_md_backedge_count(md_backedge_count);
+
+  GrowableArray<MDRecordInfo*>* md_list = mh->md_list();
+  for (int i = 0; i < (int)record_count; i++) {
+    u4 bci = read_u4();
+    LOGPARSER_ILLEGAL_COUNT_CHECK(bci, false);
+    u1 tag = read_u1();
+    u1 flags = read_u1();
+    u4 cells = read_u4();
+    LOGPARSER_ILLEGAL_COUNT_CHECK(cells, false);
+    if (_position + (int)cells * 4 > end_pos) {
+      log_error(warmup)("[JitWarmUp] ERROR : read out of bound, file format error");
+      return false;
+    }
+    // owned by method holder from now on
+    MDRecordInfo* info = new MDRecordInfo((int)bci, tag, flags);
+    md_list->append(info);
+    for (int j = 0; j < (int)cells; j++) {
+      info->counts()->append((uint)read_u4());
+    }
+    u4 receiver_count = read_u4();
+    LOGPARSER_ILLEGAL_COUNT_CHECK(receiver_count, false);
+    for (int j = 0; j < (int)receiver_count; j++) {
+      const char* name_char = read_string();
+      LOGPARSER_ILLEGAL_STRING_CHECK(name_char, false);
+      const char* loader_char = read_string();
+      LOGPARSER_ILLEGAL_STRING_CHECK(loader_char, false);
+      const char* path_char = read_string();
+      LOGPARSER_ILLEGAL_STRING_CHECK(path_char, false);
+      Symbol* name = CREATE_SYMBOL(name_char);
+      Symbol* loader_name = create_loader_symbol(loader_char);
+      Symbol* path = CREATE_SYMBOL(path_char);
+      info->receivers()->append(ClassSymbolEntry(name, loader_name, path));
+      info->receiver_counts()->append((uint)read_u4());
+    }
+  }
+
+  return true;
+}
+
+bool JitWarmUpLogParser::parse_dependencies(PreloadMethodHolder* mh, int end_pos) {
+  u4 dep_count = read_u4();
+  LOGPARSER_ILLEGAL_COUNT_CHECK(dep_count, false);
+  GrowableArray<DependencyRecordInfo*>* dep_list = mh->dep_list();
+  for (int i = 0; i < (int)dep_count; i++) {
+    const char* name_char = read_string();
+    LOGPARSER_ILLEGAL_STRING_CHECK(name_char, false);
+    const char* loader_char = read_string();
+    LOGPARSER_ILLEGAL_STRING_CHECK(loader_char, false);
+    const char* path_char = read_string();
+    LOGPARSER_ILLEGAL_STRING_CHECK(path_char, false);
+    u4 class_size = read_u4();
+    u4 class_crc32 = read_u4();
+    Symbol* name = CREATE_SYMBOL(name_char);
+    Symbol* loader_name = create_loader_symbol(loader_char);
+    Symbol* path = CREATE_SYMBOL(path_char);
+    dep_list->append(new DependencyRecordInfo(name, loader_name, path,
+                                              class_size, class_crc32));
+  }
+
+  // dependencies are the last part of a method record
+  if (_position != end_pos) {
+    log_error(warmup)("[JitWarmUp] ERROR : method record parse error");
+    return false;
+  }
+  return true;
+}
+
 #undef MAX_SIZE_VALUE
 #undef MAX_COUNT_VALUE
 #undef LOGPARSER_ILLEGAL_STRING_CHECK
@@ -1851,6 +2282,165 @@ Symbol* PreloadJitInfo::remove_meaningless_suffix(Symbol* s) {
   return result;
 }
 
+static void restore_counter(InvocationCounter* counter, uint recorded) {
+  int count = (int)MIN2(recorded, (uint)InvocationCounter::count_limit - 1);
+  if (count > counter->count()) {
+    counter->set(counter->state(), count);
+  }
+}
+
+bool PreloadJitInfo::restore_method_data(PreloadMethodHolder* mh, methodHandle m, TRAPS) {
+  GrowableArray<MDRecordInfo*>* md_list = mh->md_list();
+  if (md_list == NULL || md_list->is_empty()) {
+    return false;
+  }
+  // recorded hash is computed on rewritten bytecodes, only size is comparable here
+  if ((int)mh->size() != m->code_size()) {
+    ResourceMark rm(THREAD);
+    log_warning(warmup)("[JitWarmUp] WARNING : bytecode size of %s changed, profile is not restored",
+                        m->name_and_sig_as_C_string());
+    return false;
+  }
+  MethodData* md = m->method_data();
+  if (md == NULL) {
+    Method::build_interpreter_method_data(m, THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      CLEAR_PENDING_EXCEPTION;
+      return false;
+    }
+    md = m->method_data();
+    if (md == NULL) {
+      return false;
+    }
+  }
+
+  ResourceMark rm(THREAD);
+  // check the layout of every record before touching the MethodData,
+  // a partially restored profile is worse than none
+  for (int i = 0; i < md_list->length(); i++) {
+    MDRecordInfo* info = md_list->at(i);
+    ProfileData* data = md->bci_to_data(info->bci());
+    if (data == NULL || data->bci() != info->bci() ||
+        data->data()->tag() != info->tag() ||
+        profile_count_cells(data) != info->counts()->length()) {
+      log_debug(warmup)("[JitWarmUp] profile layout of %s mismatch at bci %d, profile is not restored",
+                        m->name_and_sig_as_C_string(), info->bci());
+      return false;
+    }
+  }
+
+  for (int i = 0; i < md_list->length(); i++) {
+    MDRecordInfo* info = md_list->at(i);
+    ProfileData* data = md->bci_to_data(info->bci());
+    for (int j = 0; j < info->counts()->length(); j++) {
+      set_profile_count_at(data, j, saturated_add(profile_count_at(data, j), info->counts()->at(j)));
+    }
+    for (int f = 0; f < DataLayout::flag_limit; f++) {
+      if ((info->flags() & (1 << f)) != 0) {
+        data->set_flag_at(f);
+      }
+    }
+    int trap_state = (info->flags() >> DataLayout::trap_shift) & DataLayout::trap_mask;
+    if (trap_state != 0 && data->trap_state() == 0) {
+      data->set_trap_state(trap_state);
+    }
+    if (!data->is_ReceiverTypeData()) {
+      continue;
+    }
+    ReceiverTypeData* rtd = data->as_ReceiverTypeData();
+    for (int j = 0; j < info->receivers()->length(); j++) {
+      uint count = info->receiver_counts()->at(j);
+      Klass* k = resolve_recorded_klass(info->receivers()->at(j), m());
+      uint row = ReceiverTypeData::row_limit();
+      if (k != NULL) {
+        uint empty_row = ReceiverTypeData::row_limit();
+        for (uint r = 0; r < ReceiverTypeData::row_limit(); r++) {
+          Klass* receiver = rtd->receiver(r);
+          if (receiver == k) {
+            row = r;
+            break;
+          } else if (receiver == NULL && empty_row == ReceiverTypeData::row_limit()) {
+            empty_row = r;
+          }
+        }
+        if (row == ReceiverTypeData::row_limit() && empty_row != ReceiverTypeData::row_limit()) {
+          row = empty_row;
+          rtd->set_receiver(row, k);
+          rtd->set_receiver_count(row, 0);
+        }
+      }
+      if (row != ReceiverTypeData::row_limit()) {
+        rtd->set_receiver_count(row, saturated_add(rtd->receiver_count(row), count));
+      } else {
+        // unresolved or overflowed receivers make the site polymorphic
+        rtd->set_count(saturated_add(rtd->count(), count));
+      }
+    }
+  }
+
+  restore_counter(md->invocation_counter(), mh->md_invocation_count());
+  restore_counter(md->backedge_counter(), mh->md_backedge_count());
+
+  log_info(warmup)("[JitWarmUp] restored %d profile records of method %s",
+                   md_list->length(), m->name_and_sig_as_C_string());
+  return true;
+}
+
+bool PreloadJitInfo::validate_dependencies(PreloadMethodHolder* mh, Method* m) {
+  GrowableArray<DependencyRecordInfo*>* dep_list = mh->dep_list();
+  for (int i = 0; i < dep_list->length(); i++) {
+    DependencyRecordInfo* info = dep_list->at(i);
+    Klass* k = resolve_recorded_klass(info->klass(), m);
+    // a class not loaded yet can not invalidate anything
+    if (k == NULL || !k->oop_is_instance()) {
+      continue;
+    }
+    InstanceKlass* ik = InstanceKlass::cast(k);
+    // fingerprint is unknown for classes from shared archive
+    if (ik->crc32() == 0 || info->crc32() == 0) {
+      continue;
+    }
+    if (ik->bytes_size() != info->size() || ik->crc32() != info->crc32()) {
+      ResourceMark rm;
+      log_info(warmup)("[JitWarmUp] class %s changed since recording, "
+                       "method %s is left to normal compilation",
+                       ik->external_name(), m->name_and_sig_as_C_string());
+      return false;
+    }
+  }
+  return true;
+}
+
+Klass* PreloadJitInfo::resolve_recorded_klass(const ClassSymbolEntry& entry, Method* m) {
+  Symbol* name = entry.class_name();
+  Symbol* loader_name = entry.class_loader_name();
+  PreloadClassEntry* e = dict()->find_entry(name->identity_hash(), name,
+                                            loader_name, entry.path());
+  if (e != NULL && e->chain_offset() >= 0) {
+    MutexLockerEx mu(PreloadClassChain_lock);
+    GrowableArray<InstanceKlass*>* klasses = chain()->at(e->chain_offset())->resolved_klasses();
+    if (!klasses->is_empty()) {
+      return klasses->at(0);
+    }
+  }
+  // array classes and classes out of the init section are found by
+  // the loader of method holder
+  Thread* THREAD = Thread::current();
+  InstanceKlass* holder = m->method_holder();
+  Handle loader(THREAD, holder->class_loader());
+  Handle protection_domain(THREAD, holder->protection_domain());
+  Klass* k = SystemDictionary::find_instance_or_array_klass(name, loader, protection_domain, THREAD);
+  if (HAS_PENDING_EXCEPTION) {
+    CLEAR_PENDING_EXCEPTION;
+    return NULL;
+  }
+  if (k != NULL &&
+      JitWarmUp::get_class_loader_name(k->class_loader_data())->fast_compare(loader_name) != 0) {
+    return NULL;
+  }
+  return k;
+}
+
 void PreloadJitInfo::jvm_booted_is_done() {
   _jvm_booted_is_done = true;
   PreloadClassChain* chain = this->chain();
@@ -1887,6 +2477,18 @@ void PreloadClassChain::eager_load_class_in_constantpool() {
   } // end of while
 }
 
+static void post_replay_event(EventJWarmUpReplay& event, const char* phase,
+                              PreloadClassChain* chain) {
+  if (event.should_commit()) {
+    event.set_phase(phase);
+    event.set_scheduledMethods((u4)chain->scheduled_count());
+    event.set_submittedMethods((u4)chain->submitted_count());
+    event.set_skippedMethods((u4)chain->skipped_count());
+    event.set_throttledTime(chain->throttled_millis());
+    event.commit();
+  }
+}
+
 void PreloadJitInfo::notify_application_startup_is_done() {
   PreloadClassChain *chain = this->chain();
   assert(chain != NULL, "PreloadClassChain is NULL");
@@ -1894,16 +2496,30 @@ void PreloadJitInfo::notify_application_startup_is_done() {
 
   // 1st, eager load classes, do eager initialize just once
   log_info(warmup)("JitWarmUp [INFO]: start eager loading classes from constant pool");
-  chain->eager_load_class_in_constantpool();
+  {
+    EventJWarmUpReplay event;
+    chain->eager_load_class_in_constantpool();
+    post_replay_event(event, "eager class loading", chain);
+  }
 
   // 2nd, warmup compilation
   log_info(warmup)("JitWarmUp [INFO]: start warmup compilation");
-  chain->warmup_impl();
+  {
+    EventJWarmUpReplay event;
+    chain->warmup_impl();
+    post_replay_event(event, "warmup compilation", chain);
+  }
   Thread *THREAD = Thread::current();
   // if exception occurs in warmup compilation, return and throw
   if (HAS_PENDING_EXCEPTION) {
     return;
   }
+  {
+    ResourceMark rm;
+    stringStream ss;
+    chain->print_progress_on(&ss);
+    log_info(warmup)("JitWarmUp [INFO]: warmup compilation submitted\n%s", ss.as_string());
+  }
 
   // 3rd, commit dummy method for compilation, check dummy method to know warmup compilation is completed
   JitWarmUp *jwp = this->holder();
@@ -1965,19 +2581,54 @@ bool PreloadJitInfo::resolve_loaded_klass(InstanceKlass* k) {
   return true;
 }
 
-class RandomFileStreamGuard : StackObj {
+// Image of the log file: mapped read only, or read into the C heap when
+// the file cannot be mapped. Released when parsing is done, the parsed
+// information does not point into it.
+class JitWarmUpLogImage : StackObj {
 public:
-  RandomFileStreamGuard(randomAccessFileStream* fs)
-    : _fs(fs) {
+  JitWarmUpLogImage(const char* path)
+    : _image(NULL),
+      _size(0),
+      _is_mapped(false) {
+    int fd = os::open(path, O_RDONLY | O_BINARY, 0);
+    if (fd < 0) {
+      return;
+    }
+    struct stat st;
+    if (os::stat(path, &st) == 0 && st.st_size > 0) {
+      _size = (long)st.st_size;
+      _image = os::map_memory(fd, path, 0, NULL, (size_t)_size, true, false);
+      if (_image != NULL) {
+        _is_mapped = true;
+      } else {
+        char* buf = NEW_C_HEAP_ARRAY(char, _size, mtInternal);
+        if (os::read(fd, buf, (unsigned int)_size) == (size_t)_size) {
+          _image = buf;
+        } else {
+          FREE_C_HEAP_ARRAY(char, buf, mtInternal);
+        }
+      }
+    }
+    os::close(fd);
   }
 
-  ~RandomFileStreamGuard() { delete _fs; }
+  ~JitWarmUpLogImage() {
+    if (_is_mapped) {
+      os::unmap_memory(_image, (size_t)_size);
+    } else if (_image != NULL) {
+      FREE_C_HEAP_ARRAY(char, _image, mtInternal);
+    }
+  }
 
-  randomAccessFileStream* operator ->() const { return _fs; }
-  randomAccessFileStream* operator ()() const { return _fs; }
+  bool        is_open()   const { return _image != NULL; }
+  bool        is_mapped() const { return _is_mapped; }
+  const char* image()     const { return _image; }
+  long        size()      const { return _size; }
 
 private:
-  randomAccessFileStream*  _fs;
+  char* _image;
+  long  _size;
+  bool  _is_mapped;
 };
 
 void PreloadJitInfo::init() {
@@ -2002,15 +2653,14 @@ void PreloadJitInfo::init() {
     return;
   }
 
-  RandomFileStreamGuard fsg(new (ResourceObj::C_HEAP, mtInternal) randomAccessFileStream(
-                                 CompilationWarmUpLogfile, "rb+"));
-  JitWarmUpLogParser parser(fsg(), this);
-  if (!fsg->is_open()) {
+  jlong start = os::javaTimeMillis();
+  JitWarmUpLogImage log_image(CompilationWarmUpLogfile);
+  if (!log_image.is_open()) {
     log_error(warmup)("[JitWarmUp] ERROR : log file %s doesn't exist", CompilationWarmUpLogfile);
     _state = IS_ERR;
     return;
   }
-  parser.set_file_size(fsg->fileSize());
+  JitWarmUpLogParser parser(log_image.image(), log_image.size(), this);
   // parse header section
   if (!parser.parse_header()) {
     // not valid log file format
@@ -2031,4 +2681,8 @@ void PreloadJitInfo::init() {
     }
     parser.inc_parsed_number();
   }
+  log_debug(warmup)("[JitWarmUp] DEBUG : parsed " UINT64_FORMAT " of %d methods from %s (%s) in "
+                    JLONG_FORMAT " ms", _loaded_count, parser.total_methods(),
+                    CompilationWarmUpLogfile, log_image.is_mapped() ? "mapped" : "read",
+                    os::javaTimeMillis() - start);
 }
@@ -42,6 +42,8 @@
 
 // forward
 class ProfileRecorder;
+class nmethod;
+class CPUPerformanceInterface;
 class PreloadJitInfo;
 
 #define INVALID_FIRST_INVOKE_INIT_ORDER -1
@@ -115,6 +117,7 @@ public:
   void init() {
     _is_deopted = false;
     _bci = InvocationEntryBci;
+    _dependencies = NULL;
   }
 
   void set_bci(int bci) { _bci = bci; }
@@ -123,6 +126,9 @@ public:
   void set_order(int order) { _order = order; }
   int  order()              { return _order; }
 
+  GrowableArray<InstanceKlass*>* dependencies()  { return _dependencies; }
+  void set_dependencies(GrowableArray<InstanceKlass*>* deps) { _dependencies = deps; }
+
   ProfileRecorderEntry* next() {
     return (ProfileRecorderEntry*)HashtableEntry<Method*, mtInternal>::next();
   }
@@ -133,6 +139,8 @@ private:
                       // InvocationEntryBci means standard compilation
                       // other means OSR compilation
   int    _order;      // compilation order
+  // context classes of the dependencies of the last recorded nmethod
+  GrowableArray<InstanceKlass*>* _dependencies;
 };
 
 // a hash table stores compiled method
@@ -190,10 +198,28 @@ public:
       _path(NULL) {
   }
 
+  // entries are copied by value into LinkedList and GrowableArray,
+  // keep the symbol refcounts balanced
+  ClassSymbolEntry(const ClassSymbolEntry& rhs)
+    : _class_name(rhs._class_name),
+      _class_loader_name(rhs._class_loader_name),
+      _path(rhs._path) {
+    increment_refcounts();
+  }
+
+  ClassSymbolEntry& operator=(const ClassSymbolEntry& rhs) {
+    if (this != &rhs) {
+      decrement_refcounts();
+      _class_name = rhs._class_name;
+      _class_loader_name = rhs._class_loader_name;
+      _path = rhs._path;
+      increment_refcounts();
+    }
+    return *this;
+  }
+
   ~ClassSymbolEntry() {
-    if (_class_name != NULL) _class_name->decrement_refcount();
-    if (_class_loader_name != NULL) _class_loader_name->decrement_refcount();
-    if (_path != NULL) _path->decrement_refcount();
+    decrement_refcounts();
   }
 
   Symbol* class_name() const { return _class_name; }
@@ -204,6 +230,19 @@ public:
   bool equals(const ClassSymbolEntry& rhs) const {
     return _class_name == rhs._class_name;
   }
+
+private:
+  void increment_refcounts() {
+    if (_class_name != NULL) _class_name->increment_refcount();
+    if (_class_loader_name != NULL) _class_loader_name->increment_refcount();
+    if (_path != NULL) _path->increment_refcount();
+  }
+
+  void decrement_refcounts() {
+    if (_class_name != NULL) _class_name->decrement_refcount();
+    if (_class_loader_name != NULL) _class_loader_name->decrement_refcount();
+    if (_path != NULL) _path->decrement_refcount();
+  }
 };
 
 // Profiling data collection
@@ -232,8 +271,8 @@ public:
 
   int class_init_count()                   { return _class_init_order_count + 1; }
 
-  // add a method into recorder
-  void add_method(Method* method, int bci);
+  // add a method into recorder, nm is the nmethod just installed
+  void add_method(Method* method, int bci, nmethod* nm);
   // remove a method from recorder
   void remove_method(Method* method);
 
@@ -287,7 +326,12 @@ private:
   // flush section
   void write_header();
   void write_inited_class();
-  void write_record(Method* method, int bci, int order);
+  void write_record(Method* method, int bci, int order,
+                    GrowableArray<InstanceKlass*>* deps);
+  void write_method_data(Method* method);
+  void write_class_symbols(Klass* klass);
+  void write_dependencies(GrowableArray<InstanceKlass*>* deps);
+  void record_dependencies(ProfileRecorderEntry* entry, nmethod* nm);
   void write_footer();
 
   void write_u1(u1 value);
@@ -310,12 +354,62 @@ class ProfileRecorder;
 class PreloadClassHolder;
 
 // a MDRecordInfo corresponds a ProfileData per bci (see oops/methodData.hpp)
-// NYI about details
+// counters are kept in the order ProfileRecorder writes them, receiver
+// klasses are kept as symbols and resolved when the profile is restored
 class MDRecordInfo : public CHeapObj<mtInternal> {
 public:
-  // empty class
-  MDRecordInfo() {  }
-  ~MDRecordInfo() {  }
+  MDRecordInfo(int bci, u1 tag, u1 flags)
+    : _bci(bci),
+      _tag(tag),
+      _flags(flags),
+      _counts(new (ResourceObj::C_HEAP, mtClass)
+              GrowableArray<uint>(4, true, mtClass)),
+      _receivers(new (ResourceObj::C_HEAP, mtClass)
+                 GrowableArray<ClassSymbolEntry>(2, true, mtClass)),
+      _receiver_counts(new (ResourceObj::C_HEAP, mtClass)
+                       GrowableArray<uint>(2, true, mtClass)) {  }
+
+  ~MDRecordInfo() {
+    delete _counts;
+    delete _receivers;
+    delete _receiver_counts;
+  }
+
+  int bci()   const { return _bci; }
+  u1  tag()   const { return _tag; }
+  u1  flags() const { return _flags; }
+
+  GrowableArray<uint>*             counts()          const { return _counts; }
+  GrowableArray<ClassSymbolEntry>* receivers()       const { return _receivers; }
+  GrowableArray<uint>*             receiver_counts() const { return _receiver_counts; }
+
+private:
+  int                               _bci;
+  u1                                _tag;      // DataLayout tag
+  u1                                _flags;    // DataLayout flags, including trap state
+  GrowableArray<uint>*              _counts;
+  GrowableArray<ClassSymbolEntry>*  _receivers;
+  GrowableArray<uint>*              _receiver_counts;
+};
+
+// a DependencyRecordInfo is a context class of a dependency of the recorded
+// nmethod, identified by its symbols and the fingerprint of its class file
+class DependencyRecordInfo : public CHeapObj<mtInternal> {
+public:
+  DependencyRecordInfo(Symbol* name, Symbol* loader_name, Symbol* path,
+                       unsigned int size, unsigned int crc32)
+    : _klass(name, loader_name, path),
+      _size(size),
+      _crc32(crc32) {  }
+
+  const ClassSymbolEntry& klass() const { return _klass; }
+  unsigned int size()             const { return _size; }
+  unsigned int crc32()            const { return _crc32; }
+
+private:
+  ClassSymbolEntry _klass;
+  unsigned int     _size;   // class file size
+  unsigned int     _crc32;  // class file crc32
 };
 
 // a method holder corresponds a method and its profile information
@@ -339,6 +433,12 @@ public:
   void set_invocation_count(unsigned int value)      { _invocation_count = value; }
   void set_backage_count(unsigned int value)         { _backage_count = value; }
 
+  // counters of the recorded MethodData
+  unsigned int md_invocation_count() const           { return _md_invocation_count; }
+  unsigned int md_backedge_count()   const           { return _md_backedge_count; }
+  void set_md_invocation_count(unsigned int value)   { _md_invocation_count = value; }
+  void set_md_backedge_count(unsigned int value)     { _md_backedge_count = value; }
+
   unsigned int hash()            const { return _hash; }
   unsigned int size()            const { return _size; }
   int          bci()             const { return _bci; }
@@ -364,6 +464,8 @@ public:
   GrowableArray<MDRecordInfo*>* md_list()         const { return _md_list; }
   void set_md_list(GrowableArray<MDRecordInfo*>* value) { _md_list = value; }
 
+  GrowableArray<DependencyRecordInfo*>* dep_list() const { return _dep_list; }
+
   PreloadMethodHolder* clone_and_add();
 
   // whether the resolved method is alive
@@ -383,9 +485,12 @@ private:
   unsigned int _invocation_count;
   unsigned int _backage_count;
 
+  unsigned int _md_invocation_count;
+  unsigned int _md_backedge_count;
+
   int          _mounted_offset;
 
-  // whether md_list array is owned by this
+  // whether md_list and dep_list arrays are owned by this
   bool         _owns_md_list;
 
   // whether resolved method has been deoptimized by JitWarmUp
@@ -397,6 +502,8 @@ private:
   Method*                        _resolved_method;
   // profile info array, shared between same PreloadMethodHolder
   GrowableArray<MDRecordInfo*>*  _md_list;
+  // dependencies of the recorded nmethod, shared like _md_list
+  GrowableArray<DependencyRecordInfo*>* _dep_list;
 };
 
 // a class holder corresponds a java class
@@ -716,6 +823,7 @@ public:
   };
   bool state_trans_to(ClassChainState new_state);
   ClassChainState current_state() { return _state; }
+  static const char* state_name(ClassChainState state);
 
   int  inited_index()        const { return _inited_index; }
   int  loaded_index()        const { return _loaded_index; }
@@ -770,6 +878,13 @@ public:
   // a PreloadMethodHolder represents a java method
   bool compile_methodholder(PreloadMethodHolder* mh);
 
+  // warmup compilation progress
+  int   scheduled_count()  const { return _scheduled_count; }
+  int   submitted_count()  const { return _submitted_count; }
+  int   skipped_count()    const { return _skipped_count; }
+  jlong throttled_millis() const { return _throttled_millis; }
+  void  print_progress_on(outputStream* st);
+
   // fix InstanceKlass* and Method* pointer during metaspace gc
   void do_unloading(BoolObjectClosure* is_alive);
 
@@ -815,7 +930,23 @@ private:
 
   bool                  _has_unmarked_compiling_flag;
 
+  // warmup compilation progress
+  volatile int          _scheduled_count;
+  volatile int          _submitted_count;
+  volatile int          _skipped_count;
+  volatile jlong        _throttled_millis;
+  // sampling cpu load for throttling, created on first use
+  CPUPerformanceInterface* _cpu_perf;
+
   void compile_methodholders_queue(Stack<PreloadMethodHolder*, mtInternal>& compile_queue);
+  // submit methods collected from the whole chain, hottest first
+  void compile_scheduled_methodholders(GrowableArray<PreloadMethodHolder*>* methods);
+  // submit a method after throttling, update progress counters
+  void submit_methodholder(PreloadMethodHolder* mh);
+  // wait while the C2 queue or the cpu is too busy for warmup compilation
+  void throttle_submission();
+  bool should_throttle();
+
 
   // update _loaded_index
   void update_loaded_index(int index);
@@ -864,7 +995,18 @@ public:
   // remove known meaningless suffix
   static Symbol* remove_meaningless_suffix(Symbol* s);
 
+  // merge the recorded profile into the MethodData of the method,
+  // must be called before the method is submitted for compilation
+  bool restore_method_data(PreloadMethodHolder* mh, methodHandle m, TRAPS);
+
+  // check the classes the recorded nmethod depended on are not changed,
+  // otherwise the method is left to normal compilation
+  bool validate_dependencies(PreloadMethodHolder* mh, Method* m);
+
 private:
+  // find a loaded klass by the symbols recorded in log file
+  Klass* resolve_recorded_klass(const ClassSymbolEntry& entry, Method* m);
+
   PreloadClassDictionary*  _dict;
   PreloadClassChain*       _chain;
   uint64_t                 _loaded_count; // methods parsed from JitWarmUp log file
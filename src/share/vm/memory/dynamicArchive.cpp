@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classLoaderData.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionaryShared.hpp"
+#include "memory/dynamicArchive.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "runtime/arguments.hpp"
+#include "runtime/globals_extension.hpp"
+#include "runtime/os.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/resourceHash.hpp"
+
+// Same limit as the class list parser in MetaspaceShared::preload_and_dump()
+static const int max_class_name = 256;
+
+typedef ResourceHashtable<Symbol*, bool, primitive_hash<Symbol*>,
+                          primitive_equals<Symbol*>, 1024> ClassNameSet;
+
+// Collects the names of the loaded classes which could be archived and
+// which are neither in the archive nor in the recorded class list.
+class RecordClassesClosure : public CLDClosure {
+  class RecordKlassClosure : public KlassClosure {
+    ClassNameSet* _recorded;
+    GrowableArray<Symbol*>* _names;
+   public:
+    RecordKlassClosure(ClassNameSet* recorded, GrowableArray<Symbol*>* names) :
+      _recorded(recorded), _names(names) {}
+
+    void do_klass(Klass* k) {
+      if (!k->oop_is_instance() || k->is_shared()) {
+        return;
+      }
+      InstanceKlass* ik = InstanceKlass::cast(k);
+      if (!ik->is_loaded() || ik->is_anonymous()) {
+        return;
+      }
+      Symbol* name = ik->name();
+      if (name->utf8_length() < max_class_name && !_recorded->contains(name)) {
+        _recorded->put(name, true);
+        _names->append(name);
+      }
+    }
+  };
+
+  class CountKlassClosure : public KlassClosure {
+    int _count;
+   public:
+    CountKlassClosure() : _count(0) {}
+    void do_klass(Klass* k) { _count++; }
+    int count() const       { return _count; }
+  };
+
+  RecordKlassClosure _klass_closure;
+  CountKlassClosure  _skipped_closure;
+ public:
+  RecordClassesClosure(ClassNameSet* recorded, GrowableArray<Symbol*>* names) :
+    _klass_closure(recorded, names) {}
+
+  void do_cld(ClassLoaderData* cld) {
+    if (cld->is_anonymous()) {
+      return;
+    }
+    if (SystemDictionaryShared::is_sharing_possible(cld)) {
+      cld->classes_do(&_klass_closure);
+    } else {
+      cld->classes_do(&_skipped_closure);
+    }
+  }
+
+  // Classes of loaders this tree's CDS cannot archive
+  int skipped() const { return _skipped_closure.count(); }
+};
+
+bool DynamicArchive::_archive_mismatch = false;
+
+// Reads the class list written by an earlier run. Returns false if there
+// is none.
+static bool read_class_list(const char* path, GrowableArray<char*>* lines,
+                            ClassNameSet* recorded) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  char class_name[max_class_name];
+  while (fgets(class_name, sizeof class_name, file) != NULL) {
+    size_t name_len = strlen(class_name);
+    if (name_len > 0 && class_name[name_len-1] == '\n') {
+      class_name[--name_len] = '\0';
+    } else if (!feof(file)) {
+      // Skip a line which is too long for the dump time parser as well
+      int c;
+      while ((c = fgetc(file)) != EOF && c != '\n') {}
+      continue;
+    }
+    if (name_len == 0 || *class_name == '#') {
+      continue;
+    }
+    char* line = NEW_RESOURCE_ARRAY(char, name_len + 1);
+    strcpy(line, class_name);
+    lines->append(line);
+    Symbol* name = SymbolTable::probe(class_name, (int)name_len);
+    if (name != NULL) {
+      recorded->put(name, true);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+// Writes the class list to tmp_path and renames it to path, so that a
+// concurrent dump never reads a partial list.
+static bool write_class_list(const char* path, const char* tmp_path,
+                             GrowableArray<char*>* lines, GrowableArray<Symbol*>* names) {
+  FILE* file = fopen(tmp_path, "w");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "# Classes recorded by -XX:ArchiveClassesAtExit\n");
+  for (int i = 0; i < lines->length(); i++) {
+    fprintf(file, "%s\n", lines->at(i));
+  }
+  // The class loader data lists the newest classes first
+  for (int i = names->length() - 1; i >= 0; i--) {
+    fprintf(file, "%s\n", names->at(i)->as_C_string());
+  }
+  if (fclose(file) != 0 || rename(tmp_path, path) != 0) {
+    remove(tmp_path);
+    return false;
+  }
+  return true;
+}
+
+static char* option(const char* name, const char* value) {
+  size_t len = strlen(name) + strlen(value) + 1;
+  char* opt = NEW_RESOURCE_ARRAY(char, len);
+  jio_snprintf(opt, len, "%s%s", name, value);
+  return opt;
+}
+
+// Starts -Xshare:dump in a child VM with the same boot class path and the
+// options which have to match between dump time and run time. The child
+// dumps to tmp_path and renames it to the archive once it is complete
+// (see publish_dumped_archive()). It is not waited for.
+static bool start_dump(const char* archive_path, const char* tmp_path, const char* list_path) {
+  const char* sep = os::file_separator();
+  size_t java_len = strlen(Arguments::get_java_home()) + 16;
+  char* java = NEW_RESOURCE_ARRAY(char, java_len);
+  jio_snprintf(java, java_len, "%s%sbin%sjava", Arguments::get_java_home(), sep, sep);
+  char buffer[32];
+  GrowableArray<char*> args;
+  args.append(java);
+  args.append((char*)"-Xshare:dump");
+  args.append((char*)"-XX:+UnlockDiagnosticVMOptions");
+  if (!PrintSharedSpaces) {
+    args.append((char*)"-XX:-DisplayVMOutput");
+  } else {
+    args.append((char*)"-XX:+PrintSharedSpaces");
+  }
+  args.append(option("-Xbootclasspath:", Arguments::get_sysclasspath()));
+  args.append(option("-XX:SharedArchiveFile=", tmp_path));
+  args.append(option("-XX:ArchiveClassesAtExit=", archive_path));
+  if (SharedClassListFile != NULL) {
+    args.append(option("-XX:SharedClassListFile=", SharedClassListFile));
+  }
+  args.append(option("-XX:ExtraSharedClassListFile=", list_path));
+  jio_snprintf(buffer, sizeof buffer, UINTX_FORMAT, SharedBaseAddress);
+  args.append(option("-XX:SharedBaseAddress=", buffer));
+#ifdef _LP64
+  jio_snprintf(buffer, sizeof buffer, INTX_FORMAT, ObjectAlignmentInBytes);
+  args.append(option("-XX:ObjectAlignmentInBytes=", buffer));
+#endif
+  if (ArchiveInternedStrings) {
+    args.append((char*)"-XX:+ArchiveInternedStrings");
+  }
+  if (PrintSharedSpaces) {
+    tty->print("Dynamic archive:");
+    for (int i = 0; i < args.length(); i++) {
+      tty->print_raw(" ");
+      tty->print_raw(args.at(i));
+    }
+    tty->cr();
+  }
+  args.append(NULL);
+  return os::spawn_detached(java, args.adr_at(0), PrintSharedSpaces) == 0;
+}
+
+void DynamicArchive::initialize_flags() {
+  if (ArchiveClassesAtExit == NULL || DumpSharedSpaces) {
+    return;
+  }
+  // Use the archive of the previous runs, as with -Xshare:auto
+  if (FLAG_IS_DEFAULT(SharedArchiveFile)) {
+    FLAG_SET_ERGO(ccstr, SharedArchiveFile, ArchiveClassesAtExit);
+  }
+  if (FLAG_IS_DEFAULT(UseSharedSpaces)) {
+    FLAG_SET_ERGO(bool, UseSharedSpaces, true);
+  }
+}
+
+void DynamicArchive::dump_at_exit(JavaThread* thread) {
+  if (ArchiveClassesAtExit == NULL || DumpSharedSpaces) {
+    return;
+  }
+#ifdef _LP64
+  if (!UseCompressedOops || !UseCompressedClassPointers) {
+    // This configuration cannot use any archive
+    return;
+  }
+#endif
+  ResourceMark rm(thread);
+  const char* archive_path = ArchiveClassesAtExit;
+  size_t path_len = strlen(archive_path) + 48;
+  char* list_path = NEW_RESOURCE_ARRAY(char, path_len);
+  char* tmp_list_path = NEW_RESOURCE_ARRAY(char, path_len);
+  char* tmp_path = NEW_RESOURCE_ARRAY(char, path_len);
+  jio_snprintf(list_path, path_len, "%s.classlist", archive_path);
+  jio_snprintf(tmp_list_path, path_len, "%s.classlist.%d.tmp", archive_path, os::current_process_id());
+  jio_snprintf(tmp_path, path_len, "%s.%d.tmp", archive_path, os::current_process_id());
+
+  ClassNameSet* recorded = new ClassNameSet();
+  GrowableArray<char*>* lines = new GrowableArray<char*>();
+  GrowableArray<Symbol*>* names = new GrowableArray<Symbol*>();
+  read_class_list(list_path, lines, recorded);
+  RecordClassesClosure rc(recorded, names);
+  ClassLoaderDataGraph::cld_do(&rc);
+  if (PrintSharedSpaces && rc.skipped() > 0) {
+    tty->print_cr("Dynamic archive: %d classes of other loaders than the boot loader "
+                  "are not archived", rc.skipped());
+  }
+
+  // Without new classes, only dump if the archive is missing or does not
+  // match this VM. An archive which is fine but could not be mapped, for
+  // example because its address range is in use, is not dumped again.
+  if (names->is_empty()) {
+    bool archive_used = UseSharedSpaces && SharedArchiveFile != NULL &&
+                        strcmp(SharedArchiveFile, archive_path) == 0;
+    struct stat st;
+    if (archive_used ||
+        (!_archive_mismatch && os::stat(archive_path, &st) == 0)) {
+      if (PrintSharedSpaces) {
+        tty->print_cr("Dynamic archive: %s is up to date", archive_path);
+      }
+      return;
+    }
+  }
+  if (PrintSharedSpaces) {
+    tty->print_cr("Dynamic archive: %d classes recorded, %d new, dumping %s",
+                  lines->length() + names->length(), names->length(), archive_path);
+  }
+  if (!write_class_list(list_path, tmp_list_path, lines, names)) {
+    warning("Cannot write the class list %s", list_path);
+    return;
+  }
+  if (!start_dump(archive_path, tmp_path, list_path)) {
+    warning("Cannot start dumping the shared archive %s", archive_path);
+  }
+}
+
+void DynamicArchive::publish_dumped_archive() {
+  if (ArchiveClassesAtExit == NULL || !DumpSharedSpaces) {
+    return;
+  }
+  const char* tmp_path = Arguments::GetSharedArchivePath();
+  if (rename(tmp_path, ArchiveClassesAtExit) != 0) {
+    warning("Cannot replace the shared archive %s", ArchiveClassesAtExit);
+    remove(tmp_path);
+    return;
+  }
+  if (PrintSharedSpaces) {
+    tty->print_cr("Dynamic archive: dumped %s", ArchiveClassesAtExit);
+  }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_MEMORY_DYNAMICARCHIVE_HPP
+#define SHARE_VM_MEMORY_DYNAMICARCHIVE_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/macros.hpp"
+
+class JavaThread;
+
+// Archive of the classes used by an application (-XX:ArchiveClassesAtExit).
+//
+// The option names an archive that the VM both uses and maintains: at
+// startup the archive is mapped like -XX:SharedArchiveFile, if it exists
+// and matches. At exit the VM records the loaded classes which the archive
+// can hold and which are not in it yet, and merges them into the class
+// list kept next to the archive ("<archive>.classlist"). It then starts a
+// child VM which regenerates the whole archive with the usual -Xshare:dump,
+// the recorded list being dumped on top of the default class list, and
+// does not wait for it. The child replaces the archive by rename once the
+// dump is complete, so running VMs keep their mapping.
+//
+// Only boot loader classes are recorded: this tree's CDS cannot archive
+// classes of other loaders (see SystemDictionaryShared::is_sharing_possible),
+// nor add a layer on top of an existing archive.
+class DynamicArchive : AllStatic {
+  static bool _archive_mismatch;
+ public:
+  // Called once the arguments are parsed: use the archive if it exists.
+  static void initialize_flags() NOT_CDS_RETURN;
+  // Called when the header of the archive does not match this VM, so that
+  // the archive is regenerated even if no new class is loaded.
+  static void set_archive_mismatch() { _archive_mismatch = true; }
+  // Called from before_exit(): record the classes and dump if needed.
+  static void dump_at_exit(JavaThread* thread) NOT_CDS_RETURN;
+  // Called by the dumping child VM once the archive has been written.
+  static void publish_dumped_archive() NOT_CDS_RETURN;
+};
+
+#endif // SHARE_VM_MEMORY_DYNAMICARCHIVE_HPP
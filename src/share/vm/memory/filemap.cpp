@@ -28,6 +28,7 @@
 #include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionaryShared.hpp"
 #include "classfile/altHashing.hpp"
+#include "memory/dynamicArchive.hpp"
 #include "memory/filemap.hpp"
 #include "memory/metadataFactory.hpp"
 #include "memory/oopFactory.hpp"
@@ -164,6 +165,10 @@ void FileMapInfo::FileMapHeader::populate(FileMapInfo* mapinfo, size_t alignment
   _version = _current_version;
   _alignment = alignment;
   _obj_alignment = ObjectAlignmentInBytes;
+  _narrow_oop_base = Universe::narrow_oop_base();
+  _narrow_oop_shift = Universe::narrow_oop_shift();
+  _narrow_klass_base = Universe::narrow_klass_base();
+  _narrow_klass_shift = Universe::narrow_klass_shift();
   _classpath_entry_table_size = mapinfo->_classpath_entry_table_size;
   _classpath_entry_table = mapinfo->_classpath_entry_table;
   _classpath_entry_size = mapinfo->_classpath_entry_size;
@@ -336,6 +341,12 @@ bool FileMapInfo::init_from_file(int fd) {
     fail_continue("The shared archive file has been truncated.");
     return false;
   }
+  si = &_header->_heap_space;
+  if (si->_used > 0 &&
+      (si->_file_offset >= len || len - si->_file_offset < si->_used)) {
+    fail_continue("The shared archive file has been truncated.");
+    return false;
+  }
 
   _file_offset += (long)n;
   return true;
@@ -442,6 +453,33 @@ void FileMapInfo::write_region(int region, char* base, size_t size,
 }
 
 
+// Dump the archived heap objects to file. They are laid out in buffer
+// as if they were at requested_base in the Java heap.
+
+void FileMapInfo::write_heap_region(char* buffer, size_t size, char* requested_base) {
+  struct FileMapInfo::FileMapHeader::space_info* si = &_header->_heap_space;
+
+  if (_file_open) {
+    guarantee(si->_file_offset == _file_offset, "file offset mismatch.");
+    if (PrintSharedSpaces) {
+      tty->print_cr("Shared file heap region: 0x%6x bytes, addr " INTPTR_FORMAT
+                    " file offset 0x%6x", size, requested_base, _file_offset);
+    }
+  } else {
+    si->_file_offset = _file_offset;
+  }
+  si->_base = requested_base;
+  si->_used = size;
+  si->_capacity = size;
+  si->_read_only = false;
+  si->_allow_exec = false;
+  si->_crc = size > 0 ? ClassLoader::crc32(0, buffer, (jint)size) : 0;
+  if (size > 0) {
+    write_bytes_aligned(buffer, (int)size);
+  }
+}
+
+
 // Dump bytes to file -- at the current file position.
 
 void FileMapInfo::write_bytes(const void* buffer, int nbytes) {
@@ -577,6 +615,39 @@ char* FileMapInfo::map_region(int i) {
   return base;
 }
 
+// Map the archived heap objects at addr, which is committed Java heap
+// memory. A private file mapping keeps the pages that are never written
+// shared with other JVMs using the same archive; fall back to reading the
+// objects if the memory cannot be mapped.
+bool FileMapInfo::map_heap_region(char* addr) {
+  struct FileMapInfo::FileMapHeader::space_info* si = &_header->_heap_space;
+  size_t size = align_size_up(si->_used, os::vm_allocation_granularity());
+
+  char* base = NULL;
+  if (!UseLargePages) {
+    base = os::map_memory(_fd, _full_path, si->_file_offset,
+                          addr, size, false /* !read_only */,
+                          false /* !allow_exec */);
+  }
+  if (base != addr) {
+    size_t n = os::read_at(_fd, addr, (unsigned int)si->_used, (jlong)si->_file_offset);
+    if (n != si->_used) {
+      if (PrintSharedSpaces) {
+        tty->print_cr("UseSharedSpaces: Unable to read the archived heap objects.");
+      }
+      return false;
+    }
+  }
+  if (VerifySharedSpaces &&
+      ClassLoader::crc32(0, addr, (jint)si->_used) != si->_crc) {
+    if (PrintSharedSpaces) {
+      tty->print_cr("UseSharedSpaces: Checksum verification of the archived heap objects failed.");
+    }
+    return false;
+  }
+  return true;
+}
+
 bool FileMapInfo::verify_region_checksum(int i) {
   if (!VerifySharedSpaces) {
     return true;
@@ -640,6 +711,7 @@ bool FileMapInfo::initialize() {
 
   init_from_file(_fd);
   if (!validate_header()) {
+    DynamicArchive::set_archive_mismatch();
     return false;
   }
 
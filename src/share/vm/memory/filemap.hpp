@@ -35,6 +35,7 @@
 //  read-write space from CompactingPermGenGen
 //  read-only space from CompactingPermGenGen
 //  misc data (block offset table, string table, symbols, dictionary, etc.)
+//  archived Java heap objects (optional, see HeapShared)
 //  tag(666)
 
 static const int JVM_IDENT_MAX = 256;
@@ -56,7 +57,7 @@ private:
   friend class ManifestStream;
   enum {
     _invalid_version = -1,
-    _current_version = 2
+    _current_version = 3
   };
 
   bool  _file_open;
@@ -102,6 +103,16 @@ public:
       bool   _allow_exec;    // executable code in space?
     } _space[MetaspaceShared::n_regions];
 
+    // Archived Java heap objects (see HeapShared), written after the
+    // metadata regions. _base is the heap address the objects were laid
+    // out for, and their narrow oops and narrow klass pointers are encoded
+    // with the dump time parameters below. _used is 0 if there is none.
+    struct space_info _heap_space;
+    address _narrow_oop_base;
+    int     _narrow_oop_shift;
+    address _narrow_klass_base;
+    int     _narrow_klass_shift;
+
     // The following fields are all sanity checks for whether this archive
     // will function correctly with this JVM and the bootclasspath it's
     // invoked with.
@@ -165,6 +176,8 @@ public:
   size_t alignment()                  { return _header->_alignment; }
   size_t space_capacity(int i)        { return _header->_space[i]._capacity; }
   char*  region_base(int i)           { return _header->_space[i]._base; }
+  size_t heap_region_used()           { return _header->_heap_space._used; }
+  char*  heap_region_base()           { return _header->_heap_space._base; }
   struct FileMapHeader* header()      { return _header; }
 
   static FileMapInfo* current_info() {
@@ -182,9 +195,11 @@ public:
   void  write_space(int i, Metaspace* space, bool read_only);
   void  write_region(int region, char* base, size_t size,
                      size_t capacity, bool read_only, bool allow_exec);
+  void  write_heap_region(char* buffer, size_t size, char* requested_base);
   void  write_bytes(const void* buffer, int count);
   void  write_bytes_aligned(const void* buffer, int count);
   char* map_region(int i);
+  bool  map_heap_region(char* addr);
   void  unmap_region(int i);
   bool  verify_region_checksum(int i);
   void  close();
@@ -35,7 +35,8 @@ size_t CodeHeap::header_size() {
 
 // Implementation of Heap
 
-CodeHeap::CodeHeap() {
+CodeHeap::CodeHeap(const char* name, int code_blob_type)
+  : _name(name), _code_blob_type(code_blob_type) {
   _number_of_committed_segments = 0;
   _number_of_reserved_segments  = 0;
   _segment_size                 = 0;
@@ -43,6 +44,9 @@ CodeHeap::CodeHeap() {
   _next_segment                 = 0;
   _freelist                     = NULL;
   _freelist_segments            = 0;
+  _blob_count                   = 0;
+  _nmethod_count                = 0;
+  _adapter_count                = 0;
 }
 
 
@@ -83,35 +87,76 @@ void CodeHeap::on_code_mapping(char* base, size_t size) {
 #ifdef LINUX
   extern void linux_wrap_code(char* base, size_t size);
   linux_wrap_code(base, size);
+  extern void linux_advise_code_huge_pages(char* base, size_t size);
+  linux_advise_code_huge_pages(base, size);
 #endif
 }
 
 
+size_t CodeHeap::preferred_page_size(size_t reserved_size) {
+  size_t page_size = os::vm_page_size();
+  if (os::can_execute_large_page_memory()) {
+    page_size = os::page_size_for_region_unaligned(reserved_size, 8);
+  } else {
+#ifdef LINUX
+    // Transparent huge pages for the code cache only
+    extern size_t linux_code_huge_page_size();
+    size_t huge_page_size = linux_code_huge_page_size();
+    if (huge_page_size != 0 && reserved_size >= huge_page_size) {
+      page_size = huge_page_size;
+    }
+#endif
+  }
+  return page_size;
+}
+
+
+bool CodeHeap::reserve_as_large_pages(size_t page_size) {
+  // Code cache huge pages are committed on demand, so only the regular
+  // large page setup may need a special reservation.
+  return page_size != (size_t) os::vm_page_size() && os::can_execute_large_page_memory();
+}
+
+
 bool CodeHeap::reserve(size_t reserved_size, size_t committed_size,
                        size_t segment_size) {
   assert(reserved_size >= committed_size, "reserved < committed");
-  assert(segment_size >= sizeof(FreeBlock), "segment size is too small");
-  assert(is_power_of_2(segment_size), "segment_size must be a power of 2");
-
-  _segment_size      = segment_size;
-  _log2_segment_size = exact_log2(segment_size);
 
   // Reserve and initialize space for _memory.
-  size_t page_size = os::vm_page_size();
-  if (os::can_execute_large_page_memory()) {
-    page_size = os::page_size_for_region_unaligned(reserved_size, 8);
-  }
+  size_t page_size = preferred_page_size(reserved_size);
 
   const size_t granularity = os::vm_allocation_granularity();
   const size_t r_align = MAX2(page_size, granularity);
   const size_t r_size = align_size_up(reserved_size, r_align);
-  const size_t c_size = align_size_up(committed_size, page_size);
 
   const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
     MAX2(page_size, granularity);
-  ReservedCodeSpace rs(r_size, rs_align, rs_align > 0);
+  ReservedCodeSpace rs(r_size, rs_align, reserve_as_large_pages(page_size));
   os::trace_page_sizes("code heap", committed_size, reserved_size, page_size,
                        rs.base(), rs.size());
+  return initialize_space(rs, committed_size, segment_size, page_size);
+}
+
+
+bool CodeHeap::reserve(ReservedSpace rs, size_t committed_size, size_t segment_size) {
+  assert(rs.size() >= committed_size, "reserved < committed");
+  size_t page_size = preferred_page_size(rs.size());
+  os::trace_page_sizes(_name, committed_size, rs.size(), page_size,
+                       rs.base(), rs.size());
+  return initialize_space(rs, committed_size, segment_size, page_size);
+}
+
+
+bool CodeHeap::initialize_space(ReservedSpace rs, size_t committed_size,
+                                size_t segment_size, size_t page_size) {
+  assert(segment_size >= sizeof(FreeBlock), "segment size is too small");
+  assert(is_power_of_2(segment_size), "segment_size must be a power of 2");
+
+  _segment_size      = segment_size;
+  _log2_segment_size = exact_log2(segment_size);
+
+  const size_t granularity = os::vm_allocation_granularity();
+  const size_t c_size = align_size_up(committed_size, page_size);
   if (!_memory.initialize(rs, c_size)) {
     return false;
   }
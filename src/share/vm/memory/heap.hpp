@@ -93,6 +93,12 @@ class CodeHeap : public CHeapObj<mtCode> {
   FreeBlock*   _freelist;
   size_t       _freelist_segments;               // No. of segments in freelist
 
+  const char*  _name;                            // Name of the CodeHeap
+  const int    _code_blob_type;                  // CodeBlobType this heap holds
+  int          _blob_count;                      // Number of CodeBlobs
+  int          _nmethod_count;                   // Number of nmethods
+  int          _adapter_count;                   // Number of adapters
+
   // Helper functions
   size_t   size_to_segments(size_t size) const { return (size + _segment_size - 1) >> _log2_segment_size; }
   size_t   segments_to_size(size_t number_of_segments) const { return number_of_segments << _log2_segment_size; }
@@ -121,11 +127,16 @@ class CodeHeap : public CHeapObj<mtCode> {
   // to perform additional actions on creation of executable code
   void on_code_mapping(char* base, size_t size);
 
+  bool  initialize_space(ReservedSpace rs, size_t committed_size, size_t segment_size, size_t page_size);
+
  public:
-  CodeHeap();
+  CodeHeap(const char* name, int code_blob_type);
 
   // Heap extents
   bool  reserve(size_t reserved_size, size_t committed_size, size_t segment_size);
+  bool  reserve(ReservedSpace rs, size_t committed_size, size_t segment_size); // uses an already reserved space
+  static size_t preferred_page_size(size_t reserved_size);
+  static bool   reserve_as_large_pages(size_t page_size);
   void  release();                               // releases all allocated memory
   bool  expand_by(size_t size);                  // expands commited memory by size
   void  shrink_by(size_t size);                  // shrinks commited memory by size
@@ -159,6 +170,16 @@ class CodeHeap : public CHeapObj<mtCode> {
   size_t allocated_capacity() const;
   size_t unallocated_capacity() const            { return max_capacity() - allocated_capacity(); }
 
+  // CodeBlob bookkeeping, maintained by the CodeCache
+  const char* name() const                       { return _name; }
+  int code_blob_type() const                     { return _code_blob_type; }
+  int blob_count() const                         { return _blob_count; }
+  int nmethod_count() const                      { return _nmethod_count; }
+  int adapter_count() const                      { return _adapter_count; }
+  void adjust_blob_count(int delta)              { _blob_count += delta; }
+  void adjust_nmethod_count(int delta)           { _nmethod_count += delta; }
+  void adjust_adapter_count(int delta)           { _adapter_count += delta; }
+
 private:
   size_t heap_unallocated_capacity() const;
 
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "classfile/javaClasses.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "memory/filemap.hpp"
+#include "memory/heapShared.hpp"
+#include "memory/iterator.hpp"
+#include "memory/metaspaceShared.hpp"
+#include "memory/universe.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/handles.inline.hpp"
+#include "utilities/copy.hpp"
+#include "utilities/growableArray.hpp"
+#if INCLUDE_ALL_GCS
+#include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
+#include "gc_implementation/g1/heapRegionBounds.inline.hpp"
+#endif // INCLUDE_ALL_GCS
+
+MemRegion HeapShared::_loaded_range;
+
+#if INCLUDE_ALL_GCS
+
+static void intern_strings_in_class(Klass* k, TRAPS) {
+  if (!k->oop_is_instance()) {
+    return;
+  }
+  ConstantPool* cp = InstanceKlass::cast(k)->constants();
+  for (int i = 1; i < cp->length(); i++) {
+    if (cp->tag_at(i).is_string()) {
+      Symbol* sym = cp->unresolved_string_at(i);
+      if (sym != NULL) {
+        oop s = StringTable::intern(sym, CHECK);
+        // The StringTable holds its strings weakly; the handle keeps the
+        // string alive until it is archived.
+        Handle h(THREAD, s);
+      }
+    }
+  }
+}
+
+void HeapShared::intern_class_strings(TRAPS) {
+  SystemDictionary::classes_do(intern_strings_in_class, THREAD);
+}
+
+class InternedStringCollector : public OopClosure {
+  GrowableArray<oop>* _strings;
+ public:
+  InternedStringCollector(GrowableArray<oop>* strings) : _strings(strings) { }
+  void do_oop(oop* p) {
+    if (*p != NULL) {
+      _strings->append(*p);
+    }
+  }
+  void do_oop(narrowOop* p) { ShouldNotReachHere(); }
+};
+
+// Lays out the archived objects in a C heap buffer, in chunks of
+// _chunk_words words.
+class HeapImageWriter : public StackObj {
+ private:
+  HeapWord* _buffer;
+  size_t    _capacity;      // in words, a multiple of _chunk_words
+  size_t    _top;           // in words
+  size_t    _chunk_words;
+  GrowableArray<size_t>* _strings;   // offsets of the archived Strings
+
+  // Write a dummy object covering words words at offset.
+  void fill(size_t offset, size_t words) {
+    HeapWord* p = _buffer + offset;
+    const size_t hdr = (size_t)arrayOopDesc::header_size(T_INT);
+    oop(p)->set_mark(markOopDesc::prototype());
+    if (words >= hdr) {
+      oop(p)->set_klass(Universe::intArrayKlassObj());
+      ((arrayOop)p)->set_length((int)((words - hdr) * HeapWordSize / sizeof(jint)));
+    } else {
+      assert(words == CollectedHeap::min_fill_size(), "unaligned size");
+      oop(p)->set_klass(SystemDictionary::Object_klass());
+    }
+  }
+
+  HeapWord* allocate(size_t word_size) {
+    assert(word_size <= _chunk_words, "does not fit in a chunk");
+    size_t chunk_end = align_size_down(_top, _chunk_words) + _chunk_words;
+    size_t left = chunk_end - _top;
+    // What is left of the chunk must be empty or big enough for a filler.
+    if (word_size > left ||
+        (word_size < left && left - word_size < CollectedHeap::min_fill_size())) {
+      fill(_top, left);
+      _top = chunk_end;
+      chunk_end += _chunk_words;
+    }
+    if (chunk_end > _capacity) {
+      _buffer = REALLOC_C_HEAP_ARRAY(HeapWord, _buffer, chunk_end, mtClassShared);
+      Copy::zero_to_words(_buffer + _capacity, chunk_end - _capacity);
+      _capacity = chunk_end;
+    }
+    HeapWord* result = _buffer + _top;
+    _top += word_size;
+    return result;
+  }
+
+ public:
+  HeapImageWriter() : _buffer(NULL), _capacity(0), _top(0),
+    _chunk_words(HeapRegionBounds::min_size() / HeapWordSize),
+    _strings(new GrowableArray<size_t>(10000)) { }
+
+  size_t used_bytes() const    { return _top * HeapWordSize; }
+  int    num_strings() const   { return _strings->length(); }
+  char*  buffer() const        { return (char*)_buffer; }
+
+  void add_string(oop s) {
+    typeArrayOop value = java_lang_String::value(s);
+    if (value == NULL) {
+      return;
+    }
+    size_t s_size = s->size();
+    size_t v_size = value->size();
+    if (s_size + v_size > _chunk_words) {
+      // Too large to share a region
+      return;
+    }
+    HeapWord* p = allocate(s_size + v_size);
+    Copy::aligned_disjoint_words((HeapWord*)s, p, s_size);
+    Copy::aligned_disjoint_words((HeapWord*)value, p + s_size, v_size);
+    oop(p)->set_mark(markOopDesc::prototype());
+    oop(p + s_size)->set_mark(markOopDesc::prototype());
+    if (java_lang_String::has_hash_field()) {
+      // Compute the hash code once here rather than in every JVM.
+      oop(p)->int_field_put(java_lang_String::hash_offset_in_bytes(),
+                            java_lang_String::hash_code(s));
+    }
+    // Keep the offset of the value until the base address is known.
+    size_t offset = p - _buffer;
+    *oop(p)->obj_field_addr<narrowOop>(java_lang_String::value_offset_in_bytes()) =
+      (narrowOop)(offset + s_size);
+    _strings->append(offset);
+  }
+
+  // Encode the value fields for an image located at base.
+  void relocate_to(HeapWord* base) {
+    for (int i = 0; i < _strings->length(); i++) {
+      oop s = oop(_buffer + _strings->at(i));
+      narrowOop* addr = s->obj_field_addr<narrowOop>(java_lang_String::value_offset_in_bytes());
+      oop value = oop(base + *addr);
+      *addr = oopDesc::encode_heap_oop_not_null(value);
+    }
+  }
+};
+
+char* HeapShared::archive_interned_strings(size_t* size, char** requested_base) {
+  *size = 0;
+  *requested_base = NULL;
+  if (!UseCompressedOops || !UseCompressedClassPointers) {
+    tty->print_cr("Interned strings are not archived without compressed oops and class pointers");
+    return NULL;
+  }
+
+  GrowableArray<oop>* strings = new GrowableArray<oop>(10000);
+  InternedStringCollector collector(strings);
+  StringTable::oops_do(&collector);
+
+  HeapImageWriter writer;
+  for (int i = 0; i < strings->length(); i++) {
+    writer.add_string(strings->at(i));
+  }
+  if (writer.used_bytes() == 0) {
+    return NULL;
+  }
+
+  // Lay the image out at the top of the heap, as it is loaded at run time
+  // when the region size matches.
+  size_t alignment = UseG1GC ? HeapRegion::GrainBytes : HeapRegionBounds::min_size();
+  MemRegion reserved = Universe::heap()->reserved_region();
+  size_t image_words = align_size_up(writer.used_bytes(), alignment) / HeapWordSize;
+  if (image_words >= reserved.word_size()) {
+    tty->print_cr("Interned strings are not archived: heap too small");
+    return NULL;
+  }
+  HeapWord* base = reserved.end() - image_words;
+  writer.relocate_to(base);
+
+  tty->print_cr("Archived %d interned strings (of %d): " SIZE_FORMAT " bytes for " PTR_FORMAT,
+                writer.num_strings(), strings->length(), writer.used_bytes(), p2i(base));
+  *size = writer.used_bytes();
+  *requested_base = (char*)base;
+  return writer.buffer();
+}
+
+// Re-encodes the narrow oops of the loaded image for the run time heap.
+class ArchivedOopRelocator : public OopClosure {
+ private:
+  address  _dump_base;
+  int      _dump_shift;
+  intptr_t _delta;
+ public:
+  ArchivedOopRelocator(address dump_base, int dump_shift, intptr_t delta) :
+    _dump_base(dump_base), _dump_shift(dump_shift), _delta(delta) { }
+
+  void do_oop(narrowOop* p) {
+    narrowOop v = *p;
+    if (v != 0) {
+      uintptr_t dump_addr = (uintptr_t)_dump_base + ((uintptr_t)v << _dump_shift);
+      *p = oopDesc::encode_heap_oop_not_null(oop(dump_addr + _delta));
+    }
+  }
+  void do_oop(oop* p) { ShouldNotReachHere(); }
+};
+
+static bool relocate_archived_heap(FileMapInfo* mapinfo, MemRegion range) {
+  FileMapInfo::FileMapHeader* header = mapinfo->header();
+  HeapWord* requested = (HeapWord*)mapinfo->heap_region_base();
+  bool same_oops = requested == range.start() &&
+                   header->_narrow_oop_base == Universe::narrow_oop_base() &&
+                   header->_narrow_oop_shift == Universe::narrow_oop_shift();
+  bool same_klasses = header->_narrow_klass_base == Universe::narrow_klass_base() &&
+                      header->_narrow_klass_shift == Universe::narrow_klass_shift();
+  if (same_oops && same_klasses) {
+    // The pages can stay shared with other JVMs.
+    return true;
+  }
+
+  ArchivedOopRelocator relocator(header->_narrow_oop_base, header->_narrow_oop_shift,
+                                 (intptr_t)range.start() - (intptr_t)requested);
+  HeapWord* p = range.start();
+  while (p < range.end()) {
+    oop obj = oop(p);
+    if (!same_klasses) {
+      narrowKlass nk = *obj->compressed_klass_addr();
+      Klass* k = (Klass*)(header->_narrow_klass_base +
+                          ((uintptr_t)nk << header->_narrow_klass_shift));
+      if (!MetaspaceShared::is_in_shared_space(k)) {
+        return false;
+      }
+      obj->set_klass(k);
+    }
+    size_t size = obj->size();
+    if (size == 0 || size > pointer_delta(range.end(), p)) {
+      return false;
+    }
+    if (!same_oops) {
+      obj->oop_iterate_no_header(&relocator);
+    }
+    p += size;
+  }
+  return true;
+}
+
+void HeapShared::load_archived_heap(FileMapInfo* mapinfo) {
+  size_t size = mapinfo->heap_region_used();
+  if (!ArchiveInternedStrings || size == 0) {
+    return;
+  }
+  if (!UseG1GC || !UseCompressedOops || !UseCompressedClassPointers) {
+    if (PrintSharedSpaces) {
+      tty->print_cr("UseSharedSpaces: archived heap objects need G1 and compressed oops");
+    }
+    return;
+  }
+
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  size_t word_size = size / HeapWordSize;
+  HeapWord* base = g1h->alloc_archive_regions(word_size);
+  if (base == NULL) {
+    if (PrintSharedSpaces) {
+      tty->print_cr("UseSharedSpaces: no regions for the archived heap objects");
+    }
+    return;
+  }
+  MemRegion range(base, word_size);
+  if (!mapinfo->map_heap_region((char*)base) ||
+      !relocate_archived_heap(mapinfo, range)) {
+    g1h->free_archive_regions(range);
+    return;
+  }
+  g1h->fill_archive_regions(range);
+  _loaded_range = range;
+
+  if (PrintSharedSpaces) {
+    tty->print_cr("Archived heap objects: " SIZE_FORMAT " bytes at " PTR_FORMAT,
+                  size, p2i(base));
+  }
+}
+
+void HeapShared::add_archived_strings_to_table() {
+  if (!is_archived_heap_loaded()) {
+    return;
+  }
+  Klass* string_klass = SystemDictionary::String_klass();
+  int added = 0;
+  int duplicates = 0;
+  HeapWord* p = _loaded_range.start();
+  while (p < _loaded_range.end()) {
+    oop obj = oop(p);
+    if (obj->klass() == string_klass) {
+      if (StringTable::add_archived_string(obj)) {
+        added++;
+      } else {
+        duplicates++;
+      }
+    }
+    p += obj->size();
+  }
+  if (PrintSharedSpaces) {
+    tty->print_cr("Archived interned strings: %d added, %d already interned",
+                  added, duplicates);
+  }
+}
+
+#endif // INCLUDE_ALL_GCS
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_MEMORY_HEAPSHARED_HPP
+#define SHARE_VM_MEMORY_HEAPSHARED_HPP
+
+#include "memory/allocation.hpp"
+#include "memory/memRegion.hpp"
+#include "utilities/exceptions.hpp"
+#include "utilities/macros.hpp"
+
+class FileMapInfo;
+
+// Archived Java heap objects in the shared archive (-XX:+ArchiveInternedStrings).
+//
+// At dump time the interned strings, including the constant pool strings of
+// all archived classes, are copied with their value arrays into an image
+// laid out in chunks of the minimum G1 region size. No object crosses a
+// chunk boundary and a String is always in the same chunk as its value, so
+// at run time no object crosses a region boundary and there are no
+// references between regions, whatever the region size. Chunk tails are
+// filled with dummy objects.
+//
+// At run time the image is mapped into regions at the top of the G1 heap,
+// relocated if the heap or the narrow oop and klass encoding changed, and
+// the regions become archive regions: old regions whose objects are always
+// live and never move. The strings are added to the StringTable once the
+// java.lang.String field offsets are known.
+class HeapShared : AllStatic {
+ private:
+  static MemRegion _loaded_range;
+
+ public:
+  // Dump time: intern the constant pool strings of all loaded classes. The
+  // strings are kept alive by handles in the current HandleMark.
+  static void intern_class_strings(TRAPS) NOT_ALL_GCS_RETURN;
+  // Dump time: build the image of the interned strings. Returns the C heap
+  // buffer holding it, or NULL if nothing is archived.
+  static char* archive_interned_strings(size_t* size, char** requested_base) NOT_ALL_GCS_RETURN_(NULL);
+
+  // Run time: load the image from the open archive into archive regions.
+  static void load_archived_heap(FileMapInfo* mapinfo) NOT_ALL_GCS_RETURN;
+  // Run time: make the archived strings the interned instances.
+  static void add_archived_strings_to_table() NOT_ALL_GCS_RETURN;
+
+  static bool is_archived_heap_loaded() { return !_loaded_range.is_empty(); }
+  static MemRegion loaded_range()       { return _loaded_range; }
+};
+
+#endif // SHARE_VM_MEMORY_HEAPSHARED_HPP
@@ -112,6 +112,17 @@ class ChunkManager : public CHeapObj<mtInternal> {
   size_t _free_chunks_total;
   size_t _free_chunks_count;
 
+  // Statistics for MetaspaceCoalesceChunks
+  size_t _merged_chunks_count;   // free chunks removed by merging
+  size_t _split_chunks_count;    // free chunks split for a smaller request
+  size_t _released_words;        // payload of merged chunks given back to the OS
+  size_t _uncommitted_words;     // free space uncommitted at the end of nodes
+
+  // Split the first free chunk found in the lists of larger chunks into
+  // chunks for the list index.  One of them is returned, still counted
+  // in the free totals, and the others are put on the free list.
+  Metachunk* split_free_chunk(ChunkIndex index);
+
   void dec_free_chunks_total(size_t v) {
     assert(_free_chunks_count > 0 &&
              _free_chunks_total > 0,
@@ -143,7 +154,9 @@ class ChunkManager : public CHeapObj<mtInternal> {
  public:
 
   ChunkManager(size_t specialized_size, size_t small_size, size_t medium_size)
-      : _free_chunks_total(0), _free_chunks_count(0) {
+      : _free_chunks_total(0), _free_chunks_count(0),
+        _merged_chunks_count(0), _split_chunks_count(0),
+        _released_words(0), _uncommitted_words(0) {
     _free_chunks[SpecializedIndex].set_size(specialized_size);
     _free_chunks[SmallIndex].set_size(small_size);
     _free_chunks[MediumIndex].set_size(medium_size);
@@ -164,6 +177,18 @@ class ChunkManager : public CHeapObj<mtInternal> {
   // of type index.
   void return_chunks(ChunkIndex index, Metachunk* chunks);
 
+  // Replace the count adjacent free chunks in [start, end) of node
+  // with as few chunks as possible.
+  void merge_free_chunks(VirtualSpaceNode* node, MetaWord* start,
+                         MetaWord* end, size_t count);
+
+  // Carve [start, start + word_size) in node into free chunks of the
+  // largest fixed sizes.  Returns the number of chunks added.
+  size_t add_free_range(VirtualSpaceNode* node, MetaWord* start,
+                        size_t word_size, bool release_pages);
+
+  void inc_uncommitted_words(size_t v) { _uncommitted_words += v; }
+
   // Total of the space in the free chunks list
   size_t free_chunks_total_words();
   size_t free_chunks_total_bytes();
@@ -246,6 +271,7 @@ class ChunkManager : public CHeapObj<mtInternal> {
 
   void locked_print_free_chunks(outputStream* st);
   void locked_print_sum_free_chunks(outputStream* st);
+  void locked_print_statistics(outputStream* st);
 
   void print_on(outputStream* st) const;
 };
@@ -376,6 +402,10 @@ class VirtualSpaceNode : public CHeapObj<mtClass> {
   // the smallest chunk size.
   void retire(ChunkManager* chunk_manager);
 
+  // Merge the runs of adjacent free chunks in this node and uncommit
+  // a free run at the end of the node.  Returns the words uncommitted.
+  size_t coalesce_free_chunks(ChunkManager* chunk_manager);
+
 #ifdef ASSERT
   // Debug support
   void mangle();
@@ -566,6 +596,9 @@ class VirtualSpaceList : public CHeapObj<mtClass> {
   // Unlink empty VirtualSpaceNodes and free it.
   void purge(ChunkManager* chunk_manager);
 
+  // Merge free chunks in the remaining nodes (MetaspaceCoalesceChunks).
+  void coalesce_free_chunks(ChunkManager* chunk_manager);
+
   void print_on(outputStream* st) const;
 
   class VirtualSpaceListIterator : public StackObj {
@@ -1180,6 +1213,83 @@ void VirtualSpaceNode::retire(ChunkManager* chunk_manager) {
   assert(free_words_in_vs() == 0, "should be empty now");
 }
 
+size_t VirtualSpaceNode::coalesce_free_chunks(ChunkManager* chunk_manager) {
+  assert(SafepointSynchronize::is_at_safepoint(), "chunks are only merged at a safepoint");
+  assert_lock_strong(SpaceManager::expand_lock());
+
+  // The chunks in a node are contiguous from bottom() to top() so
+  // the free runs are found by walking the chunk headers.
+  MetaWord* run_start = NULL;
+  size_t run_count = 0;
+  MetaWord* cur = bottom();
+  while (cur < top()) {
+    Metachunk* chunk = (Metachunk*) cur;
+    MetaWord* next = cur + chunk->word_size();
+    if (chunk->is_tagged_free()) {
+      if (run_start == NULL) {
+        run_start = cur;
+        run_count = 0;
+      }
+      run_count++;
+    } else if (run_start != NULL) {
+      chunk_manager->merge_free_chunks(this, run_start, cur, run_count);
+      run_start = NULL;
+    }
+    cur = next;
+  }
+
+  if (run_start == NULL) {
+    return 0;
+  }
+
+  // Pre-committed (large page) memory cannot be uncommitted.
+  size_t keep_bytes = align_size_up(pointer_delta(run_start, bottom(), sizeof(char)),
+                                    Metaspace::commit_alignment());
+  size_t committed_bytes = virtual_space()->committed_size();
+  if (is_pre_committed() || keep_bytes >= committed_bytes) {
+    chunk_manager->merge_free_chunks(this, run_start, top(), run_count);
+    return 0;
+  }
+
+  // The free run reaches top(): take its chunks off the free lists,
+  // lower top() and uncommit the commit granules above it.
+  for (MetaWord* p = run_start; p < top(); ) {
+    Metachunk* chunk = (Metachunk*) p;
+    p += chunk->word_size();
+    chunk_manager->remove_chunk(chunk);
+  }
+  // The last committed granule may extend above top() in the current node.
+  MetaWord* keep_top = MIN2(bottom() + keep_bytes / BytesPerWord, top());
+  set_top(keep_top);
+  virtual_space()->shrink_by(committed_bytes - keep_bytes);
+  assert(virtual_space()->committed_size() == virtual_space()->actual_committed_size(),
+         "The committed memory doesn't match the expanded memory.");
+
+  // The part of the run below the new top stays committed and goes
+  // back to the free lists.
+  if (run_start < keep_top) {
+    chunk_manager->add_free_range(this, run_start,
+                                  pointer_delta(keep_top, run_start, sizeof(MetaWord)),
+                                  false /* release_pages */);
+  }
+
+  size_t uncommitted = (committed_bytes - virtual_space()->committed_size()) / BytesPerWord;
+  chunk_manager->inc_uncommitted_words(uncommitted);
+  return uncommitted;
+}
+
+void VirtualSpaceList::coalesce_free_chunks(ChunkManager* chunk_manager) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  VirtualSpaceListIterator iter(virtual_space_list());
+  while (iter.repeat()) {
+    VirtualSpaceNode* vsn = iter.get_next();
+    size_t uncommitted = vsn->coalesce_free_chunks(chunk_manager);
+    if (uncommitted > 0) {
+      dec_committed_words(uncommitted);
+    }
+  }
+}
+
 VirtualSpaceList::VirtualSpaceList(size_t word_size) :
                                    _is_class(false),
                                    _virtual_space_list(NULL),
@@ -1771,6 +1881,47 @@ void ChunkManager::locked_print_sum_free_chunks(outputStream* st) {
                 sum_free_chunks(), sum_free_chunks_count());
 }
 
+void ChunkManager::locked_print_statistics(outputStream* st) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  size_t total_bytes = 0;
+  for (ChunkIndex i = ZeroIndex; i <= HumongousIndex; i = next_chunk_index(i)) {
+    total_bytes += size_free_chunks_in_bytes(i);
+  }
+  // Free space in specialized and small chunks can only be used for
+  // small requests, so it is reported as fragmented.
+  size_t fragmented_bytes = size_free_chunks_in_bytes(SpecializedIndex) +
+                            size_free_chunks_in_bytes(SmallIndex);
+  size_t largest_words = humongous_dictionary()->max_chunk_size();
+  if (largest_words == 0) {
+    for (int i = (int)MediumIndex; i >= (int)ZeroIndex; --i) {
+      if (num_free_chunks((ChunkIndex)i) > 0) {
+        largest_words = free_chunks((ChunkIndex)i)->size();
+        break;
+      }
+    }
+  }
+
+  st->print_cr("  free chunks: specialized " SIZE_FORMAT " (" SIZE_FORMAT "K), "
+               "small " SIZE_FORMAT " (" SIZE_FORMAT "K), "
+               "medium " SIZE_FORMAT " (" SIZE_FORMAT "K), "
+               "humongous " SIZE_FORMAT " (" SIZE_FORMAT "K), "
+               "total " SIZE_FORMAT "K",
+               num_free_chunks(SpecializedIndex), size_free_chunks_in_bytes(SpecializedIndex) / K,
+               num_free_chunks(SmallIndex), size_free_chunks_in_bytes(SmallIndex) / K,
+               num_free_chunks(MediumIndex), size_free_chunks_in_bytes(MediumIndex) / K,
+               num_free_chunks(HumongousIndex), size_free_chunks_in_bytes(HumongousIndex) / K,
+               total_bytes / K);
+  st->print_cr("  fragmentation: " SIZE_FORMAT "%% of free chunk space in "
+               "specialized and small chunks, largest free chunk " SIZE_FORMAT "K",
+               total_bytes == 0 ? 0 : fragmented_bytes * 100 / total_bytes,
+               largest_words * BytesPerWord / K);
+  st->print_cr("  coalescing: " SIZE_FORMAT " chunks merged, " SIZE_FORMAT " chunks split, "
+               SIZE_FORMAT "K released, " SIZE_FORMAT "K uncommitted",
+               _merged_chunks_count, _split_chunks_count,
+               _released_words * BytesPerWord / K,
+               _uncommitted_words * BytesPerWord / K);
+}
+
 ChunkList* ChunkManager::free_chunks(ChunkIndex index) {
   assert(index == SpecializedIndex || index == SmallIndex || index == MediumIndex,
          err_msg("Bad index: %d", (int)index));
@@ -1828,13 +1979,18 @@ Metachunk* ChunkManager::free_chunks_get(size_t word_size) {
 
     chunk = free_list->head();
 
+    if (chunk != NULL) {
+      // Remove the chunk as the head of the list.
+      free_list->remove_chunk(chunk);
+    } else if (MetaspaceCoalesceChunks && list_index(word_size) != MediumIndex) {
+      // Split a larger free chunk rather than committing more memory.
+      chunk = split_free_chunk(list_index(word_size));
+    }
+
     if (chunk == NULL) {
       return NULL;
     }
 
-    // Remove the chunk as the head of the list.
-    free_list->remove_chunk(chunk);
-
     if (TraceMetadataChunkAllocation && Verbose) {
       gclog_or_tty->print_cr("ChunkManager::free_chunks_get: free_list "
                              PTR_FORMAT " head " PTR_FORMAT " size " SIZE_FORMAT,
@@ -1864,11 +2020,9 @@ Metachunk* ChunkManager::free_chunks_get(size_t word_size) {
   // Remove it from the links to this freelist
   chunk->set_next(NULL);
   chunk->set_prev(NULL);
-#ifdef ASSERT
   // Chunk is no longer on any freelist. Setting to false make container_count_slow()
-  // work.
+  // and the merging of free chunks work.
   chunk->set_is_tagged_free(false);
-#endif
   chunk->container()->inc_container_count();
 
   slow_locked_verify();
@@ -2265,12 +2419,118 @@ void ChunkManager::return_chunks(ChunkIndex index, Metachunk* chunks) {
     // Capture the next link before it is changed
     // by the call to return_chunk_at_head();
     Metachunk* next = cur->next();
-    DEBUG_ONLY(cur->set_is_tagged_free(true);)
+    cur->set_is_tagged_free(true);
     list->return_chunk_at_head(cur);
     cur = next;
   }
 }
 
+size_t ChunkManager::add_free_range(VirtualSpaceNode* node, MetaWord* start,
+                                    size_t word_size, bool release_pages) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  size_t count = 0;
+  for (int i = (int)MediumIndex; i >= (int)ZeroIndex; --i) {
+    ChunkIndex index = (ChunkIndex)i;
+    size_t chunk_size = free_chunks(index)->size();
+    while (word_size >= chunk_size) {
+      Metachunk* chunk = ::new (start) Metachunk(chunk_size, node);
+      if (release_pages && index == MediumIndex) {
+        // Only the header of a free chunk is needed, the pages of the
+        // payload are given back and are zero filled on the next use.
+        char* from = (char*) align_ptr_up(start + Metachunk::overhead(), os::vm_page_size());
+        char* to = (char*) align_ptr_down(chunk->end(), os::vm_page_size());
+        if (from < to) {
+          os::free_memory(from, pointer_delta(to, from, sizeof(char)), os::vm_page_size());
+          _released_words += pointer_delta(to, from, sizeof(char)) / BytesPerWord;
+        }
+      }
+      chunk->set_is_tagged_free(true);
+      free_chunks(index)->return_chunk_at_head(chunk);
+      inc_free_chunks_total(chunk_size);
+      start += chunk_size;
+      word_size -= chunk_size;
+      count++;
+    }
+  }
+  assert(word_size == 0, "free ranges are multiples of the smallest chunk size");
+  return count;
+}
+
+void ChunkManager::merge_free_chunks(VirtualSpaceNode* node, MetaWord* start,
+                                     MetaWord* end, size_t count) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  size_t word_size = pointer_delta(end, start, sizeof(MetaWord));
+
+  // Number of chunks the run is carved into.
+  size_t merged_count = 0;
+  size_t remaining = word_size;
+  for (int i = (int)MediumIndex; i >= (int)ZeroIndex; --i) {
+    size_t chunk_size = free_chunks((ChunkIndex)i)->size();
+    merged_count += remaining / chunk_size;
+    remaining = remaining % chunk_size;
+  }
+  if (merged_count >= count) {
+    return;
+  }
+
+  for (MetaWord* p = start; p < end; ) {
+    Metachunk* chunk = (Metachunk*) p;
+    p += chunk->word_size();
+    remove_chunk(chunk);
+  }
+  size_t added = add_free_range(node, start, word_size, !node->is_pre_committed());
+  assert(added == merged_count, "must match");
+  _merged_chunks_count += count - merged_count;
+
+  if (TraceMetadataChunkAllocation && Verbose) {
+    gclog_or_tty->print_cr("ChunkManager::merge_free_chunks: " SIZE_FORMAT
+                           " chunks at " PTR_FORMAT " merged into " SIZE_FORMAT,
+                           count, start, merged_count);
+  }
+}
+
+Metachunk* ChunkManager::split_free_chunk(ChunkIndex index) {
+  assert_lock_strong(SpaceManager::expand_lock());
+  assert(index < MediumIndex, "only specialized and small chunks are split off");
+  size_t chunk_size = free_chunks(index)->size();
+
+  for (int i = (int)index + 1; i <= (int)MediumIndex; i++) {
+    ChunkList* larger_list = free_chunks((ChunkIndex)i);
+    Metachunk* larger = larger_list->head();
+    if (larger == NULL) {
+      continue;
+    }
+    larger_list->remove_chunk(larger);
+    dec_free_chunks_total(larger->word_size());
+
+    VirtualSpaceNode* node = larger->container();
+    MetaWord* start = larger->bottom();
+    MetaWord* end = start + larger->word_size();
+    assert(larger->word_size() % chunk_size == 0, "chunk sizes are powers of two");
+
+    Metachunk* result = ::new (start) Metachunk(chunk_size, node);
+    inc_free_chunks_total(chunk_size);
+    for (MetaWord* p = start + chunk_size; p < end; p += chunk_size) {
+      Metachunk* chunk = ::new (p) Metachunk(chunk_size, node);
+      chunk->set_is_tagged_free(true);
+      free_chunks(index)->return_chunk_at_head(chunk);
+      inc_free_chunks_total(chunk_size);
+    }
+    _split_chunks_count++;
+
+    if (TraceMetadataChunkAllocation && Verbose) {
+      gclog_or_tty->print_cr("ChunkManager::split_free_chunk: " PTR_FORMAT
+                             " size " SIZE_FORMAT " split into " SIZE_FORMAT
+                             " chunks of size " SIZE_FORMAT,
+                             start, pointer_delta(end, start, sizeof(MetaWord)),
+                             pointer_delta(end, start, sizeof(MetaWord)) / chunk_size,
+                             chunk_size);
+    }
+    return result;
+  }
+  return NULL;
+}
+
 SpaceManager::~SpaceManager() {
   // This call this->_lock which can't be done while holding expand_lock()
   assert(sum_capacity_in_chunks_in_use() == allocated_chunks_words(),
@@ -2336,9 +2596,7 @@ SpaceManager::~SpaceManager() {
   Metachunk* humongous_chunks = chunks_in_use(HumongousIndex);
 
   while (humongous_chunks != NULL) {
-#ifdef ASSERT
     humongous_chunks->set_is_tagged_free(true);
-#endif
     if (TraceMetadataChunkAllocation && Verbose) {
       gclog_or_tty->print(PTR_FORMAT " (" SIZE_FORMAT ") ",
                           humongous_chunks,
@@ -2910,6 +3168,26 @@ void MetaspaceAux::print_waste(outputStream* out) {
   }
 }
 
+// Print the usage, the chunk accounting and the state of the chunk
+// free lists.  Used by the VM.metaspace diagnostic command.
+void MetaspaceAux::print_metadata(outputStream* out) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+  print_on(out);
+  out->print("data space: "); print_on(out, Metaspace::NonClassType);
+  if (Metaspace::using_class_space()) {
+    out->print("class space: "); print_on(out, Metaspace::ClassType);
+  }
+  print_waste(out);
+
+  MutexLockerEx cl(SpaceManager::expand_lock(), Mutex::_no_safepoint_check_flag);
+  out->print_cr("Chunk free lists (data):");
+  Metaspace::chunk_manager_metadata()->locked_print_statistics(out);
+  if (Metaspace::using_class_space()) {
+    out->print_cr("Chunk free lists (class):");
+    Metaspace::chunk_manager_class()->locked_print_statistics(out);
+  }
+}
+
 // Dump global metaspace things from the end of ClassLoaderDataGraph
 void MetaspaceAux::dump(outputStream* out) {
   out->print_cr("All Metaspace:");
@@ -3736,6 +4014,9 @@ void Metaspace::iterate(Metaspace::AllocRecordClosure *closure) {
 
 void Metaspace::purge(MetadataType mdtype) {
   get_space_list(mdtype)->purge(get_chunk_manager(mdtype));
+  if (MetaspaceCoalesceChunks) {
+    get_space_list(mdtype)->coalesce_free_chunks(get_chunk_manager(mdtype));
+  }
 }
 
 void Metaspace::purge() {
@@ -377,6 +377,9 @@ class MetaspaceAux : AllStatic {
   static void print_on(outputStream * out);
   static void print_on(outputStream * out, Metaspace::MetadataType mdtype);
 
+  // Print usage, chunk accounting and free chunk statistics at a safepoint.
+  static void print_metadata(outputStream* out);
+
   static void print_class_waste(outputStream* out);
   static void print_waste(outputStream* out);
   static void dump(outputStream* out);
@@ -32,8 +32,10 @@
 #include "classfile/systemDictionary.hpp"
 #include "classfile/systemDictionaryShared.hpp"
 #include "code/codeCache.hpp"
+#include "memory/dynamicArchive.hpp"
 #include "memory/filemap.hpp"
 #include "memory/gcLocker.hpp"
+#include "memory/heapShared.hpp"
 #include "memory/metaspace.hpp"
 #include "memory/metaspaceShared.hpp"
 #include "oops/objArrayOop.hpp"
@@ -482,6 +484,14 @@ void VM_PopulateDumpSharedSpace::doit() {
   remove_unshareable_in_classes();
   tty->print_cr("done. ");
 
+  // Copy the interned strings to the heap image.
+  size_t heap_bytes = 0;
+  char* heap_base = NULL;
+  char* heap_image = NULL;
+  if (ArchiveInternedStrings) {
+    heap_image = HeapShared::archive_interned_strings(&heap_bytes, &heap_base);
+  }
+
   // Set up the share data and shared code segments.
   char* md_low = _md_vs.low();
   char* md_top = md_low;
@@ -610,6 +620,7 @@ void VM_PopulateDumpSharedSpace::doit() {
                         pointer_delta(mc_top, _mc_vs.low(), sizeof(char)),
                         SharedMiscCodeSize,
                         true, true);
+  mapinfo->write_heap_region(heap_image, heap_bytes, heap_base);
 
   // Pass 2 - write data.
   mapinfo->open_for_write();
@@ -625,6 +636,7 @@ void VM_PopulateDumpSharedSpace::doit() {
                         pointer_delta(mc_top, _mc_vs.low(), sizeof(char)),
                         SharedMiscCodeSize,
                         true, true);
+  mapinfo->write_heap_region(heap_image, heap_bytes, heap_base);
   mapinfo->close();
 
   memmove(vtbl_list, saved_vtbl, vtbl_list_size * sizeof(void*));
@@ -771,11 +783,18 @@ void MetaspaceShared::preload_and_dump(TRAPS) {
   link_and_cleanup_shared_classes(CATCH);
   tty->print_cr("Rewriting and linking classes: done");
 
+  if (ArchiveInternedStrings) {
+    // The constant pool strings of the archived classes are interned so
+    // that they are archived with the other interned strings.
+    HeapShared::intern_class_strings(CATCH);
+  }
+
   // Create and dump the shared spaces.   Everything so far is loaded
   // with the null class loader.
   ClassLoaderData* loader_data = ClassLoaderData::the_null_class_loader_data();
   VM_PopulateDumpSharedSpace op(loader_data, class_promote_order);
   VMThread::execute(&op);
+  DynamicArchive::publish_dumped_archive();
 
   // Since various initialization steps have been undone by this process,
   // it is not reasonable to continue running a java process.
@@ -1074,6 +1093,9 @@ void MetaspaceShared::initialize_shared_spaces() {
   ReadClosure rc(&array);
   serialize(&rc);
 
+  // Load the archived heap objects while the file is still open.
+  HeapShared::load_archived_heap(mapinfo);
+
   // Close the mapinfo file
   mapinfo->close();
 
@@ -186,6 +186,24 @@ size_t ReferenceProcessor::total_count(DiscoveredList lists[]) {
   return total;
 }
 
+// Visits the JNI weak global handle blocks with all workers.
+class RefProcPhaseJNITask: public AbstractRefProcTaskExecutor::ProcessTask {
+public:
+  RefProcPhaseJNITask(ReferenceProcessor& ref_processor)
+    : ProcessTask(ref_processor, NULL, true),
+      _claimed(0)
+  { }
+  virtual void work(unsigned int i, BoolObjectClosure& is_alive,
+                    OopClosure& keep_alive,
+                    VoidClosure& complete_gc)
+  {
+    JNIHandles::weak_handles_par_do(&is_alive, &keep_alive, &_claimed);
+    complete_gc.do_void();
+  }
+private:
+  volatile jint _claimed;
+};
+
 ReferenceProcessorStats ReferenceProcessor::process_discovered_references(
   BoolObjectClosure*           is_alive,
   OopClosure*                  keep_alive,
@@ -263,10 +281,7 @@ ReferenceProcessorStats ReferenceProcessor::process_discovered_references(
   // resurrect a "post-mortem" object.
   {
     GCTraceTime tt("JNI Weak Reference", trace_time, false, gc_timer, gc_id);
-    if (task_executor != NULL) {
-      task_executor->set_single_threaded_mode();
-    }
-    process_phaseJNI(is_alive, keep_alive, complete_gc);
+    process_phaseJNI(is_alive, keep_alive, complete_gc, task_executor);
   }
 
   return ReferenceProcessorStats(soft_count, weak_count, final_count, phantom_count);
@@ -290,16 +305,29 @@ uint ReferenceProcessor::count_jni_refs() {
 }
 #endif
 
-void ReferenceProcessor::process_phaseJNI(BoolObjectClosure* is_alive,
-                                          OopClosure*        keep_alive,
-                                          VoidClosure*       complete_gc) {
+void ReferenceProcessor::process_phaseJNI(BoolObjectClosure*           is_alive,
+                                          OopClosure*                  keep_alive,
+                                          VoidClosure*                 complete_gc,
+                                          AbstractRefProcTaskExecutor* task_executor) {
 #ifndef PRODUCT
   if (PrintGCDetails && PrintReferenceGC) {
     unsigned int count = count_jni_refs();
     gclog_or_tty->print(", %u refs", count);
   }
 #endif
-  JNIHandles::weak_oops_do(is_alive, keep_alive);
+  if (ParallelJNIWeakRefProcessing && _processing_is_mt && task_executor != NULL) {
+    // The handle blocks are shared out among the workers, the JVMTI and
+    // tracing weak oops are left to the single threaded part below.
+    RefProcPhaseJNITask phase_jni(*this);
+    task_executor->execute(phase_jni);
+    task_executor->set_single_threaded_mode();
+    JNIHandles::weak_extra_oops_do(is_alive, keep_alive);
+  } else {
+    if (task_executor != NULL) {
+      task_executor->set_single_threaded_mode();
+    }
+    JNIHandles::weak_oops_do(is_alive, keep_alive);
+  }
   complete_gc->do_void();
 }
 
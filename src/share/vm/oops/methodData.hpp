@@ -1789,6 +1789,15 @@ public:
                          index * per_case_cell_count +
                          relative_count_off_set);
   }
+  void set_default_count(uint count) {
+    array_set_int_at(default_count_off_set, (int)count);
+  }
+  void set_count_at(int index, uint count) {
+    array_set_int_at(case_array_start +
+                     index * per_case_cell_count +
+                     relative_count_off_set,
+                     (int)count);
+  }
   int displacement_at(int index) const {
     return array_int_at(case_array_start +
                         index * per_case_cell_count +
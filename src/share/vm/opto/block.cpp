@@ -33,6 +33,7 @@
 #include "opto/matcher.hpp"
 #include "opto/opcodes.hpp"
 #include "opto/rootnode.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "utilities/copy.hpp"
 
 void Block_Array::grow( uint i ) {
@@ -76,6 +77,8 @@ uint Block::code_alignment() {
   if (_pre_order == 0) return CodeEntryAlignment;
   // Check for Start block
   if (_pre_order == 1) return InteriorEntryAlignment;
+  // Padding cold code only makes the method larger
+  if (is_cold()) return relocInfo::addr_unit();
   // Check for loop alignment
   if (has_loop_alignment()) return loop_alignment();
 
@@ -211,6 +214,22 @@ bool Block::has_uncommon_code() const {
   return op == Op_Halt;
 }
 
+// Return true if the block is entered only when a call throws, i.e. all
+// its predecessors are CatchProjs other than the fall through projection.
+bool Block::is_exception_handler_entry() const {
+  if (!head()->is_Region() || num_preds() < 2) {
+    return false;
+  }
+  for (uint i = 1; i < num_preds(); i++) {
+    Node* p = pred(i);
+    if (p == NULL || !p->is_CatchProj() ||
+        p->as_CatchProj()->_con == CatchProjNode::fall_through_index) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // True if block is low enough frequency or guarded by a test which
 // mostly does not go here.
 bool PhaseCFG::is_uncommon(const Block* block) {
@@ -331,6 +350,9 @@ void Block::dump_head(const PhaseCFG* cfg, outputStream* st) const {
   } else if (has_loop_alignment()) {
     st->print(" top-of-loop");
   }
+  if (is_cold()) {
+    st->print(" cold");
+  }
   st->print(" Freq: %g",_freq);
   if( Verbose || WizardMode ) {
     st->print(" IDom: %d/#%d", _idom ? _idom->_pre_order : 0, _dom_depth);
@@ -597,6 +619,9 @@ void PhaseCFG::convert_NeverBranch_to_Goto(Block *b) {
 bool PhaseCFG::move_to_next(Block* bx, uint b_index) {
   if (bx == NULL) return false;
 
+  // Cold blocks stay behind the hot code
+  if (bx->is_cold()) return false;
+
   // Return false if bx is already scheduled.
   uint bx_index = bx->_pre_order;
   if ((bx_index <= b_index) && (get_block(bx_index) == bx)) {
@@ -709,6 +734,88 @@ void PhaseCFG::remove_empty_blocks() {
   } // End of for all blocks
 }
 
+// Mark the blocks on uncommon trap, slow and exception handling paths as
+// cold, as well as blocks that are only reached from cold blocks.
+void PhaseCFG::mark_cold_blocks() {
+  uint last = number_of_blocks();
+  for (uint i = 1; i < last; i++) {
+    Block* block = get_block(i);
+    if (block->is_connector()) {
+      continue;
+    }
+    if (block->is_exception_handler_entry() || is_uncommon(block)) {
+      block->set_cold();
+    }
+  }
+
+  // Propagate to blocks whose predecessors are all cold. Loop heads with
+  // a hot back branch stay hot, which is conservative.
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (uint i = 1; i < last; i++) {
+      Block* block = get_block(i);
+      if (block->is_cold() || block->is_connector() ||
+          block->head()->is_Root() || block->head()->is_Start()) {
+        continue;
+      }
+      bool all_preds_cold = block->num_preds() > 1;
+      for (uint j = 1; j < block->num_preds() && all_preds_cold; j++) {
+        Block* pred = get_block_for_node(block->pred(j));
+        while (pred->is_connector() && pred->num_preds() == 2) {
+          pred = get_block_for_node(pred->pred(1));
+        }
+        all_preds_cold = pred->is_cold();
+      }
+      if (all_preds_cold) {
+        block->set_cold();
+        progress = true;
+      }
+    }
+  }
+}
+
+// Move the cold blocks, in their current order, between the hot blocks
+// and the connector blocks, so the hot code of the method is dense.
+void PhaseCFG::move_cold_blocks_to_end() {
+  ResourceMark rm;
+  uint count = number_of_blocks();
+  GrowableArray<Block*> cold(count);
+  GrowableArray<Block*> connectors(count);
+  GrowableArray<Block*> hot(count);
+  // Cold blocks followed by a hot block change position
+  int moved = 0;
+  for (uint i = 0; i < count; i++) {
+    Block* block = get_block(i);
+    if (block->is_connector()) {
+      connectors.append(block);
+    } else if (block->is_cold()) {
+      cold.append(block);
+    } else {
+      hot.append(block);
+      moved = cold.length();
+    }
+  }
+  if (moved == 0) {
+    return;
+  }
+  assert(hot.first() == get_root_block(), "root block must stay first");
+  Atomic::add(moved, &_moved_cold_blocks);
+
+  clear_blocks();
+  for (int i = 0; i < hot.length(); i++) {
+    add_block(hot.at(i));
+  }
+  for (int i = 0; i < cold.length(); i++) {
+    add_block(cold.at(i));
+  }
+  for (int i = 0; i < connectors.length(); i++) {
+    add_block(connectors.at(i));
+  }
+}
+
+volatile jint PhaseCFG::_moved_cold_blocks = 0;
+
 Block *PhaseCFG::fixup_trap_based_check(Node *branch, Block *block, int block_pos, Block *bnext) {
   // Trap based checks must fall through to the successor with
   // PROB_ALWAYS.
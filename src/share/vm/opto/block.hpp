@@ -256,6 +256,14 @@ public:
   void set_connector() { _connector = true; }
   bool is_connector() const { return _connector; };
 
+  // Cold blocks. With SplitColdBlocks, blocks on uncommon trap, slow and
+  // exception handling paths are marked cold after register allocation
+  // and emitted together after the hot code of the method.
+  bool _cold;
+  void set_cold() { _cold = true; }
+  bool is_cold() const { return _cold; }
+  bool is_exception_handler_entry() const;
+
   // Loop_alignment will be set for blocks which are at the top of loops.
   // The block layout pass may rotate loops such that the loop head may not
   // be the sequentially first block of the loop encountered in the linear
@@ -289,6 +297,7 @@ public:
       _raise_LCA_visited(0),
       _first_inst_size(999999),
       _connector(false),
+      _cold(false),
       _loop_alignment(0) {
     _nodes.push(headnode);
   }
@@ -589,6 +598,11 @@ class PhaseCFG : public Phase {
 
   // Remove empty basic blocks
   void remove_empty_blocks();
+  // Mark cold blocks and move them after all hot blocks
+  void mark_cold_blocks();
+  void move_cold_blocks_to_end();
+  // Count of cold blocks moved behind the hot code (SplitColdBlocks)
+  static volatile jint _moved_cold_blocks;
   Block *fixup_trap_based_check(Node *branch, Block *block, int block_pos, Block *bnext);
   void fixup_flow();
 
@@ -208,6 +208,15 @@
   product(bool, UseCountedLoopSafepoints, false,                            \
           "Force counted loops to keep a safepoint")                        \
                                                                             \
+  experimental(bool, UseLongCountedLoops, false,                            \
+          "Convert loops with a long induction variable into an int "       \
+          "counted loop nested in an outer long loop")                      \
+                                                                            \
+  product(uintx, LoopStripMiningIter, 0,                                    \
+          "Number of iterations of the inner loop when an int counted "     \
+          "loop is strip mined to keep a safepoint in the outer loop, "     \
+          "0 disables strip mining")                                        \
+                                                                            \
   product(bool, UseLoopPredicate, true,                                     \
           "Generate a predicate to select fast/slow loop versions")         \
                                                                             \
@@ -318,6 +327,13 @@
   notproduct(bool, TraceLoopUnswitching, false,                             \
           "Trace loop unswitching")                                         \
                                                                             \
+  product(intx, LoopMaxUnswitch, 3,                                         \
+          "Maximum number of times a loop is unswitched")                   \
+                                                                            \
+  product(intx, LoopUnswitchNodeBudget, 4000,                               \
+          "Maximum estimated number of nodes of all versions of a loop "    \
+          "created by repeated unswitching")                                \
+                                                                            \
   product(bool, UseSuperWord, true,                                         \
           "Transform scalar operations into superword operations")          \
                                                                             \
@@ -369,6 +385,21 @@
   product(bool, UseOnlyInlinedBimorphic, true,                              \
           "Don't use BimorphicInlining if can't inline a second method")    \
                                                                             \
+  product(bool, UsePolymorphicInlining, false,                              \
+          "Profiling based guarded inlining of several receivers at "       \
+          "megamorphic call sites")                                         \
+                                                                            \
+  product(intx, PolymorphicInliningMaxTargets, 4,                           \
+          "Maximum number of receivers inlined at a polymorphic call site") \
+                                                                            \
+  product(intx, PolymorphicInliningCoveragePercent, 90,                     \
+          "Percentage of the calls at a polymorphic call site that the "    \
+          "inlined receivers must cover")                                   \
+                                                                            \
+  product(intx, PolymorphicInliningSizeBudget, 325,                         \
+          "Maximum total bytecode size of the receiver methods inlined "    \
+          "at one polymorphic call site")                                   \
+                                                                            \
   product(bool, InsertMemBarAfterArraycopy, true,                           \
           "Insert memory barrier after arraycopy call")                     \
                                                                             \
@@ -428,6 +459,10 @@
   product(bool, UseJumpTables, true,                                        \
           "Use JumpTables instead of a binary search tree for switches")    \
                                                                             \
+  product(bool, UseSwitchProfiling, false,                                  \
+          "Use profile data to peel hot cases and balance the decision "    \
+          "tree of switches")                                               \
+                                                                            \
   product(bool, UseDivMod, true,                                            \
           "Use combined DivMod instruction if available")                   \
                                                                             \
@@ -446,6 +481,14 @@
   product(bool, EliminateNestedLocks, true,                                 \
           "Eliminate nested locks of the same object when possible")        \
                                                                             \
+  product(bool, LoopLockCoarsening, false,                                  \
+          "Unroll counted loops which lock a loop invariant object so "     \
+          "that the locks of consecutive iterations are coarsened")         \
+                                                                            \
+  product(intx, LoopLockCoarseningChunk, 8,                                 \
+          "Maximum number of loop iterations executed while holding a "     \
+          "lock coarsened across loop iterations")                          \
+                                                                            \
   notproduct(bool, PrintLockStatistics, false,                              \
           "Print precise statistics on the dynamic lock usage")             \
                                                                             \
@@ -512,6 +555,10 @@
   notproduct(bool, PrintOptimizeStringConcat, false,                        \
           "Print information about transformations performed on Strings")   \
                                                                             \
+  diagnostic(bool, PrintStringConcatRejections, false,                      \
+          "Print the reason a StringBuilder chain was not fused by "        \
+          "OptimizeStringConcat")                                           \
+                                                                            \
   product(intx, ValueSearchLimit, 1000,                                     \
           "Recursion limit in PhaseMacroExpand::value_from_mem_phi")        \
                                                                             \
@@ -531,6 +578,10 @@
   product(bool, BlockLayoutRotateLoops, true,                               \
           "Allow back branches to be fall throughs in the block layour")    \
                                                                             \
+  product(bool, SplitColdBlocks, false,                                     \
+          "Lay out uncommon trap paths, slow paths and exception handlers " \
+          "after all other blocks and without loop alignment")              \
+                                                                            \
   develop(bool, InlineReflectionGetCallerClass, true,                       \
           "inline sun.reflect.Reflection.getCallerClass(), known to be part "\
           "of base library DLL")                                            \
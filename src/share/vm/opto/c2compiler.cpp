@@ -23,7 +23,10 @@
  */
 
 #include "precompiled.hpp"
+#include "opto/block.hpp"
 #include "opto/c2compiler.hpp"
+#include "opto/loopnode.hpp"
+#include "opto/macro.hpp"
 #include "opto/runtime.hpp"
 #if defined AD_MD_HPP
 # include AD_MD_HPP
@@ -161,5 +164,8 @@ void C2Compiler::compile_method(ciEnv* env, ciMethod* target, int entry_bci) {
 
 
 void C2Compiler::print_timers() {
-  // do nothing
+  tty->print_cr("    C2 lock coarsening     : %6d locks, %d unlocks, %d loops unrolled",
+                PhaseMacroExpand::_coarsened_locks, PhaseMacroExpand::_coarsened_unlocks,
+                PhaseIdealLoop::_lock_coarsening_unrolls);
+  tty->print_cr("    C2 cold block split    : %6d blocks moved", PhaseCFG::_moved_cold_blocks);
 }
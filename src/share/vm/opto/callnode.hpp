@@ -942,6 +942,7 @@ private:
     Coarsened,    // Lock was coarsened
     Nested        // Nested lock
   } _kind;
+  bool _in_coarsening_loop;  // In a loop unrolled to coarsen its locks
 #ifndef PRODUCT
   NamedCounter* _counter;
 #endif
@@ -964,7 +965,8 @@ protected:
 public:
   AbstractLockNode(const TypeFunc *tf)
     : CallNode(tf, NULL, TypeRawPtr::BOTTOM),
-      _kind(Regular)
+      _kind(Regular),
+      _in_coarsening_loop(false)
   {
 #ifndef PRODUCT
     _counter = NULL;
@@ -992,6 +994,9 @@ public:
   void set_coarsened()   { _kind = Coarsened; set_eliminated_lock_counter(); }
   void set_nested()      { _kind = Nested; set_eliminated_lock_counter(); }
 
+  bool in_coarsening_loop() const { return _in_coarsening_loop; }
+  void set_in_coarsening_loop()   { _in_coarsening_loop = true; }
+
   // locking does not modify its arguments
   virtual bool may_modify(const TypeOopPtr *t_oop, PhaseTransform *phase){ return false;}
 
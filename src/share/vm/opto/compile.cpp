@@ -2380,6 +2380,10 @@ void Compile::Code_Gen() {
     } else {
       cfg.set_loop_alignment();
     }
+    if (SplitColdBlocks) {
+      cfg.mark_cold_blocks();
+      cfg.move_cold_blocks_to_end();
+    }
     cfg.fixup_flow();
   }
 
@@ -867,6 +867,10 @@ class Compile : public Phase {
   CallGenerator*    call_generator(ciMethod* call_method, int vtable_index, bool call_does_dispatch,
                                    JVMState* jvms, bool allow_inline, float profile_factor, ciKlass* speculative_receiver_type = NULL,
                                    bool allow_intrinsics = true, bool delayed_forbidden = false);
+  // Guarded inlining of the most frequent receivers at a megamorphic call site.
+  CallGenerator*    polymorphic_call_generator(ciMethod* callee, int vtable_index, JVMState* jvms,
+                                               bool allow_inline, float profile_factor,
+                                               ciCallProfile& profile);
   bool should_delay_inlining(ciMethod* call_method, JVMState* jvms) {
     return should_delay_string_inlining(call_method, jvms) ||
            should_delay_boxing_inlining(call_method, jvms);
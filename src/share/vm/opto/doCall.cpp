@@ -223,6 +223,12 @@ CallGenerator* Compile::call_generator(ciMethod* callee, int vtable_index, bool
           speculative_receiver_type = NULL;
         }
       }
+      if (receiver_method == NULL && UsePolymorphicInlining && profile.has_receiver(2)) {
+        // More than two receivers: try a chain of guarded inlines first.
+        CallGenerator* cg = polymorphic_call_generator(callee, vtable_index, jvms,
+                                                       allow_inline, prof_factor, profile);
+        if (cg != NULL)  return cg;
+      }
       if (receiver_method == NULL &&
           (have_major_receiver || morphism == 1 ||
            (morphism == 2 && UseBimorphicInlining))) {
@@ -308,6 +314,69 @@ CallGenerator* Compile::call_generator(ciMethod* callee, int vtable_index, bool
   }
 }
 
+// Build a chain of receiver type checks for the most frequent receivers at a
+// megamorphic call site.  Receivers are taken in profile order until they cover
+// PolymorphicInliningCoveragePercent of the calls.  Every receiver method has to
+// be inlined and together they have to fit into PolymorphicInliningSizeBudget
+// bytes of bytecode.  Calls which miss all checks use a virtual call.
+CallGenerator* Compile::polymorphic_call_generator(ciMethod* callee, int vtable_index, JVMState* jvms,
+                                                   bool allow_inline, float prof_factor,
+                                                   ciCallProfile& profile) {
+  ciMethod* caller = jvms->method();
+  int site_count = profile.count();
+  int max_targets = MIN2((int)PolymorphicInliningMaxTargets, (int)ciCallProfile::PolymorphicLimit);
+  double needed = (double)PolymorphicInliningCoveragePercent * site_count;
+
+  ciMethod*      receiver_methods[ciCallProfile::PolymorphicLimit];
+  CallGenerator* hit_cgs[ciCallProfile::PolymorphicLimit];
+  int targets = 0;
+  int covered = 0;
+  int size = 0;
+  while (targets < max_targets && profile.has_receiver(targets) && 100.0 * covered < needed) {
+    ciMethod* receiver_method = callee->resolve_invoke(caller->holder(), profile.receiver(targets));
+    if (receiver_method == NULL) {
+      break;
+    }
+    size += receiver_method->code_size();
+    if (size > PolymorphicInliningSizeBudget) {
+      break;
+    }
+    CallGenerator* hit_cg = call_generator(receiver_method, vtable_index, false, jvms,
+                                           allow_inline, prof_factor);
+    if (hit_cg == NULL || !(hit_cg->is_inline() || hit_cg->is_late_inline())) {
+      // Guarding a call which is not inlined does not pay off
+      break;
+    }
+    receiver_methods[targets] = receiver_method;
+    hit_cgs[targets] = hit_cg;
+    covered += profile.receiver_count(targets);
+    targets++;
+  }
+
+  CompileLog* log = this->log();
+  if (log != NULL) {
+    log->elem("polymorphic_call targets='%d' covered='%d' count='%d' size='%d'",
+              targets, covered, site_count, size);
+  }
+  if (targets < 2 || 100.0 * covered < needed) {
+    return NULL;
+  }
+
+  // The checks are emitted in profile order, so the probability of each
+  // check is relative to the calls that missed all previous checks.
+  CallGenerator* cg = CallGenerator::for_virtual_call(callee, vtable_index);
+  int remaining = site_count - covered;
+  for (int i = targets - 1; i >= 0; i--) {
+    int receiver_count = profile.receiver_count(i);
+    remaining += receiver_count;
+    trace_type_profile(C, caller, jvms->depth() - 1, jvms->bci(), receiver_methods[i],
+                       profile.receiver(i), site_count, receiver_count);
+    cg = CallGenerator::for_predicted_call(profile.receiver(i), cg, hit_cgs[i],
+                                           (float)receiver_count / (float)remaining);
+  }
+  return cg;
+}
+
 // Return true for methods that shouldn't be inlined early so that
 // they are easier to analyze and optimize as intrinsics.
 bool Compile::should_delay_string_inlining(ciMethod* call_method, JVMState* jvms) {
@@ -328,6 +397,7 @@ bool Compile::should_delay_string_inlining(ciMethod* call_method, JVMState* jvms
       case vmIntrinsics::_StringBuilder_append_char:
       case vmIntrinsics::_StringBuilder_append_int:
       case vmIntrinsics::_StringBuilder_append_String:
+      case vmIntrinsics::_StringBuilder_append_bool:
       case vmIntrinsics::_StringBuilder_toString:
       case vmIntrinsics::_StringBuffer_void:
       case vmIntrinsics::_StringBuffer_int:
@@ -335,6 +405,7 @@ bool Compile::should_delay_string_inlining(ciMethod* call_method, JVMState* jvms
       case vmIntrinsics::_StringBuffer_append_char:
       case vmIntrinsics::_StringBuffer_append_int:
       case vmIntrinsics::_StringBuffer_append_String:
+      case vmIntrinsics::_StringBuffer_append_bool:
       case vmIntrinsics::_StringBuffer_toString:
       case vmIntrinsics::_Integer_toString:
         return true;
@@ -323,6 +323,8 @@ class LibraryCallKit : public GraphKit {
   bool inline_updateCRC32();
   bool inline_updateBytesCRC32();
   bool inline_updateByteBufferCRC32();
+  bool inline_decodeISO8859_1();
+  bool inline_decodeUTF_8();
   bool inline_multiplyToLen();
   bool inline_squareToLen();
   bool inline_mulAdd();
@@ -576,6 +578,11 @@ CallGenerator* Compile::make_vm_intrinsic(ciMethod* m, bool is_virtual) {
     if (!UseCRC32Intrinsics) return NULL;
     break;
 
+  case vmIntrinsics::_decodeISO8859_1:
+  case vmIntrinsics::_decodeUTF_8:
+    if (!UseCharsetIntrinsics) return NULL;
+    break;
+
   case vmIntrinsics::_incrementExactI:
   case vmIntrinsics::_addExactI:
     if (!Matcher::match_rule_supported(Op_OverflowAddI) || !UseMathExactIntrinsics) return NULL;
@@ -967,6 +974,11 @@ bool LibraryCallKit::try_to_inline(int predicate) {
   case vmIntrinsics::_updateByteBufferCRC32:
     return inline_updateByteBufferCRC32();
 
+  case vmIntrinsics::_decodeISO8859_1:
+    return inline_decodeISO8859_1();
+  case vmIntrinsics::_decodeUTF_8:
+    return inline_decodeUTF_8();
+
   case vmIntrinsics::_profileBoolean:
     return inline_profileBoolean();
 
@@ -6289,6 +6301,193 @@ bool LibraryCallKit::inline_updateByteBufferCRC32() {
   return true;
 }
 
+//----------------------------inline_decodeISO8859_1--------------------------
+/**
+ * Inflate ISO-8859-1 bytes into chars.
+ * int sun.nio.cs.ISO_8859_1.Decoder.decode(byte[] src, int sp, int len, char[] dst)
+ *
+ * The method is reachable through the public ArrayDecoder interface, so
+ * unlike encodeISOArray the arguments are not checked by the caller.
+ * Out of range arguments deoptimize and the interpreter throws.
+ */
+bool LibraryCallKit::inline_decodeISO8859_1() {
+  assert(UseCharsetIntrinsics, "need charset intrinsics support");
+  assert(callee()->signature()->size() == 4, "decode has 4 parameters");
+  if (too_many_traps(Deoptimization::Reason_intrinsic)) {
+    return false;
+  }
+  // the receiver, argument(0), carries no state the stub needs
+  Node* src         = argument(1); // type: oop
+  Node* src_offset  = argument(2); // type: int
+  Node* length      = argument(3); // type: int
+  Node* dst         = argument(4); // type: oop
+
+  const TypeAryPtr* top_src = src->Value(&_gvn)->isa_aryptr();
+  const TypeAryPtr* top_dst = dst->Value(&_gvn)->isa_aryptr();
+  if (top_src == NULL || top_src->klass() == NULL ||
+      top_dst == NULL || top_dst->klass() == NULL) {
+    // failed array check
+    return false;
+  }
+  if (top_src->klass()->as_array_klass()->element_type()->basic_type() != T_BYTE ||
+      top_dst->klass()->as_array_klass()->element_type()->basic_type() != T_CHAR) {
+    return false;
+  }
+
+  // Set the original stack and the reexecute bit for the interpreter to
+  // reexecute the invoke if deoptimization happens.
+  { PreserveReexecuteState preexecs(this);
+    jvms()->set_should_reexecute(true);
+
+    src = null_check(src);
+    dst = null_check(dst);
+    // Check if a null path was taken unconditionally.
+    if (stopped())  return true;
+
+    // len = max(min(len, dst.length), 0) is the number of chars decoded
+    length = generate_min_max(vmIntrinsics::_min, length, load_array_length(dst));
+    length = generate_min_max(vmIntrinsics::_max, length, intcon(0));
+
+    RegionNode* bailout = new (C) RegionNode(1);
+    record_for_igvn(bailout);
+    generate_negative_guard(src_offset, bailout);
+    generate_limit_guard(src_offset, length, load_array_length(src), bailout);
+
+    if (bailout->req() > 1) {
+      PreserveJVMState pjvms(this);
+      set_control(_gvn.transform(bailout));
+      uncommon_trap(Deoptimization::Reason_intrinsic,
+                    Deoptimization::Action_maybe_recompile);
+    }
+  }
+  if (stopped())  return true;
+
+  Node* src_start = array_element_address(src, src_offset, T_BYTE);
+  Node* dst_start = array_element_address(dst, intcon(0), T_CHAR);
+  make_runtime_call(RC_LEAF|RC_NO_FP, OptoRuntime::inflateBytes_Type(),
+                    StubRoutines::inflateBytes(), "inflateBytes",
+                    TypePtr::BOTTOM, src_start, dst_start, length);
+  set_result(length);
+  return true;
+}
+
+//----------------------------inline_decodeUTF_8-------------------------------
+/**
+ * Decode UTF-8 bytes into chars, with a fast path for ASCII input.
+ * int sun.nio.cs.UTF_8.Decoder.decode(byte[] src, int sp, int len, char[] dst)
+ *
+ * The bytes are inflated up to the first negative one. If that consumes
+ * all len bytes the result is len, otherwise the real method is called
+ * and decodes the whole input again. Argument checks are done as in
+ * inline_decodeISO8859_1.
+ */
+bool LibraryCallKit::inline_decodeUTF_8() {
+  assert(UseCharsetIntrinsics, "need charset intrinsics support");
+  assert(callee()->signature()->size() == 4, "decode has 4 parameters");
+  if (too_many_traps(Deoptimization::Reason_intrinsic)) {
+    return false;
+  }
+  // the receiver, argument(0), is only needed by the slow path
+  Node* src         = argument(1); // type: oop
+  Node* src_offset  = argument(2); // type: int
+  Node* length      = argument(3); // type: int
+  Node* dst         = argument(4); // type: oop
+
+  const TypeAryPtr* top_src = src->Value(&_gvn)->isa_aryptr();
+  const TypeAryPtr* top_dst = dst->Value(&_gvn)->isa_aryptr();
+  if (top_src == NULL || top_src->klass() == NULL ||
+      top_dst == NULL || top_dst->klass() == NULL) {
+    // failed array check
+    return false;
+  }
+  if (top_src->klass()->as_array_klass()->element_type()->basic_type() != T_BYTE ||
+      top_dst->klass()->as_array_klass()->element_type()->basic_type() != T_CHAR) {
+    return false;
+  }
+
+  Node* count = NULL;
+  // Set the original stack and the reexecute bit for the interpreter to
+  // reexecute the invoke if deoptimization happens.
+  { PreserveReexecuteState preexecs(this);
+    jvms()->set_should_reexecute(true);
+
+    src = null_check(src);
+    dst = null_check(dst);
+    // Check if a null path was taken unconditionally.
+    if (stopped())  return true;
+
+    // count = max(min(len, dst.length), 0) bytes at most are inflated,
+    // like the ASCII loop of the Java code
+    count = generate_min_max(vmIntrinsics::_min, length, load_array_length(dst));
+    count = generate_min_max(vmIntrinsics::_max, count, intcon(0));
+
+    RegionNode* bailout = new (C) RegionNode(1);
+    record_for_igvn(bailout);
+    generate_negative_guard(src_offset, bailout);
+    generate_limit_guard(src_offset, count, load_array_length(src), bailout);
+
+    if (bailout->req() > 1) {
+      PreserveJVMState pjvms(this);
+      set_control(_gvn.transform(bailout));
+      uncommon_trap(Deoptimization::Reason_intrinsic,
+                    Deoptimization::Action_maybe_recompile);
+    }
+  }
+  if (stopped())  return true;
+
+  enum {
+    ascii_path = 1, // all len bytes were inflated
+    slow_path  = 2, // UTF_8.Decoder.decode(src, sp, len, dst)
+    PATH_LIMIT
+  };
+  RegionNode* result_rgn = new (C) RegionNode(PATH_LIMIT);
+  PhiNode*    result_val = new (C) PhiNode(result_rgn, TypeInt::INT);
+
+  Node* src_start = array_element_address(src, src_offset, T_BYTE);
+  Node* dst_start = array_element_address(dst, intcon(0), T_CHAR);
+  Node* call = make_runtime_call(RC_LEAF|RC_NO_FP, OptoRuntime::inflateASCIIBytes_Type(),
+                                 StubRoutines::inflateASCIIBytes(), "inflateASCIIBytes",
+                                 TypePtr::BOTTOM, src_start, dst_start, count);
+  Node* inflated = _gvn.transform(new (C) ProjNode(call, TypeFunc::Parms));
+
+  RegionNode* slow_region = new (C) RegionNode(1);
+  record_for_igvn(slow_region);
+  Node* cmp = _gvn.transform(new (C) CmpINode(inflated, length));
+  Node* bol = _gvn.transform(new (C) BoolNode(cmp, BoolTest::ne));
+  generate_slow_guard(bol, slow_region);
+
+  result_rgn->init_req(ascii_path, control());
+  result_val->init_req(ascii_path, inflated);
+
+  set_control(_gvn.transform(slow_region));
+  if (stopped()) {
+    result_rgn->init_req(slow_path, top());
+    result_val->init_req(slow_path, top());
+  } else {
+    CallJavaNode* slow_call = generate_method_call(vmIntrinsics::_decodeUTF_8);
+    Node* slow_val = set_results_for_java_call(slow_call);
+    // this->control() comes from set_results_for_java_call
+
+    Node* fast_io  = slow_call->in(TypeFunc::I_O);
+    Node* fast_mem = slow_call->in(TypeFunc::Memory);
+
+    // These two phis are pre-filled with copies of the fast IO and Memory
+    PhiNode* result_mem = PhiNode::make(result_rgn, fast_mem, Type::MEMORY, TypePtr::BOTTOM);
+    PhiNode* result_io  = PhiNode::make(result_rgn, fast_io,  Type::ABIO);
+
+    result_rgn->init_req(slow_path, control());
+    result_io ->init_req(slow_path, i_o());
+    result_mem->init_req(slow_path, reset_memory());
+    result_val->init_req(slow_path, slow_val);
+
+    set_all_memory(_gvn.transform(result_mem));
+    set_i_o(       _gvn.transform(result_io));
+  }
+
+  set_result(result_rgn, result_val);
+  return true;
+}
+
 //----------------------------inline_reference_get----------------------------
 // public T java.lang.ref.Reference.get();
 bool LibraryCallKit::inline_reference_get() {
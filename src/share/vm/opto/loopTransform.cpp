@@ -29,11 +29,13 @@
 #include "opto/callnode.hpp"
 #include "opto/connode.hpp"
 #include "opto/divnode.hpp"
+#include "opto/locknode.hpp"
 #include "opto/loopnode.hpp"
 #include "opto/mulnode.hpp"
 #include "opto/rootnode.hpp"
 #include "opto/runtime.hpp"
 #include "opto/subnode.hpp"
+#include "runtime/atomic.inline.hpp"
 
 //------------------------------is_loop_exit-----------------------------------
 // Given an IfNode, return the loop-exiting projection or NULL if both
@@ -650,6 +652,11 @@ bool IdealLoopTree::policy_unroll( PhaseIdealLoop *phase ) const {
   int future_unroll_ct = cl->unrolled_count() * 2;
   if (future_unroll_ct > LoopMaxUnroll) return false;
 
+  // A lock coarsened across the unrolled iterations is held for the whole
+  // unrolled body, so bound the unrolling to keep the lock hold time short.
+  bool coarsen_locks = LoopLockCoarsening && EliminateLocks && has_coarsenable_lock(phase);
+  if (coarsen_locks && future_unroll_ct > LoopLockCoarseningChunk) return false;
+
   // Check for initial stride being a small enough constant
   if (abs(cl->stride_con()) > (1<<2)*future_unroll_ct) return false;
 
@@ -745,14 +752,44 @@ bool IdealLoopTree::policy_unroll( PhaseIdealLoop *phase ) const {
   // Check for being too big
   if (body_size > (uint)LoopUnrollLimit) {
     if (xors_in_loop >= 4 && body_size < (uint)LoopUnrollLimit*4) return true;
-    // Normal case: loop too big
-    return false;
+    // Removing a lock/unlock pair per iteration pays for a bigger body
+    if (!coarsen_locks || body_size >= (uint)LoopUnrollLimit*4) {
+      // Normal case: loop too big
+      return false;
+    }
   }
 
   // Unroll once!  (Each trip will soon do double iterations)
   return true;
 }
 
+//------------------------------has_coarsenable_lock---------------------------
+// Return TRUE if the loop body locks and unlocks a loop invariant object.
+// After unrolling, the unlock at the end of one iteration is directly
+// followed by the lock at the start of the next one and lock coarsening
+// (LockNode::Ideal) removes both.
+bool IdealLoopTree::has_coarsenable_lock( PhaseIdealLoop *phase ) const {
+  for (uint i = 0; i < _body.size(); i++) {
+    Node* n = _body.at(i);
+    if (!n->is_Lock() || n->as_Lock()->is_eliminated()) {
+      continue;
+    }
+    LockNode* lock = n->as_Lock();
+    if (!is_invariant(lock->obj_node())) {
+      continue;
+    }
+    for (uint j = 0; j < _body.size(); j++) {
+      Node* m = _body.at(j);
+      if (m->is_Unlock() && !m->as_Unlock()->is_eliminated() &&
+          lock->obj_node()->eqv_uncast(m->as_Unlock()->obj_node()) &&
+          BoxLockNode::same_slot(lock->box_node(), m->as_Unlock()->box_node())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 //------------------------------policy_align-----------------------------------
 // Return TRUE or FALSE if the loop should be cache-line aligned.  Gather the
 // expression that does the alignment.  Note that only one array base can be
@@ -1215,6 +1252,18 @@ void PhaseIdealLoop::do_unroll( IdealLoopTree *loop, Node_List &old_new, bool ad
   // if rounds of unroll,optimize are making progress
   loop_head->set_node_count_before_unroll(loop->_body.size());
 
+  if (LoopLockCoarsening && EliminateLocks && loop->has_coarsenable_lock(this)) {
+    Atomic::inc(&_lock_coarsening_unrolls);
+    // The clones made below inherit the mark, so locks coarsened across
+    // the unrolled iterations can be told apart from other coarsening.
+    for (uint i = 0; i < loop->_body.size(); i++) {
+      Node* n = loop->_body.at(i);
+      if (n->is_AbstractLock()) {
+        n->as_AbstractLock()->set_in_coarsening_loop();
+      }
+    }
+  }
+
   Node *ctrl  = loop_head->in(LoopNode::EntryControl);
   Node *limit = loop_head->limit();
   Node *init  = loop_head->init_trip();
@@ -1722,6 +1771,9 @@ bool PhaseIdealLoop::is_scaled_iv(Node* exp, Node* iv, int* p_scale) {
 
 //-----------------------------is_scaled_iv_plus_offset------------------------------
 // Return true if exp is a simple induction variable expression: k1*iv + (invar + k2)
+// The offset may be spread over several additions and subtractions, as in
+// a[base + i + j*stride], as long as the iv occurs only once.  Whether the
+// offset is really invariant is left to the caller.
 bool PhaseIdealLoop::is_scaled_iv_plus_offset(Node* exp, Node* iv, int* p_scale, Node** p_offset, int depth) {
   if (is_scaled_iv(exp, iv, p_scale)) {
     if (p_offset != NULL) {
@@ -1745,18 +1797,20 @@ bool PhaseIdealLoop::is_scaled_iv_plus_offset(Node* exp, Node* iv, int* p_scale,
       }
       return true;
     }
-    if (exp->in(2)->is_Con()) {
-      Node* offset2 = NULL;
-      if (depth < 2 &&
-          is_scaled_iv_plus_offset(exp->in(1), iv, p_scale,
-                                   p_offset != NULL ? &offset2 : NULL, depth+1)) {
-        if (p_offset != NULL) {
-          Node *ctrl_off2 = get_ctrl(offset2);
-          Node* offset = new (C) AddINode(offset2, exp->in(2));
-          register_new_node(offset, ctrl_off2);
-          *p_offset = offset;
+    if (depth < 2) {
+      // (k1*iv + offset2) + invar, with the operands in either order
+      for (uint i = 1; i <= 2; i++) {
+        Node* offset2 = NULL;
+        if (is_scaled_iv_plus_offset(exp->in(i), iv, p_scale,
+                                     p_offset != NULL ? &offset2 : NULL, depth+1)) {
+          if (p_offset != NULL) {
+            Node* other = exp->in(3 - i);
+            Node* offset = new (C) AddINode(offset2, other);
+            register_new_node(offset, later_ctrl(offset2, other));
+            *p_offset = offset;
+          }
+          return true;
         }
-        return true;
       }
     }
   } else if (opc == Op_SubI) {
@@ -1778,10 +1832,43 @@ bool PhaseIdealLoop::is_scaled_iv_plus_offset(Node* exp, Node* iv, int* p_scale,
       }
       return true;
     }
+    if (depth < 2) {
+      Node* offset2 = NULL;
+      // (k1*iv + offset2) - invar
+      if (is_scaled_iv_plus_offset(exp->in(1), iv, p_scale,
+                                   p_offset != NULL ? &offset2 : NULL, depth+1)) {
+        if (p_offset != NULL) {
+          Node* offset = new (C) SubINode(offset2, exp->in(2));
+          register_new_node(offset, later_ctrl(offset2, exp->in(2)));
+          *p_offset = offset;
+        }
+        return true;
+      }
+      // invar - (k1*iv + offset2)
+      if (is_scaled_iv_plus_offset(exp->in(2), iv, p_scale,
+                                   p_offset != NULL ? &offset2 : NULL, depth+1)) {
+        if (p_offset != NULL) {
+          *p_scale *= -1;
+          Node* offset = new (C) SubINode(exp->in(1), offset2);
+          register_new_node(offset, later_ctrl(offset2, exp->in(1)));
+          *p_offset = offset;
+        }
+        return true;
+      }
+    }
   }
   return false;
 }
 
+//------------------------------later_ctrl-------------------------------------
+// Return the control of whichever of n1 and n2 is computed later.  Both
+// must be inputs of the same expression so one control dominates the other.
+Node* PhaseIdealLoop::later_ctrl(Node* n1, Node* n2) {
+  Node* c1 = get_ctrl(n1);
+  Node* c2 = get_ctrl(n2);
+  return is_dominator(c1, c2) ? c2 : c1;
+}
+
 //------------------------------do_range_check---------------------------------
 // Eliminate range-checks and other trip-counter vs loop-invariant tests.
 void PhaseIdealLoop::do_range_check( IdealLoopTree *loop, Node_List &old_new ) {
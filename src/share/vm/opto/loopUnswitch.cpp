@@ -67,6 +67,15 @@ bool IdealLoopTree::policy_unswitching( PhaseIdealLoop *phase ) const {
   if (head->unswitch_count() + 1 > head->unswitch_max()) {
     return false;
   }
+  // The first unswitching is only limited by the node count above. Every
+  // further round doubles the number of versions of the loop, so stop
+  // once all versions together would exceed the budget.
+  if (head->unswitch_count() > 0) {
+    int versions_log2 = MIN2(head->unswitch_count() + 1, BitsPerInt - 1);
+    if (_body.size() > ((uint)LoopUnswitchNodeBudget >> versions_log2)) {
+      return false;
+    }
+  }
   return phase->find_unswitching_candidate(this) != NULL;
 }
 
@@ -821,6 +821,508 @@ bool PhaseIdealLoop::is_counted_loop( Node *x, IdealLoopTree *loop ) {
   return true;
 }
 
+//------------------------------create_long_loop_nest--------------------------
+// Convert a loop with a long trip counter
+//
+//   for (long i = init; i < limit; i += stride) { body(i); }
+//
+// into a nest with an int inner loop that is_counted_loop() accepts, so
+// range check elimination, unrolling and vectorization apply to the body:
+//
+//   long outer = init;
+//   do {
+//     int inner_limit = clamp(limit - outer);
+//     int j = 0;
+//     do { body(outer + j); j += stride; } while (j < inner_limit);
+//     outer += j;
+//   } while (outer < limit);
+//
+// The inner limit is clamped so that the int counter can not overflow.
+// The outer loop tests the original long condition and gets a copy of
+// the safepoint the parser put before the backward branch.  The outer
+// backward branch is only taken when the original condition holds for
+// the values of the last inner iteration, which are the values the
+// copied JVM state refers to, so deoptimizing there resumes at the
+// original branch with the right state.  The loop tree is rebuilt in
+// the next round of loop opts.
+//
+// Loop predicates stay above the outer loop.  No JVM state describes
+// the entry of the inner loop in the middle of the outer loop, so the
+// inner loop gets no predicates of its own and relies on range check
+// elimination instead of loop predication.
+bool PhaseIdealLoop::create_long_loop_nest(IdealLoopTree *loop) {
+  Node* x = loop->_head;
+  if (x->Opcode() != Op_Loop || x->in(LoopNode::Self) == NULL ||
+      x->req() != 3 || loop->_irreducible) {
+    return false;
+  }
+  Node* init_control = x->in(LoopNode::EntryControl);
+  Node* back_control = x->in(LoopNode::LoopBackControl);
+  if (init_control == NULL || back_control == NULL ||
+      init_control->is_top() || back_control->is_top()) {
+    return false;
+  }
+  uint back_op = back_control->Opcode();
+  if (back_op != Op_IfTrue && back_op != Op_IfFalse) {
+    return false;
+  }
+  Node* iff = back_control->in(0);
+  if (get_loop(iff) != loop || !iff->in(1)->is_Bool()) {
+    return false;
+  }
+  // The outer loop needs a safepoint: it gets a copy of the one the
+  // parser placed right before the backward branch.
+  Node* sfpt = iff->in(0);
+  if (sfpt->Opcode() != Op_SafePoint || get_loop(sfpt) != loop) {
+    return false;
+  }
+
+  BoolNode* test = iff->in(1)->as_Bool();
+  BoolTest::mask bt = test->_test._test;
+  if (back_op == Op_IfFalse) {
+    bt = BoolTest(bt).negate();
+  }
+  Node* cmp = test->in(1);
+  if (cmp->Opcode() != Op_CmpL) {
+    return false;
+  }
+  Node* cmp_iv = cmp->in(1);
+  Node* limit  = cmp->in(2);
+  if (!is_member(loop, get_ctrl(cmp_iv))) { // Swapped trip counter and limit?
+    Node* tmp = cmp_iv;
+    cmp_iv = limit;
+    limit = tmp;
+    bt = BoolTest(bt).commute();
+  }
+  if (is_member(loop, get_ctrl(limit)) ||   // Limit must be loop-invariant
+      !is_member(loop, get_ctrl(cmp_iv))) { // Trip counter must be loop-variant
+    return false;
+  }
+
+  // Find the trip counter phi and its increment
+  Node* incr = cmp_iv;
+  if (cmp_iv->is_Phi()) {
+    if (cmp_iv->in(0) != x || cmp_iv->req() != 3) {
+      return false;
+    }
+    incr = cmp_iv->in(LoopNode::LoopBackControl);
+  }
+  if (incr == NULL || incr->Opcode() != Op_AddL) {
+    return false;
+  }
+  Node* phi = incr->in(1);
+  Node* stride = incr->in(2);
+  if (!stride->is_Con()) {
+    phi = incr->in(2);
+    stride = incr->in(1);
+    if (!stride->is_Con()) {
+      return false;
+    }
+  }
+  if (!phi->is_Phi() || phi->in(0) != x || phi->req() != 3 ||
+      phi->in(LoopNode::LoopBackControl) != incr ||
+      (cmp_iv->is_Phi() && cmp_iv != phi)) {
+    return false;
+  }
+  // Leave room for a reasonable number of iterations in each chunk
+  jlong stride_l = stride->get_long();
+  if (stride_l == 0 || stride_l > max_jint / 4 || stride_l < -(max_jint / 4)) {
+    return false;
+  }
+  int stride_con = (int)stride_l;
+  if ((bt != BoolTest::lt && bt != BoolTest::le && stride_con > 0) ||
+      (bt != BoolTest::gt && bt != BoolTest::ge && stride_con < 0)) {
+    return false;
+  }
+
+  // Values carried around the loop must be available where the loop is
+  // exited so that the outer loop can carry them as well.
+  Node_List phis;
+  for (DUIterator_Fast imax, i = x->fast_outs(imax); i < imax; i++) {
+    Node* p = x->fast_out(i);
+    if (p->is_Phi()) {
+      Node* be = p->in(LoopNode::LoopBackControl);
+      if (p->req() != 3 || be == NULL ||
+          (be != p && !is_dominator(get_ctrl(be), iff))) {
+        return false;
+      }
+      phis.push(p);
+    }
+  }
+
+  // Largest inner limit that doesn't require a loop limit check
+  // predicate, see is_counted_loop().
+  bool incl_limit = (bt == BoolTest::le || bt == BoolTest::ge);
+  int stride_m = stride_con - (incl_limit ? 0 : (stride_con > 0 ? 1 : -1));
+  if (cmp_iv == phi) {
+    stride_m += stride_con;
+  }
+  jint chunk = stride_con > 0 ? max_jint - stride_m : min_jint - stride_m;
+  jint done  = stride_con > 0 ? -1 : 1;
+
+  IdealLoopTree* outer_loop = loop->_parent;
+  Node* exit = iff->as_If()->proj_out(back_op == Op_IfTrue ? 0 : 1);
+
+  // Outer loop head and its phis
+  LoopNode* outer_head = new (C) LoopNode(init_control, init_control);
+  register_control(outer_head, outer_loop, init_control);
+  _igvn.replace_input_of(x, LoopNode::EntryControl, outer_head);
+  set_idom(x, outer_head, dom_depth(outer_head));
+
+  Node* outer_phi = NULL;
+  for (uint i = 0; i < phis.size(); i++) {
+    Node* p = phis.at(i);
+    Node* outer_p = p->clone();
+    outer_p->set_req(0, outer_head);
+    register_new_node(outer_p, outer_head);
+    if (p == phi) {
+      outer_phi = outer_p;
+    } else {
+      _igvn.replace_input_of(p, LoopNode::EntryControl, outer_p);
+    }
+  }
+
+  // Int trip counter of the inner loop
+  Node* iphi = PhiNode::make(x, _igvn.intcon(0), TypeInt::INT);
+  register_new_node(iphi, x);
+  Node* iincr = new (C) AddINode(iphi, _igvn.intcon(stride_con));
+  register_new_node(iincr, x);
+  _igvn.replace_input_of(iphi, LoopNode::LoopBackControl, iincr);
+
+  Node* iv = new (C) ConvI2LNode(iphi);
+  register_new_node(iv, x);
+  iv = new (C) AddLNode(outer_phi, iv);
+  register_new_node(iv, x);
+  _igvn.replace_node(phi, iv);
+
+  // Inner limit: limit - outer clamped to the chunk size.  The
+  // subtraction may overflow in which case the distance is large.
+  // Once the outer counter is past the limit, the inner loop must
+  // only run the current iteration.
+  Node* chunk_con = _igvn.longcon(chunk);
+  Node* zero = _igvn.longcon(0);
+  Node* diff = new (C) SubLNode(limit, outer_phi);
+  register_new_node(diff, outer_head);
+  Node* clamp_cmp = new (C) CmpLNode(diff, chunk_con);
+  register_new_node(clamp_cmp, outer_head);
+  Node* clamp_bol = new (C) BoolNode(clamp_cmp, stride_con > 0 ? BoolTest::gt : BoolTest::lt);
+  register_new_node(clamp_bol, outer_head);
+  Node* clamp = CMoveNode::make(C, NULL, clamp_bol, diff, chunk_con, TypeLong::LONG);
+  register_new_node(clamp, outer_head);
+  Node* ovf_cmp = new (C) CmpLNode(diff, zero);
+  register_new_node(ovf_cmp, outer_head);
+  Node* ovf_bol = new (C) BoolNode(ovf_cmp, stride_con > 0 ? BoolTest::lt : BoolTest::gt);
+  register_new_node(ovf_bol, outer_head);
+  clamp = CMoveNode::make(C, NULL, ovf_bol, clamp, chunk_con, TypeLong::LONG);
+  register_new_node(clamp, outer_head);
+  Node* done_cmp = new (C) CmpLNode(outer_phi, limit);
+  register_new_node(done_cmp, outer_head);
+  Node* done_bol = new (C) BoolNode(done_cmp, stride_con > 0 ? BoolTest::gt : BoolTest::lt);
+  register_new_node(done_bol, outer_head);
+  clamp = CMoveNode::make(C, NULL, done_bol, clamp, _igvn.longcon(done), TypeLong::LONG);
+  register_new_node(clamp, outer_head);
+  Node* inner_limit = new (C) ConvL2INode(clamp);
+  register_new_node(inner_limit, outer_head);
+  const TypeInt* inner_limit_t = stride_con > 0 ? TypeInt::make(done, chunk, Type::WidenMin)
+                                                : TypeInt::make(chunk, done, Type::WidenMin);
+  inner_limit = new (C) CastIINode(inner_limit, inner_limit_t, true);
+  register_new_node(inner_limit, outer_head);
+
+  // The inner loop exits when the chunk is exhausted or the original
+  // condition fails
+  Node* inner_cmp = new (C) CmpINode(cmp_iv == phi ? iphi : iincr, inner_limit);
+  register_new_node(inner_cmp, x);
+  Node* inner_bol = new (C) BoolNode(inner_cmp, back_op == Op_IfTrue ? bt : BoolTest(bt).negate());
+  register_new_node(inner_bol, x);
+  _igvn.replace_input_of(iff, 1, inner_bol);
+
+  // The outer loop tests the original condition
+  Node* inner_exit = exit->clone();
+  register_control(inner_exit, outer_loop, iff);
+  IfNode* outer_iff = new (C) IfNode(inner_exit, test, PROB_FAIR, COUNT_UNKNOWN);
+  register_control(outer_iff, outer_loop, inner_exit);
+  Node* outer_back;
+  Node* outer_exit;
+  if (back_op == Op_IfTrue) {
+    outer_back = new (C) IfTrueNode(outer_iff);
+    outer_exit = new (C) IfFalseNode(outer_iff);
+  } else {
+    outer_back = new (C) IfFalseNode(outer_iff);
+    outer_exit = new (C) IfTrueNode(outer_iff);
+  }
+  register_control(outer_back, outer_loop, outer_iff);
+  register_control(outer_exit, get_loop(exit), outer_iff);
+  lazy_replace(exit, outer_exit);
+
+  Node* outer_sfpt = sfpt->clone();
+  outer_sfpt->set_req(TypeFunc::Control, outer_back);
+  register_control(outer_sfpt, outer_loop, outer_back);
+  _igvn.replace_input_of(outer_head, LoopNode::LoopBackControl, outer_sfpt);
+
+  recompute_dom_depth();
+
+#ifndef PRODUCT
+  if (TraceLoopOpts) {
+    tty->print("LongLoopNest ");
+    loop->dump_head();
+  }
+#endif
+
+  return true;
+}
+
+//------------------------------create_strip_mined_loop_nest-------------------
+// Strip mine an int loop that is_counted_loop() would convert and strip of
+// its safepoint:
+//
+//   for (int i = init; i < limit; i += stride) { body(i); }
+//
+// becomes an outer loop that polls for safepoints once every
+// LoopStripMiningIter iterations around an inner loop that runs at most
+// that many iterations:
+//
+//   int i = init;
+//   do {
+//     int inner_limit = min(limit, i + LoopStripMiningIter * stride);
+//     do { body(i); i += stride; } while (i < inner_limit);
+//   } while (i < limit);
+//
+// The inner loop keeps the original trip counter and its safepoint is
+// removed so that it becomes a counted loop in the next round and is
+// unrolled and vectorized as before.  The inner limit is clamped so that
+// no loop limit check predicate is needed, see is_counted_loop().  The
+// outer loop tests the original condition and is never a candidate for
+// strip mining itself since its test isn't preceded by a safepoint.
+// The outer loop is added to the loop tree, so the transforms that follow
+// in the same round see the nest.
+bool PhaseIdealLoop::create_strip_mined_loop_nest(IdealLoopTree *loop, bool check_only) {
+  Node* x = loop->_head;
+  if (x->Opcode() != Op_Loop || x->in(LoopNode::Self) == NULL ||
+      x->req() != 3 || loop->_irreducible || loop->_has_call) {
+    return false;
+  }
+  if (!Matcher::has_match_rule(Op_MinI) || !Matcher::has_match_rule(Op_MaxI)) {
+    return false;
+  }
+  Node* init_control = x->in(LoopNode::EntryControl);
+  Node* back_control = x->in(LoopNode::LoopBackControl);
+  if (init_control == NULL || back_control == NULL ||
+      init_control->is_top() || back_control->is_top()) {
+    return false;
+  }
+  uint back_op = back_control->Opcode();
+  if (back_op != Op_IfTrue && back_op != Op_IfFalse) {
+    return false;
+  }
+  Node* iff = back_control->in(0);
+  if (get_loop(iff) != loop || !iff->in(1)->is_Bool()) {
+    return false;
+  }
+  // The safepoint the parser placed right before the backward branch
+  // moves to the outer loop.
+  Node* sfpt = iff->in(0);
+  if (sfpt->Opcode() != Op_SafePoint || get_loop(sfpt) != loop ||
+      !is_deleteable_safept(sfpt)) {
+    return false;
+  }
+
+  BoolNode* test = iff->in(1)->as_Bool();
+  BoolTest::mask bt = test->_test._test;
+  if (back_op == Op_IfFalse) {
+    bt = BoolTest(bt).negate();
+  }
+  Node* cmp = test->in(1);
+  if (cmp->Opcode() != Op_CmpI) {
+    return false;
+  }
+  Node* incr  = cmp->in(1);
+  Node* limit = cmp->in(2);
+  if (!is_member(loop, get_ctrl(incr))) { // Swapped trip counter and limit?
+    Node* tmp = incr;
+    incr = limit;
+    limit = tmp;
+    bt = BoolTest(bt).commute();
+  }
+  if (is_member(loop, get_ctrl(limit)) ||   // Limit must be loop-invariant
+      !is_member(loop, get_ctrl(incr))) {   // Trip counter must be loop-variant
+    return false;
+  }
+
+  // Only the plain shape: the test is on the increment of the trip
+  // counter phi, without truncation.
+  if (incr->Opcode() != Op_AddI) {
+    return false;
+  }
+  Node* phi = incr->in(1);
+  Node* stride = incr->in(2);
+  if (!stride->is_Con()) {
+    phi = incr->in(2);
+    stride = incr->in(1);
+    if (!stride->is_Con()) {
+      return false;
+    }
+  }
+  if (!phi->is_Phi() || phi->in(0) != x || phi->req() != 3 ||
+      phi->in(LoopNode::LoopBackControl) != incr) {
+    return false;
+  }
+  int stride_con = stride->get_int();
+  if (stride_con == 0 ||
+      (bt != BoolTest::lt && bt != BoolTest::le && stride_con > 0) ||
+      (bt != BoolTest::gt && bt != BoolTest::ge && stride_con < 0)) {
+    return false;
+  }
+  jlong chunk_l = (jlong)LoopStripMiningIter * stride_con;
+  if (chunk_l > max_jint / 4 || chunk_l < -(max_jint / 4)) {
+    return false;
+  }
+  jint chunk = (jint)chunk_l;
+
+  // Not worth it if the loop can't run longer than a single chunk
+  const TypeInt* init_t  = _igvn.type(phi->in(LoopNode::EntryControl))->is_int();
+  const TypeInt* limit_t = _igvn.type(limit)->is_int();
+  if ((stride_con > 0 && (jlong)limit_t->_hi - init_t->_lo <= chunk_l) ||
+      (stride_con < 0 && (jlong)limit_t->_lo - init_t->_hi >= chunk_l)) {
+    return false;
+  }
+
+  // Values carried around the loop must be available where the loop is
+  // exited so that the outer loop can carry them as well.
+  Node_List phis;
+  for (DUIterator_Fast imax, i = x->fast_outs(imax); i < imax; i++) {
+    Node* p = x->fast_out(i);
+    if (p->is_Phi()) {
+      Node* be = p->in(LoopNode::LoopBackControl);
+      if (p->req() != 3 || be == NULL ||
+          (be != p && !is_dominator(get_ctrl(be), iff))) {
+        return false;
+      }
+      phis.push(p);
+    }
+  }
+
+  // Largest inner limit that doesn't require a loop limit check
+  // predicate, see is_counted_loop().
+  bool incl_limit = (bt == BoolTest::le || bt == BoolTest::ge);
+  int stride_m = stride_con - (incl_limit ? 0 : (stride_con > 0 ? 1 : -1));
+  jint bound = stride_con > 0 ? max_jint - stride_m : min_jint - stride_m;
+
+  if (check_only) {
+    return true;
+  }
+
+  // Put the outer loop between the inner loop and its parent
+  IdealLoopTree* parent = loop->_parent;
+  IdealLoopTree* outer_loop = new IdealLoopTree(this, NULL, NULL);
+  IdealLoopTree** pp = &parent->_child;
+  while (*pp != loop) {
+    pp = &(*pp)->_next;
+  }
+  *pp = outer_loop;
+  outer_loop->_parent = parent;
+  outer_loop->_next   = loop->_next;
+  outer_loop->_child  = loop;
+  outer_loop->_nest   = loop->_nest;
+  outer_loop->_has_sfpt = 1;
+  loop->_parent = outer_loop;
+  loop->_next   = NULL;
+  loop->_nest++;
+
+  Node* exit = iff->as_If()->proj_out(back_op == Op_IfTrue ? 0 : 1);
+
+  // Outer loop head and its phis
+  LoopNode* outer_head = new (C) LoopNode(init_control, init_control);
+  outer_loop->_head = outer_head;
+  register_control(outer_head, outer_loop, init_control);
+  _igvn.replace_input_of(x, LoopNode::EntryControl, outer_head);
+  set_idom(x, outer_head, dom_depth(outer_head));
+
+  Node* outer_phi = NULL;
+  for (uint i = 0; i < phis.size(); i++) {
+    Node* p = phis.at(i);
+    Node* outer_p = p->clone();
+    outer_p->set_req(0, outer_head);
+    register_new_node(outer_p, outer_head);
+    _igvn.replace_input_of(p, LoopNode::EntryControl, outer_p);
+    if (p == phi) {
+      outer_phi = outer_p;
+    }
+  }
+
+  // Inner limit: the original limit or the end of the chunk, whichever
+  // comes first.  Both are clamped to the bound so the int arithmetic
+  // can't overflow.
+  Node* bound_con = _igvn.intcon(bound);
+  Node* inner_limit;
+  Node* chunk_start;
+  if (stride_con > 0) {
+    inner_limit = new (C) MinINode(limit, bound_con);
+    chunk_start = new (C) MinINode(outer_phi, _igvn.intcon(bound - chunk));
+  } else {
+    inner_limit = new (C) MaxINode(limit, bound_con);
+    chunk_start = new (C) MaxINode(outer_phi, _igvn.intcon(bound - chunk));
+  }
+  register_new_node(inner_limit, outer_head);
+  register_new_node(chunk_start, outer_head);
+  Node* chunk_end = new (C) AddINode(chunk_start, _igvn.intcon(chunk));
+  register_new_node(chunk_end, outer_head);
+  if (stride_con > 0) {
+    inner_limit = new (C) MinINode(inner_limit, chunk_end);
+  } else {
+    inner_limit = new (C) MaxINode(inner_limit, chunk_end);
+  }
+  register_new_node(inner_limit, outer_head);
+
+  // The inner loop exits when the chunk is exhausted or the original
+  // condition fails
+  Node* inner_cmp = new (C) CmpINode(incr, inner_limit);
+  register_new_node(inner_cmp, x);
+  Node* inner_bol = new (C) BoolNode(inner_cmp, back_op == Op_IfTrue ? bt : BoolTest(bt).negate());
+  register_new_node(inner_bol, x);
+  _igvn.replace_input_of(iff, 1, inner_bol);
+
+  // The outer loop tests the original condition
+  Node* inner_exit = exit->clone();
+  register_control(inner_exit, outer_loop, iff);
+  IfNode* outer_iff = new (C) IfNode(inner_exit, test, iff->as_If()->_prob, COUNT_UNKNOWN);
+  register_control(outer_iff, outer_loop, inner_exit);
+  Node* outer_back;
+  Node* outer_exit;
+  if (back_op == Op_IfTrue) {
+    outer_back = new (C) IfTrueNode(outer_iff);
+    outer_exit = new (C) IfFalseNode(outer_iff);
+  } else {
+    outer_back = new (C) IfFalseNode(outer_iff);
+    outer_exit = new (C) IfTrueNode(outer_iff);
+  }
+  register_control(outer_back, outer_loop, outer_iff);
+  register_control(outer_exit, get_loop(exit), outer_iff);
+  lazy_replace(exit, outer_exit);
+
+  Node* outer_sfpt = sfpt->clone();
+  outer_sfpt->set_req(TypeFunc::Control, outer_back);
+  register_control(outer_sfpt, outer_loop, outer_back);
+  _igvn.replace_input_of(outer_head, LoopNode::LoopBackControl, outer_sfpt);
+  outer_loop->_tail = outer_sfpt;
+
+  // The inner loop is bounded now and doesn't need its safepoint
+  lazy_replace(sfpt, sfpt->in(TypeFunc::Control));
+  if (loop->_safepts != NULL) {
+    loop->_safepts->yank(sfpt);
+  }
+
+  recompute_dom_depth();
+
+#ifndef PRODUCT
+  if (TraceLoopOpts) {
+    tty->print("StripMined   ");
+    loop->dump_head();
+  }
+#endif
+
+  return true;
+}
+
 //----------------------exact_limit-------------------------------------------
 Node* PhaseIdealLoop::exact_limit( IdealLoopTree *loop ) {
   assert(loop->_head->is_CountedLoop(), "");
@@ -1864,8 +2366,13 @@ void IdealLoopTree::counted_loop( PhaseIdealLoop *phase ) {
     if (_head->is_Loop()) _head->as_Loop()->set_inner_loop();
   }
 
-  if (_head->is_CountedLoop() ||
-      phase->is_counted_loop(_head, this)) {
+  if (LoopStripMiningIter > 0 && !UseCountedLoopSafepoints && !_child &&
+      _allow_optimizations && phase->create_strip_mined_loop_nest(this, true /* check_only */)) {
+    // Strip mined once the loop tree is complete, see build_and_optimize().
+    // The inner loop is recognized as a counted loop in the next round.
+
+  } else if (_head->is_CountedLoop() ||
+             phase->is_counted_loop(_head, this)) {
 
     if (!UseCountedLoopSafepoints) {
       // Indicate we do not need a safepoint here
@@ -2356,6 +2863,24 @@ void PhaseIdealLoop::build_and_optimize(bool do_split_ifs, bool skip_loop_opts)
     return;
   }
 
+  // Strip mine the loops counted_loop() left alone.  The loop tree is not
+  // changed while it is walked: candidates are collected first.
+  if (LoopStripMiningIter > 0 && !UseCountedLoopSafepoints && C->has_loops()) {
+    Node_List strip_mined_loops;
+    for (LoopTreeIterator iter(_ltree_root); !iter.done(); iter.next()) {
+      IdealLoopTree* lpt = iter.current();
+      if (lpt->is_inner() && lpt->_allow_optimizations &&
+          lpt->_head->Opcode() == Op_Loop) {
+        strip_mined_loops.push(lpt->_head);
+      }
+    }
+    for (uint i = 0; i < strip_mined_loops.size(); i++) {
+      if (create_strip_mined_loop_nest(get_loop(strip_mined_loops.at(i)))) {
+        C->set_major_progress();
+      }
+    }
+  }
+
   if (ReassociateInvariants) {
     // Reassociate invariants and prep for split_thru_phi
     for (LoopTreeIterator iter(_ltree_root); !iter.done(); iter.next()) {
@@ -2387,6 +2912,26 @@ void PhaseIdealLoop::build_and_optimize(bool do_split_ifs, bool skip_loop_opts)
     C->set_major_progress();
   }
 
+  // Nest loops with a long trip counter around an int counted loop.  The
+  // loop tree is not changed while it is walked: candidates are collected
+  // first and the new loops are only recognized in the next round.
+  if (UseLongCountedLoops && C->has_loops() && !C->major_progress() &&
+      Matcher::has_match_rule(Op_CMoveL)) {
+    Node_List long_loops;
+    for (LoopTreeIterator iter(_ltree_root); !iter.done(); iter.next()) {
+      IdealLoopTree* lpt = iter.current();
+      if (lpt->is_inner() && lpt->_allow_optimizations &&
+          lpt->_head->Opcode() == Op_Loop) {
+        long_loops.push(lpt->_head);
+      }
+    }
+    for (uint i = 0; i < long_loops.size(); i++) {
+      if (create_long_loop_nest(get_loop(long_loops.at(i)))) {
+        C->set_major_progress();
+      }
+    }
+  }
+
   // Perform loop predication before iteration splitting
   if (C->has_loops() && !C->major_progress() && (C->predicate_count() > 0)) {
     _ltree_root->_child->loop_predication(this);
@@ -2468,6 +3013,8 @@ void PhaseIdealLoop::build_and_optimize(bool do_split_ifs, bool skip_loop_opts)
   }
 }
 
+volatile jint PhaseIdealLoop::_lock_coarsening_unrolls = 0;
+
 #ifndef PRODUCT
 //------------------------------print_statistics-------------------------------
 int PhaseIdealLoop::_loop_invokes=0;// Count of PhaseIdealLoop invokes
@@ -64,7 +64,6 @@ protected:
          PartialPeelLoop=32,
          PartialPeelFailed=64 };
   char _unswitch_count;
-  enum { _unswitch_max=3 };
 
 public:
   // Names for edge indices
@@ -78,7 +77,7 @@ public:
   int partial_peel_has_failed() const { return _loop_flags & PartialPeelFailed; }
   void mark_partial_peel_failed() { _loop_flags |= PartialPeelFailed; }
 
-  int unswitch_max() { return _unswitch_max; }
+  int unswitch_max() { return LoopMaxUnswitch; }
   int unswitch_count() { return _unswitch_count; }
   void set_unswitch_count(int val) {
     assert (val <= unswitch_max(), "too many unswitches");
@@ -459,6 +458,10 @@ public:
   // the loop is a CountedLoop and the body is small enough.
   bool policy_unroll( PhaseIdealLoop *phase ) const;
 
+  // Return TRUE if the loop body locks and unlocks a loop invariant object,
+  // so that unrolling lets the locks of consecutive iterations be coarsened.
+  bool has_coarsenable_lock( PhaseIdealLoop *phase ) const;
+
   // Return TRUE or FALSE if the loop should be range-check-eliminated.
   // Gather a list of IF tests that are dominated by iteration splitting;
   // also gather the end of the first split and the start of the 2nd split.
@@ -826,6 +829,15 @@ public:
 
   bool is_counted_loop( Node *x, IdealLoopTree *loop );
 
+  // Convert a loop with a long trip counter into an int counted loop
+  // nested in an outer loop that advances the long counter.
+  bool create_long_loop_nest( IdealLoopTree *loop );
+
+  // Nest an int loop that would lose its safepoint inside an outer loop
+  // that polls once every LoopStripMiningIter iterations.  With check_only
+  // the graph is not changed, only the shape of the loop is checked.
+  bool create_strip_mined_loop_nest( IdealLoopTree *loop, bool check_only = false );
+
   Node* exact_limit( IdealLoopTree *loop );
 
   // Return a post-walked LoopNode
@@ -886,9 +898,12 @@ public:
   // Return true if exp is a constant times an induction var
   bool is_scaled_iv(Node* exp, Node* iv, int* p_scale);
 
-  // Return true if exp is a scaled induction var plus (or minus) constant
+  // Return true if exp is a scaled induction var plus (or minus) an offset
   bool is_scaled_iv_plus_offset(Node* exp, Node* iv, int* p_scale, Node** p_offset, int depth = 0);
 
+  // Control of whichever of the two nodes is computed later
+  Node* later_ctrl(Node* n1, Node* n2);
+
   // Create a new if above the uncommon_trap_if_pattern for the predicate to be promoted
   ProjNode* create_new_if_for_predicate(ProjNode* cont_proj, Node* new_entry,
                                         Deoptimization::DeoptReason reason);
@@ -1076,6 +1091,9 @@ public:
   void dump_bad_graph(const char* msg, Node* n, Node* early, Node* LCA);
 #endif
 
+  // Count of loops unrolled to coarsen locks across loop iterations
+  static volatile jint _lock_coarsening_unrolls;
+
 #ifndef PRODUCT
   void dump( ) const;
   void dump( IdealLoopTree *loop, uint rpo_idx, Node_List &rpo_list ) const;
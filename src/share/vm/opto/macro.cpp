@@ -40,6 +40,7 @@
 #include "opto/runtime.hpp"
 #include "opto/subnode.hpp"
 #include "opto/type.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "runtime/sharedRuntime.hpp"
 
 
@@ -2037,6 +2038,9 @@ void PhaseMacroExpand::mark_eliminated_locking_nodes(AbstractLockNode *alock) {
   }
 }
 
+volatile jint PhaseMacroExpand::_coarsened_locks   = 0;
+volatile jint PhaseMacroExpand::_coarsened_unlocks = 0;
+
 // we have determined that this lock/unlock can be eliminated, we simply
 // eliminate the node without expanding it.
 //
@@ -2058,6 +2062,10 @@ bool PhaseMacroExpand::eliminate_locking_node(AbstractLockNode *alock) {
 
   alock->log_lock_optimization(C, "eliminate_lock");
 
+  if (alock->is_coarsened() && alock->in_coarsening_loop()) {
+    Atomic::inc(alock->is_Lock() ? &_coarsened_locks : &_coarsened_unlocks);
+  }
+
 #ifndef PRODUCT
   if (PrintEliminateLocks) {
     if (alock->is_Lock()) {
@@ -126,6 +126,10 @@ public:
   void eliminate_macro_nodes();
   bool expand_macro_nodes();
 
+  // Counts of lock and unlock nodes removed by lock coarsening across
+  // the iterations of loops unrolled for it (LoopLockCoarsening)
+  static volatile jint _coarsened_locks;
+  static volatile jint _coarsened_unlocks;
 };
 
 #endif // SHARE_VM_OPTO_MACRO_HPP
@@ -352,6 +352,8 @@ class Parse : public GraphKit {
 
   const FastLockNode* _synch_lock; // FastLockNode for synchronized method
 
+  int _switch_profile_depth;    // Deepest switch tree level split by profile counts
+
 #ifndef PRODUCT
   int _max_switch_depth;        // Debugging SwitchRanges.
   int _est_switch_depth;        // Debugging SwitchRanges.
@@ -563,7 +565,7 @@ class Parse : public GraphKit {
   void    sharpen_type_after_if(BoolTest::mask btest,
                                 Node* con, const Type* tcon,
                                 Node* val, const Type* tval);
-  IfNode* jump_if_fork_int(Node* a, Node* b, BoolTest::mask mask);
+  IfNode* jump_if_fork_int(Node* a, Node* b, BoolTest::mask mask, float prob = PROB_UNKNOWN, float cnt = COUNT_UNKNOWN);
   Node*   jump_if_join(Node* iffalse, Node* iftrue);
   void    jump_if_true_fork(IfNode *ifNode, int dest_bci_if_true, int prof_table_index);
   void    jump_if_false_fork(IfNode *ifNode, int dest_bci_if_false, int prof_table_index);
@@ -574,6 +576,8 @@ class Parse : public GraphKit {
   void    do_lookupswitch();
   void    jump_switch_ranges(Node* a, SwitchRange* lo, SwitchRange* hi, int depth = 0);
   bool    create_jump_tables(Node* a, SwitchRange* lo, SwitchRange* hi);
+  void    peel_hot_switch_ranges(Node* a, SwitchRange* lo, SwitchRange* hi);
+  ciMultiBranchData* switch_profile();
 
   // helper functions for methodData style profiling
   void test_counter_against_threshold(Node* cnt, int limit);
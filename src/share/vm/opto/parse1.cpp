@@ -399,6 +399,7 @@ Parse::Parse(JVMState* caller, ciMethod* parse_method, float expected_uses)
   _first_return = true;
   _replaced_nodes_for_exceptions = false;
   _new_idx = C->unique();
+  _switch_profile_depth = 0;
   debug_only(_block_count = -1);
   debug_only(_blocks = (Block*)-1);
 #ifndef PRODUCT
@@ -171,10 +171,13 @@ Node* Parse::array_addressing(BasicType type, int vals, const Type* *result2) {
 
 
 // returns IfNode
-IfNode* Parse::jump_if_fork_int(Node* a, Node* b, BoolTest::mask mask) {
+IfNode* Parse::jump_if_fork_int(Node* a, Node* b, BoolTest::mask mask, float prob, float cnt) {
   Node   *cmp = _gvn.transform( new (C) CmpINode( a, b)); // two cases: shiftcount > 32 and shiftcount <= 32
   Node   *tst = _gvn.transform( new (C) BoolNode( cmp, mask));
-  IfNode *iff = create_and_map_if( control(), tst, ((mask == BoolTest::eq) ? PROB_STATIC_INFREQUENT : PROB_FAIR), COUNT_UNKNOWN );
+  if (prob == PROB_UNKNOWN) {
+    prob = (mask == BoolTest::eq) ? PROB_STATIC_INFREQUENT : PROB_FAIR;
+  }
+  IfNode *iff = create_and_map_if( control(), tst, prob, cnt );
   return iff;
 }
 
@@ -246,6 +249,7 @@ class SwitchRange : public StackObj {
   jint _hi;                     // inclusive upper limit
   int _dest;
   int _table_index;             // index into method data table
+  float _cnt;                   // how many times this range was hit according to profiling
 
 public:
   jint lo() const              { return _lo;   }
@@ -253,27 +257,31 @@ public:
   int  dest() const            { return _dest; }
   int  table_index() const     { return _table_index; }
   bool is_singleton() const    { return _lo == _hi; }
+  float cnt() const            { return _cnt; }
 
-  void setRange(jint lo, jint hi, int dest, int table_index) {
+  void setRange(jint lo, jint hi, int dest, int table_index, float cnt) {
     assert(lo <= hi, "must be a non-empty range");
-    _lo = lo, _hi = hi; _dest = dest; _table_index = table_index;
+    _lo = lo, _hi = hi; _dest = dest; _table_index = table_index; _cnt = cnt;
   }
-  bool adjoinRange(jint lo, jint hi, int dest, int table_index) {
+  bool adjoinRange(jint lo, jint hi, int dest, int table_index, float cnt) {
     assert(lo <= hi, "must be a non-empty range");
     if (lo == _hi+1 && dest == _dest && table_index == _table_index) {
       _hi = hi;
+      _cnt += cnt;
       return true;
     }
     return false;
   }
 
-  void set (jint value, int dest, int table_index) {
-    setRange(value, value, dest, table_index);
+  void set (jint value, int dest, int table_index, float cnt) {
+    setRange(value, value, dest, table_index, cnt);
   }
-  bool adjoin(jint value, int dest, int table_index) {
-    return adjoinRange(value, value, dest, table_index);
+  bool adjoin(jint value, int dest, int table_index, float cnt) {
+    return adjoinRange(value, value, dest, table_index, cnt);
   }
 
+  void set_cnt(float cnt) { _cnt = cnt; }
+
   void print() {
     if (is_singleton())
       tty->print(" {%d}=>%d", lo(), dest());
@@ -283,9 +291,45 @@ public:
       tty->print(" {%d..}=>%d", lo(), dest());
     else
       tty->print(" {%d..%d}=>%d", lo(), hi(), dest());
+    if (_cnt > 0) {
+      tty->print(" (%.0f)", _cnt);
+    }
   }
 };
 
+// Sum of the profile counts of all the ranges in [lo..hi]
+static float sum_of_cnts(SwitchRange* lo, SwitchRange* hi) {
+  float cnt = 0;
+  for (SwitchRange* sr = lo; sr <= hi; sr++) {
+    cnt += sr->cnt();
+  }
+  return cnt;
+}
+
+// Clamp a probability computed from switch profile counts
+static float switch_prob(float cnt, float total) {
+  float prob = cnt / total;
+  return MIN2(MAX2(prob, PROB_MIN), PROB_MAX);
+}
+
+//------------------------------switch_profile---------------------------------
+// Returns the profile of the current switch bytecode if it is usable for
+// ordering the decision tree, NULL otherwise.
+ciMultiBranchData* Parse::switch_profile() {
+  if (!UseSwitchProfiling) {
+    return NULL;
+  }
+  ciMethodData* methodData = method()->method_data();
+  if (!methodData->is_mature()) {
+    return NULL;
+  }
+  ciProfileData* data = methodData->bci_to_data(bci());
+  if (data == NULL || !data->is_MultiBranchData()) {
+    return NULL;
+  }
+  return (ciMultiBranchData*)data->as_MultiBranchData();
+}
+
 
 //-------------------------------do_tableswitch--------------------------------
 void Parse::do_tableswitch() {
@@ -304,28 +348,37 @@ void Parse::do_tableswitch() {
     return;
   }
 
+  ciMultiBranchData* profile = switch_profile();
+  float default_cnt = 0;
+  if (profile != NULL) {
+    // The default count is shared by the (at most two) ranges around the table
+    int default_ranges = (lo_index != min_jint ? 1 : 0) + (hi_index != max_jint ? 1 : 0);
+    default_cnt = (float)profile->default_count() / MAX2(default_ranges, 1);
+  }
+
   // generate decision tree, using trichotomy when possible
   int rnum = len+2;
   bool makes_backward_branch = false;
   SwitchRange* ranges = NEW_RESOURCE_ARRAY(SwitchRange, rnum);
   int rp = -1;
   if (lo_index != min_jint) {
-    ranges[++rp].setRange(min_jint, lo_index-1, default_dest, NullTableIndex);
+    ranges[++rp].setRange(min_jint, lo_index-1, default_dest, NullTableIndex, default_cnt);
   }
   for (int j = 0; j < len; j++) {
     jint match_int = lo_index+j;
     int  dest      = iter().get_dest_table(j+3);
     makes_backward_branch |= (dest <= bci());
     int  table_index = method_data_update() ? j : NullTableIndex;
-    if (rp < 0 || !ranges[rp].adjoin(match_int, dest, table_index)) {
-      ranges[++rp].set(match_int, dest, table_index);
+    float cnt = (profile != NULL) ? (float)profile->count_at(j) : 0;
+    if (rp < 0 || !ranges[rp].adjoin(match_int, dest, table_index, cnt)) {
+      ranges[++rp].set(match_int, dest, table_index, cnt);
     }
   }
   jint highest = lo_index+(len-1);
   assert(ranges[rp].hi() == highest, "");
   if (highest != max_jint
-      && !ranges[rp].adjoinRange(highest+1, max_jint, default_dest, NullTableIndex)) {
-    ranges[++rp].setRange(highest+1, max_jint, default_dest, NullTableIndex);
+      && !ranges[rp].adjoinRange(highest+1, max_jint, default_dest, NullTableIndex, default_cnt)) {
+    ranges[++rp].setRange(highest+1, max_jint, default_dest, NullTableIndex, default_cnt);
   }
   assert(rp < len+2, "not too many ranges");
 
@@ -360,6 +413,24 @@ void Parse::do_lookupswitch() {
     qsort( table, len, 2*sizeof(table[0]), jint_cmp );
   }
 
+  ciMultiBranchData* profile = switch_profile();
+  float default_cnt = 0;
+  if (profile != NULL) {
+    // The default count is shared evenly by the gaps between the keys.
+    // Keys are sorted in the bytecode already, so the profile's case
+    // indices match the sorted table.
+    int default_ranges = (table[0] != min_jint) ? 1 : 0;
+    for (int j = 1; j < len; j++) {
+      if (table[j+j+0] != table[j+j-2] + 1) {
+        default_ranges++;
+      }
+    }
+    if (table[2*(len-1)] != max_jint) {
+      default_ranges++;
+    }
+    default_cnt = (float)profile->default_count() / MAX2(default_ranges, 1);
+  }
+
   int rnum = len*2+1;
   bool makes_backward_branch = false;
   SwitchRange* ranges = NEW_RESOURCE_ARRAY(SwitchRange, rnum);
@@ -369,19 +440,20 @@ void Parse::do_lookupswitch() {
     int  dest        = table[j+j+1];
     int  next_lo     = rp < 0 ? min_jint : ranges[rp].hi()+1;
     int  table_index = method_data_update() ? j : NullTableIndex;
+    float cnt        = (profile != NULL) ? (float)profile->count_at(j) : 0;
     makes_backward_branch |= (dest <= bci());
     if( match_int != next_lo ) {
-      ranges[++rp].setRange(next_lo, match_int-1, default_dest, NullTableIndex);
+      ranges[++rp].setRange(next_lo, match_int-1, default_dest, NullTableIndex, default_cnt);
     }
-    if( rp < 0 || !ranges[rp].adjoin(match_int, dest, table_index) ) {
-      ranges[++rp].set(match_int, dest, table_index);
+    if( rp < 0 || !ranges[rp].adjoin(match_int, dest, table_index, cnt) ) {
+      ranges[++rp].set(match_int, dest, table_index, cnt);
     }
   }
   jint highest = table[2*(len-1)];
   assert(ranges[rp].hi() == highest, "");
   if( highest != max_jint
-      && !ranges[rp].adjoinRange(highest+1, max_jint, default_dest, NullTableIndex) ) {
-    ranges[++rp].setRange(highest+1, max_jint, default_dest, NullTableIndex);
+      && !ranges[rp].adjoinRange(highest+1, max_jint, default_dest, NullTableIndex, default_cnt) ) {
+    ranges[++rp].setRange(highest+1, max_jint, default_dest, NullTableIndex, default_cnt);
   }
   assert(rp < rnum, "not too many ranges");
 
@@ -494,6 +566,46 @@ bool Parse::create_jump_tables(Node* key_val, SwitchRange* lo, SwitchRange* hi)
   return true;
 }
 
+//--------------------------peel_hot_switch_ranges------------------------------
+// Test for the hottest ranges of a profiled switch up front, before the
+// decision tree is entered.  A range is peeled as long as it was taken more
+// often than all the remaining ranges together.  Peeled ranges stay in the
+// tree (with no count) so the tree still covers the whole key domain.
+void Parse::peel_hot_switch_ranges(Node* key_val, SwitchRange* lo, SwitchRange* hi) {
+  float total_cnt = sum_of_cnts(lo, hi);
+  // Enough to pay for the extra tests even when nothing is peeled
+  const int max_peeled = 3;
+  for (int peeled = 0; peeled < max_peeled && total_cnt > 0; peeled++) {
+    SwitchRange* hottest = lo;
+    for (SwitchRange* sr = lo + 1; sr <= hi; sr++) {
+      if (sr->cnt() > hottest->cnt()) {
+        hottest = sr;
+      }
+    }
+    if (hottest->cnt() * 2 <= total_cnt) {
+      break;
+    }
+    float prob = switch_prob(hottest->cnt(), total_cnt);
+    Node* tst;
+    if (hottest->is_singleton()) {
+      Node* cmp = _gvn.transform(new (C) CmpINode(key_val, _gvn.intcon(hottest->lo())));
+      tst = _gvn.transform(new (C) BoolNode(cmp, BoolTest::eq));
+    } else {
+      // (unsigned)(key - lo) <= (hi - lo)
+      Node* adjusted = _gvn.transform(new (C) SubINode(key_val, _gvn.intcon(hottest->lo())));
+      Node* cmp = _gvn.transform(new (C) CmpUNode(adjusted, _gvn.intcon((juint)hottest->hi() - (juint)hottest->lo())));
+      tst = _gvn.transform(new (C) BoolNode(cmp, BoolTest::le));
+    }
+    IfNode* iff = create_and_map_if(control(), tst, prob, total_cnt);
+    jump_if_true_fork(iff, hottest->dest(), hottest->table_index());
+    total_cnt -= hottest->cnt();
+    hottest->set_cnt(0);
+    if (stopped()) {
+      break;
+    }
+  }
+}
+
 //----------------------------jump_switch_ranges-------------------------------
 void Parse::jump_switch_ranges(Node* key_val, SwitchRange *lo, SwitchRange *hi, int switch_depth) {
   Block* switch_block = block();
@@ -532,9 +644,18 @@ void Parse::jump_switch_ranges(Node* key_val, SwitchRange *lo, SwitchRange *hi,
       assert(min_val <= max_val, "invalid int type");
     }
     while (lo->hi() < min_val)  lo++;
-    if (lo->lo() < min_val)  lo->setRange(min_val, lo->hi(), lo->dest(), lo->table_index());
+    if (lo->lo() < min_val)  lo->setRange(min_val, lo->hi(), lo->dest(), lo->table_index(), lo->cnt());
     while (hi->lo() > max_val)  hi--;
-    if (hi->hi() > max_val)  hi->setRange(hi->lo(), max_val, hi->dest(), hi->table_index());
+    if (hi->hi() > max_val)  hi->setRange(hi->lo(), max_val, hi->dest(), hi->table_index(), hi->cnt());
+
+    if (UseSwitchProfiling && lo < hi) {
+      peel_hot_switch_ranges(key_val, lo, hi);
+    }
+
+    // A skewed profile would otherwise peel off one range per level.
+    // Below this depth the ranges are split in the middle, so the tree
+    // stays within a few levels of a balanced one.
+    _switch_profile_depth = log2_intptr((hi-lo+1)-1)+1 + 3;
   }
 
 #ifndef PRODUCT
@@ -554,34 +675,56 @@ void Parse::jump_switch_ranges(Node* key_val, SwitchRange *lo, SwitchRange *hi,
     if (create_jump_tables(key_val, lo, hi)) return;
 
     int nr = hi - lo + 1;
+    float total_cnt = UseSwitchProfiling ? sum_of_cnts(lo, hi) : 0;
+    bool split_by_cnt = total_cnt > 0 && switch_depth < _switch_profile_depth;
 
     SwitchRange* mid = lo + nr/2;
-    // if there is an easy choice, pivot at a singleton:
-    if (nr > 3 && !mid->is_singleton() && (mid-1)->is_singleton())  mid--;
+    if (split_by_cnt) {
+      // Balance the tree by profile counts rather than by number of
+      // ranges so that hot cases end up close to the root.
+      float lo_cnt = 0;
+      float best_diff = total_cnt;
+      for (SwitchRange* sr = lo + 1; sr <= hi; sr++) {
+        lo_cnt += (sr-1)->cnt();
+        float diff = fabs(total_cnt - 2 * lo_cnt);
+        if (diff < best_diff) {
+          best_diff = diff;
+          mid = sr;
+        }
+      }
+    } else {
+      // if there is an easy choice, pivot at a singleton:
+      if (nr > 3 && !mid->is_singleton() && (mid-1)->is_singleton())  mid--;
 
+      assert(nr != 2 || mid == hi,   "should pick higher of 2");
+      assert(nr != 3 || mid == hi-1, "should pick middle of 3");
+    }
     assert(lo < mid && mid <= hi, "good pivot choice");
-    assert(nr != 2 || mid == hi,   "should pick higher of 2");
-    assert(nr != 3 || mid == hi-1, "should pick middle of 3");
 
     Node *test_val = _gvn.intcon(mid->lo());
 
     if (mid->is_singleton()) {
-      IfNode *iff_ne = jump_if_fork_int(key_val, test_val, BoolTest::ne);
+      float prob = PROB_UNKNOWN;
+      if (total_cnt > 0) {
+        prob = switch_prob(total_cnt - mid->cnt(), total_cnt);
+      }
+      IfNode *iff_ne = jump_if_fork_int(key_val, test_val, BoolTest::ne, prob);
       jump_if_false_fork(iff_ne, mid->dest(), mid->table_index());
 
       // Special Case:  If there are exactly three ranges, and the high
       // and low range each go to the same place, omit the "gt" test,
       // since it will not discriminate anything.
-      bool eq_test_only = (hi == lo+2 && hi->dest() == lo->dest());
-      if (eq_test_only) {
-        assert(mid == hi-1, "");
-      }
+      bool eq_test_only = (hi == lo+2 && mid == hi-1 && hi->dest() == lo->dest());
 
       // if there is a higher range, test for it and process it:
       if (mid < hi && !eq_test_only) {
         // two comparisons of same values--should enable 1 test for 2 branches
         // Use BoolTest::le instead of BoolTest::gt
-        IfNode *iff_le  = jump_if_fork_int(key_val, test_val, BoolTest::le);
+        float prob = PROB_UNKNOWN;
+        if (total_cnt > mid->cnt()) {
+          prob = switch_prob(sum_of_cnts(lo, mid-1), total_cnt - mid->cnt());
+        }
+        IfNode *iff_le  = jump_if_fork_int(key_val, test_val, BoolTest::le, prob);
         Node   *iftrue  = _gvn.transform( new (C) IfTrueNode(iff_le) );
         Node   *iffalse = _gvn.transform( new (C) IfFalseNode(iff_le) );
         { PreserveJVMState pjvms(this);
@@ -593,7 +736,11 @@ void Parse::jump_switch_ranges(Node* key_val, SwitchRange *lo, SwitchRange *hi,
 
     } else {
       // mid is a range, not a singleton, so treat mid..hi as a unit
-      IfNode *iff_ge = jump_if_fork_int(key_val, test_val, BoolTest::ge);
+      float prob = PROB_UNKNOWN;
+      if (total_cnt > 0) {
+        prob = switch_prob(sum_of_cnts(mid, hi), total_cnt);
+      }
+      IfNode *iff_ge = jump_if_fork_int(key_val, test_val, BoolTest::ge, prob);
 
       // if there is a higher range, test for it and process it:
       if (mid == hi) {
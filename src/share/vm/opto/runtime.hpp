@@ -313,6 +313,9 @@ private:
 
   static const TypeFunc* updateBytesCRC32_Type();
 
+  static const TypeFunc* inflateBytes_Type();
+  static const TypeFunc* inflateASCIIBytes_Type();
+
   // leaf on stack replacement interpreter accessor types
   static const TypeFunc* osr_end_Type();
 
@@ -61,7 +61,8 @@ class StringConcat : public ResourceObj {
     StringMode,
     IntMode,
     CharMode,
-    StringNullCheckMode
+    StringNullCheckMode,
+    BoolMode
   };
 
   StringConcat(PhaseStringOpts* stringopts, CallStaticJavaNode* end):
@@ -127,6 +128,9 @@ class StringConcat : public ResourceObj {
   void push_char(Node* value) {
     push(value, CharMode);
   }
+  void push_bool(Node* value) {
+    push(value, BoolMode);
+  }
 
   static bool is_SB_toString(Node* call) {
     if (call->is_CallStaticJava()) {
@@ -204,6 +208,12 @@ class StringConcat : public ResourceObj {
   void eliminate_call(CallNode* call);
 
   void maybe_log_transform() {
+#ifndef PRODUCT
+    if (PrintOptimizeStringConcat) {
+      tty->print("fusing string concat in ");
+      _begin->jvms()->dump_spec(tty); tty->cr();
+    }
+#endif
     CompileLog* log = _stringopts->C->log();
     if (log != NULL) {
       log->head("replace_string_concat arguments='%d' string_alloc='%d' multiple='%d'",
@@ -414,14 +424,17 @@ StringConcat* PhaseStringOpts::build_candidate(CallStaticJavaNode* call) {
   ciSymbol* string_sig;
   ciSymbol* int_sig;
   ciSymbol* char_sig;
+  ciSymbol* bool_sig;
   if (m->holder() == C->env()->StringBuilder_klass()) {
     string_sig = ciSymbol::String_StringBuilder_signature();
     int_sig = ciSymbol::int_StringBuilder_signature();
     char_sig = ciSymbol::char_StringBuilder_signature();
+    bool_sig = ciSymbol::bool_StringBuilder_signature();
   } else if (m->holder() == C->env()->StringBuffer_klass()) {
     string_sig = ciSymbol::String_StringBuffer_signature();
     int_sig = ciSymbol::int_StringBuffer_signature();
     char_sig = ciSymbol::char_StringBuffer_signature();
+    bool_sig = ciSymbol::bool_StringBuffer_signature();
   } else {
     return NULL;
   }
@@ -448,6 +461,9 @@ StringConcat* PhaseStringOpts::build_candidate(CallStaticJavaNode* call) {
     if (cnode == NULL) {
       alloc = recv->isa_Allocate();
       if (alloc == NULL) {
+        // The builder comes from somewhere else (a parameter, a field
+        // or a previous loop iteration) so its initial contents are unknown.
+        reject("builder is not allocated locally", call);
         break;
       }
       // Find the constructor call
@@ -460,6 +476,7 @@ StringConcat* PhaseStringOpts::build_candidate(CallStaticJavaNode* call) {
           alloc->jvms()->dump_spec(tty); tty->cr();
         }
 #endif
+        reject("allocation looks strange", call);
         break;
       }
       Node* constructor = NULL;
@@ -487,6 +504,7 @@ StringConcat* PhaseStringOpts::build_candidate(CallStaticJavaNode* call) {
                   alloc->jvms()->dump_spec(tty); tty->cr();
                 }
 #endif
+                reject("StringBuilder(null) throws exception", call);
                 return NULL;
               }
               // StringBuilder(str) argument needs null check.
@@ -513,6 +531,7 @@ StringConcat* PhaseStringOpts::build_candidate(CallStaticJavaNode* call) {
           alloc->jvms()->dump_spec(tty); tty->cr();
         }
 #endif
+        reject("unknown constructor", call);
         break;
       }
 
@@ -529,19 +548,23 @@ StringConcat* PhaseStringOpts::build_candidate(CallStaticJavaNode* call) {
         return NULL;
       }
     } else if (cnode->method() == NULL) {
+      reject("call to unknown method on builder", call);
       break;
     } else if (!cnode->method()->is_static() &&
                cnode->method()->holder() == m->holder() &&
                cnode->method()->name() == ciSymbol::append_name() &&
                (cnode->method()->signature()->as_symbol() == string_sig ||
                 cnode->method()->signature()->as_symbol() == char_sig ||
-                cnode->method()->signature()->as_symbol() == int_sig)) {
+                cnode->method()->signature()->as_symbol() == int_sig ||
+                cnode->method()->signature()->as_symbol() == bool_sig)) {
       sc->add_control(cnode);
       Node* arg = cnode->in(TypeFunc::Parms + 1);
       if (cnode->method()->signature()->as_symbol() == int_sig) {
         sc->push_int(arg);
       } else if (cnode->method()->signature()->as_symbol() == char_sig) {
         sc->push_char(arg);
+      } else if (cnode->method()->signature()->as_symbol() == bool_sig) {
+        sc->push_bool(arg);
       } else {
         if (arg->is_Proj() && arg->in(0)->is_CallStaticJava()) {
           CallStaticJavaNode* csj = arg->in(0)->as_CallStaticJava();
@@ -574,6 +597,9 @@ StringConcat* PhaseStringOpts::build_candidate(CallStaticJavaNode* call) {
         cnode->in(TypeFunc::Parms + 1)->dump();
       }
 #endif
+      reject(err_msg_res("unsupported call %s%s on builder",
+                         cnode->method()->name()->as_utf8(),
+                         cnode->method()->signature()->as_symbol()->as_utf8()), call);
       break;
     }
   }
@@ -669,6 +695,23 @@ PhaseStringOpts::PhaseStringOpts(PhaseGVN* gvn, Unique_Node_List*):
   remove_dead_nodes();
 }
 
+void PhaseStringOpts::reject(const char* reason, CallNode* call) {
+  JVMState* jvms = call->jvms();
+  if (PrintStringConcatRejections) {
+    ttyLocker ttyl;
+    tty->print("string concat not fused (%s) in ", reason);
+    if (jvms != NULL) {
+      jvms->method()->print_short_name(tty);
+      tty->print(" @ bci:%d", jvms->bci());
+    }
+    tty->cr();
+  }
+  CompileLog* log = C->log();
+  if (log != NULL) {
+    log->elem("string_concat_reject reason='%s' bci='%d'", reason, jvms != NULL ? jvms->bci() : -1);
+  }
+}
+
 void PhaseStringOpts::record_dead_node(Node* dead) {
   dead_worklist.push(dead);
 }
@@ -749,6 +792,7 @@ bool StringConcat::validate_mem_flow() {
                 path.dump();
               }
 #endif
+              _stringopts->reject("side effects between appends", _end);
               return false;
             }
           }
@@ -769,6 +813,7 @@ bool StringConcat::validate_mem_flow() {
               path.dump();
             }
 #endif
+            _stringopts->reject("unknown call between appends", _end);
             return false;
           }
         } else {
@@ -780,6 +825,7 @@ bool StringConcat::validate_mem_flow() {
             path.dump();
           }
 #endif
+          _stringopts->reject("store between appends", _end);
           return false;
         }
       } else {
@@ -861,6 +907,7 @@ bool StringConcat::validate_control_flow() {
   // Check to see if this resulted in too many uncommon traps previously
   if (Compile::current()->too_many_traps(_begin->jvms()->method(), _begin->jvms()->bci(),
                         Deoptimization::Reason_intrinsic)) {
+    _stringopts->reject("too many traps", _end);
     return false;
   }
 
@@ -1021,7 +1068,10 @@ bool StringConcat::validate_control_flow() {
     tty->cr();
   }
 #endif
-  if (fail) return !fail;
+  if (fail) {
+    _stringopts->reject("unexpected control flow between appends", _end);
+    return false;
+  }
 
   // Validate that all these results produced are contained within
   // this cluster of objects.  First collect all the results produced
@@ -1074,6 +1124,9 @@ bool StringConcat::validate_control_flow() {
         use->dump();
       }
 #endif
+      if (!fail) {
+        _stringopts->reject("intermediate result escapes", _end);
+      }
       fail = true;
       break;
     }
@@ -1373,6 +1426,45 @@ void PhaseStringOpts::int_getChars(GraphKit& kit, Node* arg, Node* char_array, N
 }
 
 
+void PhaseStringOpts::bool_getChars(GraphKit& kit, Node* arg, Node* char_array, Node* start) {
+  RegionNode *merge = new (C) RegionNode(3);
+  kit.gvn().set_type(merge, Type::CONTROL);
+  Node *mem = PhiNode::make(merge, kit.memory(char_adr_idx), Type::MEMORY, TypeAryPtr::CHARS);
+  kit.gvn().set_type(mem, Type::MEMORY);
+
+  // if (b) "true" else "false"
+  IfNode* iff = kit.create_and_map_if(kit.control(),
+                                      __ Bool(__ CmpI(arg, __ intcon(0)), BoolTest::ne),
+                                      PROB_FAIR, COUNT_UNKNOWN);
+  Node* old_mem = kit.memory(char_adr_idx);
+  Node* is_true = __ IfTrue(iff);
+  Node* is_false = __ IfFalse(iff);
+  for (uint path = 1; path <= 2; path++) {
+    kit.set_control(path == 1 ? is_true : is_false);
+    kit.set_memory(old_mem, char_adr_idx);
+    if (kit.stopped()) {
+      merge->init_req(path, C->top());
+      mem->init_req(path, C->top());
+      continue;
+    }
+    Node* pos = start;
+    for (const char* c = (path == 1 ? "true" : "false"); *c != '\0'; c++) {
+      __ store_to_memory(kit.control(), kit.array_element_address(char_array, pos, T_CHAR),
+                         __ intcon(*c), T_CHAR, char_adr_idx, MemNode::unordered);
+      pos = __ AddI(pos, __ intcon(1));
+    }
+    merge->init_req(path, kit.control());
+    mem->init_req(path, kit.memory(char_adr_idx));
+  }
+
+  kit.set_control(merge);
+  kit.set_memory(mem, char_adr_idx);
+
+  C->record_for_igvn(merge);
+  C->record_for_igvn(mem);
+}
+
+
 Node* PhaseStringOpts::copy_string(GraphKit& kit, Node* str, Node* char_array, Node* start) {
   Node* string = str;
   Node* offset = kit.load_String_offset(kit.control(), string);
@@ -1552,6 +1644,14 @@ void PhaseStringOpts::replace_string_concat(StringConcat* sc) {
         length = __ AddI(length, __ intcon(1));
         break;
       }
+      case StringConcat::BoolMode: {
+        // "true" or "false"
+        Node* bool_size = kit.gvn().transform(new (C) CMoveINode(__ Bool(__ CmpI(arg, __ intcon(0)), BoolTest::ne),
+                                                                  __ intcon(5), __ intcon(4), TypeInt::make(4, 5, Type::WidenMin)));
+        length = __ AddI(length, bool_size);
+        string_sizes->init_req(argi, bool_size);
+        break;
+      }
       default:
         ShouldNotReachHere();
     }
@@ -1619,6 +1719,11 @@ void PhaseStringOpts::replace_string_concat(StringConcat* sc) {
           start = __ AddI(start, __ intcon(1));
           break;
         }
+        case StringConcat::BoolMode: {
+          bool_getChars(kit, arg, char_array, start);
+          start = __ AddI(start, string_sizes->in(argi));
+          break;
+        }
         default:
           ShouldNotReachHere();
       }
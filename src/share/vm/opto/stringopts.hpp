@@ -67,9 +67,15 @@ class PhaseStringOpts : public Phase {
   // Copy the characters representing value into char_array starting at start
   void int_getChars(GraphKit& kit, Node* value, Node* char_array, Node* start, Node* end);
 
+  // Copy "true" or "false" into char_array starting at start
+  void bool_getChars(GraphKit& kit, Node* value, Node* char_array, Node* start);
+
   // Copy of the contents of the String str into char_array starting at index start.
   Node* copy_string(GraphKit& kit, Node* str, Node* char_array, Node* start);
 
+  // Report why a StringBuilder chain ending at call could not be fused
+  void reject(const char* reason, CallNode* call);
+
   // Clean up any leftover nodes
   void record_dead_node(Node* node);
   void remove_dead_nodes();
@@ -5073,6 +5073,7 @@ _JNI_IMPORT_OR_EXPORT_ jint JNICALL JNI_GetDefaultJavaVMInitArgs(void *args_) {
 
 #ifndef PRODUCT
 
+#include "compiler/compileBroker.hpp"
 #include "gc_implementation/shared/gcTimer.hpp"
 #include "gc_interface/collectedHeap.hpp"
 #if INCLUDE_ALL_GCS
@@ -5136,6 +5137,7 @@ void execute_internal_vm_tests() {
     run_unit_test(Test_linked_list());
     run_unit_test(TestChunkedList_test());
     run_unit_test(ObjectMonitor::sanity_checks());
+    run_unit_test(CompileQueue::test_priority_heap());
 #if INCLUDE_VM_STRUCTS
     run_unit_test(VMStructs::test());
 #endif
@@ -918,7 +918,7 @@ CodeBlob* WhiteBox::allocate_code_blob(int size, int blob_type) {
   }
   {
     MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-    blob = (BufferBlob*) CodeCache::allocate(full_size);
+    blob = (BufferBlob*) CodeCache::allocate(full_size, blob_type);
     ::new (blob) BufferBlob("WB::DummyBlob", full_size);
   }
   // Track memory usage statistic after releasing CodeCache_lock
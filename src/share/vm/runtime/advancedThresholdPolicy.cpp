@@ -160,22 +160,22 @@ bool AdvancedThresholdPolicy::is_method_profiled(Method* method) {
   return false;
 }
 
-// Called with the queue locked and with at least one element
-CompileTask* AdvancedThresholdPolicy::select_task(CompileQueue* compile_queue) {
-  CompileTask *max_task = NULL;
-  Method* max_method = NULL;
-  jlong t = os::javaTimeMillis();
-  // Iterate through the queue and find a method with a maximum rate.
-  for (CompileTask* task = compile_queue->first(); task != NULL;) {
-    CompileTask* next_task = task->next();
-    Method* method = task->method();
-    update_rate(t, method);
-    if (max_task == NULL) {
-      max_task = task;
-      max_method = method;
-    } else {
-      // If a method has been stale for some time, remove it from the queue.
-      if (is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method)) {
+// The priority of a task is the highest compilation level of its method
+// and the method's weight, which orders tasks like compare_methods().
+// Rates change over time, so the priorities of all tasks are recomputed,
+// and stale tasks are removed, at most every CompileQueuePriorityRefreshInterval
+// milliseconds. In between, only tasks added since then get a priority and
+// the task is selected in O(log n) instead of scanning the whole queue.
+CompileTask* AdvancedThresholdPolicy::select_task_from_heap(CompileQueue* compile_queue, jlong t) {
+  if (compile_queue->needs_priority_refresh(t)) {
+    compile_queue->begin_priority_refresh();
+    CompileTask* first = compile_queue->first();
+    for (CompileTask* task = first; task != NULL;) {
+      CompileTask* next_task = task->next();
+      Method* method = task->method();
+      update_rate(t, method);
+      // Like select_task(), never remove the first task so that we return one
+      if (task != first && is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method)) {
         if (PrintTieredEvents) {
           print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel)task->comp_level());
         }
@@ -184,14 +184,59 @@ CompileTask* AdvancedThresholdPolicy::select_task(CompileQueue* compile_queue) {
         task = next_task;
         continue;
       }
+      task->set_priority(method->highest_comp_level(), weight(method));
+      task = next_task;
+    }
+    compile_queue->end_priority_refresh(t);
+  } else {
+    CompileTask* task;
+    while ((task = compile_queue->next_unprioritized()) != NULL) {
+      Method* method = task->method();
+      update_rate(t, method);
+      task->set_priority(method->highest_comp_level(), weight(method));
+      compile_queue->add_to_heap(task);
+    }
+  }
+  return compile_queue->highest_priority_task();
+}
 
-      // Select a method with a higher rate
-      if (compare_methods(method, max_method)) {
+// Called with the queue locked and with at least one element
+CompileTask* AdvancedThresholdPolicy::select_task(CompileQueue* compile_queue) {
+  CompileTask *max_task = NULL;
+  Method* max_method = NULL;
+  jlong t = os::javaTimeMillis();
+  if (compile_queue->uses_priority_heap()) {
+    max_task = select_task_from_heap(compile_queue, t);
+    max_method = max_task->method();
+  } else {
+    // Iterate through the queue and find a method with a maximum rate.
+    for (CompileTask* task = compile_queue->first(); task != NULL;) {
+      CompileTask* next_task = task->next();
+      Method* method = task->method();
+      update_rate(t, method);
+      if (max_task == NULL) {
         max_task = task;
         max_method = method;
+      } else {
+        // If a method has been stale for some time, remove it from the queue.
+        if (is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method)) {
+          if (PrintTieredEvents) {
+            print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel)task->comp_level());
+          }
+          compile_queue->remove_and_mark_stale(task);
+          method->clear_queued_for_compilation();
+          task = next_task;
+          continue;
+        }
+
+        // Select a method with a higher rate
+        if (compare_methods(method, max_method)) {
+          max_task = task;
+          max_method = method;
+        }
       }
+      task = next_task;
     }
-    task = next_task;
   }
 
   if (max_task->comp_level() == CompLevel_full_profile && TieredStopAtLevel > CompLevel_full_profile
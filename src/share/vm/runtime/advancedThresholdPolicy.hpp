@@ -200,6 +200,9 @@ class AdvancedThresholdPolicy : public SimpleThresholdPolicy {
   void create_mdo(methodHandle mh, JavaThread* thread);
   // Is method profiled enough?
   bool is_method_profiled(Method* method);
+  // Select the task with the highest priority from the compile queue heap
+  // (UseCompileQueuePriorityHeap).
+  CompileTask* select_task_from_heap(CompileQueue* compile_queue, jlong t);
 
   double _increase_threshold_at_ratio;
 
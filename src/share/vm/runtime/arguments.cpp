@@ -23,12 +23,14 @@
  */
 
 #include "precompiled.hpp"
+#include "ci/ciCallProfile.hpp"
 #include "classfile/classLoader.hpp"
 #include "classfile/javaAssertions.hpp"
 #include "classfile/symbolTable.hpp"
 #include "compiler/compilerOracle.hpp"
 #include "memory/allocation.inline.hpp"
 #include "memory/cardTableRS.hpp"
+#include "memory/dynamicArchive.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/referenceProcessor.hpp"
 #include "memory/universe.inline.hpp"
@@ -2353,6 +2355,9 @@ bool Arguments::check_vm_args_consistency() {
   status = status && verify_interval(SymbolTableSize, minimumSymbolTableSize,
     (max_uintx / SymbolTable::bucket_size()), "SymbolTable size");
 
+  status = status && verify_interval(JNIGlobalHandleCacheSize, 1, 1024,
+                                     "JNIGlobalHandleCacheSize");
+
   {
     // Using "else if" below to avoid printing two error messages if min > max.
     // This will also prevent us from reporting both min>100 and max>100 at the
@@ -2592,6 +2597,15 @@ bool Arguments::check_vm_args_consistency() {
 #ifdef COMPILER1
   status = status && verify_min_value(ValueMapInitialSize, 1, "ValueMapInitialSize");
 #endif
+#ifdef COMPILER2
+  // The unswitch count of a loop is kept in a signed char
+  status = status && verify_interval(LoopMaxUnswitch, 0, 127, "LoopMaxUnswitch");
+  status = status && verify_interval(PolymorphicInliningMaxTargets, 2,
+                                     ciCallProfile::PolymorphicLimit,
+                                     "PolymorphicInliningMaxTargets");
+  status = status && verify_percentage(PolymorphicInliningCoveragePercent,
+                                       "PolymorphicInliningCoveragePercent");
+#endif
 
   if (PrintNMTStatistics) {
 #if INCLUDE_NMT
@@ -4027,6 +4041,9 @@ jint Arguments::parse(const JavaVMInitArgs* args) {
     return result;
   }
 
+  // -XX:ArchiveClassesAtExit may set SharedArchiveFile.
+  DynamicArchive::initialize_flags();
+
   // Call get_shared_archive_path() here, after possible SharedArchiveFile option got parsed.
   SharedArchivePath = get_shared_archive_path();
   if (SharedArchivePath == NULL) {
@@ -4217,6 +4234,11 @@ jint Arguments::apply_ergo() {
     // nothing to use the profiling, turn if off
     FLAG_SET_DEFAULT(TypeProfileLevel, 0);
   }
+  if (UsePolymorphicInlining && FLAG_IS_DEFAULT(TypeProfileWidth) &&
+      TypeProfileWidth < PolymorphicInliningMaxTargets) {
+    // record enough receiver rows to see all inlining candidates
+    FLAG_SET_DEFAULT(TypeProfileWidth, PolymorphicInliningMaxTargets);
+  }
 #endif
 
   if (PrintAssembly && FLAG_IS_DEFAULT(DebugNonSafepoints)) {
@@ -27,6 +27,8 @@
 #include "oops/markOop.hpp"
 #include "runtime/basicLock.hpp"
 #include "runtime/biasedLocking.hpp"
+#include "runtime/handshake.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/task.hpp"
 #include "runtime/vframe.hpp"
 #include "runtime/vmThread.hpp"
@@ -36,6 +38,14 @@
 static bool _biased_locking_enabled = false;
 BiasedLockingCounters BiasedLocking::_counters;
 
+PerfCounter* BiasedLocking::_perf_cas_revocations          = NULL;
+PerfCounter* BiasedLocking::_perf_self_revocations         = NULL;
+PerfCounter* BiasedLocking::_perf_exited_owner_revocations = NULL;
+PerfCounter* BiasedLocking::_perf_handshake_revocations    = NULL;
+PerfCounter* BiasedLocking::_perf_safepoint_revocations    = NULL;
+PerfCounter* BiasedLocking::_perf_bulk_rebiases            = NULL;
+PerfCounter* BiasedLocking::_perf_bulk_revocations         = NULL;
+
 static GrowableArray<Handle>*  _preserved_oop_stack  = NULL;
 static GrowableArray<markOop>* _preserved_mark_stack = NULL;
 
@@ -85,6 +95,32 @@ class EnableBiasedLockingTask : public PeriodicTask {
 };
 
 
+void BiasedLocking::create_perf_counters(TRAPS) {
+  const char* ns = "biasedLocking";
+  _perf_cas_revocations =
+    PerfDataManager::create_counter(SUN_RT, PerfDataManager::counter_name(ns, "casRevocations"),
+                                    PerfData::U_Events, CHECK);
+  _perf_self_revocations =
+    PerfDataManager::create_counter(SUN_RT, PerfDataManager::counter_name(ns, "selfRevocations"),
+                                    PerfData::U_Events, CHECK);
+  _perf_exited_owner_revocations =
+    PerfDataManager::create_counter(SUN_RT, PerfDataManager::counter_name(ns, "exitedOwnerRevocations"),
+                                    PerfData::U_Events, CHECK);
+  _perf_handshake_revocations =
+    PerfDataManager::create_counter(SUN_RT, PerfDataManager::counter_name(ns, "handshakeRevocations"),
+                                    PerfData::U_Events, CHECK);
+  _perf_safepoint_revocations =
+    PerfDataManager::create_counter(SUN_RT, PerfDataManager::counter_name(ns, "safepointRevocations"),
+                                    PerfData::U_Events, CHECK);
+  _perf_bulk_rebiases =
+    PerfDataManager::create_counter(SUN_RT, PerfDataManager::counter_name(ns, "bulkRebiases"),
+                                    PerfData::U_Events, CHECK);
+  _perf_bulk_revocations =
+    PerfDataManager::create_counter(SUN_RT, PerfDataManager::counter_name(ns, "bulkRevocations"),
+                                    PerfData::U_Events, CHECK);
+}
+
+
 void BiasedLocking::init() {
   // If biased locking is enabled, schedule a task to fire a few
   // seconds into the run which turns on biased locking for all
@@ -94,6 +130,10 @@ void BiasedLocking::init() {
   // Ideally we would have a lower cost for individual bias revocation
   // and not need a mechanism like this.
   if (UseBiasedLocking) {
+    if (UsePerfData) {
+      EXCEPTION_MARK;
+      create_perf_counters(THREAD);
+    }
     if (BiasedLockingStartupDelay > 0) {
       EnableBiasedLockingTask* task = new EnableBiasedLockingTask(BiasedLockingStartupDelay);
       task->enroll();
@@ -144,7 +184,10 @@ static GrowableArray<MonitorInfo*>* get_or_compute_monitor_info(JavaThread* thre
 }
 
 
-static BiasedLocking::Condition revoke_bias(oop obj, bool allow_rebias, bool is_bulk, JavaThread* requesting_thread, JavaThread** biased_locker) {
+// owner_is_alive is set by callers that keep the bias owner from exiting
+// themselves, so the thread list does not need to be walked.
+static BiasedLocking::Condition revoke_bias(oop obj, bool allow_rebias, bool is_bulk, JavaThread* requesting_thread, JavaThread** biased_locker,
+                                            bool owner_is_alive = false) {
   markOop mark = obj->mark();
   if (!mark->has_bias_pattern()) {
     if (TraceBiasedLocking) {
@@ -181,7 +224,7 @@ static BiasedLocking::Condition revoke_bias(oop obj, bool allow_rebias, bool is_
 
   // Handle case where the thread toward which the object was biased has exited
   bool thread_is_alive = false;
-  if (requesting_thread == biased_thread) {
+  if (requesting_thread == biased_thread || owner_is_alive) {
     thread_is_alive = true;
   } else {
     for (JavaThread* cur_thread = Threads::first(); cur_thread != NULL; cur_thread = cur_thread->next()) {
@@ -337,6 +380,12 @@ static BiasedLocking::Condition bulk_revoke_or_rebias_at_safepoint(oop o,
                   p2i((void *) o), (intptr_t) o->mark(), o->klass()->external_name());
   }
 
+  if (bulk_rebias) {
+    BiasedLocking::inc_bulk_rebiases();
+  } else {
+    BiasedLocking::inc_bulk_revocations();
+  }
+
   jlong cur_time = os::javaTimeMillis();
   o->klass()->set_last_biased_lock_bulk_revocation_time(cur_time);
 
@@ -496,6 +545,7 @@ public:
         tty->print_cr("Revoking bias with potentially per-thread safepoint:");
       }
       JavaThread* biased_locker = NULL;
+      BiasedLocking::inc_safepoint_revocations();
       _status_code = revoke_bias((*_obj)(), false, false, _requesting_thread, &biased_locker);
       if (biased_locker != NULL) {
         _biased_locker_id = THREAD_TRACE_ID(biased_locker);
@@ -543,6 +593,128 @@ public:
 };
 
 
+// Revoke the bias of an object whose bias owner has exited without
+// bringing the system to a safepoint. Threads_lock keeps the thread
+// list stable while we look for the owner: no new thread can be added
+// (and reuse the exited thread's address) before the unbiased header
+// is installed, and an exited thread holds no lock records which would
+// need a displaced header. Returns false if the owner is still alive
+// or we lost a race, in which case the caller falls back to a
+// safepoint revocation.
+static bool revoke_bias_of_exited_owner(Handle obj, BiasedLocking::Condition* cond) {
+  MutexLocker ml(Threads_lock);
+  markOop mark = obj->mark();
+  if (!mark->has_bias_pattern()) {
+    *cond = BiasedLocking::NOT_BIASED;
+    return true;
+  }
+  JavaThread* biased_thread = mark->biased_locker();
+  if (biased_thread == NULL) {
+    return false;
+  }
+  for (JavaThread* cur_thread = Threads::first(); cur_thread != NULL; cur_thread = cur_thread->next()) {
+    if (cur_thread == biased_thread) {
+      return false;
+    }
+  }
+  markOop unbiased_prototype = markOopDesc::prototype()->set_age(mark->age());
+  markOop res_mark = (markOop) Atomic::cmpxchg_ptr(unbiased_prototype, obj->mark_addr(), mark);
+  if (res_mark != mark) {
+    return false;
+  }
+  if (TraceBiasedLocking) {
+    ResourceMark rm;
+    tty->print_cr("Revoked bias of object " INTPTR_FORMAT " , type %s , biased toward exited thread " INTPTR_FORMAT " without safepoint",
+                  p2i((void *)obj()), obj->klass()->external_name(), p2i(biased_thread));
+  }
+  BiasedLocking::inc_exited_owner_revocations();
+  *cond = BiasedLocking::BIAS_REVOKED;
+  return true;
+}
+
+
+// Revokes the bias of a single object by walking the stack of its bias
+// owner in a handshake instead of at a safepoint (-XX:+ThreadLocalHandshakes).
+class RevokeOneBias : public ThreadClosure {
+ private:
+  Handle                   _obj;
+  JavaThread*              _requesting_thread;
+  bool                     _executed;
+  BiasedLocking::Condition _status_code;
+  traceid                  _biased_locker_id;
+
+ public:
+  RevokeOneBias(Handle obj, JavaThread* requesting_thread)
+    : _obj(obj)
+    , _requesting_thread(requesting_thread)
+    , _executed(false)
+    , _status_code(BiasedLocking::NOT_BIASED)
+    , _biased_locker_id(0) {}
+
+  void do_thread(Thread* target) {
+    markOop mark = _obj->mark();
+    if (!mark->has_bias_pattern()) {
+      _executed = true;
+      _status_code = BiasedLocking::NOT_BIASED;
+      return;
+    }
+    // Only the bias owner may store into the mark word without a CAS,
+    // and it is stopped. If the bias moved on or expired meanwhile,
+    // leave the object to the safepoint revocation.
+    if (mark->biased_locker() != target ||
+        mark->bias_epoch() != _obj->klass()->prototype_header()->bias_epoch()) {
+      return;
+    }
+    ResourceMark rm;
+    JavaThread* biased_thread = (JavaThread*) target;
+    JavaThread* biased_locker = NULL;
+    // The handshake keeps the target from exiting, and the thread list
+    // may not be walked here without Threads_lock.
+    _status_code = revoke_bias(_obj(), false, false, _requesting_thread, &biased_locker, true);
+    if (biased_locker != NULL) {
+      _biased_locker_id = THREAD_TRACE_ID(biased_locker);
+    }
+    biased_thread->set_cached_monitor_info(NULL);
+    _executed = true;
+  }
+
+  bool executed() const                        { return _executed; }
+  BiasedLocking::Condition status_code() const { return _status_code; }
+  traceid biased_locker() const                { return _biased_locker_id; }
+};
+
+// Returns false if the bias owner could not be reached in time, in which
+// case the caller falls back to a safepoint revocation.
+static bool revoke_bias_with_handshake(Handle obj, JavaThread* requesting_thread, BiasedLocking::Condition* cond) {
+  markOop mark = obj->mark();
+  JavaThread* biased_thread = mark->biased_locker();
+  if (!mark->has_bias_pattern() || biased_thread == NULL) {
+    return false;
+  }
+  EventBiasedLockRevocation event;
+  RevokeOneBias revoke(obj, requesting_thread);
+  if (!Handshake::execute(&revoke, biased_thread) || !revoke.executed()) {
+    return false;
+  }
+  if (TraceBiasedLocking) {
+    tty->print_cr("  Revoked bias of object " INTPTR_FORMAT " in a handshake with thread " INTPTR_FORMAT,
+                  p2i((void *)obj()), p2i(biased_thread));
+  }
+  if (revoke.status_code() != BiasedLocking::NOT_BIASED) {
+    BiasedLocking::inc_handshake_revocations();
+    if (event.should_commit()) {
+      event.set_lockClass(obj->klass());
+      // No safepoint was involved
+      event.set_safepointId(0);
+      event.set_previousOwner(revoke.biased_locker());
+      event.commit();
+    }
+  }
+  *cond = revoke.status_code();
+  return true;
+}
+
+
 BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attempt_rebias, TRAPS) {
   assert(!SafepointSynchronize::is_at_safepoint(), "must not be called while at safepoint");
 
@@ -562,6 +734,7 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
     markOop unbiased_prototype = markOopDesc::prototype()->set_age(mark->age());
     markOop res_mark = (markOop) Atomic::cmpxchg_ptr(unbiased_prototype, obj->mark_addr(), mark);
     if (res_mark == biased_value) {
+      inc_cas_revocations();
       return BIAS_REVOKED;
     }
   } else if (mark->has_bias_pattern()) {
@@ -577,6 +750,9 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
       markOop biased_value       = mark;
       markOop res_mark = (markOop) Atomic::cmpxchg_ptr(prototype_header, obj->mark_addr(), mark);
       assert(!(*(obj->mark_addr()))->has_bias_pattern(), "even if we raced, should still be revoked");
+      if (res_mark == biased_value) {
+        inc_cas_revocations();
+      }
       return BIAS_REVOKED;
     } else if (prototype_header->bias_epoch() != mark->bias_epoch()) {
       // The epoch of this biasing has expired indicating that the
@@ -592,6 +768,7 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
         markOop rebiased_prototype = markOopDesc::encode((JavaThread*) THREAD, mark->age(), prototype_header->bias_epoch());
         markOop res_mark = (markOop) Atomic::cmpxchg_ptr(rebiased_prototype, obj->mark_addr(), mark);
         if (res_mark == biased_value) {
+          inc_cas_revocations();
           return BIAS_REVOKED_AND_REBIASED;
         }
       } else {
@@ -599,6 +776,7 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
         markOop unbiased_prototype = markOopDesc::prototype()->set_age(mark->age());
         markOop res_mark = (markOop) Atomic::cmpxchg_ptr(unbiased_prototype, obj->mark_addr(), mark);
         if (res_mark == biased_value) {
+          inc_cas_revocations();
           return BIAS_REVOKED;
         }
       }
@@ -627,6 +805,7 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
         tty->print_cr("Revoking bias by walking my own stack:");
       }
       EventBiasedLockSelfRevocation event;
+      inc_self_revocations();
       BiasedLocking::Condition cond = revoke_bias(obj(), false, false, (JavaThread*) THREAD, NULL);
       ((JavaThread*) THREAD)->set_cached_monitor_info(NULL);
       assert(cond == BIAS_REVOKED, "why not?");
@@ -636,6 +815,18 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
       }
       return cond;
     } else {
+      if (BiasedLockingRevokeExitedOwnerWithoutSafepoint) {
+        BiasedLocking::Condition cond;
+        if (revoke_bias_of_exited_owner(obj, &cond)) {
+          return cond;
+        }
+      }
+      if (ThreadLocalHandshakes) {
+        BiasedLocking::Condition cond;
+        if (revoke_bias_with_handshake(obj, (JavaThread*) THREAD, &cond)) {
+          return cond;
+        }
+      }
       EventBiasedLockRevocation event;
       VM_RevokeBias revoke(&obj, (JavaThread*) THREAD);
       VMThread::execute(&revoke);
@@ -683,6 +874,7 @@ void BiasedLocking::revoke_at_safepoint(Handle h_obj) {
   oop obj = h_obj();
   HeuristicsResult heuristics = update_heuristics(obj, false);
   if (heuristics == HR_SINGLE_REVOKE) {
+    inc_safepoint_revocations();
     revoke_bias(obj, false, false, NULL, NULL);
   } else if ((heuristics == HR_BULK_REBIAS) ||
              (heuristics == HR_BULK_REVOKE)) {
@@ -699,6 +891,7 @@ void BiasedLocking::revoke_at_safepoint(GrowableArray<Handle>* objs) {
     oop obj = (objs->at(i))();
     HeuristicsResult heuristics = update_heuristics(obj, false);
     if (heuristics == HR_SINGLE_REVOKE) {
+      inc_safepoint_revocations();
       revoke_bias(obj, false, false, NULL, NULL);
     } else if ((heuristics == HR_BULK_REBIAS) ||
                (heuristics == HR_BULK_REVOKE)) {
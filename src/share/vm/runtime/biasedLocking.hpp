@@ -26,6 +26,7 @@
 #define SHARE_VM_RUNTIME_BIASEDLOCKING_HPP
 
 #include "runtime/handles.hpp"
+#include "runtime/perfData.hpp"
 #include "utilities/growableArray.hpp"
 
 // This class describes operations to implement Store-Free Biased
@@ -149,6 +150,17 @@ class BiasedLocking : AllStatic {
 private:
   static BiasedLockingCounters _counters;
 
+  // Revocation counters exported through PerfData (sun.rt.biasedLocking.*)
+  static PerfCounter* _perf_cas_revocations;
+  static PerfCounter* _perf_self_revocations;
+  static PerfCounter* _perf_exited_owner_revocations;
+  static PerfCounter* _perf_handshake_revocations;
+  static PerfCounter* _perf_safepoint_revocations;
+  static PerfCounter* _perf_bulk_rebiases;
+  static PerfCounter* _perf_bulk_revocations;
+
+  static void create_perf_counters(TRAPS);
+
 public:
   static int* total_entry_count_addr();
   static int* biased_lock_entry_count_addr();
@@ -182,6 +194,14 @@ public:
   static void revoke_at_safepoint(Handle obj);
   static void revoke_at_safepoint(GrowableArray<Handle>* objs);
 
+  static void inc_cas_revocations()           { if (_perf_cas_revocations != NULL)          _perf_cas_revocations->inc(); }
+  static void inc_self_revocations()          { if (_perf_self_revocations != NULL)         _perf_self_revocations->inc(); }
+  static void inc_exited_owner_revocations()  { if (_perf_exited_owner_revocations != NULL) _perf_exited_owner_revocations->inc(); }
+  static void inc_handshake_revocations()     { if (_perf_handshake_revocations != NULL)    _perf_handshake_revocations->inc(); }
+  static void inc_safepoint_revocations()     { if (_perf_safepoint_revocations != NULL)    _perf_safepoint_revocations->inc(); }
+  static void inc_bulk_rebiases()             { if (_perf_bulk_rebiases != NULL)            _perf_bulk_rebiases->inc(); }
+  static void inc_bulk_revocations()          { if (_perf_bulk_revocations != NULL)         _perf_bulk_revocations->inc(); }
+
   static void print_counters() { _counters.print(); }
   static BiasedLockingCounters* counters() { return &_counters; }
 
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_RUNTIME_CODECACHESWEEPERTHREAD_HPP
+#define SHARE_VM_RUNTIME_CODECACHESWEEPERTHREAD_HPP
+
+#include "runtime/thread.hpp"
+
+// A JavaThread that sweeps the code cache instead of the compiler threads
+// (-XX:+UseCodeCacheSweeperThread). See NMethodSweeper::sweeper_loop().
+class CodeCacheSweeperThread : public JavaThread {
+  friend class VMStructs;
+ private:
+
+  static CodeCacheSweeperThread* _instance;
+
+  nmethod* _scanned_nmethod;  // nmethod being scanned by the sweeper
+
+  static void sweeper_thread_entry(JavaThread* thread, TRAPS);
+  CodeCacheSweeperThread(ThreadFunction entry_point) : JavaThread(entry_point), _scanned_nmethod(NULL) {};
+
+ public:
+  static void initialize();
+
+  // Hide this thread from external view.
+  bool is_hidden_from_external_view() const      { return true; }
+
+  // Returns true if the passed thread is the sweeper thread.
+  static bool is_sweeper_thread(Thread* thread);
+
+  // Track the nmethod currently being scanned by the sweeper
+  void set_scanned_nmethod(nmethod* nm) {
+    assert(_scanned_nmethod == NULL || nm == NULL, "should reset to NULL before writing a new value");
+    _scanned_nmethod = nm;
+  }
+
+  // GC support
+  // Apply "f->do_oop" to all root oops in "this".
+  // Apply "cf->do_code_blob" (if !NULL) to all code blobs active in frames
+  void oops_do(OopClosure* f, CLDClosure* cld_f, CodeBlobClosure* cf);
+};
+
+#endif // SHARE_VM_RUNTIME_CODECACHESWEEPERTHREAD_HPP
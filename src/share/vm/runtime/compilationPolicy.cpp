@@ -83,6 +83,10 @@ void compilationPolicy_init() {
   default:
     fatal("CompilationPolicyChoice must be in the range: [0-3]");
   }
+  if (CompilationPolicyChoice != 3 && UseCompileQueuePriorityHeap) {
+    // Only AdvancedThresholdPolicy selects compile tasks by priority
+    FLAG_SET_DEFAULT(UseCompileQueuePriorityHeap, false);
+  }
   CompilationPolicy::policy()->initialize();
 }
 
@@ -738,6 +738,10 @@ class CommandLineFlags {
   product(bool, UseCRC32Intrinsics, false,                                  \
           "use intrinsics for java.util.zip.CRC32")                         \
                                                                             \
+  product(bool, UseCharsetIntrinsics, false,                                \
+          "use intrinsics for ISO-8859-1 and ASCII-only UTF-8 decoding "    \
+          "of byte[] into char[]")                                          \
+                                                                            \
   develop(bool, TraceCallFixup, false,                                      \
           "Trace all call fixups")                                          \
                                                                             \
@@ -1165,6 +1169,14 @@ class CommandLineFlags {
                                                                             \
   product(intx, SyncVerbose, 0, "(Unstable)")                               \
                                                                             \
+  product(bool, UseAdaptiveMonitorSpinning, false,                          \
+          "Skip spinning on contended monitors whose average hold time "    \
+          "exceeds the SpinHoldLimit sync knob (in microseconds)")          \
+                                                                            \
+  product(bool, UseNUMAMonitorHandoff, false,                               \
+          "On monitor exit prefer to wake a thread waiting on the "         \
+          "releasing thread's NUMA node. Requires UseNUMA")                 \
+                                                                            \
   product(intx, ClearFPUAtPark, 0, "(Unsafe, Unstable)")                    \
                                                                             \
   product(intx, hashCode, 5,                                                \
@@ -1232,6 +1244,14 @@ class CommandLineFlags {
   product(bool, CheckJNICalls, false,                                       \
           "Verify all arguments to JNI calls")                              \
                                                                             \
+  product(bool, UseThreadLocalJNIGlobalHandles, false,                      \
+          "Allocate and delete JNI global handles through a per-thread "    \
+          "cache of handle slots")                                          \
+                                                                            \
+  product(intx, JNIGlobalHandleCacheSize, 32,                               \
+          "Number of JNI global handle slots moved between a thread "       \
+          "cache and the global handle blocks at a time")                   \
+                                                                            \
   product(bool, CheckEndorsedAndExtDirs, false,                             \
           "Verify the endorsed and extension directories are not used")     \
                                                                             \
@@ -1301,6 +1321,10 @@ class CommandLineFlags {
           "Decay time (in milliseconds) to re-enable bulk rebiasing of a "  \
           "type after previous bulk rebias")                                \
                                                                             \
+  product(bool, BiasedLockingRevokeExitedOwnerWithoutSafepoint, false,      \
+          "Revoke the bias of an object biased toward an exited thread "    \
+          "with a CAS under Threads_lock instead of a safepoint")           \
+                                                                            \
   product(bool, ExitOnOutOfMemoryError, false,                              \
           "JVM exits on the first occurrence of an out-of-memory error")    \
                                                                             \
@@ -1955,6 +1979,10 @@ class CommandLineFlags {
   product(bool, ParallelRefProcBalancingEnabled, true,                      \
           "Enable balancing of reference processing queues")                \
                                                                             \
+  product(bool, ParallelJNIWeakRefProcessing, false,                        \
+          "Process JNI weak global handles with all reference processing "  \
+          "workers when parallel reference processing is used")             \
+                                                                            \
   product(uintx, CMSTriggerRatio, 80,                                       \
           "Percentage of MinHeapFreeRatio in CMS generation that is "       \
           "allocated before a CMS collection cycle commences")              \
@@ -2609,6 +2637,14 @@ class CommandLineFlags {
           "Print safepoint statistics only when safepoint takes "           \
           "more than PrintSafepointSatisticsTimeout in millis")             \
                                                                             \
+  product(bool, ProfileTimeToSafepoint, false,                              \
+          "Record the last thread to reach each slow safepoint, and the "   \
+          "method it stopped in (see VM.safepoint_profile)")                \
+                                                                            \
+  product(uintx, ProfileTimeToSafepointThreshold, 1,                        \
+          "Only profile safepoints whose synchronization takes at least "   \
+          "this many milliseconds")                                         \
+                                                                            \
   product(bool, TraceSafepointCleanupTime, false,                           \
           "Print the break down of clean up tasks performed during "        \
           "safepoint")                                                      \
@@ -3022,6 +3058,14 @@ class CommandLineFlags {
   product(intx, SafepointTimeoutDelay, 10000,                               \
           "Delay in milliseconds for option SafepointTimeout")              \
                                                                             \
+  product(bool, ThreadLocalHandshakes, false,                               \
+          "Run per-thread operations such as single-thread stack dumps "    \
+          "and bias revocations with a handshake instead of a safepoint")   \
+                                                                            \
+  product(uintx, ThreadLocalHandshakeTimeout, 10,                           \
+          "Milliseconds to wait for a handshake target to reach a safe "    \
+          "state before falling back to a safepoint")                       \
+                                                                            \
   product(intx, NmethodSweepFraction, 16,                                   \
           "Number of invocations of sweeper to cover all nmethods")         \
                                                                             \
@@ -3032,6 +3076,18 @@ class CommandLineFlags {
           "Removes cold nmethods from code cache if > 0. Higher values "    \
           "result in more aggressive sweeping")                             \
                                                                             \
+  product(bool, UseCodeCacheSweeperThread, false,                           \
+          "Sweep the code cache in a dedicated thread instead of in the "   \
+          "compiler threads")                                               \
+                                                                            \
+  product(bool, UseSizeAwareCodeCacheEviction, false,                       \
+          "When the code cache fills up, make large cold C2-compiled "      \
+          "nmethods not entrant before smaller ones")                       \
+                                                                            \
+  product(uintx, CodeCacheEvictionSizeUnit, 16*K,                           \
+          "Size of a C2-compiled nmethod that doubles its eviction "        \
+          "priority with UseSizeAwareCodeCacheEviction")                    \
+                                                                            \
   notproduct(bool, LogSweeper, false,                                       \
           "Keep a ring buffer of sweeper activity")                         \
                                                                             \
@@ -3287,6 +3343,11 @@ class CommandLineFlags {
   product(uintx, MaxMetaspaceExpansion, ScaleForWordSize(4*M),              \
           "The maximum expansion of Metaspace without full GC (in bytes)")  \
                                                                             \
+  product(bool, MetaspaceCoalesceChunks, false,                             \
+          "Merge adjacent free Metaspace chunks after class unloading, "    \
+          "split free chunks instead of committing more memory, and "       \
+          "uncommit free space at the end of Metaspace virtual spaces")     \
+                                                                            \
   product(uintx, QueuedAllocationWarningCount, 0,                           \
           "Number of times an allocation that queues behind a GC "          \
           "will retry before printing a warning")                           \
@@ -3410,6 +3471,22 @@ class CommandLineFlags {
   product_pd(uintx, CodeCacheExpansionSize,                                 \
           "Code cache expansion size (in bytes)")                           \
                                                                             \
+  product(bool, SegmentedCodeCache, false,                                  \
+          "Split the code cache into separate heaps for non-nmethods, "     \
+          "profiled and non-profiled nmethods")                             \
+                                                                            \
+  product(uintx, NonNMethodCodeHeapSize, 0,                                 \
+          "Size of the code heap with non-nmethods (in bytes), "            \
+          "chosen ergonomically by default")                                \
+                                                                            \
+  product(uintx, ProfiledCodeHeapSize, 0,                                   \
+          "Size of the code heap with profiled nmethods (in bytes), "       \
+          "chosen ergonomically by default")                                \
+                                                                            \
+  product(uintx, NonProfiledCodeHeapSize, 0,                                \
+          "Size of the code heap with non-profiled nmethods (in bytes), "   \
+          "chosen ergonomically by default")                                \
+                                                                            \
   develop_pd(uintx, CodeCacheMinBlockLength,                                \
           "Minimum number of segments in a code cache block")               \
                                                                             \
@@ -3690,6 +3767,15 @@ class CommandLineFlags {
           "Kill compile task if method was not used within "                \
           "given timeout in milliseconds")                                  \
                                                                             \
+  product(bool, UseCompileQueuePriorityHeap, false,                         \
+          "Keep tiered compile tasks in a priority heap instead of "        \
+          "scanning the whole compile queue for the hottest method")        \
+                                                                            \
+  product(intx, CompileQueuePriorityRefreshInterval, 20,                    \
+          "Minimum time in milliseconds between recomputations of the "     \
+          "priorities of all queued compile tasks with "                    \
+          "UseCompileQueuePriorityHeap")                                    \
+                                                                            \
   product(intx, TieredStopAtLevel, 4,                                       \
           "Stop at given compilation level")                                \
                                                                             \
@@ -3863,6 +3949,11 @@ class CommandLineFlags {
           "If PrintSharedArchiveAndExit is true, also print the shared "    \
           "dictionary")                                                     \
                                                                             \
+  product(bool, ArchiveInternedStrings, false,                              \
+          "Archive interned strings as Java heap objects when dumping the " \
+          "shared archive, and load them into G1 archive regions at "       \
+          "startup")                                                        \
+                                                                            \
   product(uintx, SharedReadWriteSize,  NOT_LP64(12*M) LP64_ONLY(16*M),      \
           "Size of read-write space for metadata (in bytes)")               \
                                                                             \
@@ -3995,6 +4086,12 @@ class CommandLineFlags {
   product(ccstr, ExtraSharedClassListFile, NULL,                            \
           "Extra classlist for building the CDS archive file")              \
                                                                             \
+  product(ccstr, ArchiveClassesAtExit, NULL,                                \
+          "Use the specified CDS archive if it exists, and record the "     \
+          "boot classes loaded by the application and regenerate the "      \
+          "archive with them in the background at exit if it is missing "   \
+          "or incomplete")                                                  \
+                                                                            \
   experimental(uintx, ArrayAllocatorMallocLimit,                            \
           SOLARIS_ONLY(64*K) NOT_SOLARIS(max_uintx),                        \
           "Allocation less than this value will be allocated "              \
@@ -4074,6 +4171,30 @@ class CommandLineFlags {
                                                                             \
   lp64_product(intx, CompilationWarmUpRecordMinLevel, 3,                    \
           "Minimal compilation level recorded in JWarmUP recording phase")  \
+                                                                            \
+  lp64_product(bool, CompilationWarmUpRestoreProfile, false,                \
+          "Restore MethodData recorded in JWarmUP log file before "         \
+          "compiling a method")                                             \
+                                                                            \
+  lp64_product(bool, CompilationWarmUpValidateDependencies, false,          \
+          "Skip JWarmUP compilation of a method if a class its recorded "   \
+          "nmethod depended on has a different class file")                 \
+                                                                            \
+  lp64_product(bool, CompilationWarmUpSortByHotness, false,                 \
+          "Submit JWarmUP compilations after the class chain is "           \
+          "initialized, hottest recorded methods first")                    \
+                                                                            \
+  lp64_product(intx, CompilationWarmUpMaxQueuedTasks, 0,                    \
+          "Pause JWarmUP submission while the C2 compile queue holds "      \
+          "this many tasks, 0 means no limit")                              \
+                                                                            \
+  lp64_product(uintx, CompilationWarmUpMaxCPULoad, 0,                       \
+          "Pause JWarmUP submission while system cpu load is above this "   \
+          "percentage, 0 means no limit (Linux only)")                      \
+                                                                            \
+  lp64_product(uintx, CompilationWarmUpMaxThrottleTime, 1000,               \
+          "Maximal time in milliseconds JWarmUP waits for a busy compile "  \
+          "queue or cpu before submitting a method anyway")                 \
 
 /*
  *  Macros for factoring of globals
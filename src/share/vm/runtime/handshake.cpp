@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/handshake.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.inline.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/thread.inline.hpp"
+
+bool HandshakeState::try_claim() {
+  return _claimed == 0 && Atomic::cmpxchg(1, &_claimed, 0) == 0;
+}
+
+static void short_wait(int* attempts) {
+  if (++(*attempts) < 100) {
+    SpinPause();
+  } else {
+    os::naked_short_sleep(1);
+  }
+}
+
+void HandshakeState::claim() {
+  int attempts = 0;
+  while (!try_claim()) {
+    short_wait(&attempts);
+  }
+}
+
+void HandshakeState::release_claim() {
+  OrderAccess::release_store(&_claimed, 0);
+}
+
+bool HandshakeState::add_requester(JavaThread* target) {
+  assert(Threads_lock->owned_by_self(), "must hold Threads_lock");
+  if (_requesters != 0 || target->is_exiting()) {
+    return false;
+  }
+  Atomic::inc(&_requesters);
+  return true;
+}
+
+void HandshakeState::remove_requester() {
+  Atomic::dec(&_requesters);
+}
+
+void HandshakeState::set_operation(JavaThread* target, ThreadClosure* op) {
+  assert(Threads_lock->owned_by_self(), "must hold Threads_lock");
+  assert(_operation == NULL, "only one handshake at a time");
+  _executed = false;
+  _operation = op;
+  // The flag update is a full fence: the target sees the operation
+  // before the flag, and we read its state only after arming it.
+  target->set_has_handshake();
+}
+
+bool HandshakeState::cancel_operation(JavaThread* target) {
+  claim();
+  bool cancelled = has_operation();
+  if (cancelled) {
+    target->clear_has_handshake();
+    _operation = NULL;
+  }
+  release_claim();
+  return cancelled;
+}
+
+void HandshakeState::process_by_self(JavaThread* thread) {
+  assert(thread == Thread::current(), "must be");
+  // Wait out a requester walking our stack before we change it.
+  claim();
+  ThreadClosure* op = _operation;
+  if (op != NULL) {
+    op->do_thread(thread);
+    _executed = true;
+    thread->clear_has_handshake();
+    _operation = NULL;
+  }
+  release_claim();
+}
+
+bool HandshakeState::try_process_by_requester(JavaThread* target) {
+  if (!has_operation()) {
+    return true;
+  }
+  if (!try_claim()) {
+    return false;
+  }
+  // Flush the target's last state transition to memory, as the safepoint
+  // code does, before deciding whether its stack can be walked.
+  if (!UseMembar && os::is_MP()) {
+    os::serialize_thread_states();
+  }
+  bool processed = true;
+  ThreadClosure* op = _operation;
+  if (op != NULL) {
+    // An exiting target cancels the operation itself.
+    if (!target->is_exiting() &&
+        SafepointSynchronize::safepoint_safe(target, target->thread_state())) {
+      op->do_thread(target);
+      _executed = true;
+      target->clear_has_handshake();
+      _operation = NULL;
+    } else {
+      processed = false;
+    }
+  }
+  release_claim();
+  return processed;
+}
+
+void HandshakeState::thread_exit(JavaThread* thread) {
+  assert(thread == Thread::current(), "must be");
+  cancel_operation(thread);
+  int attempts = 0;
+  while (OrderAccess::load_acquire(&_requesters) != 0) {
+    short_wait(&attempts);
+  }
+}
+
+bool Handshake::execute(ThreadClosure* op, JavaThread* target) {
+  assert(ThreadLocalHandshakes, "should not be called");
+  JavaThread* self = JavaThread::current();
+  if (target == self) {
+    op->do_thread(target);
+    return true;
+  }
+
+  HandshakeState* state = target->handshake_state();
+  {
+    // The Threads_lock is only held to find target on the thread list.
+    // Once registered, target waits for us in thread_exit() before it
+    // can be freed, so the lock is not needed while we wait.
+    MutexLocker ml(Threads_lock);
+    bool alive = false;
+    for (JavaThread* jt = Threads::first(); jt != NULL; jt = jt->next()) {
+      if (jt == target) {
+        alive = true;
+        break;
+      }
+    }
+    // A thread running Java code does not poll for handshakes.
+    if (!alive || target->thread_state() == _thread_in_Java ||
+        !state->add_requester(target)) {
+      return false;
+    }
+    state->set_operation(target, op);
+  }
+
+  const jlong deadline = os::javaTimeNanos() +
+                         (jlong)ThreadLocalHandshakeTimeout * NANOSECS_PER_MILLISEC;
+  int attempts = 0;
+  while (!state->try_process_by_requester(target)) {
+    if (target->thread_state() == _thread_in_Java ||
+        os::javaTimeNanos() >= deadline) {
+      // Unless the target processed op while we were cancelling.
+      state->cancel_operation(target);
+      break;
+    }
+    short_wait(&attempts);
+  }
+  bool executed = state->executed();
+  state->remove_requester();
+  return executed;
+}
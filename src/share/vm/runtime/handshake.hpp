@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_RUNTIME_HANDSHAKE_HPP
+#define SHARE_VM_RUNTIME_HANDSHAKE_HPP
+
+#include "memory/allocation.hpp"
+
+class JavaThread;
+class ThreadClosure;
+
+// A handshake runs a ThreadClosure on a single JavaThread without
+// bringing the other threads to a safepoint (-XX:+ThreadLocalHandshakes).
+//
+// The requesting thread registers with the target under the Threads_lock,
+// arms it and releases the lock again. It then either processes the
+// operation itself once the target is in a safe state (blocked, or in
+// native with a walkable stack), or waits for the target to process it
+// on its own at its next thread state transition. An exiting target
+// cancels the operation and waits for its requester to go away before it
+// is freed. There is no per-thread polling page: a target running Java
+// code is only reached when it leaves Java, so the requester gives up at
+// once in that case, and after ThreadLocalHandshakeTimeout otherwise. The
+// caller then falls back to a VM operation.
+class Handshake : AllStatic {
+ public:
+  // Returns true if op has been run on target, false if the caller has
+  // to fall back to a VM operation.
+  static bool execute(ThreadClosure* op, JavaThread* target);
+};
+
+// Per-thread handshake state, embedded in JavaThread.
+class HandshakeState VALUE_OBJ_CLASS_SPEC {
+ private:
+  ThreadClosure* volatile _operation;
+  volatile jint           _claimed;     // 1 while a thread processes _operation
+  volatile jint           _requesters;  // Requesters that may still access the owning thread
+  volatile bool           _executed;    // The current operation has been run
+
+  bool try_claim();
+  void claim();
+  void release_claim();
+
+ public:
+  HandshakeState() : _operation(NULL), _claimed(0), _requesters(0), _executed(false) {}
+
+  bool has_operation() const { return _operation != NULL; }
+  bool executed() const      { return _executed; }
+
+  // Registers the only requester of target, under the Threads_lock.
+  // Returns false if another handshake with target is in progress.
+  bool add_requester(JavaThread* target);
+  void remove_requester();
+
+  void set_operation(JavaThread* target, ThreadClosure* op);
+  // Disarms target unless the operation has already been processed.
+  // Returns true if the operation was cancelled.
+  bool cancel_operation(JavaThread* target);
+
+  // Called by the target at a thread state transition.
+  void process_by_self(JavaThread* thread);
+  // Called by the requester; returns true if the operation is no longer
+  // pending, either because it has been processed or cancelled.
+  bool try_process_by_requester(JavaThread* target);
+
+  // Called by the owning thread once it is off the thread list: cancels
+  // a pending operation and waits until no requester refers to it.
+  void thread_exit(JavaThread* thread);
+
+  // True while the operation is being run on behalf of the owning thread.
+  bool is_processing() const { return _claimed != 0 && _operation != NULL; }
+};
+
+#endif // SHARE_VM_RUNTIME_HANDSHAKE_HPP
@@ -30,6 +30,7 @@
 #include "compiler/compileBroker.hpp"
 #include "compiler/compilerOracle.hpp"
 #include "interpreter/bytecodeHistogram.hpp"
+#include "memory/dynamicArchive.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/oopFactory.hpp"
 #include "memory/universe.hpp"
@@ -486,6 +487,10 @@ void before_exit(JavaThread * thread) {
     os::infinite_sleep();
   }
 
+  // Record the classes used by this run for the -XX:ArchiveClassesAtExit
+  // archive, and start regenerating it in the background if needed.
+  DynamicArchive::dump_at_exit(thread);
+
   // Terminate watcher thread - must before disenrolling any periodic task
   if (PeriodicTask::num_tasks() > 0)
     WatcherThread::stop();
@@ -28,6 +28,7 @@
 #include "oops/oop.inline.hpp"
 #include "prims/jvmtiExport.hpp"
 #include "runtime/jniHandles.hpp"
+#include "runtime/atomic.inline.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/thread.inline.hpp"
 #if INCLUDE_ALL_GCS
@@ -80,9 +81,17 @@ jobject JNIHandles::make_global(Handle obj) {
   jobject res = NULL;
   if (!obj.is_null()) {
     // ignore null handles
-    MutexLocker ml(JNIGlobalHandle_lock);
-    assert(Universe::heap()->is_in_reserved(obj()), "sanity check");
-    res = _global_handles->allocate_handle(obj());
+    Thread* owner = global_handle_cache_owner();
+    if (owner != NULL) {
+      oop* handle = allocate_cached_global(owner);
+      assert(Universe::heap()->is_in_reserved(obj()), "sanity check");
+      *handle = obj();
+      res = (jobject) handle;
+    } else {
+      MutexLocker ml(JNIGlobalHandle_lock);
+      assert(Universe::heap()->is_in_reserved(obj()), "sanity check");
+      res = _global_handles->allocate_handle(obj());
+    }
   } else {
     CHECK_UNHANDLED_OOPS_ONLY(Thread::current()->clear_unhandled_oops());
   }
@@ -129,7 +138,69 @@ template oop JNIHandles::resolve_jweak<false>(jweak);
 void JNIHandles::destroy_global(jobject handle) {
   if (handle != NULL) {
     assert(is_global_handle(handle), "Invalid delete of global JNI handle");
-    jobject_ref(handle) = deleted_handle();
+    Thread* owner = global_handle_cache_owner();
+    if (owner != NULL) {
+      cache_global(owner, &jobject_ref(handle));
+    } else {
+      jobject_ref(handle) = deleted_handle();
+    }
+  }
+}
+
+// The global handle cache of a thread is only used while the thread is in
+// the VM, so a safepoint never sees a slot being relinked.  Checked JNI
+// expects deleted handles to hold deleted_handle() and does not use it.
+Thread* JNIHandles::global_handle_cache_owner() {
+  if (!UseThreadLocalJNIGlobalHandles || CheckJNICalls) {
+    return NULL;
+  }
+  Thread* thread = Thread::current();
+  if (thread->is_Java_thread() &&
+      ((JavaThread*)thread)->thread_state() == _thread_in_vm) {
+    return thread;
+  }
+  return NULL;
+}
+
+oop* JNIHandles::allocate_cached_global(Thread* thread) {
+  oop* handle = thread->global_handle_cache();
+  int count = thread->global_handle_cache_count();
+  if (handle == NULL) {
+    MutexLocker ml(JNIGlobalHandle_lock);
+    count = _global_handles->reserve_handles((int)JNIGlobalHandleCacheSize, &handle);
+  }
+  assert(handle != NULL && count > 0, "no cached global handle");
+  thread->set_global_handle_cache((oop*) *handle, count - 1);
+  return handle;
+}
+
+void JNIHandles::cache_global(Thread* thread, oop* handle) {
+  int count = thread->global_handle_cache_count() + 1;
+  *handle = (oop) thread->global_handle_cache();
+  if (count <= 2 * JNIGlobalHandleCacheSize) {
+    thread->set_global_handle_cache(handle, count);
+    return;
+  }
+
+  // Keep JNIGlobalHandleCacheSize handles and give the rest back in one batch.
+  oop* last = handle;
+  for (int i = 1; i < JNIGlobalHandleCacheSize; i++) {
+    last = (oop*) *last;
+  }
+  oop* released = (oop*) *last;
+  *last = NULL;
+  thread->set_global_handle_cache(handle, (int)JNIGlobalHandleCacheSize);
+
+  MutexLocker ml(JNIGlobalHandle_lock);
+  _global_handles->release_handles(released);
+}
+
+void JNIHandles::release_global_handle_cache(Thread* thread) {
+  oop* list = thread->global_handle_cache();
+  if (list != NULL) {
+    thread->set_global_handle_cache(NULL, 0);
+    MutexLocker ml(JNIGlobalHandle_lock);
+    _global_handles->release_handles(list);
   }
 }
 
@@ -148,6 +219,23 @@ void JNIHandles::oops_do(OopClosure* f) {
 
 void JNIHandles::weak_oops_do(BoolObjectClosure* is_alive, OopClosure* f) {
   _weak_global_handles->weak_oops_do(is_alive, f);
+  weak_extra_oops_do(is_alive, f);
+}
+
+
+void JNIHandles::weak_handles_par_do(BoolObjectClosure* is_alive, OopClosure* f,
+                                     volatile jint* claimed) {
+  _weak_global_handles->weak_par_oops_do(is_alive, f, claimed);
+}
+
+
+void JNIHandles::weak_extra_oops_do(BoolObjectClosure* is_alive, OopClosure* f) {
+  /*
+   * JVMTI data structures may also contain weak oops.  The iteration of them
+   * is placed here so that we don't need to add it to each of the collectors.
+   */
+  JvmtiExport::weak_oops_do(is_alive, f);
+  TRACE_WEAK_OOPS_DO(is_alive, f);
 }
 
 
@@ -401,40 +489,69 @@ void JNIHandleBlock::oops_do(OopClosure* f) {
 }
 
 
-void JNIHandleBlock::weak_oops_do(BoolObjectClosure* is_alive,
-                                  OopClosure* f) {
-  for (JNIHandleBlock* current = this; current != NULL; current = current->_next) {
-    assert(current->pop_frame_link() == NULL,
-      "blocks holding weak global JNI handles should not have pop frame link set");
-    for (int index = 0; index < current->_top; index++) {
-      oop* root = &(current->_handles)[index];
-      oop value = *root;
-      // traverse heap pointers only, not deleted handles or free list pointers
-      if (value != NULL && Universe::heap()->is_in_reserved(value)) {
-        if (is_alive->do_object_b(value)) {
-          // The weakly referenced object is alive, update pointer
-          f->do_oop(root);
-        } else {
-          // The weakly referenced object is not alive, clear the reference by storing NULL
-          if (TraceReferenceGC) {
-            tty->print_cr("Clearing JNI weak reference (" INTPTR_FORMAT ")", root);
-          }
-          *root = NULL;
+void JNIHandleBlock::weak_block_oops_do(BoolObjectClosure* is_alive,
+                                        OopClosure* f) {
+  assert(pop_frame_link() == NULL,
+    "blocks holding weak global JNI handles should not have pop frame link set");
+  for (int index = 0; index < _top; index++) {
+    oop* root = &_handles[index];
+    oop value = *root;
+    // traverse heap pointers only, not deleted handles or free list pointers
+    if (value != NULL && Universe::heap()->is_in_reserved(value)) {
+      if (is_alive->do_object_b(value)) {
+        // The weakly referenced object is alive, update pointer
+        f->do_oop(root);
+      } else {
+        // The weakly referenced object is not alive, clear the reference by storing NULL
+        if (TraceReferenceGC) {
+          tty->print_cr("Clearing JNI weak reference (" INTPTR_FORMAT ")", root);
         }
+        *root = NULL;
       }
     }
+  }
+}
+
+
+void JNIHandleBlock::weak_oops_do(BoolObjectClosure* is_alive,
+                                  OopClosure* f) {
+  for (JNIHandleBlock* current = this; current != NULL; current = current->_next) {
+    current->weak_block_oops_do(is_alive, f);
     // the next handle block is valid only if current block is full
     if (current->_top < block_size_in_oops) {
       break;
     }
   }
+}
 
-  /*
-   * JVMTI data structures may also contain weak oops.  The iteration of them
-   * is placed here so that we don't need to add it to each of the collectors.
-   */
-  JvmtiExport::weak_oops_do(is_alive, f);
-  TRACE_WEAK_OOPS_DO(is_alive, f);
+
+// Each worker claims the next par_claim_stride blocks of the chain.  Claims
+// only move forward, so a worker walks the chain once in total.
+void JNIHandleBlock::weak_par_oops_do(BoolObjectClosure* is_alive,
+                                      OopClosure* f,
+                                      volatile jint* claimed) {
+  JNIHandleBlock* current = this;
+  jint index = 0;
+  while (true) {
+    jint start = Atomic::add(par_claim_stride, claimed) - par_claim_stride;
+    while (current != NULL && index < start) {
+      if (current->_top < block_size_in_oops) {
+        return;                 // the chain ends before the claimed blocks
+      }
+      current = current->_next;
+      index++;
+    }
+    for (jint end = start + par_claim_stride; current != NULL && index < end; index++) {
+      current->weak_block_oops_do(is_alive, f);
+      if (current->_top < block_size_in_oops) {
+        return;
+      }
+      current = current->_next;
+    }
+    if (current == NULL) {
+      return;
+    }
+  }
 }
 
 
@@ -497,6 +614,30 @@ jobject JNIHandleBlock::allocate_handle(oop obj) {
 }
 
 
+int JNIHandleBlock::reserve_handles(int count, oop** list) {
+  oop* head = NULL;
+  for (int i = 0; i < count; i++) {
+    // The slot is taken with a heap oop and then relinked before the
+    // next allocation can rebuild the free list.
+    oop* handle = (oop*) allocate_handle(JNIHandles::deleted_handle());
+    *handle = (oop) head;
+    head = handle;
+  }
+  *list = head;
+  return count;
+}
+
+
+void JNIHandleBlock::release_handles(oop* list) {
+  while (list != NULL) {
+    oop* next = (oop*) *list;
+    *list = (oop) _free_list;
+    _free_list = list;
+    list = next;
+  }
+}
+
+
 void JNIHandleBlock::rebuild_free_list() {
   assert(_allocate_before_rebuild == 0 && _free_list == NULL, "just checking");
   int free = 0;
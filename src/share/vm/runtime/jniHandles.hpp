@@ -44,6 +44,11 @@ class JNIHandles : AllStatic {
   inline static oop& jobject_ref(jobject handle); // NOT jweak!
   inline static oop& jweak_ref(jobject handle);
 
+  // Per-thread cache of global handle slots
+  static Thread* global_handle_cache_owner();
+  static oop* allocate_cached_global(Thread* thread);
+  static void cache_global(Thread* thread, oop* handle);
+
   template<bool external_guard> inline static oop guard_value(oop value);
   template<bool external_guard> inline static oop resolve_impl(jobject handle);
   template<bool external_guard> static oop resolve_jweak(jweak handle);
@@ -83,6 +88,9 @@ class JNIHandles : AllStatic {
   static jobject make_weak_global(Handle obj);
   static void destroy_weak_global(jobject handle);
 
+  // Return the global handle slots cached by an exiting thread
+  static void release_global_handle_cache(Thread* thread);
+
   // Sentinel marking deleted handles in block. Note that we cannot store NULL as
   // the sentinel, since clearing weak global JNI refs are done by storing NULL in
   // the handle. The handle may not be reused before destroy_weak_global is called.
@@ -109,6 +117,12 @@ class JNIHandles : AllStatic {
   static void weak_oops_do(BoolObjectClosure* is_alive, OopClosure* f);
   // Traversal of weak global handles.
   static void weak_oops_do(OopClosure* f);
+  // Parallel traversal of the weak global handle blocks.  Workers claim
+  // blocks through claimed, which starts at 0.  The other weak roots
+  // visited by weak_oops_do() are left to weak_extra_oops_do().
+  static void weak_handles_par_do(BoolObjectClosure* is_alive, OopClosure* f,
+                                  volatile jint* claimed);
+  static void weak_extra_oops_do(BoolObjectClosure* is_alive, OopClosure* f);
 };
 
 
@@ -157,10 +171,22 @@ class JNIHandleBlock : public CHeapObj<mtInternal> {
   // Free list computation
   void rebuild_free_list();
 
+  // Visit the weak handles of this block only
+  void weak_block_oops_do(BoolObjectClosure* is_alive, OopClosure* f);
+
+  // Number of blocks claimed at a time by weak_par_oops_do()
+  enum { par_claim_stride = 8 };
+
  public:
   // Handle allocation
   jobject allocate_handle(oop obj);
 
+  // Take up to count unused handles for a thread cache.  They are chained
+  // through their values and hold no oop.  Returns the number taken.
+  int reserve_handles(int count, oop** list);
+  // Return a chain of handles taken by reserve_handles() to the free list.
+  void release_handles(oop* list);
+
   // Block allocation and block free list management
   static JNIHandleBlock* allocate_block(Thread* thread = NULL);
   static void release_block(JNIHandleBlock* block, Thread* thread = NULL);
@@ -177,6 +203,8 @@ class JNIHandleBlock : public CHeapObj<mtInternal> {
   void oops_do(OopClosure* f);
   // Traversal of weak handles. Unreachable oops are cleared.
   void weak_oops_do(BoolObjectClosure* is_alive, OopClosure* f);
+  void weak_par_oops_do(BoolObjectClosure* is_alive, OopClosure* f,
+                        volatile jint* claimed);
 
   // Checked JNI support
   void set_planned_capacity(size_t planned_capacity) { _planned_capacity = planned_capacity; }
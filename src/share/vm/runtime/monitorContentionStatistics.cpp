@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "memory/iterator.hpp"
+#include "oops/klass.hpp"
+#include "runtime/atomic.inline.hpp"
+#include "runtime/monitorContentionStatistics.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "trace/tracing.hpp"
+#include "utilities/macros.hpp"
+
+MonitorContentionStatistics::Entry MonitorContentionStatistics::_table[MonitorContentionStatistics::table_size];
+
+bool MonitorContentionStatistics::is_enabled() {
+#if INCLUDE_TRACE
+  return Tracing::is_event_enabled(TraceJavaMonitorContentionStatisticsEvent);
+#else
+  return false;
+#endif
+}
+
+static uint hash_klass(Klass* k) {
+  uintptr_t v = (uintptr_t)k >> LogHeapWordSize;
+  return (uint)(v ^ (v >> 9) ^ (v >> 17));
+}
+
+MonitorContentionStatistics::Entry* MonitorContentionStatistics::find_or_insert(Klass* k) {
+  uint index = hash_klass(k);
+  for (int i = 0; i < max_probes; i++) {
+    Entry* e = &_table[(index + i) & (table_size - 1)];
+    Klass* cur = e->_klass;
+    if (cur == NULL) {
+      cur = (Klass*)Atomic::cmpxchg_ptr(k, &e->_klass, NULL);
+      if (cur == NULL) {
+        return e;
+      }
+    }
+    if (cur == k) {
+      return e;
+    }
+  }
+  // Too many classes hash to this neighbourhood; drop the sample.
+  return NULL;
+}
+
+void MonitorContentionStatistics::record(Klass* k, jlong blocked_ticks) {
+  Entry* e = find_or_insert(k);
+  if (e == NULL) {
+    return;
+  }
+  jlong micros = blocked_ticks * 1000000 / os::elapsed_frequency();
+  int bucket = 0;
+  for (jlong limit = 10; bucket < bucket_count - 1 && micros >= limit; limit *= 10) {
+    bucket++;
+  }
+  Atomic::add_ptr(1, &e->_count);
+  Atomic::add_ptr((intptr_t)micros, &e->_blocked_micros);
+  Atomic::add_ptr(1, &e->_buckets[bucket]);
+}
+
+void MonitorContentionStatistics::clear() {
+  for (int i = 0; i < table_size; i++) {
+    Entry* e = &_table[i];
+    e->_klass = NULL;
+    e->_count = 0;
+    e->_blocked_micros = 0;
+    for (int b = 0; b < bucket_count; b++) {
+      e->_buckets[b] = 0;
+    }
+  }
+}
+
+void MonitorContentionStatistics::emit_events() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  for (int i = 0; i < table_size; i++) {
+    Entry* e = &_table[i];
+    if (e->_klass == NULL || e->_count == 0) {
+      continue;
+    }
+    EventJavaMonitorContentionStatistics event;
+    event.set_monitorClass(e->_klass);
+    event.set_contendedCount(e->_count);
+    event.set_totalBlockedTime((jlong)e->_blocked_micros * 1000);
+    event.set_blockedUnder10us(e->_buckets[0]);
+    event.set_blockedUnder100us(e->_buckets[1]);
+    event.set_blockedUnder1ms(e->_buckets[2]);
+    event.set_blockedUnder10ms(e->_buckets[3]);
+    event.set_blockedUnder100ms(e->_buckets[4]);
+    event.set_blockedOver100ms(e->_buckets[5]);
+    event.commit();
+  }
+  clear();
+}
+
+void MonitorContentionStatistics::do_unloading(BoolObjectClosure* is_alive) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  bool found_dead = false;
+  for (int i = 0; i < table_size && !found_dead; i++) {
+    Klass* k = _table[i]._klass;
+    found_dead = (k != NULL) && !k->is_loader_alive(is_alive);
+  }
+  if (!found_dead) {
+    return;
+  }
+
+  // Entries are placed by linear probing, so rebuild the table from the
+  // entries of the classes that are still alive.
+  Entry* live = NEW_C_HEAP_ARRAY(Entry, table_size, mtInternal);
+  int live_count = 0;
+  for (int i = 0; i < table_size; i++) {
+    Entry* e = &_table[i];
+    if (e->_klass != NULL && e->_klass->is_loader_alive(is_alive)) {
+      Entry* copy = &live[live_count++];
+      copy->_klass = e->_klass;
+      copy->_count = e->_count;
+      copy->_blocked_micros = e->_blocked_micros;
+      for (int b = 0; b < bucket_count; b++) {
+        copy->_buckets[b] = e->_buckets[b];
+      }
+    }
+  }
+  clear();
+  for (int i = 0; i < live_count; i++) {
+    Entry* e = find_or_insert(live[i]._klass);
+    if (e != NULL) {
+      e->_count = live[i]._count;
+      e->_blocked_micros = live[i]._blocked_micros;
+      for (int b = 0; b < bucket_count; b++) {
+        e->_buckets[b] = live[i]._buckets[b];
+      }
+    }
+  }
+  FREE_C_HEAP_ARRAY(Entry, live, mtInternal);
+}
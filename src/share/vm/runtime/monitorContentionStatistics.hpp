@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_RUNTIME_MONITORCONTENTIONSTATISTICS_HPP
+#define SHARE_VM_RUNTIME_MONITORCONTENTIONSTATISTICS_HPP
+
+#include "memory/allocation.hpp"
+
+class BoolObjectClosure;
+class Klass;
+
+// Per-class histograms of the time threads spend blocked entering
+// contended ObjectMonitors. Samples are only collected while the
+// JavaMonitorContentionStatistics event is enabled. The table is
+// drained (and reset) at a safepoint when the periodic event is
+// emitted, and entries of unloaded classes are dropped by
+// ClassLoaderDataGraph::do_unloading().
+class MonitorContentionStatistics : AllStatic {
+ public:
+  enum {
+    bucket_count = 6            // <10us, <100us, <1ms, <10ms, <100ms, >=100ms
+  };
+
+ private:
+  enum {
+    table_size = 512,           // must be a power of 2
+    max_probes = 32
+  };
+
+  struct Entry {
+    Klass* volatile   _klass;
+    volatile intptr_t _count;
+    volatile intptr_t _blocked_micros;
+    volatile intptr_t _buckets[bucket_count];
+  };
+
+  static Entry _table[table_size];
+
+  static Entry* find_or_insert(Klass* k);
+  static void   clear();
+
+ public:
+  // True if contended monitor enters should be sampled.
+  static bool is_enabled();
+
+  // Record a contended enter of a monitor of class k which blocked
+  // the entering thread for blocked_ticks (os::elapsed_counter() units).
+  static void record(Klass* k, jlong blocked_ticks);
+
+  // Emit one JavaMonitorContentionStatistics event per sampled class
+  // and reset the histograms. Must be called at a safepoint.
+  static void emit_events();
+
+  // Drop the entries of unloaded classes.
+  static void do_unloading(BoolObjectClosure* is_alive);
+};
+
+#endif // SHARE_VM_RUNTIME_MONITORCONTENTIONSTATISTICS_HPP
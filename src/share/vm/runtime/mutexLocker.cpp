@@ -127,6 +127,7 @@ Monitor* GCTaskManager_lock           = NULL;
 
 Mutex*   Management_lock              = NULL;
 Monitor* Service_lock                 = NULL;
+Monitor* CodeSweeper_lock             = NULL;
 Monitor* PeriodicTask_lock            = NULL;
 
 #ifdef INCLUDE_TRACE
@@ -217,6 +218,7 @@ void mutex_init() {
   def(Patching_lock                , Mutex  , special,     true ); // used for safepointing and code patching.
   def(ObjAllocPost_lock            , Monitor, special,     false);
   def(Service_lock                 , Monitor, special,     true ); // used for service thread operations
+  def(CodeSweeper_lock             , Monitor, special,     true ); // used for code cache sweeper thread wakeups
   def(JmethodIdCreation_lock       , Mutex  , leaf,        true ); // used for creating jmethodIDs.
 
   def(SystemDictionary_lock        , Monitor, leaf,        true ); // lookups done by VM thread
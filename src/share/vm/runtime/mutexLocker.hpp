@@ -143,6 +143,7 @@ extern Mutex*   MMUTracker_lock;                 // protects the MMU
 
 extern Mutex*   Management_lock;                 // a lock used to serialize JVM management
 extern Monitor* Service_lock;                    // a lock used for service thread operation
+extern Monitor* CodeSweeper_lock;                // a lock used by the code cache sweeper thread
 extern Monitor* PeriodicTask_lock;               // protects the periodic task structure
 
 #ifdef INCLUDE_TRACE
@@ -29,6 +29,7 @@
 #include "oops/oop.inline.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/interfaceSupport.hpp"
+#include "runtime/monitorContentionStatistics.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/objectMonitor.hpp"
 #include "runtime/objectMonitor.inline.hpp"
@@ -179,6 +180,10 @@ static int BackOffMask             = 0 ;
 static int Knob_FastHSSEC          = 0 ;
 static int Knob_MoveNotifyee       = 2 ;       // notify() - disposition of notifyee
 static int Knob_QMode              = 0 ;       // EntryList-cxq policy - queue discipline
+static int Knob_SpinHoldLimit      = 20 ;      // UseAdaptiveMonitorSpinning: max avg hold time (us) worth spinning for
+static int Knob_NUMAHandoffScan    = 8 ;       // UseNUMAMonitorHandoff: EntryList nodes examined per handoff
+static int Knob_NUMAHandoffSkips   = 4 ;       // UseNUMAMonitorHandoff: max consecutive bypasses of the EntryList head
+static jlong SpinHoldLimitTicks    = 0 ;       // Knob_SpinHoldLimit in os::elapsed_counter() units
 static volatile int InitDone       = 0 ;
 
 #define TrySpin TrySpin_VaryDuration
@@ -350,6 +355,13 @@ void ATTR ObjectMonitor::enter(TRAPS) {
   assert (Self->_Stalled == 0, "invariant") ;
   Self->_Stalled = intptr_t(this) ;
 
+  // Time the contended acquisition for the adaptive spin controller
+  // and the per-class contention histograms.
+  jlong contended_start = 0 ;
+  if (UseAdaptiveMonitorSpinning || MonitorContentionStatistics::is_enabled()) {
+     contended_start = os::elapsed_counter() ;
+  }
+
   // Try one round of spinning *before* enqueueing Self
   // and before going through the awkward and expensive state
   // transitions.  The following spin is strictly optional ...
@@ -360,6 +372,7 @@ void ATTR ObjectMonitor::enter(TRAPS) {
      assert (_recursions == 0    , "invariant") ;
      assert (((oop)(object()))->mark() == markOopDesc::encode(this), "invariant") ;
      Self->_Stalled = 0 ;
+     ContendedEnterEpilog (Self, contended_start) ;
      return ;
   }
 
@@ -434,6 +447,7 @@ void ATTR ObjectMonitor::enter(TRAPS) {
   Atomic::dec_ptr(&_count);
   assert (_count >= 0, "invariant") ;
   Self->_Stalled = 0 ;
+  ContendedEnterEpilog (Self, contended_start) ;
 
   // Must either set _recursions = 0 or ASSERT _recursions == 0.
   assert (_recursions == 0     , "invariant") ;
@@ -476,6 +490,22 @@ void ATTR ObjectMonitor::enter(TRAPS) {
   }
 }
 
+// ContendedEnterEpilog() is called once the entering thread has acquired a
+// contended monitor.  It stamps the acquisition time for the hold time
+// estimate used by UseAdaptiveMonitorSpinning and records the time spent
+// blocked in the per-class contention histograms.
+
+void ObjectMonitor::ContendedEnterEpilog (Thread * Self, jlong contended_start) {
+  if (contended_start == 0) return ;
+  jlong now = os::elapsed_counter() ;
+  if (UseAdaptiveMonitorSpinning) {
+     _acquire_ticks = now ;
+  }
+  if (MonitorContentionStatistics::is_enabled()) {
+     MonitorContentionStatistics::record(((oop)object())->klass(), now - contended_start) ;
+  }
+}
+
 
 // Caveat: TryLock() is not necessarily serializing if it returns failure.
 // Callers must compensate as needed.
@@ -547,6 +577,9 @@ void ATTR ObjectMonitor::EnterI (TRAPS) {
     Self->_ParkEvent->reset() ;
     node._prev   = (ObjectWaiter *) 0xBAD ;
     node.TState  = ObjectWaiter::TS_CXQ ;
+    if (UseNUMA && UseNUMAMonitorHandoff) {
+        node._numa_node = os::numa_get_group_id() ;
+    }
 
     // Push "Self" onto the front of the _cxq.
     // Once on cxq/EntryList, Self stays on-queue until it acquires the lock.
@@ -984,6 +1017,14 @@ void ATTR ObjectMonitor::exit(bool not_suspended, TRAPS) {
      return ;
    }
 
+   // Feed the hold time of a contended acquisition to the adaptive spin
+   // controller.  Only the owner updates the average, so no atomics are needed.
+   if (_acquire_ticks != 0) {
+      jlong held = os::elapsed_counter() - _acquire_ticks ;
+      _acquire_ticks = 0 ;
+      _avg_hold_ticks = (_avg_hold_ticks * 7 + held) >> 3 ;
+   }
+
    // Invariant: after setting Responsible=null an thread must execute
    // a MEMBAR or other serializing instruction before fetching EntryList|cxq.
    if ((SyncFlags & 4) == 0) {
@@ -1198,7 +1239,7 @@ void ATTR ObjectMonitor::exit(bool not_suspended, TRAPS) {
           // Given all that, we have to tolerate the circumstance where "w" is
           // associated with Self.
           assert (w->TState == ObjectWaiter::TS_ENTER, "invariant") ;
-          ExitEpilog (Self, w) ;
+          ExitEpilog (Self, SelectSuccessor (w)) ;
           return ;
       }
 
@@ -1271,7 +1312,7 @@ void ATTR ObjectMonitor::exit(bool not_suspended, TRAPS) {
       w = _EntryList  ;
       if (w != NULL) {
           guarantee (w->TState == ObjectWaiter::TS_ENTER, "invariant") ;
-          ExitEpilog (Self, w) ;
+          ExitEpilog (Self, SelectSuccessor (w)) ;
           return ;
       }
    }
@@ -1324,6 +1365,44 @@ bool ObjectMonitor::ExitSuspendEquivalent (JavaThread * jSelf) {
 }
 
 
+// SelectSuccessor() picks the EntryList thread to wake.
+// By default that's the head of the EntryList.  With UseNUMAMonitorHandoff
+// we prefer a thread that enqueued itself on the releasing thread's NUMA node
+// so the monitor and the data it protects stay in that node's caches instead
+// of bouncing between sockets.  To bound unfairness we only examine the first
+// Knob_NUMAHandoffScan nodes and fall back to the head after
+// Knob_NUMAHandoffSkips consecutive bypasses.  Waking a node other than the
+// head is safe: the wakee unlinks itself from anywhere in the EntryList DLL
+// in UnlinkAfterAcquire().
+
+ObjectWaiter * ObjectMonitor::SelectSuccessor (ObjectWaiter * head) {
+   assert (head != NULL, "invariant") ;
+   if (!UseNUMA || !UseNUMAMonitorHandoff || head->_next == NULL) return head ;
+   if (_NUMASkips >= Knob_NUMAHandoffSkips) {
+      _NUMASkips = 0 ;
+      return head ;
+   }
+   const int node = os::numa_get_group_id() ;
+   int n = Knob_NUMAHandoffScan ;
+   for (ObjectWaiter * w = head ; w != NULL && --n >= 0 ; w = w->_next) {
+      assert (w->TState == ObjectWaiter::TS_ENTER, "invariant") ;
+      if (w->_numa_node == node) {
+         if (w == head) {
+            _NUMASkips = 0 ;
+         } else {
+            _NUMASkips ++ ;
+            TEVENT (Inflated exit - NUMA local successor) ;
+            if (ObjectMonitor::_sync_NUMAHandoffs != NULL) {
+               ObjectMonitor::_sync_NUMAHandoffs->inc() ;
+            }
+         }
+         return w ;
+      }
+   }
+   _NUMASkips = 0 ;
+   return head ;
+}
+
 void ObjectMonitor::ExitEpilog (Thread * Self, ObjectWaiter * Wakee) {
    assert (_owner == Self, "invariant") ;
 
@@ -2054,6 +2133,25 @@ int ObjectMonitor::TrySpin_VaryDuration (Thread * Self) {
 
     ctr = _SpinDuration  ;
     if (ctr < Knob_SpinBase) ctr = Knob_SpinBase ;
+
+    // Adaptive spinning - consult the observed hold times of contended
+    // acquisitions.  If the owner typically holds the monitor for longer
+    // than a park/unpark round trip, spinning just burns cycles; park
+    // after the pre-spin above.  If holds are short, spin at least at the
+    // poverty line even if failed spins have driven _SpinDuration to zero.
+    // The hold time estimate is maintained by threads that park as well,
+    // so neither state is absorbing.
+    if (UseAdaptiveMonitorSpinning && SpinHoldLimitTicks > 0) {
+       jlong hold = _avg_hold_ticks ;
+       if (hold > SpinHoldLimitTicks) {
+          TEVENT (Spin abort - long hold time) ;
+          if (ObjectMonitor::_sync_LongHoldSpinAborts != NULL) {
+             ObjectMonitor::_sync_LongHoldSpinAborts->inc() ;
+          }
+          return 0 ;
+       }
+       if (hold > 0 && ctr < Knob_Poverty) ctr = Knob_Poverty ;
+    }
     if (ctr <= 0) return 0 ;
 
     if (Knob_SuccRestrict && _succ != NULL) return 0 ;
@@ -2313,6 +2411,7 @@ ObjectWaiter::ObjectWaiter(Thread* thread) {
   _thread   = thread;
   _event    = thread->_ParkEvent ;
   _active   = false;
+  _numa_node = -1;
   assert (_event != NULL, "invariant") ;
 }
 
@@ -2395,6 +2494,8 @@ PerfCounter * ObjectMonitor::_sync_SlowNotify                  = NULL ;
 PerfCounter * ObjectMonitor::_sync_SlowNotifyAll               = NULL ;
 PerfCounter * ObjectMonitor::_sync_FailedSpins                 = NULL ;
 PerfCounter * ObjectMonitor::_sync_SuccessfulSpins             = NULL ;
+PerfCounter * ObjectMonitor::_sync_LongHoldSpinAborts          = NULL ;
+PerfCounter * ObjectMonitor::_sync_NUMAHandoffs                = NULL ;
 PerfCounter * ObjectMonitor::_sync_MonInCirculation            = NULL ;
 PerfCounter * ObjectMonitor::_sync_MonScavenged                = NULL ;
 PerfCounter * ObjectMonitor::_sync_Inflations                  = NULL ;
@@ -2427,6 +2528,8 @@ void ObjectMonitor::Initialize () {
       NEWPERFCOUNTER(_sync_SlowNotifyAll) ;
       NEWPERFCOUNTER(_sync_FailedSpins) ;
       NEWPERFCOUNTER(_sync_SuccessfulSpins) ;
+      NEWPERFCOUNTER(_sync_LongHoldSpinAborts) ;
+      NEWPERFCOUNTER(_sync_NUMAHandoffs) ;
       NEWPERFCOUNTER(_sync_PrivateA) ;
       NEWPERFCOUNTER(_sync_PrivateB) ;
       NEWPERFCOUNTER(_sync_MonInCirculation) ;
@@ -2528,8 +2631,13 @@ void ObjectMonitor::DeferredInitialize () {
   SETKNOB(ResetEvent) ;
   SETKNOB(MoveNotifyee) ;
   SETKNOB(FastHSSEC) ;
+  SETKNOB(SpinHoldLimit) ;
+  SETKNOB(NUMAHandoffScan) ;
+  SETKNOB(NUMAHandoffSkips) ;
   #undef SETKNOB
 
+  SpinHoldLimitTicks = (jlong)Knob_SpinHoldLimit * os::elapsed_frequency() / 1000000 ;
+
   if (Knob_Verbose) {
     sanity_checks();
   }
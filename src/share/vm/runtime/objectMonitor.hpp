@@ -48,6 +48,7 @@ class ObjectWaiter : public StackObj {
   volatile TStates TState ;
   Sorted        _Sorted ;           // List placement disposition
   bool          _active ;           // Contention monitoring is enabled
+  int           _numa_node ;        // NUMA node the thread enqueued on, or -1
  public:
   ObjectWaiter(Thread* thread);
 
@@ -155,6 +156,9 @@ class ObjectMonitor {
     _SpinClock    = 0 ;
     OwnerIsThread = 0 ;
     _previous_owner_tid = 0;
+    _acquire_ticks  = 0 ;
+    _avg_hold_ticks = 0 ;
+    _NUMASkips      = 0 ;
   }
 
   ~ObjectMonitor() {
@@ -178,6 +182,9 @@ private:
     _SpinFreq      = 0 ;
     _SpinClock     = 0 ;
     OwnerIsThread  = 0 ;
+    _acquire_ticks  = 0 ;
+    _avg_hold_ticks = 0 ;
+    _NUMASkips      = 0 ;
   }
 
 public:
@@ -223,6 +230,8 @@ public:
   int       TrySpin_VaryDuration  (Thread * Self) ;
   void      ctAsserts () ;
   void      ExitEpilog (Thread * Self, ObjectWaiter * Wakee) ;
+  ObjectWaiter * SelectSuccessor (ObjectWaiter * head) ;
+  void      ContendedEnterEpilog (Thread * Self, jlong contended_start) ;
   bool      ExitSuspendEquivalent (JavaThread * Self) ;
   void      post_monitor_wait_event(EventJavaMonitorWait * event,
                                                    jlong notifier_tid,
@@ -267,6 +276,9 @@ public:
   volatile int _SpinClock ;
   volatile int _SpinDuration ;
   volatile intptr_t _SpinState ;    // MCS/CLH list of spinners
+  jlong _acquire_ticks ;            // time of the last contended acquisition, 0 if not timed
+  jlong _avg_hold_ticks ;           // moving average of contended hold times
+  int _NUMASkips ;                  // consecutive handoffs that bypassed the EntryList head
 
   // TODO-FIXME: _count, _waiters and _recursions should be of
   // type int, or int32_t but not intptr_t.  There's no reason
@@ -301,6 +313,8 @@ public:
   static PerfCounter * _sync_SlowNotifyAll ;
   static PerfCounter * _sync_FailedSpins ;
   static PerfCounter * _sync_SuccessfulSpins ;
+  static PerfCounter * _sync_LongHoldSpinAborts ;
+  static PerfCounter * _sync_NUMAHandoffs ;
   static PerfCounter * _sync_PrivateA ;
   static PerfCounter * _sync_PrivateB ;
   static PerfCounter * _sync_MonInCirculation ;
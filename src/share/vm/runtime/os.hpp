@@ -529,6 +529,12 @@ class os: AllStatic {
   // run cmd in a separate process and return its exit code; or -1 on failures
   static int fork_and_exec(char *cmd, bool use_vfork_if_available = false);
 
+  // run the executable path with the NULL terminated argv in a separate
+  // process without a shell and without waiting for it to finish; the
+  // process keeps the standard streams only if inherit_output is true.
+  // Return 0 if the process was started, or -1 on failures
+  static int spawn_detached(const char* path, char* const argv[], bool inherit_output);
+
   // os::exit() is merged with vm_exit()
   // static void exit(int num);
 
@@ -51,6 +51,7 @@
 #include "runtime/sweeper.hpp"
 #include "runtime/synchronizer.hpp"
 #include "runtime/thread.inline.hpp"
+#include "runtime/timeToSafepointProfiler.hpp"
 #include "services/runtimeService.hpp"
 #include "utilities/events.hpp"
 #include "utilities/macros.hpp"
@@ -193,6 +194,9 @@ void SafepointSynchronize::begin() {
   //
   EventSafepointStateSynchronization sync_event;
   int initial_running = 0;
+  if (ProfileTimeToSafepoint) {
+    TimeToSafepointProfiler::begin_synchronize();
+  }
   _state            = _synchronizing;
   OrderAccess::fence();
 
@@ -392,6 +396,10 @@ void SafepointSynchronize::begin() {
 
   OrderAccess::fence();
 
+  if (ProfileTimeToSafepoint) {
+    TimeToSafepointProfiler::end_synchronize(safepoint_counter());
+  }
+
   if (wait_blocked_event.should_commit()) {
     wait_blocked_event.set_safepointId(safepoint_counter());
     wait_blocked_event.set_runningThreadCount(initial_waiting_to_block);
@@ -730,6 +738,9 @@ void SafepointSynchronize::block(JavaThread *thread) {
         assert(_waiting_to_block > 0, "sanity check");
         _waiting_to_block--;
         thread->safepoint_state()->set_has_called_back(true);
+        if (ProfileTimeToSafepoint) {
+          TimeToSafepointProfiler::note_thread_stopped(thread, state);
+        }
 
         DEBUG_ONLY(thread->set_visited_for_critical_count(true));
         if (thread->in_critical()) {
@@ -972,6 +983,9 @@ void ThreadSafepointState::roll_forward(suspend_type type) {
   switch(_type) {
     case _at_safepoint:
       SafepointSynchronize::signal_thread_at_safepoint();
+      if (ProfileTimeToSafepoint) {
+        TimeToSafepointProfiler::note_thread_stopped(_thread, _orig_thread_state);
+      }
       DEBUG_ONLY(_thread->set_visited_for_critical_count(true));
       if (_thread->in_critical()) {
         // Notice that this thread is in a critical section
@@ -208,6 +208,9 @@ class StubRoutines: AllStatic {
   static address _updateBytesCRC32;
   static address _crc_table_adr;
 
+  static address _inflateBytes;
+  static address _inflateASCIIBytes;
+
   static address _multiplyToLen;
   static address _squareToLen;
   static address _mulAdd;
@@ -370,6 +373,9 @@ class StubRoutines: AllStatic {
   static address updateBytesCRC32()    { return _updateBytesCRC32; }
   static address crc_table_addr()      { return _crc_table_adr; }
 
+  static address inflateBytes()        { return _inflateBytes; }
+  static address inflateASCIIBytes()   { return _inflateASCIIBytes; }
+
   static address multiplyToLen()       {return _multiplyToLen; }
   static address squareToLen()         {return _squareToLen; }
   static address mulAdd()              {return _mulAdd; }
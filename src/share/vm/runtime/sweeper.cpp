@@ -31,12 +31,15 @@
 #include "memory/resourceArea.hpp"
 #include "oops/method.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/codeCacheSweeperThread.hpp"
 #include "runtime/compilationPolicy.hpp"
+#include "runtime/interfaceSupport.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.inline.hpp"
 #include "runtime/os.hpp"
 #include "runtime/sweeper.hpp"
 #include "runtime/thread.inline.hpp"
+#include "runtime/vmThread.hpp"
 #include "runtime/vm_operations.hpp"
 #include "trace/tracing.hpp"
 #include "utilities/events.hpp"
@@ -140,6 +143,7 @@ int      NMethodSweeper::_seen                         = 0;    // Nof. nmethod w
 int      NMethodSweeper::_flushed_count                = 0;    // Nof. nmethods flushed in current sweep
 int      NMethodSweeper::_zombified_count              = 0;    // Nof. nmethods made zombie in current sweep
 int      NMethodSweeper::_marked_for_reclamation_count = 0;    // Nof. nmethods marked for reclaim in current sweep
+int      NMethodSweeper::_made_not_entrant_count       = 0;    // Nof. nmethods evicted (made not-entrant) in current sweep
 
 volatile bool NMethodSweeper::_should_sweep            = true; // Indicates if we should invoke the sweeper
 volatile int  NMethodSweeper::_sweep_fractions_left    = 0;    // Nof. invocations left until we are completed with this pass
@@ -153,6 +157,8 @@ int    NMethodSweeper::_hotness_counter_reset_val       = 0;
 long   NMethodSweeper::_total_nof_methods_reclaimed     = 0;    // Accumulated nof methods flushed
 long   NMethodSweeper::_total_nof_c2_methods_reclaimed  = 0;    // Accumulated nof methods flushed
 size_t NMethodSweeper::_total_flushed_size              = 0;    // Total number of bytes flushed from the code cache
+long   NMethodSweeper::_total_nof_methods_evicted       = 0;    // Accumulated nof methods made not-entrant by the sweeper
+size_t NMethodSweeper::_total_evicted_size              = 0;    // Total number of bytes made not-entrant by the sweeper
 Tickspan  NMethodSweeper::_total_time_sweeping;                 // Accumulated time sweeping
 Tickspan  NMethodSweeper::_total_time_this_sweep;               // Total time this sweep
 Tickspan  NMethodSweeper::_peak_sweep_time;                     // Peak time for a full sweep
@@ -197,6 +203,15 @@ bool NMethodSweeper::sweep_in_progress() {
   return (_current != NULL);
 }
 
+// Only compiler threads are allowed to sweep, unless there is a dedicated
+// sweeper thread.
+bool NMethodSweeper::is_sweeper_thread(Thread* thread) {
+  if (UseCodeCacheSweeperThread) {
+    return CodeCacheSweeperThread::is_sweeper_thread(thread);
+  }
+  return thread->is_Compiler_thread();
+}
+
 // Scans the stacks of all Java threads and marks activations of not-entrant methods.
 // No need to synchronize access, since 'mark_active_nmethods' is always executed at a
 // safepoint.
@@ -240,8 +255,7 @@ void NMethodSweeper::mark_active_nmethods() {
  */
 void NMethodSweeper::possibly_sweep() {
   assert(JavaThread::current()->thread_state() == _thread_in_vm, "must run in vm mode");
-  // Only compiler threads are allowed to sweep
-  if (!MethodFlushing || !sweep_in_progress() || !Thread::current()->is_Compiler_thread()) {
+  if (!MethodFlushing || !sweep_in_progress() || !is_sweeper_thread(Thread::current())) {
     return;
   }
 
@@ -318,6 +332,60 @@ void NMethodSweeper::possibly_sweep() {
   }
 }
 
+/**
+ * Main loop of the sweeper thread. The thread wakes up every NmethodSweepCheckInterval
+ * seconds, or as soon as it is notified that the code cache is full, and sweeps the
+ * whole code cache in one pass. Stacks are still scanned at safepoints only. If a
+ * sweep is needed but no safepoint has started one since the last sweep finished,
+ * the thread requests a safepoint itself instead of waiting for an unrelated one, so
+ * that not-entrant nmethods can become zombies and zombies can be flushed.
+ */
+void NMethodSweeper::sweeper_loop() {
+  JavaThread* thread = JavaThread::current();
+  while (true) {
+    {
+      ThreadBlockInVM tbivm(thread);
+      MutexLockerEx waiter(CodeSweeper_lock, Mutex::_no_safepoint_check_flag);
+      CodeSweeper_lock->wait(Mutex::_no_safepoint_check_flag, NmethodSweepCheckInterval * 1000);
+    }
+    if (!sweep_in_progress() && sweep_needed()) {
+      VM_MarkActiveNMethods op;
+      VMThread::execute(&op);
+    }
+    possibly_sweep();
+  }
+}
+
+/**
+ * Determines if the sweeper thread should request a safepoint to start a new
+ * sweep: the code cache is under pressure, or enough nmethods changed state
+ * since the last sweep (see possibly_enable_sweeper()). An idle code cache
+ * does not cause any safepoints.
+ */
+bool NMethodSweeper::sweep_needed() {
+  if (!MethodFlushing) {
+    return false;
+  }
+  const int max_wait_time = ReservedCodeCacheSize / (16 * M);
+  if (!CompileBroker::should_compile_new_jobs() ||
+      CodeCache::reverse_free_ratio() >= max_wait_time) {
+    _should_sweep = true;
+  } else {
+    possibly_enable_sweeper();
+  }
+  return _should_sweep;
+}
+
+/**
+ * Wakes up the sweeper thread, e.g. because the code cache is full.
+ */
+void NMethodSweeper::notify() {
+  if (UseCodeCacheSweeperThread) {
+    MonitorLockerEx waiter(CodeSweeper_lock, Mutex::_no_safepoint_check_flag);
+    waiter.notify();
+  }
+}
+
 void NMethodSweeper::sweep_code_cache() {
   ResourceMark rm;
   Ticks sweep_start_counter = Ticks::now();
@@ -325,15 +393,17 @@ void NMethodSweeper::sweep_code_cache() {
   _flushed_count                = 0;
   _zombified_count              = 0;
   _marked_for_reclamation_count = 0;
+  _made_not_entrant_count       = 0;
 
   if (PrintMethodFlushing && Verbose) {
     tty->print_cr("### Sweep at %d out of %d. Invocations left: %d", _seen, CodeCache::nof_nmethods(), _sweep_fractions_left);
   }
 
-  if (!CompileBroker::should_compile_new_jobs()) {
+  if (UseCodeCacheSweeperThread || !CompileBroker::should_compile_new_jobs()) {
     // If we have turned off compilations we might as well do full sweeps
     // in order to reach the clean state faster. Otherwise the sleeping compiler
-    // threads will slow down sweeping.
+    // threads will slow down sweeping. The sweeper thread does not delay
+    // compilations, so it always does full sweeps.
     _sweep_fractions_left = 1;
   }
 
@@ -400,6 +470,7 @@ void NMethodSweeper::sweep_code_cache() {
     event.set_sweptCount(swept_count);
     event.set_flushedCount(_flushed_count);
     event.set_zombifiedCount(_zombified_count);
+    event.set_evictedCount(_made_not_entrant_count);
     event.commit();
   }
 
@@ -457,17 +528,26 @@ void NMethodSweeper::possibly_enable_sweeper() {
 
 class NMethodMarker: public StackObj {
  private:
-  CompilerThread* _thread;
+  JavaThread* _thread;
+
+  void set_scanned_nmethod(nmethod* nm) {
+    if (_thread->is_Compiler_thread()) {
+      _thread->as_CompilerThread()->set_scanned_nmethod(nm);
+    } else {
+      assert(CodeCacheSweeperThread::is_sweeper_thread(_thread), "only compiler threads and the sweeper thread sweep");
+      ((CodeCacheSweeperThread*)_thread)->set_scanned_nmethod(nm);
+    }
+  }
  public:
   NMethodMarker(nmethod* nm) {
-    _thread = CompilerThread::current();
+    _thread = JavaThread::current();
     if (!nm->is_zombie() && !nm->is_unloaded()) {
       // Only expose live nmethods for scanning
-      _thread->set_scanned_nmethod(nm);
+      set_scanned_nmethod(nm);
     }
   }
   ~NMethodMarker() {
-    _thread->set_scanned_nmethod(NULL);
+    set_scanned_nmethod(NULL);
   }
 };
 
@@ -488,6 +568,25 @@ void NMethodSweeper::release_nmethod(nmethod *nm) {
   nm->flush();
 }
 
+/**
+ * The hotness counter of an nmethod is decremented by every sweep and reset by
+ * every stack scan that finds the nmethod on a stack, so nmethods that were not
+ * used for the longest time have the lowest counters. An nmethod is evicted if
+ * its counter falls below the threshold computed here, which grows as the code
+ * cache fills up. With UseSizeAwareCodeCacheEviction the threshold grows faster
+ * for large C2-compiled nmethods: evicting them frees the most space, and they
+ * are only recompiled if they become hot again.
+ */
+double NMethodSweeper::eviction_threshold(nmethod* nm, int reset_val) {
+  double pressure = CodeCache::reverse_free_ratio() * NmethodSweepActivity;
+  if (UseSizeAwareCodeCacheEviction && nm->is_compiled_by_c2()) {
+    double size_units = (double)nm->total_size() / MAX2(CodeCacheEvictionSizeUnit, (uintx)1);
+    // Cap the size bonus so that recency still dominates for huge nmethods
+    pressure *= MIN2(1.0 + size_units, 8.0);
+  }
+  return -reset_val + pressure;
+}
+
 int NMethodSweeper::process_nmethod(nmethod *nm) {
   assert(!CodeCache_lock->owned_by_self(), "just checking");
 
@@ -590,7 +689,7 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
         // ReservedCodeCacheSize
         int reset_val = hotness_counter_reset_val();
         int time_since_reset = reset_val - nm->hotness_counter();
-        double threshold = -reset_val + (CodeCache::reverse_free_ratio() * NmethodSweepActivity);
+        double threshold = eviction_threshold(nm, reset_val);
         // The less free space in the code cache we have - the bigger reverse_free_ratio() is.
         // I.e., 'threshold' increases with lower available space in the code cache and a higher
         // NmethodSweepActivity. If the current hotness counter - which decreases from its initial
@@ -604,7 +703,11 @@ int NMethodSweeper::process_nmethod(nmethod *nm) {
           //    sizes (e.g., <10m) and the code cache size is too small to hold all hot methods.
           //    The second condition ensures that methods are not immediately made not-entrant
           //    after compilation.
-          nm->make_not_entrant();
+          if (nm->make_not_entrant()) {
+            _made_not_entrant_count++;
+            _total_nof_methods_evicted++;
+            _total_evicted_size += nm->total_size();
+          }
           // Code cache state change is tracked in make_not_entrant()
           if (PrintMethodFlushing && Verbose) {
             tty->print_cr("### Nmethod %d/" PTR_FORMAT "made not-entrant: hotness counter %d/%d threshold %f",
@@ -671,4 +774,6 @@ void NMethodSweeper::print() {
   tty->print_cr("  Total number of flushed methods: %ld(%ld C2 methods)", _total_nof_methods_reclaimed,
                                                     _total_nof_c2_methods_reclaimed);
   tty->print_cr("  Total size of flushed methods:   " SIZE_FORMAT "kB", _total_flushed_size/K);
+  tty->print_cr("  Total number of evicted methods: %ld", _total_nof_methods_evicted);
+  tty->print_cr("  Total size of evicted methods:   " SIZE_FORMAT "kB", _total_evicted_size/K);
 }
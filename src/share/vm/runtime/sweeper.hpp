@@ -51,7 +51,10 @@
 //     state change happens during separate sweeps. It may take at least 3 sweeps before an
 //     nmethod's space is freed. Sweeping is currently done by compiler threads between
 //     compilations or at least each 5 sec (NmethodSweepCheckInterval) when the code cache
-//     is full.
+//     is full. With -XX:+UseCodeCacheSweeperThread a dedicated thread sweeps instead; it
+//     covers the whole code cache in one pass and requests a safepoint for stack
+//     scanning if none happened since the last sweep, so that nmethods advance
+//     through their states without waiting for an unrelated safepoint.
 
 class NMethodSweeper : public AllStatic {
   static long      _traversals;                     // Stack scan count, also sweep ID.
@@ -63,6 +66,7 @@ class NMethodSweeper : public AllStatic {
   static int       _flushed_count;                  // Nof. nmethods flushed in current sweep
   static int       _zombified_count;                // Nof. nmethods made zombie in current sweep
   static int       _marked_for_reclamation_count;   // Nof. nmethods marked for reclaim in current sweep
+  static int       _made_not_entrant_count;         // Nof. nmethods evicted (made not-entrant) in current sweep
 
   static volatile int  _sweep_fractions_left;       // Nof. invocations left until we are completed with this pass
   static volatile int  _sweep_started;              // Flag to control conc sweeper
@@ -75,6 +79,8 @@ class NMethodSweeper : public AllStatic {
   static long      _total_nof_methods_reclaimed;    // Accumulated nof methods flushed
   static long      _total_nof_c2_methods_reclaimed; // Accumulated nof C2-compiled methods flushed
   static size_t    _total_flushed_size;             // Total size of flushed methods
+  static long      _total_nof_methods_evicted;      // Accumulated nof methods made not-entrant by the sweeper
+  static size_t    _total_evicted_size;             // Total size of methods made not-entrant by the sweeper
   static int       _hotness_counter_reset_val;
 
   static Tickspan  _total_time_sweeping;            // Accumulated time sweeping
@@ -86,11 +92,17 @@ class NMethodSweeper : public AllStatic {
   static void release_nmethod(nmethod* nm);
 
   static bool sweep_in_progress();
+  static bool sweep_needed();
+  static bool is_sweeper_thread(Thread* thread);
   static void sweep_code_cache();
+  static double eviction_threshold(nmethod* nm, int reset_val);
 
  public:
   static long traversal_count()              { return _traversals; }
   static int  total_nof_methods_reclaimed()  { return _total_nof_methods_reclaimed; }
+  static long total_nof_code_cache_sweeps()  { return _total_nof_code_cache_sweeps; }
+  static long total_nof_methods_evicted()    { return _total_nof_methods_evicted; }
+  static size_t total_evicted_size()         { return _total_evicted_size; }
   static const Tickspan total_time_sweeping()      { return _total_time_sweeping; }
   static const Tickspan peak_sweep_time()          { return _peak_sweep_time; }
   static const Tickspan peak_sweep_fraction_time() { return _peak_sweep_fraction_time; }
@@ -107,6 +119,8 @@ class NMethodSweeper : public AllStatic {
 
   static void mark_active_nmethods();      // Invoked at the end of each safepoint
   static void possibly_sweep();            // Compiler threads call this to sweep
+  static void sweeper_loop();              // Main loop of the sweeper thread
+  static void notify();                    // Wakes up the sweeper thread
 
   static int hotness_counter_reset_val();
   static void report_state_change(nmethod* nm);
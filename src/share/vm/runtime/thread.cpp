@@ -232,6 +232,7 @@ Thread::Thread() {
   set_metadata_handles(new (ResourceObj::C_HEAP, mtClass) GrowableArray<Metadata*>(30, true));
   set_active_handles(NULL);
   set_free_handle_block(NULL);
+  set_global_handle_cache(NULL, 0);
   set_last_handle_mark(NULL);
   set_in_eagerly_loading_class(false);
 
@@ -1905,6 +1906,8 @@ void JavaThread::exit(bool destroy_vm, ExitType exit_type) {
     JNIHandleBlock::release_block(block);
   }
 
+  JNIHandles::release_global_handle_cache(this);
+
   // These have to be removed while this is still a valid thread.
   remove_stack_guard_pages();
 
@@ -1984,6 +1987,8 @@ void JavaThread::cleanup_failed_attach_current_thread() {
     JNIHandleBlock::release_block(block);
   }
 
+  JNIHandles::release_global_handle_cache(this);
+
   // These have to be removed while this is still a valid thread.
   remove_stack_guard_pages();
 
@@ -2420,6 +2425,10 @@ void JavaThread::check_safepoint_and_suspend_for_native_trans(JavaThread *thread
     SafepointSynchronize::block(curJT);
   }
 
+  if (curJT == thread && thread->has_handshake()) {
+    thread->handshake_process_by_self();
+  }
+
   if (thread->is_deopt_suspend()) {
     thread->clear_deopt_suspend();
     RegisterMap map(thread, false);
@@ -4177,6 +4186,11 @@ void Threads::remove(JavaThread* p) {
     p->set_terminated_value();
   } // unlock Threads_lock
 
+  if (ThreadLocalHandshakes) {
+    // A handshake requester may still refer to p; wait until it is done.
+    p->handshake_state()->thread_exit(p);
+  }
+
   // Since Events::log uses a lock, we grab it outside the Threads_lock
   Events::log(p, "Thread exited: " INTPTR_FORMAT, p);
 }
@@ -31,6 +31,7 @@
 #include "prims/jni.h"
 #include "prims/jvmtiExport.hpp"
 #include "runtime/frame.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/javaFrameAnchor.hpp"
 #include "runtime/jniHandles.hpp"
 #include "runtime/mutexLocker.hpp"
@@ -196,7 +197,8 @@ class Thread: public ThreadShadow {
 
     _has_async_exception    = 0x00000001U, // there is a pending async exception
     _critical_native_unlock = 0x00000002U, // Must call back to unlock JNI critical lock
-    _trace_flag             = 0x00000004U  // call tracing backend
+    _trace_flag             = 0x00000004U, // call tracing backend
+    _has_handshake          = 0x00000008U  // a thread-local handshake is pending
   };
 
   // various suspension related flags - atomically updated
@@ -233,6 +235,11 @@ class Thread: public ThreadShadow {
   // One-element thread local free list
   JNIHandleBlock* _free_handle_block;
 
+  // Free JNI global handle slots cached by this thread, chained through
+  // their values (UseThreadLocalJNIGlobalHandles)
+  oop*            _global_handle_cache;
+  int             _global_handle_cache_count;
+
   // Point to the last handle mark
   HandleMark* _last_handle_mark;
 
@@ -441,6 +448,12 @@ class Thread: public ThreadShadow {
   void set_active_handles(JNIHandleBlock* block) { _active_handles = block; }
   JNIHandleBlock* free_handle_block() const      { return _free_handle_block; }
   void set_free_handle_block(JNIHandleBlock* block) { _free_handle_block = block; }
+  oop* global_handle_cache() const               { return _global_handle_cache; }
+  int global_handle_cache_count() const          { return _global_handle_cache_count; }
+  void set_global_handle_cache(oop* list, int count) {
+    _global_handle_cache = list;
+    _global_handle_cache_count = count;
+  }
 
   // Internal handle support
   HandleArea* handle_area() const                { return _handle_area; }
@@ -1786,6 +1799,16 @@ public:
   GrowableArray<MonitorInfo*>* cached_monitor_info() { return _cached_monitor_info; }
   void set_cached_monitor_info(GrowableArray<MonitorInfo*>* info) { _cached_monitor_info = info; }
 
+  // Thread-local handshake support
+private:
+  HandshakeState _handshake;
+public:
+  HandshakeState* handshake_state()       { return &_handshake; }
+  bool has_handshake() const              { return (_suspend_flags & _has_handshake) != 0; }
+  void set_has_handshake()                { set_suspend_flag(_has_handshake); }
+  void clear_has_handshake()              { clear_suspend_flag(_has_handshake); }
+  void handshake_process_by_self()        { _handshake.process_by_self(this); }
+
   // clearing/querying jni attach status
   bool is_attaching_via_jni() const { return _jni_attach_state == _attaching_via_jni; }
   bool has_attached_via_jni() const { return is_attaching_via_jni() || _jni_attach_state == _attached_via_jni; }
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "precompiled.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/method.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/timeToSafepointProfiler.hpp"
+#include "runtime/vframe.hpp"
+#include "runtime/vmThread.hpp"
+#include "trace/tracing.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+
+TimeToSafepointProfiler::Entry TimeToSafepointProfiler::_table[TimeToSafepointProfiler::table_size];
+TimeToSafepointProfiler::Entry TimeToSafepointProfiler::_no_java_frame;
+jlong           TimeToSafepointProfiler::_profiled_safepoints = 0;
+jlong           TimeToSafepointProfiler::_dropped_samples     = 0;
+jlong           TimeToSafepointProfiler::_sync_start_nanos    = 0;
+JavaThread*     TimeToSafepointProfiler::_laggard             = NULL;
+JavaThreadState TimeToSafepointProfiler::_laggard_state       = _thread_uninitialized;
+
+extern const char* _get_thread_state_name(JavaThreadState _thread_state);
+
+static uint hash_symbols(Symbol* holder, Symbol* name, Symbol* signature) {
+  uintptr_t v = ((uintptr_t)holder ^ ((uintptr_t)name >> 3) ^ ((uintptr_t)signature >> 6)) >> LogHeapWordSize;
+  return (uint)(v ^ (v >> 9) ^ (v >> 17));
+}
+
+TimeToSafepointProfiler::Entry* TimeToSafepointProfiler::find_or_insert(Method* m) {
+  Symbol* holder = m->klass_name();
+  Symbol* name = m->name();
+  Symbol* signature = m->signature();
+  uint index = hash_symbols(holder, name, signature);
+  for (int i = 0; i < max_probes; i++) {
+    Entry* e = &_table[(index + i) & (table_size - 1)];
+    if (e->_holder == NULL) {
+      holder->increment_refcount();
+      name->increment_refcount();
+      signature->increment_refcount();
+      e->_holder = holder;
+      e->_name = name;
+      e->_signature = signature;
+      return e;
+    }
+    if (e->_holder == holder && e->_name == name && e->_signature == signature) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+void TimeToSafepointProfiler::clear() {
+  Entry empty;
+  memset(&empty, 0, sizeof(empty));
+  for (int i = 0; i < table_size; i++) {
+    Entry* e = &_table[i];
+    if (e->_holder != NULL) {
+      e->_holder->decrement_refcount();
+      e->_name->decrement_refcount();
+      e->_signature->decrement_refcount();
+    }
+    *e = empty;
+  }
+  _no_java_frame = empty;
+}
+
+void TimeToSafepointProfiler::begin_synchronize() {
+  _laggard = NULL;
+  _sync_start_nanos = os::javaTimeNanos();
+}
+
+void TimeToSafepointProfiler::end_synchronize(int safepoint_id) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  JavaThread* laggard = _laggard;
+  JavaThreadState state = _laggard_state;
+  _laggard = NULL;
+
+  jlong ttsp = os::javaTimeNanos() - _sync_start_nanos;
+  if (laggard == NULL || ttsp < (jlong)ProfileTimeToSafepointThreshold * NANOSECS_PER_MILLISEC) {
+    return;
+  }
+
+  // The laggard is stopped now, so its stack can be walked. A compiled
+  // frame which stopped at a poll gets its scope, and so the bci, from the
+  // PcDesc recorded for the poll.
+  Method* method = NULL;
+  int bci = -1;
+  bool compiled = false;
+  if (laggard->has_last_Java_frame()) {
+    ResourceMark rm;
+    RegisterMap map(laggard, false);
+    javaVFrame* jvf = laggard->last_java_vframe(&map);
+    if (jvf != NULL) {
+      method = jvf->method();
+      bci = jvf->bci();
+      compiled = jvf->is_compiled_frame();
+    }
+  }
+
+  _profiled_safepoints++;
+  Entry* e = (method == NULL) ? &_no_java_frame : find_or_insert(method);
+  if (e == NULL) {
+    _dropped_samples++;
+  } else {
+    e->_count++;
+    e->_total_nanos += ttsp;
+    e->_max_nanos = MAX2(e->_max_nanos, ttsp);
+    e->_last_bci = bci;
+    e->_last_compiled = compiled;
+    e->_last_state = state;
+  }
+
+  EventSafepointLaggard event;
+  if (event.should_commit()) {
+    event.set_safepointId(safepoint_id);
+    event.set_timeToSafepoint(ttsp);
+    event.set_laggard(THREAD_TRACE_ID(laggard));
+    event.set_threadState(_get_thread_state_name(state));
+    event.set_method(method);
+    event.set_bci(bci);
+    event.set_compiled(compiled);
+    event.commit();
+  }
+}
+
+int TimeToSafepointProfiler::compare_total_nanos(Entry** a, Entry** b) {
+  jlong ta = (*a)->_total_nanos;
+  jlong tb = (*b)->_total_nanos;
+  return (ta > tb) ? -1 : ((ta < tb) ? 1 : 0);
+}
+
+void TimeToSafepointProfiler::print_entry(outputStream* out, const Entry* e) {
+  out->print(INT64_FORMAT_W(10) " %12.3f %10.3f %8d %-9s %-24s ",
+             (int64_t)e->_count,
+             (double)e->_total_nanos / NANOSECS_PER_MILLISEC,
+             (double)e->_max_nanos / NANOSECS_PER_MILLISEC,
+             e->_last_bci,
+             e->_holder == NULL ? "-" : (e->_last_compiled ? "compiled" : "interp"),
+             _get_thread_state_name(e->_last_state));
+  if (e->_holder != NULL) {
+    out->print_cr("%s.%s%s", e->_holder->as_klass_external_name(),
+                  e->_name->as_C_string(), e->_signature->as_C_string());
+  } else {
+    out->print_cr("<no Java frame>");
+  }
+}
+
+void TimeToSafepointProfiler::print_on(outputStream* out) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  ResourceMark rm;
+  out->print_cr("Time to safepoint profile: " INT64_FORMAT " safepoints of at least "
+                UINTX_FORMAT " ms profiled, " INT64_FORMAT " samples dropped",
+                (int64_t)_profiled_safepoints, ProfileTimeToSafepointThreshold,
+                (int64_t)_dropped_samples);
+
+  GrowableArray<Entry*> entries(table_size + 1);
+  for (int i = 0; i < table_size; i++) {
+    if (_table[i]._holder != NULL && _table[i]._count > 0) {
+      entries.append(&_table[i]);
+    }
+  }
+  if (_no_java_frame._count > 0) {
+    entries.append(&_no_java_frame);
+  }
+  entries.sort(compare_total_nanos);
+
+  out->print_cr("%10s %12s %10s %8s %-9s %-24s %s",
+                "Count", "Total ms", "Max ms", "Last bci", "Frame", "Last state", "Method");
+  for (int i = 0; i < entries.length(); i++) {
+    print_entry(out, entries.at(i));
+  }
+}
+
+void TimeToSafepointProfiler::reset() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  clear();
+  _profiled_safepoints = 0;
+  _dropped_samples = 0;
+}
+
+void TimeToSafepointProfileVMOperation::doit() {
+  TimeToSafepointProfiler::print_on(_out);
+  if (_reset) {
+    TimeToSafepointProfiler::reset();
+  }
+}
+
+TimeToSafepointProfileDCmd::TimeToSafepointProfileDCmd(outputStream* output, bool heap) :
+                                       DCmdWithParser(output, heap),
+  _reset("-reset", "Clear the profile after printing it",
+         "BOOLEAN", false, "false") {
+  _dcmdparser.add_dcmd_option(&_reset);
+}
+
+void TimeToSafepointProfileDCmd::execute(DCmdSource source, TRAPS) {
+  if (!ProfileTimeToSafepoint) {
+    output()->print_cr("Time to safepoint profiling is disabled, use -XX:+ProfileTimeToSafepoint");
+    return;
+  }
+  TimeToSafepointProfileVMOperation op(output(), _reset.value());
+  VMThread::execute(&op);
+}
+
+int TimeToSafepointProfileDCmd::num_arguments() {
+  ResourceMark rm;
+  TimeToSafepointProfileDCmd* dcmd = new TimeToSafepointProfileDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation. Alibaba designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SHARE_VM_RUNTIME_TIMETOSAFEPOINTPROFILER_HPP
+#define SHARE_VM_RUNTIME_TIMETOSAFEPOINTPROFILER_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/vm_operations.hpp"
+#include "services/diagnosticCommand.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class JavaThread;
+class Method;
+class outputStream;
+class Symbol;
+
+// Time-to-safepoint profiling (-XX:+ProfileTimeToSafepoint).
+//
+// For every safepoint whose synchronization takes at least
+// ProfileTimeToSafepointThreshold milliseconds, the thread which was the
+// last to stop (the laggard), the thread state it was in and the Java
+// method/bci it stopped in are recorded. Compiled frames resolve the bci
+// from the nmethod's PcDesc at the poll. Each such safepoint is reported
+// with a SafepointLaggard event, and the samples are aggregated per
+// method and printed by the VM.safepoint_profile diagnostic command.
+//
+// Methods are identified by the names of their class, of the method and
+// of its signature, whose reference counts the table holds, so entries
+// stay valid when a class is redefined or unloaded. Methods of same named
+// classes of different loaders share an entry.
+//
+// All recording happens in the VM thread while it holds the
+// Safepoint_lock or is at the safepoint, so the table is not locked.
+class TimeToSafepointProfiler : AllStatic {
+ private:
+  enum {
+    table_size = 256,           // must be a power of 2
+    max_probes = 16
+  };
+
+  struct Entry {
+    Symbol*         _holder;    // NULL for laggards without Java frames
+    Symbol*         _name;
+    Symbol*         _signature;
+    jlong           _count;
+    jlong           _total_nanos;
+    jlong           _max_nanos;
+    int             _last_bci;
+    bool            _last_compiled;
+    JavaThreadState _last_state;
+  };
+
+  static Entry           _table[table_size];
+  static Entry           _no_java_frame;
+  static jlong           _profiled_safepoints;
+  static jlong           _dropped_samples;
+
+  // Current synchronization
+  static jlong           _sync_start_nanos;
+  static JavaThread*     _laggard;
+  static JavaThreadState _laggard_state;
+
+  static Entry* find_or_insert(Method* m);
+  static void   clear();
+  static void   print_entry(outputStream* out, const Entry* e);
+  static int    compare_total_nanos(Entry** a, Entry** b);
+
+ public:
+  // Called by the VM thread when it starts and completes the
+  // synchronization of the safepoint with id safepoint_id.
+  static void begin_synchronize();
+  static void end_synchronize(int safepoint_id);
+
+  // Called, under the Safepoint_lock, each time a thread is found or
+  // reports itself safe. The last call of a synchronization names the
+  // laggard.
+  static void note_thread_stopped(JavaThread* thread, JavaThreadState state) {
+    _laggard = thread;
+    _laggard_state = state;
+  }
+
+  // Print the per-method aggregate, most expensive first. Must be called
+  // at a safepoint.
+  static void print_on(outputStream* out);
+  static void reset();
+};
+
+class TimeToSafepointProfileDCmd : public DCmdWithParser {
+ protected:
+  DCmdArgument<bool> _reset;
+ public:
+  TimeToSafepointProfileDCmd(outputStream* output, bool heap);
+  static const char* name() {
+    return "VM.safepoint_profile";
+  }
+  static const char* description() {
+    return "Print the methods and thread states of the threads which were "
+           "the last to reach a safepoint. Requires -XX:+ProfileTimeToSafepoint.";
+  }
+  static const char* impact() {
+    return "Low: Requires a safepoint.";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+class TimeToSafepointProfileVMOperation : public VM_Operation {
+  outputStream* _out;
+  bool          _reset;
+
+ public:
+  TimeToSafepointProfileVMOperation(outputStream* out, bool reset) :
+    _out(out), _reset(reset) {
+  }
+
+  VMOp_Type type() const {
+    return VMOp_TimeToSafepointProfile;
+  }
+
+  void doit();
+};
+
+#endif // SHARE_VM_RUNTIME_TIMETOSAFEPOINTPROFILER_HPP
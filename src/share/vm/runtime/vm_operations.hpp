@@ -46,6 +46,7 @@
   template(FindDeadlocks)                         \
   template(ForceSafepoint)                        \
   template(ForceAsyncSafepoint)                   \
+  template(MarkActiveNMethods)                    \
   template(Deoptimize)                            \
   template(DeoptimizeFrame)                       \
   template(DeoptimizeAll)                         \
@@ -53,6 +54,7 @@
   template(UnlinkSymbols)                         \
   template(Verify)                                \
   template(PrintJNI)                              \
+  template(PrintMetadata)                         \
   template(HeapDumper)                            \
   template(DeoptimizeTheWorld)                    \
   template(CollectForMetadataAllocation)          \
@@ -98,6 +100,8 @@
   template(RotateGCLog)                           \
   template(WhiteBoxOperation)                     \
   template(ClassLoaderStatsOperation)             \
+  template(MonitorContentionStatistics)           \
+  template(TimeToSafepointProfile)                \
 
 class VM_Operation: public CHeapObj<mtInternal> {
  public:
@@ -229,6 +233,15 @@ class VM_ForceSafepoint: public VM_Operation {
   VMOp_Type type() const { return VMOp_ForceSafepoint; }
 };
 
+// dummy vm op, evaluated just to let the safepoint cleanup tasks scan the
+// thread stacks for active nmethods (see NMethodSweeper::mark_active_nmethods)
+class VM_MarkActiveNMethods: public VM_Operation {
+ public:
+  VM_MarkActiveNMethods() {}
+  void doit()         {}
+  VMOp_Type type() const { return VMOp_MarkActiveNMethods; }
+};
+
 // dummy vm op, evaluated just to force a safepoint
 class VM_ForceAsyncSafepoint: public VM_Operation {
  public:
@@ -326,6 +339,15 @@ class VM_PrintJNI: public VM_Operation {
   void doit();
 };
 
+class VM_PrintMetadata : public VM_Operation {
+ private:
+  outputStream* _out;
+ public:
+  VM_PrintMetadata(outputStream* out)   { _out = out; }
+  VMOp_Type type() const                { return VMOp_PrintMetadata; }
+  void doit();
+};
+
 class DeadlockCycle;
 class VM_FindDeadlocks: public VM_Operation {
  private:
@@ -25,8 +25,10 @@
 #include "precompiled.hpp"
 #include "classfile/classLoaderStats.hpp"
 #include "gc_implementation/shared/vmGCOperations.hpp"
+#include "jwarmup/jitWarmUp.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/os.hpp"
+#include "runtime/timeToSafepointProfiler.hpp"
 #include "services/diagnosticArgument.hpp"
 #include "services/diagnosticCommand.hpp"
 #include "services/diagnosticFramework.hpp"
@@ -56,6 +58,7 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RunFinalizationDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapInfoDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<FinalizerInfoDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<MetaspaceDCmd>(full_export, true, false));
 #if INCLUDE_SERVICES // Heap dumping/inspection supported
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapDumpDCmd>(DCmd_Source_Internal | DCmd_Source_AttachAPI, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassHistogramDCmd>(full_export, true, false));
@@ -64,6 +67,7 @@ void DCmdRegistrant::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ThreadDumpDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RotateGCLogDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ClassLoaderStatsDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<TimeToSafepointProfileDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<JWarmupDCmd>(full_export, true, false));
 
   // Enhanced JMX Agent Support
@@ -287,6 +291,11 @@ void HeapInfoDCmd::execute(DCmdSource source, TRAPS) {
   Universe::heap()->print_on(output());
 }
 
+void MetaspaceDCmd::execute(DCmdSource source, TRAPS) {
+  VM_PrintMetadata op(output());
+  VMThread::execute(&op);
+}
+
 void FinalizerInfoDCmd::execute(DCmdSource source, TRAPS) {
   ResourceMark rm;
 
@@ -751,11 +760,13 @@ JWarmupDCmd::JWarmupDCmd(outputStream* output, bool heap_allocated) : DCmdWithPa
   _notify_startup("-notify", "Notify JVM that application startup is done", "BOOLEAN", false, "false"),
   _check_compile_finished("-check", "Check if the last compilation submitted by JWarmup is complete", "BOOLEAN", false, "false"),
   _deopt("-deopt", "Notify JVM to de-optimize warmup methods", "BOOLEAN", false, "false"),
+  _status("-status", "Print progress of JWarmup warmup compilation", "BOOLEAN", false, "false"),
   _help("-help", "Print this help information", "BOOLEAN", false, "false")
 {
   _dcmdparser.add_dcmd_option(&_notify_startup);
   _dcmdparser.add_dcmd_option(&_check_compile_finished);
   _dcmdparser.add_dcmd_option(&_deopt);
+  _dcmdparser.add_dcmd_option(&_status);
   _dcmdparser.add_dcmd_option(&_help);
 }
 
@@ -836,6 +847,20 @@ void JWarmupDCmd::execute(DCmdSource source, TRAPS) {
       CLEAR_PENDING_EXCEPTION;
       return;
     }
+  } else if (_status.value()) {
+    if (!CompilationWarmUp) {
+      output()->print_cr("CompilationWarmUp is off, "
+                         "status is invalid");
+      return;
+    }
+
+    JitWarmUp* jwp = JitWarmUp::instance();
+    if (jwp == NULL || !jwp->is_valid() || jwp->preloader() == NULL ||
+        jwp->preloader()->chain() == NULL) {
+      output()->print_cr("JWarmup is not initialized");
+      return;
+    }
+    jwp->preloader()->chain()->print_progress_on(output());
   } else if (_help.value()) {
     print_info();
   } else {
@@ -848,8 +873,10 @@ void JWarmupDCmd::print_info() {
                        "-notify: %s\n"
                        "-check: %s\n"
                        "-deopt: %s\n"
+                       "-status: %s\n"
                        "-help: %s\n",
-                       _notify_startup.description(), _check_compile_finished.description(), _deopt.description(), _help.description());
+                       _notify_startup.description(), _check_compile_finished.description(), _deopt.description(),
+                       _status.description(), _help.description());
 }
 
 ElasticHeapDCmd::ElasticHeapDCmd(outputStream* output, bool heap) :
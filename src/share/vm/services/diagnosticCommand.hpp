@@ -239,6 +239,26 @@ public:
   virtual void execute(DCmdSource source, TRAPS);
 };
 
+class MetaspaceDCmd : public DCmd {
+public:
+  MetaspaceDCmd(outputStream* output, bool heap) : DCmd(output, heap) { }
+  static const char* name() { return "VM.metaspace"; }
+  static const char* description() {
+    return "Print Metaspace usage and chunk free list statistics.";
+  }
+  static const char* impact() {
+    return "Medium: Depends on number of class loaders.";
+  }
+  static int num_arguments() { return 0; }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+      "monitor", NULL};
+      return p;
+  }
+
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
 #if INCLUDE_SERVICES   // Heap dumping supported
 // See also: dump_heap in attachListener.cpp
 class HeapDumpDCmd : public DCmdWithParser {
@@ -447,6 +467,7 @@ protected:
   DCmdArgument<bool> _notify_startup;
   DCmdArgument<bool> _check_compile_finished;
   DCmdArgument<bool> _deopt;
+  DCmdArgument<bool> _status;
   DCmdArgument<bool> _help;
   void print_info();
 public:
@@ -30,6 +30,7 @@
 #include "oops/instanceKlass.hpp"
 #include "oops/oop.inline.hpp"
 #include "runtime/handles.inline.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/init.hpp"
 #include "runtime/thread.hpp"
 #include "runtime/vframe.hpp"
@@ -55,6 +56,7 @@ PerfCounter*  ThreadService::_total_threads_count = NULL;
 PerfVariable* ThreadService::_live_threads_count = NULL;
 PerfVariable* ThreadService::_peak_threads_count = NULL;
 PerfVariable* ThreadService::_daemon_threads_count = NULL;
+PerfCounter*  ThreadService::_handshake_stack_dumps = NULL;
 volatile int ThreadService::_exiting_threads_count = 0;
 volatile int ThreadService::_exiting_daemon_threads_count = 0;
 
@@ -85,6 +87,10 @@ void ThreadService::init() {
                 PerfDataManager::create_variable(JAVA_THREADS, "daemon",
                                                  PerfData::U_None, CHECK);
 
+  _handshake_stack_dumps =
+                PerfDataManager::create_counter(SUN_THREADS, "handshakeStackDumps",
+                                                PerfData::U_Events, CHECK);
+
   if (os::is_thread_cpu_time_supported()) {
     _thread_cpu_time_enabled = true;
   }
@@ -238,6 +244,33 @@ void ThreadService::remove_thread_dump(ThreadDumpResult* dump) {
   assert(found, "The threaddump result to be removed must exist.");
 }
 
+// Takes the stack snapshot of a single thread in a handshake
+// (-XX:+ThreadLocalHandshakes), instead of in a VM_ThreadDump.
+class ThreadSnapshotHandshakeClosure : public ThreadClosure {
+ private:
+  ThreadDumpResult* _result;
+  instanceHandle    _thread_obj;
+ public:
+  ThreadSnapshotHandshakeClosure(ThreadDumpResult* result, instanceHandle thread_obj) :
+    _result(result), _thread_obj(thread_obj) {}
+
+  void do_thread(Thread* thread) {
+    JavaThread* jt = (JavaThread*) thread;
+    if (java_lang_Thread::thread(_thread_obj()) != jt ||
+        jt->is_exiting() ||
+        jt->is_hidden_from_external_view()) {
+      // Same as VM_ThreadDump: add a NULL snapshot if skipped
+      _result->add_thread_snapshot(new ThreadSnapshot());
+      return;
+    }
+    ResourceMark rm;
+    HandleMark hm;
+    ThreadSnapshot* ts = new ThreadSnapshot(jt);
+    ts->dump_stack_at_safepoint(-1 /* entire stack */, false /* with locked monitors */);
+    _result->add_thread_snapshot(ts);
+  }
+};
+
 // Dump stack trace of threads specified in the given threads array.
 // Returns StackTraceElement[][] each element is the stack trace of a thread in
 // the corresponding entry in the given threads array
@@ -247,13 +280,26 @@ Handle ThreadService::dump_stack_traces(GrowableArray<instanceHandle>* threads,
   assert(num_threads > 0, "just checking");
 
   ThreadDumpResult dump_result;
-  VM_ThreadDump op(&dump_result,
-                   threads,
-                   num_threads,
-                   -1,    /* entire stack */
-                   false, /* with locked monitors */
-                   false  /* with locked synchronizers */);
-  VMThread::execute(&op);
+  bool done = false;
+  if (ThreadLocalHandshakes && num_threads == 1 && threads->at(0)() != NULL) {
+    JavaThread* jt = java_lang_Thread::thread(threads->at(0)());
+    if (jt != NULL) {
+      ThreadSnapshotHandshakeClosure cl(&dump_result, threads->at(0));
+      done = Handshake::execute(&cl, jt);
+      if (done) {
+        _handshake_stack_dumps->inc();
+      }
+    }
+  }
+  if (!done) {
+    VM_ThreadDump op(&dump_result,
+                     threads,
+                     num_threads,
+                     -1,    /* entire stack */
+                     false, /* with locked monitors */
+                     false  /* with locked synchronizers */);
+    VMThread::execute(&op);
+  }
 
   // Allocate the resulting StackTraceElement[][] object
 
@@ -555,7 +601,9 @@ ThreadStackTrace::~ThreadStackTrace() {
 }
 
 void ThreadStackTrace::dump_stack_at_safepoint(int maxDepth) {
-  assert(SafepointSynchronize::is_at_safepoint(), "all threads are stopped");
+  assert(SafepointSynchronize::is_at_safepoint() ||
+         _thread == Thread::current() ||
+         _thread->handshake_state()->is_processing(), "all threads are stopped");
 
   if (_thread->has_last_Java_frame()) {
     RegisterMap reg_map(_thread);
@@ -57,6 +57,8 @@ private:
   static PerfVariable* _live_threads_count;
   static PerfVariable* _peak_threads_count;
   static PerfVariable* _daemon_threads_count;
+  // Single-thread stack dumps taken in a thread-local handshake
+  static PerfCounter*  _handshake_stack_dumps;
 
   // These 2 counters are atomically incremented once the thread is exiting.
   // They will be atomically decremented when ThreadService::remove_thread is called.
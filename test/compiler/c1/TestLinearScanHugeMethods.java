@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+import java.lang.reflect.Method;
+
+import com.oracle.java.testlibrary.*;
+
+import jdk.internal.org.objectweb.asm.ClassWriter;
+import jdk.internal.org.objectweb.asm.Label;
+import jdk.internal.org.objectweb.asm.MethodVisitor;
+import static jdk.internal.org.objectweb.asm.Opcodes.*;
+
+/*
+ * @test
+ * @summary C1 compiles huge synthetic methods with many blocks and long-lived
+ *          values correctly, and -XX:+CITime reports the linear scan phases.
+ *          Run with "bench [methods] [segments]" to measure C1 throughput.
+ * @library /testlibrary
+ * @compile -XDignore.symbol.file TestLinearScanHugeMethods.java
+ * @run main TestLinearScanHugeMethods
+ */
+public class TestLinearScanHugeMethods extends ClassLoader {
+    private static final int CLASS_FILE_VERSION = 52;
+    private static final String CLASS_PREFIX = "HugeMethod";
+    private static final int LOCALS = 24;
+
+    // Generates "static int run(int a)": a chain of diamonds and small loops
+    // over LOCALS int locals, so that most intervals span most of the blocks.
+    private static byte[] generate(String name, int segments) {
+        ClassWriter cw = new ClassWriter(ClassWriter.COMPUTE_FRAMES | ClassWriter.COMPUTE_MAXS);
+        cw.visit(CLASS_FILE_VERSION, ACC_PUBLIC | ACC_SUPER, name, null, "java/lang/Object", null);
+
+        MethodVisitor mv = cw.visitMethod(ACC_PUBLIC | ACC_STATIC, "run", "(I)I", null, null);
+        mv.visitCode();
+        for (int l = 1; l <= LOCALS; l++) {
+            mv.visitVarInsn(ILOAD, 0);
+            mv.visitLdcInsn(l);
+            mv.visitInsn(IADD);
+            mv.visitVarInsn(ISTORE, l);
+        }
+        int counter = LOCALS + 1;
+        for (int s = 0; s < segments; s++) {
+            int x = 1 + s % LOCALS;
+            int y = 1 + (s + 7) % LOCALS;
+            if (s % 8 == 7) {
+                // for (i = 0; i < 3; i++) x += y ^ i;
+                Label head = new Label();
+                Label exit = new Label();
+                mv.visitInsn(ICONST_0);
+                mv.visitVarInsn(ISTORE, counter);
+                mv.visitLabel(head);
+                mv.visitVarInsn(ILOAD, counter);
+                mv.visitInsn(ICONST_3);
+                mv.visitJumpInsn(IF_ICMPGE, exit);
+                mv.visitVarInsn(ILOAD, x);
+                mv.visitVarInsn(ILOAD, y);
+                mv.visitVarInsn(ILOAD, counter);
+                mv.visitInsn(IXOR);
+                mv.visitInsn(IADD);
+                mv.visitVarInsn(ISTORE, x);
+                mv.visitIincInsn(counter, 1);
+                mv.visitJumpInsn(GOTO, head);
+                mv.visitLabel(exit);
+            } else {
+                // if (a > s) x += y; else y ^= s;
+                Label other = new Label();
+                Label join = new Label();
+                mv.visitVarInsn(ILOAD, 0);
+                mv.visitLdcInsn(s);
+                mv.visitJumpInsn(IF_ICMPLE, other);
+                mv.visitVarInsn(ILOAD, x);
+                mv.visitVarInsn(ILOAD, y);
+                mv.visitInsn(IADD);
+                mv.visitVarInsn(ISTORE, x);
+                mv.visitJumpInsn(GOTO, join);
+                mv.visitLabel(other);
+                mv.visitVarInsn(ILOAD, y);
+                mv.visitLdcInsn(s);
+                mv.visitInsn(IXOR);
+                mv.visitVarInsn(ISTORE, y);
+                mv.visitLabel(join);
+            }
+        }
+        mv.visitInsn(ICONST_0);
+        for (int l = 1; l <= LOCALS; l++) {
+            mv.visitVarInsn(ILOAD, l);
+            mv.visitInsn(IADD);
+        }
+        mv.visitInsn(IRETURN);
+        mv.visitMaxs(0, 0);
+        mv.visitEnd();
+
+        cw.visitEnd();
+        return cw.toByteArray();
+    }
+
+    // Reference implementation of the generated method
+    private static int expected(int a, int segments) {
+        int[] v = new int[LOCALS + 1];
+        for (int l = 1; l <= LOCALS; l++) {
+            v[l] = a + l;
+        }
+        for (int s = 0; s < segments; s++) {
+            int x = 1 + s % LOCALS;
+            int y = 1 + (s + 7) % LOCALS;
+            if (s % 8 == 7) {
+                for (int i = 0; i < 3; i++) {
+                    v[x] += v[y] ^ i;
+                }
+            } else if (a > s) {
+                v[x] += v[y];
+            } else {
+                v[y] ^= s;
+            }
+        }
+        int sum = 0;
+        for (int l = 1; l <= LOCALS; l++) {
+            sum += v[l];
+        }
+        return sum;
+    }
+
+    private void runWorker(int methods, int segments, boolean report) throws Exception {
+        long bytecodes = 0;
+        long start = System.nanoTime();
+        for (int m = 0; m < methods; m++) {
+            String name = CLASS_PREFIX + m;
+            byte[] bytes = generate(name, segments);
+            Class<?> klass = defineClass(name, bytes, 0, bytes.length);
+            Method run = klass.getMethod("run", int.class);
+            // -Xcomp -Xbatch: the first call compiles the method with C1
+            for (int a : new int[] { -1, segments / 2, segments + 1 }) {
+                int result = (Integer) run.invoke(null, a);
+                if (result != expected(a, segments)) {
+                    throw new RuntimeException(name + ".run(" + a + ") = " + result +
+                                               ", expected " + expected(a, segments));
+                }
+            }
+            bytecodes += bytes.length;
+        }
+        long elapsed = Math.max(1, (System.nanoTime() - start) / 1000000);
+        if (report) {
+            System.out.println("Compiled " + methods + " methods with " + segments +
+                               " segments: " + elapsed + " ms, " +
+                               (bytecodes / elapsed) + " class file bytes/ms");
+        }
+    }
+
+    private static OutputAnalyzer runBenchmark(String... args) throws Exception {
+        String[] vmArgs = new String[] {
+            "-XX:+TieredCompilation", "-XX:TieredStopAtLevel=1",
+            "-XX:-DontCompileHugeMethods", "-Xcomp", "-Xbatch",
+            "-XX:CompileCommand=quiet",
+            "-XX:CompileCommand=compileonly," + CLASS_PREFIX + "*.run",
+            "-XX:+CITime",
+            TestLinearScanHugeMethods.class.getName()
+        };
+        String[] all = new String[vmArgs.length + args.length];
+        System.arraycopy(vmArgs, 0, all, 0, vmArgs.length);
+        System.arraycopy(args, 0, all, vmArgs.length, args.length);
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(all);
+        return new OutputAnalyzer(pb.start());
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("worker")) {
+            new TestLinearScanHugeMethods().runWorker(Integer.parseInt(args[1]),
+                                                      Integer.parseInt(args[2]),
+                                                      Boolean.parseBoolean(args[3]));
+            return;
+        }
+        if (args.length > 0 && args[0].equals("bench")) {
+            String methods = args.length > 1 ? args[1] : "20";
+            String segments = args.length > 2 ? args[2] : "2000";
+            OutputAnalyzer out = runBenchmark("worker", methods, segments, "true");
+            System.out.print(out.getOutput());
+            out.shouldHaveExitValue(0);
+            return;
+        }
+
+        OutputAnalyzer out = runBenchmark("worker", "4", "1500", "false");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Linear Scan:");
+        out.shouldContain("Resolve Data Flow");
+        out.shouldContain("Global Live Sets");
+    }
+}
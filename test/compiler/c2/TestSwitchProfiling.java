@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary profile guided switch code shape must dispatch every key correctly
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement -XX:+UseSwitchProfiling TestSwitchProfiling
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement TestSwitchProfiling
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement -XX:+UseSwitchProfiling -XX:-UseJumpTables TestSwitchProfiling
+ */
+public class TestSwitchProfiling {
+
+    // tableswitch
+    static int dense(int op) {
+        switch (op) {
+            case 0:  return 10;
+            case 1:  return 11;
+            case 2:  return 12;
+            case 3:  return 13;
+            case 4:  return 14;
+            case 5:  return 15;
+            case 6:  return 16;
+            case 7:  return 17;
+            case 8:  return 13;
+            case 9:  return 13;
+            default: return -1;
+        }
+    }
+
+    // lookupswitch
+    static int sparse(int op) {
+        switch (op) {
+            case -1000:  return 1;
+            case 3:      return 2;
+            case 4:      return 2;
+            case 100:    return 3;
+            case 1000:   return 4;
+            case 65536:  return 5;
+            case Integer.MAX_VALUE: return 6;
+            case Integer.MIN_VALUE: return 7;
+            default:     return 0;
+        }
+    }
+
+    static int denseRef(int op) {
+        if (op < 0 || op > 9) return -1;
+        return (op == 8 || op == 9) ? 13 : 10 + op;
+    }
+
+    static int sparseRef(int op) {
+        if (op == -1000) return 1;
+        if (op == 3 || op == 4) return 2;
+        if (op == 100) return 3;
+        if (op == 1000) return 4;
+        if (op == 65536) return 5;
+        if (op == Integer.MAX_VALUE) return 6;
+        if (op == Integer.MIN_VALUE) return 7;
+        return 0;
+    }
+
+    static final int[] KEYS = { Integer.MIN_VALUE, -1001, -1000, -999, -1, 0, 1, 2, 3, 4, 5,
+                                6, 7, 8, 9, 10, 99, 100, 101, 999, 1000, 1001, 65535,
+                                65536, 65537, Integer.MAX_VALUE - 1, Integer.MAX_VALUE };
+
+    static void check(int key) {
+        if (dense(key) != denseRef(key)) {
+            throw new RuntimeException("dense(" + key + ") = " + dense(key) + ", expected " + denseRef(key));
+        }
+        if (sparse(key) != sparseRef(key)) {
+            throw new RuntimeException("sparse(" + key + ") = " + sparse(key) + ", expected " + sparseRef(key));
+        }
+    }
+
+    public static void main(String[] args) {
+        // Three very different profiles: one dominating case, one dominating
+        // range and the default case being the hottest.
+        int[][] hot = { { 5, 100 }, { 3, 4, 8, 9 }, { 42, -5 } };
+        for (int[] keys : hot) {
+            for (int i = 0; i < 20000; i++) {
+                check(keys[i % keys.length]);
+                if (i % 97 == 0) {
+                    check(KEYS[i % KEYS.length]);
+                }
+            }
+            for (int key : KEYS) {
+                check(key);
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Checks that the segmented code cache creates the expected code
+ *          heaps and rejects inconsistent code heap sizes
+ * @library /testlibrary
+ * @run main CheckSegmentedCodeCache
+ */
+import com.oracle.java.testlibrary.*;
+
+public class CheckSegmentedCodeCache {
+    private static final String NON_METHOD = "CodeHeap 'non-nmethods'";
+    private static final String PROFILED = "CodeHeap 'profiled nmethods'";
+    private static final String NON_PROFILED = "CodeHeap 'non-profiled nmethods'";
+
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 1];
+        System.arraycopy(flags, 0, args, 0, flags.length);
+        args[flags.length] = "-version";
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        return new OutputAnalyzer(pb.start());
+    }
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer out;
+
+        // Without segmentation there is a single code heap
+        out = run("-XX:-SegmentedCodeCache", "-XX:+PrintCodeCache");
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain(NON_METHOD);
+
+        // Tiered compilation uses all three code heaps
+        out = run("-XX:+SegmentedCodeCache", "-XX:+TieredCompilation", "-XX:+PrintCodeCache");
+        out.shouldHaveExitValue(0);
+        out.shouldContain(NON_METHOD);
+        out.shouldContain(PROFILED);
+        out.shouldContain(NON_PROFILED);
+
+        // There is no profiled code heap without tiered compilation
+        out = run("-XX:+SegmentedCodeCache", "-XX:-TieredCompilation", "-XX:+PrintCodeCache");
+        out.shouldHaveExitValue(0);
+        out.shouldContain(NON_METHOD);
+        out.shouldNotContain(PROFILED);
+        out.shouldContain(NON_PROFILED);
+
+        // Explicit sizes that fit into ReservedCodeCacheSize
+        out = run("-XX:+SegmentedCodeCache", "-XX:+TieredCompilation",
+                  "-XX:ReservedCodeCacheSize=64m", "-XX:NonNMethodCodeHeapSize=8m",
+                  "-XX:ProfiledCodeHeapSize=16m", "-XX:+PrintCodeCache");
+        out.shouldHaveExitValue(0);
+        out.shouldContain(PROFILED + ": size=16384Kb");
+
+        // All sizes given: they define the code cache size
+        out = run("-XX:+SegmentedCodeCache", "-XX:+TieredCompilation",
+                  "-XX:NonNMethodCodeHeapSize=8m", "-XX:ProfiledCodeHeapSize=16m",
+                  "-XX:NonProfiledCodeHeapSize=24m", "-XX:+PrintCodeCache");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("CodeCache: size=49152Kb");
+
+        // Sizes that exceed ReservedCodeCacheSize are rejected
+        out = run("-XX:+SegmentedCodeCache", "-XX:+TieredCompilation",
+                  "-XX:ReservedCodeCacheSize=32m", "-XX:ProfiledCodeHeapSize=24m",
+                  "-XX:NonProfiledCodeHeapSize=24m");
+        out.shouldContain("exceed ReservedCodeCacheSize");
+        out.shouldHaveExitValue(1);
+    }
+}
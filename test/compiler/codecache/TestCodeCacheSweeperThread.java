@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Checks that the dedicated code cache sweeper thread evicts and
+ *          flushes methods when the code cache fills up
+ * @library /testlibrary
+ * @run main TestCodeCacheSweeperThread
+ */
+import java.math.BigDecimal;
+import java.util.*;
+import java.util.regex.*;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestCodeCacheSweeperThread {
+
+    public static void main(String[] args) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+UnlockDiagnosticVMOptions",
+                "-XX:+UseCodeCacheSweeperThread",
+                "-XX:+UseSizeAwareCodeCacheEviction",
+                "-XX:+PrintMethodFlushingStatistics",
+                "-XX:ReservedCodeCacheSize=4m",
+                "-XX:InitialCodeCacheSize=4m",
+                "-XX:NmethodSweepCheckInterval=1",
+                "-Xcomp",
+                "-XX:+TieredCompilation",
+                Workload.class.getName());
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Code cache sweeper statistics");
+
+        long evicted = count(out, "Total number of evicted methods: (\\d+)");
+        long flushed = count(out, "Total number of flushed methods: (\\d+)");
+        if (evicted <= 0) {
+            throw new RuntimeException("no methods evicted: " + evicted);
+        }
+        if (flushed <= 0) {
+            throw new RuntimeException("no methods flushed: " + flushed);
+        }
+    }
+
+    private static long count(OutputAnalyzer out, String regex) {
+        Matcher m = Pattern.compile(regex).matcher(out.getStdout());
+        if (!m.find()) {
+            throw new RuntimeException("missing \"" + regex + "\" in output");
+        }
+        return Long.parseLong(m.group(1));
+    }
+
+    // Uses different parts of the class library in turns so that the code
+    // of the earlier phases gets cold while the code cache is full.
+    public static class Workload {
+        public static void main(String[] args) throws Exception {
+            long deadline = System.currentTimeMillis() + 10_000;
+            long sink = 0;
+            while (System.currentTimeMillis() < deadline) {
+                sink += collections();
+                sink += text();
+                sink += numbers();
+            }
+            System.out.println(sink);
+        }
+
+        static long collections() {
+            Map<String, List<Integer>> map = new TreeMap<>();
+            for (int i = 0; i < 1000; i++) {
+                map.computeIfAbsent("k" + (i % 37), k -> new ArrayList<>()).add(i);
+            }
+            Set<Integer> set = new HashSet<>();
+            for (List<Integer> l : map.values()) {
+                Collections.sort(l, Collections.reverseOrder());
+                set.addAll(l);
+            }
+            return set.size() + new ArrayDeque<>(set).size();
+        }
+
+        static long text() {
+            StringBuilder sb = new StringBuilder();
+            for (int i = 0; i < 100; i++) {
+                sb.append(String.format("%05d:%s;", i, Integer.toHexString(i)));
+            }
+            Matcher m = Pattern.compile("(\\d+):([0-9a-f]+);").matcher(sb);
+            long n = 0;
+            while (m.find()) {
+                n += m.group(2).length();
+            }
+            return n + sb.toString().toUpperCase().split(";").length;
+        }
+
+        static long numbers() {
+            BigDecimal d = BigDecimal.ONE;
+            for (int i = 1; i < 100; i++) {
+                d = d.multiply(BigDecimal.valueOf(i)).divide(BigDecimal.valueOf(3), 20, BigDecimal.ROUND_HALF_UP);
+            }
+            return d.toBigInteger().bitLength() + Long.parseLong(Long.toString(d.longValue()));
+        }
+    }
+}
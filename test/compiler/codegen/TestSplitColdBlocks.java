@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary methods whose slow paths, uncommon traps and exception handlers
+ *          are laid out after the hot code must compute the same results
+ * @library /testlibrary
+ * @run main/othervm -XX:-BackgroundCompilation -XX:+SplitColdBlocks TestSplitColdBlocks
+ * @run main/othervm -XX:-BackgroundCompilation -XX:+SplitColdBlocks
+ *                   -XX:-BlockLayoutByFrequency TestSplitColdBlocks
+ * @run main TestSplitColdBlocks verify
+ */
+import com.oracle.java.testlibrary.*;
+
+public class TestSplitColdBlocks {
+
+    static int parse(String s) {
+        try {
+            return Integer.parseInt(s);
+        } catch (NumberFormatException e) {
+            return -1;
+        }
+    }
+
+    static long sumLoop(int[] a, int limit) {
+        long sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            if (a[i] > limit) {
+                // rarely taken, allocates and throws
+                try {
+                    throw new IllegalStateException("over " + limit);
+                } catch (IllegalStateException e) {
+                    sum -= e.getMessage().length();
+                    continue;
+                }
+            }
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static Object[] grow(Object[] a, int n) {
+        if (n >= a.length) {
+            // slow path
+            Object[] b = new Object[n * 2 + 1];
+            System.arraycopy(a, 0, b, 0, a.length);
+            a = b;
+        }
+        a[n] = Integer.valueOf(n);
+        return a;
+    }
+
+    static void check(String what, long actual, long expected) {
+        if (actual != expected) {
+            throw new RuntimeException(what + ": " + actual + " != " + expected);
+        }
+    }
+
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 4];
+        System.arraycopy(flags, 0, args, 0, flags.length);
+        args[flags.length]     = "-XX:-TieredCompilation";
+        args[flags.length + 1] = "-XX:-BackgroundCompilation";
+        args[flags.length + 2] = "-XX:+CITime";
+        args[flags.length + 3] = TestSplitColdBlocks.class.getName();
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        return out;
+    }
+
+    // Checks that cold blocks are only moved when the flag is on.
+    static void verifyMovedBlocks() throws Exception {
+        if (!Platform.isServer()) {
+            System.out.println("C2 is not available, skipping");
+            return;
+        }
+        run("-XX:+SplitColdBlocks")
+            .shouldMatch("C2 cold block split +: +[1-9]\\d* blocks moved");
+        run("-XX:+SplitColdBlocks", "-XX:-BlockLayoutByFrequency")
+            .shouldMatch("C2 cold block split +: +[1-9]\\d* blocks moved");
+        run("-XX:-SplitColdBlocks")
+            .shouldMatch("C2 cold block split +: +0 blocks moved");
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("verify")) {
+            verifyMovedBlocks();
+            return;
+        }
+
+        int[] a = new int[100];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i;
+        }
+        Object[] o = new Object[200];
+        for (int i = 0; i < 20_000; i++) {
+            parse("42");
+            sumLoop(a, 1000);
+            grow(o, i % 100);
+        }
+
+        check("parse", parse("42"), 42);
+        check("parse invalid", parse("x42"), -1);
+        check("sumLoop", sumLoop(a, 1000), 4950);
+        // Takes the cold path 9 times: values 91..99, message "over 90"
+        check("sumLoop cold", sumLoop(a, 90), 4095 - 9 * 7);
+        Object[] g = grow(new Object[1], 5);
+        check("grow", g.length, 11);
+        check("grow value", ((Integer) g[5]).intValue(), 5);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary C2 inlines the most frequent receivers of a megamorphic call site
+ *          behind type checks and still dispatches other receivers correctly
+ * @library /testlibrary
+ * @run main TestPolymorphicInlining
+ */
+import com.oracle.java.testlibrary.*;
+
+public class TestPolymorphicInlining {
+    static abstract class Shape {
+        abstract int sides();
+    }
+    static class Triangle extends Shape { int sides() { return 3; } }
+    static class Square   extends Shape { int sides() { return 4; } }
+    static class Pentagon extends Shape { int sides() { return 5; } }
+    static class Hexagon  extends Shape { int sides() { return 6; } }
+    static class Octagon  extends Shape { int sides() { return 8; } }
+
+    static int count(Shape[] shapes) {
+        int sum = 0;
+        for (Shape s : shapes) {
+            sum += s.sides();
+        }
+        return sum;
+    }
+
+    public static class Worker {
+        public static void main(String[] args) {
+            Shape[] shapes = new Shape[100];
+            for (int i = 0; i < shapes.length; i++) {
+                switch (i % 4) {
+                    case 0:  shapes[i] = new Triangle(); break;
+                    case 1:  shapes[i] = new Square();   break;
+                    case 2:  shapes[i] = new Pentagon(); break;
+                    default: shapes[i] = new Hexagon();  break;
+                }
+            }
+            for (int i = 0; i < 20_000; i++) {
+                if (count(shapes) != 25 * (3 + 4 + 5 + 6)) {
+                    throw new RuntimeException("wrong result");
+                }
+            }
+            // A receiver which is not inlined takes the virtual call
+            shapes[0] = new Octagon();
+            if (count(shapes) != 25 * (3 + 4 + 5 + 6) + 5) {
+                throw new RuntimeException("wrong result with new receiver");
+            }
+        }
+    }
+
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 5];
+        System.arraycopy(flags, 0, args, 0, flags.length);
+        args[flags.length]     = "-XX:-TieredCompilation";
+        args[flags.length + 1] = "-XX:-BackgroundCompilation";
+        args[flags.length + 2] = "-XX:+UnlockDiagnosticVMOptions";
+        args[flags.length + 3] = "-XX:+PrintInlining";
+        args[flags.length + 4] = Worker.class.getName();
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        return new OutputAnalyzer(pb.start());
+    }
+
+    public static void main(String[] args) throws Exception {
+        // Four receivers are inlined behind type checks
+        OutputAnalyzer out = run("-XX:+UsePolymorphicInlining");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("TestPolymorphicInlining$Triangle::sides");
+        out.shouldContain("TestPolymorphicInlining$Square::sides");
+        out.shouldContain("TestPolymorphicInlining$Pentagon::sides");
+        out.shouldContain("TestPolymorphicInlining$Hexagon::sides");
+
+        // The coverage threshold is not reached with only two targets
+        out = run("-XX:+UsePolymorphicInlining", "-XX:PolymorphicInliningMaxTargets=2");
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain("TestPolymorphicInlining$Pentagon::sides");
+
+        // Without the flag the call site stays virtual
+        out = run("-XX:-UsePolymorphicInlining");
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain("TestPolymorphicInlining$Pentagon::sides");
+    }
+}
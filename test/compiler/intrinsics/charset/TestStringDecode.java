@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary ISO-8859-1 decoding is intrinsified by C2 and decodes every byte
+ *          value at every length around the vector steps of the stub
+ * @library /testlibrary
+ * @run main/othervm -Xbatch TestStringDecode
+ * @run main/othervm -Xbatch -XX:-TieredCompilation TestStringDecode
+ * @run main/othervm -Xbatch -XX:-UseCharsetIntrinsics TestStringDecode
+ * @run main TestStringDecode checkIntrinsic
+ */
+
+import java.nio.charset.Charset;
+import java.nio.charset.StandardCharsets;
+import java.util.Random;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestStringDecode {
+    static final String INTRINSIC = "sun\\.nio\\.cs\\.ISO_8859_1\\$Decoder::decode .*\\(intrinsic\\)";
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("checkIntrinsic")) {
+            checkIntrinsic();
+            return;
+        }
+        Charset cs = StandardCharsets.ISO_8859_1;
+        Random rnd = new Random(42);
+
+        /* every length and offset around the 8- and 16-byte steps of the stub */
+        for (int len = 0; len < 80; len++) {
+            byte[] data = bytes(rnd, len);
+            for (int i = 0; i < 200; i++) {
+                check(data, 0, len, cs);
+                if (len > 2) {
+                    check(data, 1, len - 2, cs);
+                }
+            }
+        }
+
+        /* every byte value, including the ones that are negative in Java */
+        byte[] all = new byte[256];
+        for (int i = 0; i < all.length; i++) {
+            all[i] = (byte)i;
+        }
+        for (int i = 0; i < 20_000; i++) {
+            check(all, 0, all.length, cs);
+            check(all, 100, 150, cs);
+        }
+    }
+
+    /* runs a decoding workload with C2 and checks that it used the intrinsic */
+    static void checkIntrinsic() throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+UnlockDiagnosticVMOptions", "-XX:+PrintIntrinsics",
+                "-Xbatch", "-XX:-TieredCompilation",
+                TestStringDecode.class.getName());
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldMatch(INTRINSIC);
+
+        pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+UnlockDiagnosticVMOptions", "-XX:+PrintIntrinsics",
+                "-Xbatch", "-XX:-TieredCompilation", "-XX:-UseCharsetIntrinsics",
+                TestStringDecode.class.getName());
+        out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldNotMatch(INTRINSIC);
+    }
+
+    static byte[] bytes(Random rnd, int len) {
+        byte[] data = new byte[len];
+        rnd.nextBytes(data);
+        return data;
+    }
+
+    static void check(byte[] data, int off, int len, Charset cs) throws Exception {
+        String s = new String(data, off, len, cs);
+        String expected = decode(data, off, len);
+        if (!s.equals(expected)) {
+            throw new Exception("TestStringDecode Error: " + cs + " mismatch for length " + len +
+                                "\n expected " + expected + "\n computed " + s);
+        }
+    }
+
+    /* reference decoder, never intrinsified */
+    static String decode(byte[] data, int off, int len) {
+        char[] chars = new char[len];
+        for (int i = 0; i < len; i++) {
+            chars[i] = (char)(data[off + i] & 0xff);
+        }
+        return new String(chars);
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary UTF-8 decoding takes the ASCII fast path of the C2 intrinsic and
+ *          falls back to the Java decoder for multi-byte and malformed input
+ * @library /testlibrary
+ * @run main/othervm -Xbatch TestStringDecodeUTF8
+ * @run main/othervm -Xbatch -XX:-TieredCompilation TestStringDecodeUTF8
+ * @run main/othervm -Xbatch -XX:-UseCharsetIntrinsics TestStringDecodeUTF8
+ * @run main TestStringDecodeUTF8 checkIntrinsic
+ */
+
+/*
+ * "java TestStringDecodeUTF8 bench" is not run by jtreg: it times the
+ * decoding of ASCII and of mostly ASCII strings with and without the
+ * intrinsic and prints the results.
+ */
+
+import java.nio.ByteBuffer;
+import java.nio.charset.CharsetDecoder;
+import java.nio.charset.CodingErrorAction;
+import java.nio.charset.StandardCharsets;
+import java.util.Random;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestStringDecodeUTF8 {
+    static final String INTRINSIC = "sun\\.nio\\.cs\\.UTF_8\\$Decoder::decode .*\\(intrinsic\\)";
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("checkIntrinsic")) {
+            checkIntrinsic();
+            return;
+        }
+        if (args.length > 0 && args[0].equals("bench")) {
+            bench();
+            return;
+        }
+        if (args.length > 0 && args[0].equals("benchChild")) {
+            benchChild();
+            return;
+        }
+        Random rnd = new Random(42);
+
+        /* ASCII at every length and offset around the 16-byte step of the stub */
+        for (int len = 0; len < 80; len++) {
+            byte[] data = ascii(rnd, len);
+            for (int i = 0; i < 200; i++) {
+                check(data, 0, len);
+                if (len > 2) {
+                    check(data, 1, len - 2);
+                }
+            }
+        }
+
+        /* one multi-byte character at every position, the ASCII prefix is
+           decoded by the stub and again by the Java code */
+        byte[] euro = { (byte)0xe2, (byte)0x82, (byte)0xac }; // U+20AC
+        for (int len = 0; len < 40; len++) {
+            for (int pos = 0; pos <= len; pos++) {
+                byte[] data = ascii(rnd, len + euro.length);
+                System.arraycopy(euro, 0, data, pos, euro.length);
+                for (int i = 0; i < 20; i++) {
+                    check(data, 0, data.length);
+                }
+            }
+        }
+
+        /* malformed input: a lone continuation byte */
+        byte[] bad = ascii(rnd, 40);
+        bad[20] = (byte)0x80;
+        for (int i = 0; i < 20_000; i++) {
+            check(bad, 0, bad.length);
+            check(bad, 21, 10);
+        }
+    }
+
+    /* runs a decoding workload with C2 and checks that it used the intrinsic */
+    static void checkIntrinsic() throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+UnlockDiagnosticVMOptions", "-XX:+PrintIntrinsics",
+                "-Xbatch", "-XX:-TieredCompilation",
+                TestStringDecodeUTF8.class.getName());
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldMatch(INTRINSIC);
+
+        pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+UnlockDiagnosticVMOptions", "-XX:+PrintIntrinsics",
+                "-Xbatch", "-XX:-TieredCompilation", "-XX:-UseCharsetIntrinsics",
+                TestStringDecodeUTF8.class.getName());
+        out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldNotMatch(INTRINSIC);
+    }
+
+    static void bench() throws Exception {
+        String[] flags = { "-XX:+UseCharsetIntrinsics", "-XX:-UseCharsetIntrinsics" };
+        for (String flag : flags) {
+            ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                    flag, TestStringDecodeUTF8.class.getName(), "benchChild");
+            OutputAnalyzer out = new OutputAnalyzer(pb.start());
+            out.shouldHaveExitValue(0);
+            System.out.print(flag + "\n" + out.getStdout());
+        }
+    }
+
+    static void benchChild() {
+        Random rnd = new Random(42);
+        int[] lengths = { 16, 64, 1024 };
+        for (int len : lengths) {
+            byte[] data = ascii(rnd, len);
+            benchOne("ascii    " + len, data);
+            data[len / 2] = (byte)0xc3;
+            data[len / 2 + 1] = (byte)0xa9;
+            benchOne("2-byte   " + len, data);
+        }
+    }
+
+    static void benchOne(String what, byte[] data) {
+        int iterations = 20_000_000 / data.length;
+        int sink = 0;
+        for (int warmup = 0; warmup < 3; warmup++) {
+            for (int i = 0; i < iterations; i++) {
+                sink += new String(data, StandardCharsets.UTF_8).length();
+            }
+        }
+        long start = System.nanoTime();
+        for (int i = 0; i < iterations; i++) {
+            sink += new String(data, StandardCharsets.UTF_8).length();
+        }
+        long ns = System.nanoTime() - start;
+        System.out.printf("%s: %8.1f ns/op (%d)%n", what, (double)ns / iterations, sink);
+    }
+
+    static byte[] ascii(Random rnd, int len) {
+        byte[] data = new byte[len];
+        for (int i = 0; i < len; i++) {
+            data[i] = (byte)(0x20 + rnd.nextInt(0x5f));
+        }
+        return data;
+    }
+
+    static void check(byte[] data, int off, int len) throws Exception {
+        String s = new String(data, off, len, StandardCharsets.UTF_8);
+        String expected = decode(data, off, len);
+        if (!s.equals(expected)) {
+            throw new Exception("TestStringDecodeUTF8 Error: mismatch for length " + len +
+                                "\n expected " + expected + "\n computed " + s);
+        }
+    }
+
+    /* reference decoder: the buffer loop of the decoder, never intrinsified */
+    static String decode(byte[] data, int off, int len) throws Exception {
+        CharsetDecoder dec = StandardCharsets.UTF_8.newDecoder()
+                .onMalformedInput(CodingErrorAction.REPLACE)
+                .onUnmappableCharacter(CodingErrorAction.REPLACE);
+        return dec.decode(ByteBuffer.wrap(data, off, len)).toString();
+    }
+}
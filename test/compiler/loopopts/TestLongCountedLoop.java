@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary loops with a long induction variable nested around an int counted
+ *          loop must keep their trip count, including across int range
+ *          boundaries and when limit - init overflows
+ * @library /testlibrary
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:+UnlockExperimentalVMOptions -XX:+UseLongCountedLoops TestLongCountedLoop
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement TestLongCountedLoop
+ * @run main TestLongCountedLoop verify
+ */
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestLongCountedLoop {
+
+    static int sumArray(int[] a, long from, long to) {
+        int sum = 0;
+        for (long i = from; i < to; i++) {
+            sum += a[(int)i];
+        }
+        return sum;
+    }
+
+    static long countUp(long from, long to) {
+        long count = 0;
+        for (long i = from; i < to; i += 7) {
+            count++;
+        }
+        return count;
+    }
+
+    static long countUpIncl(long from, long to) {
+        long count = 0;
+        for (long i = from; i <= to; i += 1000) {
+            count++;
+        }
+        return count;
+    }
+
+    static long countDown(long from, long to) {
+        long count = 0;
+        for (long i = from; i > to; i -= 3) {
+            count++;
+        }
+        return count;
+    }
+
+    static long doWhile(long from, long to) {
+        long count = 0;
+        long i = from;
+        do {
+            count++;
+            i++;
+        } while (i < to);
+        return count;
+    }
+
+    static long lastValue(long from, long to) {
+        long last = 0;
+        for (long i = from; i < to; i += 5) {
+            last = i;
+        }
+        return last;
+    }
+
+    static long breakOut(long from, long to, long stop) {
+        long count = 0;
+        for (long i = from; i < to; i++) {
+            if (i == stop) {
+                break;
+            }
+            count++;
+        }
+        return count;
+    }
+
+    static long expectedCount(long from, long to, long stride) {
+        if (from >= to) {
+            return 0;
+        }
+        return (to - from + stride - 1) / stride;
+    }
+
+    static void check(String what, long actual, long expected) {
+        if (actual != expected) {
+            throw new RuntimeException(what + ": " + actual + " != " + expected);
+        }
+    }
+
+    static OutputAnalyzer runTraced(String... flags) throws Exception {
+        List<String> args = new ArrayList<>();
+        args.add("-XX:-BackgroundCompilation");
+        args.add("-XX:-UseOnStackReplacement");
+        args.add("-XX:+UnlockExperimentalVMOptions");
+        args.add("-XX:+TraceLoopOpts");
+        args.addAll(Arrays.asList(flags));
+        args.add(TestLongCountedLoop.class.getName());
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                args.toArray(new String[args.size()]));
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        return out;
+    }
+
+    // Checks that the loop nest is only created when the flag is on.
+    static void verifyLoopNest() throws Exception {
+        if (!Platform.isDebugBuild()) {
+            System.out.println("TraceLoopOpts is not available, skipping");
+            return;
+        }
+        runTraced("-XX:+UseLongCountedLoops").shouldContain("LongLoopNest");
+        runTraced("-XX:-UseLongCountedLoops").shouldNotContain("LongLoopNest");
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("verify")) {
+            verifyLoopNest();
+            return;
+        }
+
+        int[] a = new int[100];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i;
+        }
+
+        for (int i = 0; i < 20_000; i++) {
+            sumArray(a, 0, a.length);
+            countUp(0, 100);
+            countUpIncl(0, 10_000);
+            countDown(100, 0);
+            doWhile(0, 10);
+            lastValue(0, 100);
+            breakOut(0, 100, 50);
+        }
+
+        check("sumArray", sumArray(a, 0, a.length), 4950);
+        check("sumArray partial", sumArray(a, 10, 20), 145);
+        try {
+            sumArray(a, 50, 101);
+            throw new RuntimeException("expected AIOOBE");
+        } catch (ArrayIndexOutOfBoundsException e) {
+            // expected
+        }
+
+        long intMax = Integer.MAX_VALUE;
+        check("countUp small", countUp(0, 100), expectedCount(0, 100, 7));
+        check("countUp across int range", countUp(intMax - 100, 3 * intMax),
+              expectedCount(intMax - 100, 3 * intMax, 7));
+        check("countUp negative", countUp(-2 * intMax, intMax),
+              expectedCount(-2 * intMax, intMax, 7));
+        check("countUp near max", countUp(Long.MAX_VALUE - 100, Long.MAX_VALUE),
+              expectedCount(Long.MAX_VALUE - 100, Long.MAX_VALUE, 7));
+        check("countUp empty", countUp(10, 10), 0);
+
+        check("countUpIncl", countUpIncl(0, 10_000), 11);
+        check("countUpIncl across int range", countUpIncl(-intMax, 2 * intMax),
+              3 * intMax / 1000 + 1);
+
+        check("countDown", countDown(100, 0), 34);
+        check("countDown across int range", countDown(intMax, -intMax),
+              (2 * intMax + 2) / 3);
+        check("countDown near min", countDown(Long.MIN_VALUE + 30, Long.MIN_VALUE), 10);
+
+        check("doWhile", doWhile(0, 10), 10);
+        check("doWhile past limit", doWhile(20, 10), 1);
+        // limit - init overflows to a small positive value
+        check("doWhile overflow", doWhile(Long.MAX_VALUE - 5, Long.MIN_VALUE + 5), 1);
+
+        check("lastValue", lastValue(0, 100), 95);
+        check("lastValue across int range", lastValue(intMax - 20, intMax + 20),
+              intMax + 15);
+
+        // limit - init overflows to a negative value
+        check("breakOut overflow", breakOut(Long.MIN_VALUE, Long.MAX_VALUE, Long.MIN_VALUE + 1000), 1000);
+        check("breakOut", breakOut(0, 100, 50), 50);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary locks on a loop invariant object are coarsened across unrolled
+ *          loop iterations, and the results and the lock state stay correct
+ * @library /testlibrary
+ * @run main TestLoopLockCoarsening
+ */
+import java.util.Vector;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestLoopLockCoarsening {
+    static final Object LOCK = new Object();
+    static int counter;
+
+    static int sumVector(Vector<Integer> v) {
+        int sum = 0;
+        for (int i = 0; i < v.size(); i++) {
+            sum += v.get(i);
+        }
+        return sum;
+    }
+
+    static void increment(int n) {
+        for (int i = 0; i < n; i++) {
+            synchronized (LOCK) {
+                counter += i;
+            }
+        }
+    }
+
+    public static class Worker {
+        public static void main(String[] args) throws Exception {
+            Vector<Integer> v = new Vector<>();
+            for (int i = 0; i < 1000; i++) {
+                v.add(i);
+            }
+            for (int i = 0; i < 20_000; i++) {
+                if (sumVector(v) != 999 * 1000 / 2) {
+                    throw new RuntimeException("wrong sum");
+                }
+                increment(100);
+            }
+
+            // Another thread contends for the lock while the loop runs
+            counter = 0;
+            Thread t = new Thread() {
+                public void run() {
+                    for (int i = 0; i < 1000; i++) {
+                        synchronized (LOCK) {
+                            counter -= i;
+                        }
+                    }
+                }
+            };
+            t.start();
+            for (int i = 0; i < 100; i++) {
+                increment(1000);
+            }
+            t.join();
+            if (counter != 99 * 999 * 1000 / 2) {
+                throw new RuntimeException("wrong counter " + counter);
+            }
+            if (Thread.holdsLock(LOCK)) {
+                throw new RuntimeException("lock still held");
+            }
+        }
+    }
+
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 4];
+        System.arraycopy(flags, 0, args, 0, flags.length);
+        args[flags.length]     = "-XX:-TieredCompilation";
+        args[flags.length + 1] = "-XX:-BackgroundCompilation";
+        args[flags.length + 2] = "-XX:+CITime";
+        args[flags.length + 3] = Worker.class.getName();
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        return new OutputAnalyzer(pb.start());
+    }
+
+    public static void main(String[] args) throws Exception {
+        // Only locks coarsened across the iterations of a loop unrolled
+        // for LoopLockCoarsening are counted.
+        OutputAnalyzer out = run("-XX:+LoopLockCoarsening");
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("C2 lock coarsening +: +[1-9]\\d* locks, [1-9]\\d* unlocks, [1-9]\\d* loops unrolled");
+
+        out = run("-XX:+LoopLockCoarsening", "-XX:LoopLockCoarseningChunk=2");
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("C2 lock coarsening +: +[1-9]\\d* locks, [1-9]\\d* unlocks, [1-9]\\d* loops unrolled");
+
+        out = run("-XX:-LoopLockCoarsening");
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("C2 lock coarsening +: +0 locks, 0 unlocks, 0 loops unrolled");
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary int counted loops strip mined around a safepoint poll must keep
+ *          their trip count and results, including near the int range limits
+ * @library /testlibrary
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:-UseCountedLoopSafepoints -XX:LoopStripMiningIter=1000
+ *                   TestLoopStripMining
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:-UseCountedLoopSafepoints -XX:LoopStripMiningIter=7
+ *                   TestLoopStripMining
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:-UseCountedLoopSafepoints -XX:LoopStripMiningIter=1
+ *                   TestLoopStripMining
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:LoopStripMiningIter=0 TestLoopStripMining
+ * @run main TestLoopStripMining verify
+ */
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestLoopStripMining {
+
+    static int sumArray(int[] a, int from, int to) {
+        int sum = 0;
+        for (int i = from; i < to; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static void addArrays(int[] dst, int[] src) {
+        for (int i = 0; i < dst.length; i++) {
+            dst[i] += src[i] * 3;
+        }
+    }
+
+    static long countUp(int from, int to) {
+        long count = 0;
+        for (int i = from; i < to; i += 5) {
+            count++;
+        }
+        return count;
+    }
+
+    static long countUpIncl(int from, int to) {
+        long count = 0;
+        for (int i = from; i <= to; i += 3) {
+            count++;
+        }
+        return count;
+    }
+
+    static long countDown(int from, int to) {
+        long count = 0;
+        for (int i = from; i > to; i -= 3) {
+            count++;
+        }
+        return count;
+    }
+
+    static int lastValue(int from, int to) {
+        int last = 0;
+        for (int i = from; i < to; i += 2) {
+            last = i;
+        }
+        return last;
+    }
+
+    static long expectedCount(long from, long to, long stride) {
+        if (from >= to) {
+            return 0;
+        }
+        return (to - from + stride - 1) / stride;
+    }
+
+    static void check(String what, long actual, long expected) {
+        if (actual != expected) {
+            throw new RuntimeException(what + ": " + actual + " != " + expected);
+        }
+    }
+
+    static OutputAnalyzer runTraced(String... flags) throws Exception {
+        List<String> args = new ArrayList<>();
+        args.add("-XX:-BackgroundCompilation");
+        args.add("-XX:-UseOnStackReplacement");
+        args.add("-XX:+TraceLoopOpts");
+        args.add("-XX:CompileCommand=compileonly,TestLoopStripMining::sumArray");
+        args.addAll(Arrays.asList(flags));
+        args.add(TestLoopStripMining.class.getName());
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                args.toArray(new String[args.size()]));
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        return out;
+    }
+
+    // Checks that the loop nest is only created when strip mining is on.
+    static void verifyStripMining() throws Exception {
+        if (!Platform.isDebugBuild()) {
+            System.out.println("TraceLoopOpts is not available, skipping");
+            return;
+        }
+        runTraced("-XX:-UseCountedLoopSafepoints", "-XX:LoopStripMiningIter=1000")
+            .shouldContain("StripMined");
+        runTraced("-XX:-UseCountedLoopSafepoints", "-XX:LoopStripMiningIter=0")
+            .shouldNotContain("StripMined");
+        runTraced("-XX:+UseCountedLoopSafepoints", "-XX:LoopStripMiningIter=1000")
+            .shouldNotContain("StripMined");
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("verify")) {
+            verifyStripMining();
+            return;
+        }
+
+        int[] a = new int[10_000];
+        int[] b = new int[a.length];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i;
+        }
+
+        for (int i = 0; i < 20_000; i++) {
+            sumArray(a, 0, 100);
+            addArrays(b, a);
+            countUp(0, 100);
+            countUpIncl(0, 100);
+            countDown(100, 0);
+            lastValue(0, 100);
+        }
+
+        check("sumArray", sumArray(a, 0, a.length), 49_995_000);
+        check("sumArray partial", sumArray(a, 1000, 1100), 104_950);
+        try {
+            sumArray(a, 9_000, 10_001);
+            throw new RuntimeException("expected AIOOBE");
+        } catch (ArrayIndexOutOfBoundsException e) {
+            // expected
+        }
+
+        int[] c = new int[a.length];
+        addArrays(c, a);
+        for (int i = 0; i < c.length; i++) {
+            check("addArrays " + i, c[i], 3 * i);
+        }
+
+        int intMax = Integer.MAX_VALUE;
+        int intMin = Integer.MIN_VALUE;
+        check("countUp", countUp(0, 1_000_000), expectedCount(0, 1_000_000, 5));
+        check("countUp near max", countUp(intMax - 100_000, intMax),
+              expectedCount(intMax - 100_000L, intMax, 5));
+        check("countUp from min", countUp(intMin, intMin + 100_000),
+              expectedCount(intMin, intMin + 100_000L, 5));
+        check("countUp empty", countUp(10, 10), 0);
+
+        check("countUpIncl", countUpIncl(0, 1_000_000), 1_000_000 / 3 + 1);
+        check("countUpIncl near max", countUpIncl(intMax - 99_999, intMax - 3), 33_333);
+
+        check("countDown", countDown(1_000_000, 0), (1_000_000 + 2) / 3);
+        check("countDown near min", countDown(intMin + 30_000, intMin), 10_000);
+
+        check("lastValue", lastValue(0, 1_000_001), 1_000_000);
+        check("lastValue near max", lastValue(intMax - 10_001, intMax - 1), intMax - 3);
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary range checks with offsets spread over several invariant terms and loops
+ *          unswitched on several invariant flags must keep their semantics
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement TestNestedIndexRCE
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:LoopMaxUnswitch=0 TestNestedIndexRCE
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:LoopUnswitchNodeBudget=100000 TestNestedIndexRCE
+ */
+public class TestNestedIndexRCE {
+
+    // a[base + i + j*stride]
+    static int sumRow(int[] a, int base, int j, int stride, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += a[base + i + j * stride];
+        }
+        return sum;
+    }
+
+    // a[base - (i + off)]
+    static int sumBackward(int[] a, int base, int off, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += a[base - (i + off)];
+        }
+        return sum;
+    }
+
+    // several invariant tests in one loop body
+    static int flags(int[] a, boolean f1, boolean f2, boolean f3, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            int v = a[i];
+            if (f1) {
+                v += 1;
+            }
+            if (f2) {
+                v *= 3;
+            } else {
+                v -= 2;
+            }
+            if (f3) {
+                v ^= 0x55;
+            }
+            sum += v;
+        }
+        return sum;
+    }
+
+    static int flagsRef(int[] a, boolean f1, boolean f2, boolean f3, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            int v = a[i] + (f1 ? 1 : 0);
+            v = f2 ? v * 3 : v - 2;
+            sum += f3 ? (v ^ 0x55) : v;
+        }
+        return sum;
+    }
+
+    static void check(int computed, int expected, String what) {
+        if (computed != expected) {
+            throw new RuntimeException(what + ": " + computed + " != " + expected);
+        }
+    }
+
+    public static void main(String[] args) {
+        int[] a = new int[1000];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i;
+        }
+        for (int iter = 0; iter < 20000; iter++) {
+            int j = iter % 9;
+            // row j of a 100 wide matrix starting at 50
+            check(sumRow(a, 50, j, 100, 100), 100 * (50 + j * 100) + 4950, "sumRow");
+            check(sumBackward(a, 999, 10, 100), 100 * 989 - 4950, "sumBackward");
+            boolean f1 = (iter & 1) != 0, f2 = (iter & 2) != 0, f3 = (iter & 4) != 0;
+            check(flags(a, f1, f2, f3, 1000), flagsRef(a, f1, f2, f3, 1000), "flags");
+        }
+        // The out of bounds access must still be detected at the right point
+        try {
+            sumRow(a, 50, 9, 100, 100);
+            throw new RuntimeException("sumRow: expected AIOOBE");
+        } catch (ArrayIndexOutOfBoundsException e) {
+            check(Integer.parseInt(e.getMessage()), 1000, "sumRow index");
+        }
+        try {
+            sumBackward(a, 99, 10, 100);
+            throw new RuntimeException("sumBackward: expected AIOOBE");
+        } catch (ArrayIndexOutOfBoundsException e) {
+            check(Integer.parseInt(e.getMessage()), -1, "sumBackward index");
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary test that fused string concatenations with boolean, char and nested appends are correct.
+ * @library /testlibrary
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement TestBooleanConcat
+ * @run main/othervm -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:+UnlockDiagnosticVMOptions -XX:+PrintStringConcatRejections TestBooleanConcat
+ * @run main TestBooleanConcat verify
+ */
+import com.oracle.java.testlibrary.*;
+
+public class TestBooleanConcat {
+
+    static String bools(boolean a, boolean b) {
+        return new StringBuilder().append(a).append('/').append(b).toString();
+    }
+
+    static String mixed(String s, int i, boolean b, char c) {
+        return "s=" + s + " i=" + i + " b=" + b + " c=" + c;
+    }
+
+    static String constant() {
+        return "x" + true + false;
+    }
+
+    static String nested(boolean b, int i) {
+        String inner = new StringBuilder().append(b).append(i).toString();
+        return new StringBuilder().append('[').append(inner).append(']').append(!b).toString();
+    }
+
+    static String buffer(boolean b) {
+        return new StringBuffer().append(b).append(b).toString();
+    }
+
+    static void check(String computed, String expected) {
+        if (!computed.equals(expected)) {
+            throw new RuntimeException("expected '" + expected + "' but got '" + computed + "'");
+        }
+    }
+
+    // Checks that the concatenations were fused rather than just computed
+    // correctly by the unoptimized StringBuilder calls.
+    static void verifyFused() throws Exception {
+        if (!Platform.isDebugBuild()) {
+            System.out.println("PrintOptimizeStringConcat is not available, skipping");
+            return;
+        }
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:-BackgroundCompilation",
+                "-XX:-UseOnStackReplacement",
+                "-XX:+PrintOptimizeStringConcat",
+                TestBooleanConcat.class.getName());
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("fusing string concat in +TestBooleanConcat::bools ");
+        out.shouldMatch("fusing string concat in +TestBooleanConcat::mixed ");
+        out.shouldMatch("fusing string concat in +TestBooleanConcat::nested ");
+        out.shouldMatch("fusing string concat in +TestBooleanConcat::buffer ");
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("verify")) {
+            verifyFused();
+            return;
+        }
+
+        for (int i = 0; i < 20000; i++) {
+            boolean b = (i & 1) == 0;
+            String bs = b ? "true" : "false";
+            String nbs = b ? "false" : "true";
+            check(bools(b, !b), bs + "/" + nbs);
+            check(mixed(null, i, b, 'z'), "s=null i=" + Integer.toString(i) + " b=" + bs + " c=z");
+            check(constant(), "xtruefalse");
+            check(nested(b, -i), "[" + bs + Integer.toString(-i) + "]" + nbs);
+            check(buffer(b), bs.concat(bs));
+        }
+    }
+}
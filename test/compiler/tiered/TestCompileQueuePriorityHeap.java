@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Selecting tiered compile tasks from the priority heap keeps
+ *          compiling methods in priority order and reports compile queue
+ *          wait times
+ * @library /testlibrary
+ * @run main TestCompileQueuePriorityHeap
+ */
+import com.oracle.java.testlibrary.*;
+
+public class TestCompileQueuePriorityHeap {
+
+    public static class Workload {
+        static int sink;
+
+        static int hash(String s, int seed) {
+            int h = seed;
+            for (int i = 0; i < s.length(); i++) {
+                h = 31 * h + s.charAt(i);
+            }
+            return h;
+        }
+
+        public static void main(String[] args) {
+            StringBuilder sb = new StringBuilder();
+            for (int i = 0; i < 200_000; i++) {
+                sb.setLength(0);
+                sb.append("key").append(i % 1000);
+                sink += hash(sb.toString(), i);
+            }
+            System.out.println("sink " + sink);
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+                "-XX:+TieredCompilation",
+                "-XX:+UseCompileQueuePriorityHeap",
+                "-XX:CompileQueuePriorityRefreshInterval=1",
+                "-XX:+CITime",
+                Workload.class.getName());
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldContain("sink ");
+        out.shouldMatch("C1 CompileQueue *: +\\d+ queued, [1-9]\\d* dequeued");
+        out.shouldMatch("C2 CompileQueue *: +\\d+ queued, \\d+ dequeued");
+
+        // The internal VM test checks that tasks leave the heap in priority
+        // order, also after tasks were removed from the middle of the heap.
+        if (Platform.isDebugBuild()) {
+            pb = ProcessTools.createJavaProcessBuilder(
+                    "-XX:+ExecuteInternalVMTests",
+                    "-version");
+            out = new OutputAnalyzer(pb.start());
+            out.shouldHaveExitValue(0);
+            out.shouldContain("Running test: CompileQueue::test_priority_heap()");
+            out.shouldContain("All internal VM tests passed");
+        }
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+package jfr.event.runtime;
+
+import java.nio.file.Paths;
+import java.time.Duration;
+import java.util.List;
+
+import jdk.jfr.Recording;
+import jdk.jfr.consumer.RecordedEvent;
+
+import com.oracle.java.testlibrary.Asserts;
+import com.oracle.java.testlibrary.PerfCounters;
+import com.oracle.java.testlibrary.jfr.EventNames;
+import com.oracle.java.testlibrary.jfr.Events;
+
+/*
+ * @test TestJavaMonitorContentionStatistics
+ * @library /testlibrary
+ * @run main/othervm -XX:+FlightRecorder -XX:+EnableJFR -XX:+UsePerfData
+ *                   jfr.event.runtime.TestJavaMonitorContentionStatistics
+ * @run main/othervm -XX:+FlightRecorder -XX:+EnableJFR -XX:+UsePerfData -XX:+UseAdaptiveMonitorSpinning
+ *                   -XX:SyncKnobs=SpinHoldLimit=1
+ *                   jfr.event.runtime.TestJavaMonitorContentionStatistics longHolds
+ * @run main/othervm -XX:+FlightRecorder -XX:+EnableJFR -XX:+UsePerfData -XX:+UseAdaptiveMonitorSpinning
+ *                   -XX:SyncKnobs=SpinHoldLimit=1000000
+ *                   jfr.event.runtime.TestJavaMonitorContentionStatistics
+ * @run main/othervm -XX:+FlightRecorder -XX:+EnableJFR -XX:+UsePerfData -XX:+UseNUMA -XX:+UseNUMAMonitorHandoff
+ *                   jfr.event.runtime.TestJavaMonitorContentionStatistics numa
+ * @run main/othervm -XX:+FlightRecorder -XX:+EnableJFR -XX:+UsePerfData -XX:+UseNUMA -XX:+UseNUMAMonitorHandoff
+ *                   -XX:SyncKnobs=NUMAHandoffSkips=0
+ *                   jfr.event.runtime.TestJavaMonitorContentionStatistics
+ */
+public class TestJavaMonitorContentionStatistics {
+    private static final int THREADS = 4;
+    private static final int ITERATIONS = 2000;
+
+    static class ContendedLock {
+    }
+
+    private static final ContendedLock lock = new ContendedLock();
+    private static long counter;
+
+    private static long syncCounter(String name) throws Exception {
+        return PerfCounters.findByName("sun.rt._sync_" + name).longValue();
+    }
+
+    public static void main(String[] args) throws Throwable {
+        // longHolds: holds of up to 1ms exceed SpinHoldLimit, so spins are aborted
+        // numa: the EntryList head may be bypassed for a waiter on the local node
+        String mode = args.length > 0 ? args[0] : "";
+        Recording recording = new Recording();
+        recording.enable(EventNames.JavaMonitorContentionStatistics).withPeriod(Duration.ofMillis(100));
+        recording.start();
+
+        Thread[] threads = new Thread[THREADS];
+        for (int i = 0; i < THREADS; i++) {
+            threads[i] = new Thread() {
+                public void run() {
+                    for (int j = 0; j < ITERATIONS; j++) {
+                        synchronized (lock) {
+                            counter++;
+                            if (j % 100 == 0) {
+                                try {
+                                    Thread.sleep(1);
+                                } catch (InterruptedException e) {
+                                    throw new RuntimeException(e);
+                                }
+                            }
+                        }
+                    }
+                }
+            };
+        }
+        for (Thread t : threads) {
+            t.start();
+        }
+        for (Thread t : threads) {
+            t.join();
+        }
+        recording.stop();
+
+        try {
+            Asserts.assertEQ(counter, (long) THREADS * ITERATIONS, "lost updates under contention");
+
+            long contended = 0;
+            List<RecordedEvent> events = Events.fromRecording(recording);
+            for (RecordedEvent event : events) {
+                if (!event.getEventType().getName().equals(EventNames.JavaMonitorContentionStatistics)) {
+                    continue;
+                }
+                if (!event.getClass("monitorClass").getName().equals(ContendedLock.class.getName())) {
+                    continue;
+                }
+                long count = event.getLong("contendedCount");
+                long buckets = event.getLong("blockedUnder10us") + event.getLong("blockedUnder100us") +
+                               event.getLong("blockedUnder1ms") + event.getLong("blockedUnder10ms") +
+                               event.getLong("blockedUnder100ms") + event.getLong("blockedOver100ms");
+                Asserts.assertEQ(buckets, count, "histogram buckets must add up to the contended count");
+                contended += count;
+            }
+            Asserts.assertGT(contended, 0L, "expected contention on " + ContendedLock.class.getName());
+
+            long spinAborts = syncCounter("LongHoldSpinAborts");
+            long numaHandoffs = syncCounter("NUMAHandoffs");
+            System.out.println("spin aborts: " + spinAborts + ", NUMA handoffs: " + numaHandoffs);
+            if (mode.equals("longHolds")) {
+                Asserts.assertGT(spinAborts, 0L, "spinning should be skipped for long holds");
+            } else {
+                Asserts.assertEQ(spinAborts, 0L, "no hold exceeds the spin limit");
+            }
+            if (!mode.equals("numa")) {
+                Asserts.assertEQ(numaHandoffs, 0L, "the EntryList head must not be bypassed");
+            }
+        } catch (Throwable e) {
+            recording.dump(Paths.get("failed.jfr"));
+            throw e;
+        } finally {
+            recording.close();
+        }
+    }
+}
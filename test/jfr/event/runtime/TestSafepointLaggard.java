@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+package jfr.event.runtime;
+
+import java.lang.management.ManagementFactory;
+import java.nio.file.Paths;
+import java.util.List;
+
+import javax.management.ObjectName;
+
+import jdk.jfr.Recording;
+import jdk.jfr.consumer.RecordedEvent;
+
+import com.oracle.java.testlibrary.Asserts;
+import com.oracle.java.testlibrary.jfr.EventNames;
+import com.oracle.java.testlibrary.jfr.Events;
+
+/*
+ * @test TestSafepointLaggard
+ * @library /testlibrary
+ * @run main/othervm -XX:+FlightRecorder -XX:+EnableJFR
+ *                   -XX:+ProfileTimeToSafepoint -XX:ProfileTimeToSafepointThreshold=0
+ *                   jfr.event.runtime.TestSafepointLaggard
+ */
+public class TestSafepointLaggard {
+    private static final int SAFEPOINTS = 10;
+
+    private static volatile boolean done;
+    private static volatile long sink;
+
+    // A long counted loop, which compiled code does not poll in.
+    private static long spin(int n) {
+        long sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += i ^ (sum >>> 3);
+        }
+        return sum;
+    }
+
+    private static String safepointProfile(String... args) throws Exception {
+        return (String) ManagementFactory.getPlatformMBeanServer().invoke(
+            new ObjectName("com.sun.management:type=DiagnosticCommand"),
+            "vmSafepointProfile",
+            new Object[] { args },
+            new String[] { String[].class.getName() });
+    }
+
+    public static void main(String[] args) throws Throwable {
+        Recording recording = new Recording();
+        recording.enable(EventNames.SafepointLaggard);
+        recording.start();
+
+        Thread spinner = new Thread("Spinner") {
+            public void run() {
+                while (!done) {
+                    sink += spin(10_000_000);
+                }
+            }
+        };
+        spinner.start();
+        for (int i = 0; i < SAFEPOINTS; i++) {
+            System.gc();
+            Thread.sleep(10);
+        }
+        done = true;
+        spinner.join();
+        recording.stop();
+
+        try {
+            int laggards = 0;
+            List<RecordedEvent> events = Events.fromRecording(recording);
+            for (RecordedEvent event : events) {
+                if (!event.getEventType().getName().equals(EventNames.SafepointLaggard)) {
+                    continue;
+                }
+                System.out.println(event);
+                Asserts.assertGTE(event.getDuration("timeToSafepoint").toNanos(), 0L, "negative time to safepoint");
+                Asserts.assertNotNull(event.getThread("laggard"), "laggard thread must be set");
+                Asserts.assertNotNull(event.getString("threadState"), "thread state must be set");
+                laggards++;
+            }
+            Asserts.assertGTE(laggards, SAFEPOINTS, "every safepoint should report its laggard");
+        } catch (Throwable e) {
+            recording.dump(Paths.get("failed.jfr"));
+            throw e;
+        } finally {
+            recording.close();
+        }
+
+        String profile = safepointProfile();
+        System.out.println(profile);
+        Asserts.assertTrue(profile.contains("Time to safepoint profile"), "missing profile header");
+        Asserts.assertTrue(profile.contains("Last state"), "missing profile columns");
+        Asserts.assertTrue(profile.contains("TestSafepointLaggard.spin"), "the spinning thread should be a laggard");
+
+        safepointProfile("-reset");
+        profile = safepointProfile();
+        Asserts.assertFalse(profile.contains("TestSafepointLaggard.spin"), "profile should have been reset");
+    }
+}
@@ -213,6 +213,17 @@ public class TestReadLogfile {
         return fileName;
     }
 
+    // truncated in the middle of the method records
+    public static String generateIllegalLogfile5(String originLogfileName) throws IOException {
+        String fileName = "jitwarmup_5.log";
+        File f = createNewFile(fileName);
+        byte[] originContent = getFileContent(originLogfileName);
+        RandomAccessFile raf = new RandomAccessFile(f, "rw");
+        raf.write(originContent, 0, originContent.length - 7);
+        raf.close();
+        return fileName;
+    }
+
     public static void main(String[] args) throws Exception {
         OutputAnalyzer output = null;
         String originLogfileName = generateOriginLogfile();
@@ -220,6 +231,7 @@ public class TestReadLogfile {
         output = testReadLogfileAndGetResult(originLogfileName);
         output.shouldContain("read log file OK");
         output.shouldHaveExitValue(0);
+        output.shouldMatch("parsed [1-9]\\d* of \\d+ methods from .* \\(mapped\\)");
         // generate and test illegal log file header
         output = testReadLogfileAndGetResult(generateIllegalLogfile1(originLogfileName));
         output.shouldNotContain("read log file OK");
@@ -232,6 +244,9 @@ public class TestReadLogfile {
         // generate and test illegal appid
         output = testReadLogfileAndGetResult(generateIllegalLogfile4(originLogfileName));
         output.shouldNotContain("read log file OK");
+        // generate and test truncated log file
+        output = testReadLogfileAndGetResult(generateIllegalLogfile5(originLogfileName));
+        output.shouldNotContain("read log file OK");
     }
 
     public static class InnerA {
@@ -44,6 +44,7 @@ public class TestInvokeJWarmupViaJcmd {
         CheckCompilationSuccess.run();
         CheckCompilationFail.run();
         CheckDeopt.run();
+        CheckStatus.run();
     }
 }
 
@@ -68,6 +69,7 @@ class JCMDArg {
     public static final String notify = "-notify";
     public static final String check = "-check";
     public static final String deopt = "-deopt";
+    public static final String status = "-status";
 
 }
 
@@ -77,6 +79,7 @@ class ProgramArg {
     public static final String CheckCompilationSuccess = "CheckCompilationSuccess";
     public static final String CheckCompilationFail = "CheckCompilationFail";
     public static final String Deopt = "Deopt";
+    public static final String Status = "Status";
 }
 
 /**
@@ -163,6 +166,15 @@ class CheckDeopt {
     }
 }
 
+class CheckStatus {
+    public static void run() throws Exception {
+        System.out.println("Test JWarmup status.");
+        ProcessBuilder processBuilder = ProcessBuilderFactory.create(ProgramArg.Status, JVMArg.Running);
+        Process p = processBuilder.start();
+        JcmdCaller.callJcmd(ProgramArg.Status, PID.get(p));
+    }
+}
+
 class ProcessBuilderFactory {
     public static ProcessBuilder create(String programArg, final List<String> jvmArgs) throws Exception {
         assert jvmArgs != null && jvmArgs.size() != 0;
@@ -195,6 +207,10 @@ class JcmdCaller {
             ProcessBuilder processBuilder = deopt(pid);
             OutputAnalyzer output = new OutputAnalyzer(processBuilder.start());
             output.shouldContain("Command executed successfully");
+        } else if (ProgramArg.Status.equals(arg)) {
+            OutputAnalyzer output = pollStatus(pid);
+            output.shouldContain("state: warmup");
+            output.shouldMatch("methods: \\d+ scheduled, \\d+ submitted, \\d+ skipped");
         } else {
             throw new RuntimeException(String.format("Unrecognized argument: %s", arg));
         }
@@ -227,6 +243,36 @@ class JcmdCaller {
                 .addToolArg(JCMDArg.deopt);
         return new ProcessBuilder(deopt.getCommand());
     }
+
+    private static final long STATUS_TIMEOUT_MS = 60_000;
+
+    // Invokes notifyStartup() once the VM accepts jcmd, then polls the
+    // status until the warmup is reported or the timeout expires.
+    private static OutputAnalyzer pollStatus(String pid) throws Exception {
+        long deadline = System.currentTimeMillis() + STATUS_TIMEOUT_MS;
+        while (notifyStartup(pid).start().waitFor() != 0) {
+            if (System.currentTimeMillis() > deadline) {
+                throw new RuntimeException("JWarmup notifyStartup failed");
+            }
+            Thread.sleep(100);
+        }
+        while (true) {
+            OutputAnalyzer output = new OutputAnalyzer(status(pid).start());
+            if (output.getOutput().contains("state: warmup") ||
+                System.currentTimeMillis() > deadline) {
+                return output;
+            }
+            Thread.sleep(100);
+        }
+    }
+
+    private static ProcessBuilder status(String pid) {
+        JDKToolLauncher status = JDKToolLauncher.create("jcmd")
+                .addToolArg(pid)
+                .addToolArg("JWarmup")
+                .addToolArg(JCMDArg.status);
+        return new ProcessBuilder(status.getCommand());
+    }
 }
 
 class PID {
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Revoke biases held by exited threads without a safepoint
+ * @library /testlibrary
+ * @run main/othervm -XX:+UseBiasedLocking -XX:BiasedLockingStartupDelay=0 -XX:+UsePerfData
+ *                   -XX:+BiasedLockingRevokeExitedOwnerWithoutSafepoint TestRevokeExitedOwnerBias true
+ * @run main/othervm -XX:+UseBiasedLocking -XX:BiasedLockingStartupDelay=0 -XX:+UsePerfData
+ *                   -XX:-BiasedLockingRevokeExitedOwnerWithoutSafepoint TestRevokeExitedOwnerBias false
+ */
+
+import com.oracle.java.testlibrary.*;
+
+public class TestRevokeExitedOwnerBias {
+    // Stay below BiasedLockingBulkRebiasThreshold so that every
+    // revocation is handled as a single-object revocation.
+    private static final int OBJECT_COUNT = 10;
+
+    static class Lock {
+        int value;
+    }
+
+    private static long counter(String name) throws Exception {
+        return PerfCounters.findByName("sun.rt.biasedLocking." + name).longValue();
+    }
+
+    public static void main(String[] args) throws Exception {
+        boolean withoutSafepoint = Boolean.parseBoolean(args[0]);
+
+        final Lock[] locks = new Lock[OBJECT_COUNT];
+        for (int i = 0; i < OBJECT_COUNT; i++) {
+            locks[i] = new Lock();
+        }
+
+        // Bias each object toward a short-lived thread.
+        for (int i = 0; i < OBJECT_COUNT; i++) {
+            final Lock lock = locks[i];
+            Thread t = new Thread() {
+                public void run() {
+                    synchronized (lock) {
+                        lock.value++;
+                    }
+                }
+            };
+            t.start();
+            t.join();
+        }
+
+        long exitedBefore = counter("exitedOwnerRevocations");
+        long safepointBefore = counter("safepointRevocations");
+
+        // Every lock is now biased toward an exited thread.
+        for (int i = 0; i < OBJECT_COUNT; i++) {
+            synchronized (locks[i]) {
+                locks[i].value++;
+            }
+        }
+
+        long exited = counter("exitedOwnerRevocations") - exitedBefore;
+        long safepoint = counter("safepointRevocations") - safepointBefore;
+        System.out.println("exitedOwnerRevocations: " + exited + ", safepointRevocations: " + safepoint);
+
+        if (withoutSafepoint) {
+            Asserts.assertGTE(exited, (long) OBJECT_COUNT, "biases of exited owners should be revoked without safepoint");
+        } else {
+            Asserts.assertEQ(exited, 0L, "no revocation without safepoint expected");
+            Asserts.assertGT(safepoint, 0L, "revocations should use safepoints");
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary free Metaspace chunks are merged after class unloading and the
+ *          statistics are printed by the VM.metaspace diagnostic command
+ * @library /testlibrary /runtime/testlibrary classes
+ * @build test.Empty ClassUnloadCommon
+ * @run main/othervm -XX:+MetaspaceCoalesceChunks TestMetaspaceCoalesceChunks
+ */
+import java.util.ArrayList;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestMetaspaceCoalesceChunks {
+    static final Pattern COALESCING = Pattern.compile(
+        "coalescing: (\\d+) chunks merged, (\\d+) chunks split, (\\d+)K released, (\\d+)K uncommitted");
+
+    static void loadClasses(int count, ArrayList<ClassLoader> loaders) throws Exception {
+        for (int i = 0; i < count; i++) {
+            ClassLoader ldr = ClassUnloadCommon.newClassLoader();
+            // Keep every other class loader alive to fragment the metaspace
+            if (i % 2 == 1) {
+                loaders.add(ldr);
+            }
+            ldr.loadClass("test.Empty");
+        }
+    }
+
+    static OutputAnalyzer metaspace() throws Exception {
+        String pid = Integer.toString(ProcessTools.getProcessId());
+        ProcessBuilder pb = new ProcessBuilder();
+        pb.command(new String[] { JDKToolFinder.getJDKTool("jcmd"), pid, "VM.metaspace" });
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        return out;
+    }
+
+    public static void main(String[] args) throws Exception {
+        ArrayList<ClassLoader> loaders = new ArrayList<>();
+        loadClasses(2000, loaders);
+        ClassUnloadCommon.triggerUnloading();
+
+        OutputAnalyzer out = metaspace();
+        out.shouldContain("Chunk free lists (data):");
+        out.shouldMatch("fragmentation: \\d+% of free chunk space");
+
+        // Once all loaders are dead the free chunks are adjacent and are
+        // either merged or uncommitted at the end of the virtual space
+        loaders.clear();
+        ClassUnloadCommon.triggerUnloading();
+        out = metaspace();
+        Matcher m = COALESCING.matcher(out.getStdout());
+        if (!m.find()) {
+            throw new RuntimeException("no coalescing statistics");
+        }
+        long merged = Long.parseLong(m.group(1));
+        long uncommitted = Long.parseLong(m.group(4));
+        if (merged == 0 && uncommitted == 0) {
+            throw new RuntimeException("no free chunks were merged or uncommitted");
+        }
+
+        // The merged chunks are reused for new class loaders
+        loadClasses(2000, loaders);
+        metaspace().shouldMatch(COALESCING.pattern());
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary -XX:ArchiveClassesAtExit records the classes used by a run,
+ *          dumps an archive with them at exit and uses it in later runs
+ * @library /testlibrary
+ * @run main ArchiveClassesAtExit
+ */
+import java.io.File;
+import java.nio.file.Files;
+
+import com.oracle.java.testlibrary.*;
+
+public class ArchiveClassesAtExit {
+    static final String ARCHIVE = "./ArchiveClassesAtExit.jsa";
+
+    public static class Worker {
+        public static void main(String[] args) {
+            java.util.concurrent.ConcurrentSkipListMap<String, String> map =
+                new java.util.concurrent.ConcurrentSkipListMap<>();
+            map.put("a", "b");
+            if (!map.get("a").equals("b")) {
+                throw new RuntimeException("wrong value");
+            }
+        }
+    }
+
+    // With -XX:+PrintSharedSpaces the background dump keeps the output of
+    // the VM open, so the output is complete once the dump is done.
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 4];
+        args[0] = "-XX:ArchiveClassesAtExit=" + ARCHIVE;
+        args[1] = "-XX:+PrintSharedSpaces";
+        args[2] = "-XX:+TraceClassLoading";
+        System.arraycopy(flags, 0, args, 3, flags.length);
+        args[args.length - 1] = Worker.class.getName();
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        return new OutputAnalyzer(pb.start());
+    }
+
+    public static void main(String[] args) throws Exception {
+        new File(ARCHIVE).delete();
+        new File(ARCHIVE + ".classlist").delete();
+
+        // No archive yet: the classes are recorded and the archive is dumped
+        OutputAnalyzer out = run();
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("Dynamic archive: \\d+ classes recorded, [1-9]\\d* new");
+        // Worker itself is an app loader class
+        out.shouldMatch("Dynamic archive: [1-9]\\d* classes of other loaders than the boot loader are not archived");
+        out.shouldContain("Dynamic archive: dumped");
+        if (!new File(ARCHIVE).exists()) {
+            throw new RuntimeException("archive not dumped");
+        }
+        String list = new String(Files.readAllBytes(new File(ARCHIVE + ".classlist").toPath()));
+        if (!list.contains("java/util/concurrent/ConcurrentSkipListMap\n")) {
+            throw new RuntimeException("class not recorded:\n" + list);
+        }
+
+        // The archive holds the recorded classes and is not dumped again
+        out = run();
+        out.shouldHaveExitValue(0);
+        out.shouldContain("java.util.concurrent.ConcurrentSkipListMap from shared objects file");
+        out.shouldContain("is up to date");
+        out.shouldNotContain("Dynamic archive: dumped");
+
+        // A stale archive is replaced
+        Files.write(new File(ARCHIVE).toPath(), new byte[] { 1, 2, 3 });
+        out = run();
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Dynamic archive: dumped");
+        out = run();
+        out.shouldHaveExitValue(0);
+        out.shouldContain("is up to date");
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary interned strings archived with -XX:+ArchiveInternedStrings are
+ *          loaded into G1 archive regions, stay the interned instances and
+ *          survive full GCs and concurrent marking, also when the heap
+ *          layout changes
+ * @library /testlibrary
+ * @run main ArchivedInternedStrings
+ */
+import com.oracle.java.testlibrary.*;
+
+public class ArchivedInternedStrings {
+    public static class Worker {
+        static void check(String literal, String computed) {
+            if (computed == literal) {
+                throw new RuntimeException("expected a new string");
+            }
+            if (computed.intern() != literal) {
+                throw new RuntimeException("\"" + literal + "\" is not the interned instance");
+            }
+            if (computed.hashCode() != literal.hashCode()) {
+                throw new RuntimeException("wrong hash code for \"" + literal + "\"");
+            }
+        }
+
+        static void checkAll() {
+            check("java.lang.Object", Object.class.getName());
+            check("java.lang.String", new StringBuilder("java.lang.").append("String").toString());
+            check("", new String(new char[0]));
+            check("ArchivedInternedStrings", ArchivedInternedStrings.class.getName());
+        }
+
+        public static void main(String[] args) throws Exception {
+            checkAll();
+            String s = "java.lang.Object";
+            // Lock and hash an archived string so that its mark word changes.
+            synchronized (s) {
+                System.identityHashCode(s);
+            }
+            for (int i = 0; i < 3; i++) {
+                Object[] garbage = new Object[10000];
+                for (int j = 0; j < garbage.length; j++) {
+                    garbage[j] = "x" + j;
+                }
+                System.gc();
+                checkAll();
+            }
+            if (args.length > 0 && args[0].equals("concurrent")) {
+                // Let the concurrent cycles started by System.gc() finish
+                // marking through the archive regions.
+                for (int i = 0; i < 10; i++) {
+                    Thread.sleep(100);
+                    checkAll();
+                }
+            }
+        }
+    }
+
+    private static OutputAnalyzer run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 4];
+        args[0] = "-XX:+UnlockDiagnosticVMOptions";
+        args[1] = "-XX:SharedArchiveFile=./ArchivedInternedStrings.jsa";
+        args[2] = "-XX:+UseG1GC";
+        args[3] = "-XX:+ArchiveInternedStrings";
+        System.arraycopy(flags, 0, args, 4, flags.length);
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        return new OutputAnalyzer(pb.start());
+    }
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer out = run("-Xmx128m", "-Xshare:dump");
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("Archived [1-9]\\d* interned strings");
+
+        // Same heap layout: the image is used as mapped
+        out = run("-Xmx128m", "-Xshare:on", "-XX:+PrintSharedSpaces", "-XX:+VerifyBeforeGC",
+                  "-XX:+VerifyAfterGC", Worker.class.getName());
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Archived heap objects:");
+        out.shouldMatch("Archived interned strings: [1-9]\\d* added");
+
+        // Young GCs and concurrent marking over the archive regions
+        out = run("-Xmx128m", "-Xshare:on", "-XX:+ExplicitGCInvokesConcurrent", "-XX:+PrintGC",
+                  "-XX:+VerifyBeforeGC", "-XX:+VerifyDuringGC", "-XX:+VerifyAfterGC",
+                  Worker.class.getName(), "concurrent");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("(initial-mark)");
+        out.shouldContain("GC remark");
+
+        // Different heap size and region size: the image is relocated
+        out = run("-Xmx1g", "-XX:G1HeapRegionSize=4m", "-Xshare:on", "-XX:+PrintSharedSpaces",
+                  Worker.class.getName());
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("Archived interned strings: [1-9]\\d* added");
+
+        // The image is ignored without the flag or with another collector
+        out = run("-Xmx128m", "-Xshare:on", "-XX:-ArchiveInternedStrings", "-XX:+PrintSharedSpaces",
+                  Worker.class.getName());
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain("Archived heap objects:");
+
+        out = run("-Xmx128m", "-Xshare:on", "-XX:-UseG1GC", "-XX:+UseParallelGC",
+                  Worker.class.getName());
+        out.shouldHaveExitValue(0);
+    }
+}
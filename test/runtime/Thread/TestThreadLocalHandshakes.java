@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * @test
+ * @summary Run single-thread stack dumps and bias revocations in a thread-local handshake
+ * @library /testlibrary
+ * @run main/othervm -XX:+UseBiasedLocking -XX:BiasedLockingStartupDelay=0 -XX:+UsePerfData
+ *                   -XX:+ThreadLocalHandshakes TestThreadLocalHandshakes true
+ * @run main/othervm -XX:+UseBiasedLocking -XX:BiasedLockingStartupDelay=0 -XX:+UsePerfData
+ *                   -XX:-ThreadLocalHandshakes TestThreadLocalHandshakes false
+ */
+
+import java.util.concurrent.CountDownLatch;
+
+import com.oracle.java.testlibrary.*;
+
+public class TestThreadLocalHandshakes {
+    // Stay below BiasedLockingBulkRebiasThreshold so that every
+    // revocation is handled as a single-object revocation.
+    private static final int OBJECT_COUNT = 10;
+
+    static class Lock {
+        int value;
+    }
+
+    private static long counter(String name) throws Exception {
+        return PerfCounters.findByName("sun.rt.biasedLocking." + name).longValue();
+    }
+
+    private static long stackDumps() throws Exception {
+        return PerfCounters.findByName("sun.threads.handshakeStackDumps").longValue();
+    }
+
+    public static void main(String[] args) throws Exception {
+        boolean handshakes = Boolean.parseBoolean(args[0]);
+
+        final Lock[] locks = new Lock[OBJECT_COUNT];
+        for (int i = 0; i < OBJECT_COUNT; i++) {
+            locks[i] = new Lock();
+        }
+        final CountDownLatch biased = new CountDownLatch(1);
+        final CountDownLatch release = new CountDownLatch(1);
+
+        // Bias every object toward a thread which stays alive, blocked
+        // in the VM, while the biases are revoked.
+        Thread owner = new Thread() {
+            public void run() {
+                for (Lock lock : locks) {
+                    synchronized (lock) {
+                        lock.value++;
+                    }
+                }
+                biased.countDown();
+                try {
+                    release.await();
+                } catch (InterruptedException e) {
+                    throw new RuntimeException(e);
+                }
+            }
+        };
+        owner.start();
+        biased.await();
+        while (owner.getState() != Thread.State.WAITING) {
+            Thread.sleep(10);
+        }
+
+        long dumpsBefore = stackDumps();
+        StackTraceElement[] stack = owner.getStackTrace();
+        long dumps = stackDumps() - dumpsBefore;
+        System.out.println("handshakeStackDumps: " + dumps);
+        boolean found = false;
+        for (StackTraceElement e : stack) {
+            System.out.println("    " + e);
+            if (e.getMethodName().equals("await")) {
+                found = true;
+            }
+        }
+        Asserts.assertTrue(found, "stack of the blocked thread should contain await()");
+
+        long handshakeBefore = counter("handshakeRevocations");
+        for (Lock lock : locks) {
+            synchronized (lock) {
+                lock.value++;
+            }
+        }
+        long revoked = counter("handshakeRevocations") - handshakeBefore;
+        System.out.println("handshakeRevocations: " + revoked);
+
+        release.countDown();
+        owner.join();
+
+        if (handshakes) {
+            Asserts.assertEQ(dumps, 1L, "stack of a blocked thread should be taken in a handshake");
+            Asserts.assertGT(revoked, 0L, "biases of a blocked owner should be revoked in a handshake");
+        } else {
+            Asserts.assertEQ(dumps, 0L, "no handshake stack dump expected");
+            Asserts.assertEQ(revoked, 0L, "no handshake revocation expected");
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Native support for GlobalRefCache test.
+ */
+
+#include <stdlib.h>
+#include "jni.h"
+
+#define MAX_REFS 4096
+
+static jobject strong_refs[MAX_REFS];
+static jweak weak_refs[MAX_REFS];
+
+/*
+ * Creates and deletes global refs for the elements of objs in rounds and
+ * returns the number of refs that did not resolve to their object.
+ */
+JNIEXPORT jint JNICALL
+Java_GlobalRefCache_churn(JNIEnv* env, jclass jclazz, jobjectArray objs, jint rounds) {
+  jint len = (*env)->GetArrayLength(env, objs);
+  jobject* refs = (jobject*) malloc(len * sizeof(jobject));
+  jint errors = 0;
+  jint r, i;
+  if (refs == NULL) {
+    return -1;
+  }
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < len; i++) {
+      jobject obj = (*env)->GetObjectArrayElement(env, objs, i);
+      refs[i] = (*env)->NewGlobalRef(env, obj);
+      (*env)->DeleteLocalRef(env, obj);
+    }
+    for (i = 0; i < len; i++) {
+      jobject obj = (*env)->GetObjectArrayElement(env, objs, i);
+      if (!(*env)->IsSameObject(env, obj, refs[i])) {
+        errors++;
+      }
+      (*env)->DeleteLocalRef(env, obj);
+    }
+    /* Delete in the reverse order every other round */
+    for (i = 0; i < len; i++) {
+      (*env)->DeleteGlobalRef(env, refs[(r & 1) ? len - 1 - i : i]);
+    }
+  }
+  free(refs);
+  return errors;
+}
+
+JNIEXPORT void JNICALL
+Java_GlobalRefCache_keep(JNIEnv* env, jclass jclazz, jobjectArray objs, jboolean weak) {
+  jint len = (*env)->GetArrayLength(env, objs);
+  jint i;
+  for (i = 0; i < len && i < MAX_REFS; i++) {
+    jobject obj = (*env)->GetObjectArrayElement(env, objs, i);
+    if (weak) {
+      weak_refs[i] = (*env)->NewWeakGlobalRef(env, obj);
+    } else {
+      strong_refs[i] = (*env)->NewGlobalRef(env, obj);
+    }
+    (*env)->DeleteLocalRef(env, obj);
+  }
+}
+
+/*
+ * Returns the number of kept refs that are cleared (weak) or that no
+ * longer resolve to the element of objs (strong).
+ */
+JNIEXPORT jint JNICALL
+Java_GlobalRefCache_check(JNIEnv* env, jclass jclazz, jobjectArray objs, jboolean weak) {
+  jint len = (*env)->GetArrayLength(env, objs);
+  jint count = 0;
+  jint i;
+  for (i = 0; i < len && i < MAX_REFS; i++) {
+    if (weak) {
+      if ((*env)->IsSameObject(env, weak_refs[i], NULL)) {
+        count++;
+      }
+    } else {
+      jobject obj = (*env)->GetObjectArrayElement(env, objs, i);
+      if (!(*env)->IsSameObject(env, obj, strong_refs[i])) {
+        count++;
+      }
+      (*env)->DeleteLocalRef(env, obj);
+    }
+  }
+  return count;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Allocates and deletes JNI global refs from several threads and checks
+ * that strong refs keep their objects and weak refs are cleared.
+ */
+public class GlobalRefCache {
+    static {
+        System.loadLibrary("GlobalRefCache");
+    }
+
+    static native int churn(Object[] objs, int rounds);
+    static native void keep(Object[] objs, boolean weak);
+    static native int check(Object[] objs, boolean weak);
+
+    static final int THREADS = 8;
+    static final int KEPT = 1000;
+
+    public static void main(String[] args) throws Exception {
+        Object[] strong = new Object[KEPT];
+        Object[] weak = new Object[KEPT];
+        for (int i = 0; i < KEPT; i++) {
+            strong[i] = new Object();
+            weak[i] = new Object();
+        }
+        keep(strong, false);
+        keep(weak, true);
+
+        final int[] errors = new int[THREADS];
+        Thread[] threads = new Thread[THREADS];
+        for (int t = 0; t < THREADS; t++) {
+            final int id = t;
+            threads[t] = new Thread() {
+                public void run() {
+                    Object[] objs = new Object[100 + id];
+                    for (int i = 0; i < objs.length; i++) {
+                        objs[i] = new int[i];
+                    }
+                    errors[id] = churn(objs, 2000);
+                }
+            };
+            threads[t].start();
+        }
+        for (int t = 0; t < THREADS; t++) {
+            threads[t].join();
+            if (errors[t] != 0) {
+                throw new RuntimeException(errors[t] + " global refs resolved to the wrong object");
+            }
+        }
+
+        // Drop every other weakly referenced object
+        for (int i = 0; i < KEPT; i += 2) {
+            weak[i] = null;
+        }
+        System.gc();
+        System.gc();
+
+        // With -XX:+ExplicitGCInvokesConcurrent the weak handles are
+        // processed by a concurrent cycle which may still be running.
+        int cleared = check(weak, true);
+        for (int i = 0; i < 300 && cleared != KEPT / 2; i++) {
+            Thread.sleep(100);
+            System.gc();
+            cleared = check(weak, true);
+        }
+
+        int moved = check(strong, false);
+        if (moved != 0) {
+            throw new RuntimeException(moved + " kept global refs are wrong after GC");
+        }
+        if (cleared != KEPT / 2) {
+            throw new RuntimeException(cleared + " weak global refs cleared, expected " + KEPT / 2);
+        }
+        System.out.println("Passed");
+    }
+}
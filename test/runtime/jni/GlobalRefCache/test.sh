@@ -0,0 +1,87 @@
+#!/bin/sh
+
+#
+# Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+# DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+#
+# This code is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License version 2 only, as
+# published by the Free Software Foundation.
+#
+# This code is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+# version 2 for more details (a copy is included in the LICENSE file that
+# accompanied this code).
+#
+# You should have received a copy of the GNU General Public License version
+# 2 along with this work; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+
+## @test test.sh
+## @summary JNI global refs are allocated from per-thread caches and weak
+##          global refs are processed by parallel reference processing workers
+## @run shell test.sh
+
+if [ "${TESTSRC}" = "" ]
+then
+  TESTSRC=${PWD}
+  echo "TESTSRC not set.  Using "${TESTSRC}" as default"
+fi
+echo "TESTSRC=${TESTSRC}"
+## Adding common setup Variables for running shell tests.
+. ${TESTSRC}/../../../test_env.sh
+
+# set platform-dependent variables
+OS=`uname -s`
+echo "Testing on " $OS
+case "$OS" in
+  Linux)
+    cc_cmd=`which gcc`
+    if [ "x$cc_cmd" == "x" ]; then
+        echo "WARNING: gcc not found. Cannot execute test." 2>&1
+        exit 0;
+    fi
+    ;;
+  *)
+    echo "Test passed; only valid for Linux"
+    exit 0;
+    ;;
+esac
+
+THIS_DIR=.
+
+cp ${TESTSRC}${FS}*.java ${THIS_DIR}
+${TESTJAVA}${FS}bin${FS}javac *.java
+
+$cc_cmd -fPIC -shared -o libGlobalRefCache.so \
+    -I${TESTJAVA}${FS}include -I${TESTJAVA}${FS}include${FS}linux \
+    ${TESTSRC}${FS}GlobalRefCache.c
+
+LD_LIBRARY_PATH=${THIS_DIR}
+echo   LD_LIBRARY_PATH = ${LD_LIBRARY_PATH}
+export LD_LIBRARY_PATH
+
+# System.gc() is a serial full GC with G1 and CMS. The concurrent cycles
+# started with ExplicitGCInvokesConcurrent process the weak handles with
+# the parallel reference processing workers.
+for flags in "-XX:+UseG1GC" "-XX:+UseParallelGC" "-XX:+UseConcMarkSweepGC" \
+             "-XX:+UseG1GC -XX:+ExplicitGCInvokesConcurrent" \
+             "-XX:+UseConcMarkSweepGC -XX:+ExplicitGCInvokesConcurrent"
+do
+  echo
+  echo ${TESTJAVA}${FS}bin${FS}java ${TESTVMOPTS} -cp ${THIS_DIR} ${flags} \
+      -XX:+UseThreadLocalJNIGlobalHandles -XX:JNIGlobalHandleCacheSize=8 \
+      -XX:+ParallelRefProcEnabled -XX:+ParallelJNIWeakRefProcessing GlobalRefCache
+  ${TESTJAVA}${FS}bin${FS}java ${TESTVMOPTS} -cp ${THIS_DIR} ${flags} \
+      -XX:+UseThreadLocalJNIGlobalHandles -XX:JNIGlobalHandleCacheSize=8 \
+      -XX:+ParallelRefProcEnabled -XX:+ParallelJNIWeakRefProcessing GlobalRefCache
+  JAVA_RETVAL=$?
+  if [ "$JAVA_RETVAL" != "0" ]
+  then
+    exit $JAVA_RETVAL
+  fi
+done
+
+exit 0
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2019 Alibaba Group Holding Limited. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/* @test TestCodeCacheHugePages
+ * @summary Tests that the code cache can be backed by transparent huge pages
+ *          on its own, with and without a segmented code cache
+ * @library /testlibrary
+ * @run driver TestCodeCacheHugePages
+ */
+
+import com.oracle.java.testlibrary.OutputAnalyzer;
+import com.oracle.java.testlibrary.Platform;
+import com.oracle.java.testlibrary.ProcessTools;
+
+public class TestCodeCacheHugePages {
+    public static void main(String[] args) throws Exception {
+        if (!Platform.isLinux()) {
+            // UseTransparentHugePagesForCodeCache is a Linux flag
+            return;
+        }
+
+        run("-XX:-UseLargePages");
+        run("-XX:-UseLargePages", "-XX:+SegmentedCodeCache");
+        run("-XX:-UseLargePages", "-XX:-TieredCompilation", "-XX:ReservedCodeCacheSize=20m");
+    }
+
+    private static void run(String... flags) throws Exception {
+        String[] args = new String[flags.length + 3];
+        args[0] = "-XX:+UseTransparentHugePagesForCodeCache";
+        args[1] = "-XX:+PrintCodeCache";
+        System.arraycopy(flags, 0, args, 2, flags.length);
+        args[args.length - 1] = "-version";
+
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(args);
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        // Without transparent huge pages in the kernel the flag is turned
+        // off with a warning, the VM must start either way.
+        out.shouldContain("CodeCache: size=");
+        out.shouldHaveExitValue(0);
+        if (out.getOutput().contains("TransparentHugePages is not supported")) {
+            out.shouldNotContain("CodeCache huge pages:");
+        } else {
+            // The committed code cache was advised without failures
+            out.shouldMatch("CodeCache huge pages: page_size=[1-9]\\d*K advised=[1-9]\\d*Kb failed=0");
+        }
+    }
+}
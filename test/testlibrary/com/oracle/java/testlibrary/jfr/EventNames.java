@@ -62,6 +62,7 @@ public class EventNames {
     public final static String JavaMonitorEnter = PREFIX + "JavaMonitorEnter"; // "java.monitor_enter";
     public final static String JavaMonitorWait = PREFIX + "JavaMonitorWait"; // "java.monitor_wait";
     public final static String JavaMonitorInflate = PREFIX + "JavaMonitorInflate"; // "java.monitor_inflate";
+    public final static String JavaMonitorContentionStatistics = PREFIX + "JavaMonitorContentionStatistics"; // "java.statistics.monitor_contention";
     public final static String ClassLoad = PREFIX + "ClassLoad"; // "vm.class.load";
     public final static String ClassDefine = PREFIX + "ClassDefine";// "vm.class.define";
     public final static String ClassUnload = PREFIX + "ClassUnload";// "vm.class.unload";
@@ -71,6 +72,7 @@ public class EventNames {
     public final static String SafepointCleanup = PREFIX + "SafepointCleanup";// "vm.runtime.safepoint.cleanup";
     public final static String SafepointCleanupTask = PREFIX + "SafepointCleanupTask";// "vm.runtime.safepoint.cleanuptask";
     public final static String SafepointEnd = PREFIX + "SafepointEnd";// "vm.runtime.safepoint.end";
+    public final static String SafepointLaggard = PREFIX + "SafepointLaggard";// "vm.runtime.safepoint.laggard";
     public final static String ExecuteVMOperation = PREFIX + "ExecuteVMOperation"; // "vm.runtime.execute_vm_operation";
     public final static String Shutdown = PREFIX + "Shutdown"; // "vm.runtime.shutdown";
     public final static String VMError = PREFIX + "VMError"; // "vm.runtime.vm_error";
@@ -31,7 +31,25 @@ import sun.hotspot.WhiteBox;
 
 public enum BlobType {
     // All types (No code cache segmentation)
-    All(0, "Code Cache", "ReservedCodeCacheSize");
+    All(0, "Code Cache", "ReservedCodeCacheSize"),
+    // Execution level 1 and 4 (non-profiled) nmethods (including native nmethods)
+    MethodNonProfiled(1, "CodeHeap 'non-profiled nmethods'", "NonProfiledCodeHeapSize"),
+    // Execution level 2 and 3 (profiled) nmethods
+    MethodProfiled(2, "CodeHeap 'profiled nmethods'", "ProfiledCodeHeapSize") {
+        @Override
+        public boolean allowTypeWhenOverflow(BlobType type) {
+            return super.allowTypeWhenOverflow(type)
+                    || type == BlobType.MethodNonProfiled;
+        }
+    },
+    // Non-nmethods like Buffers, Adapters and Runtime Stubs
+    NonNMethod(3, "CodeHeap 'non-nmethods'", "NonNMethodCodeHeapSize") {
+        @Override
+        public boolean allowTypeWhenOverflow(BlobType type) {
+            return super.allowTypeWhenOverflow(type)
+                    || type == BlobType.MethodNonProfiled;
+        }
+    };
 
     public final int id;
     public final String sizeOptionName;
@@ -54,11 +72,21 @@ public enum BlobType {
     }
 
     public boolean allowTypeWhenOverflow(BlobType type) {
-        return type == this;
+        return type == this
+                || (this == MethodNonProfiled && type == MethodProfiled);
     }
 
     public static EnumSet<BlobType> getAvailable() {
-        return EnumSet.of(All);
+        WhiteBox whiteBox = WhiteBox.getWhiteBox();
+        if (!whiteBox.getBooleanVMFlag("SegmentedCodeCache")) {
+            // only All for non segmented world
+            return EnumSet.of(All);
+        }
+        if (!whiteBox.getBooleanVMFlag("TieredCompilation")) {
+            // there is no MethodProfiled in non tiered world
+            return EnumSet.of(MethodNonProfiled, NonNMethod);
+        }
+        return EnumSet.of(MethodProfiled, MethodNonProfiled, NonNMethod);
     }
 
     public long getSize() {